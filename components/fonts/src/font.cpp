@@ -8,6 +8,8 @@
 #include "alloc.hpp"
 #include "screen.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <ostream>
 #include <sys/stat.h>
@@ -19,7 +21,7 @@ Font::Font() {
   }
 
   cache.reserve(50);
-  currentFontSize = -1;
+  currentFontSize = 0;
   ready           = false;
 }
 
@@ -31,24 +33,177 @@ auto Font::getOrCreateGlyph(char32_t charcode, int16_t glyphSize) -> Glyph * {
     Glyphs glyphs(0, std::hash<uint32_t>{}, std::equal_to<uint32_t>{},
                   GlyphsAlloc{ glyphsMapPool.get() });
     it = cache.emplace(key, std::move(glyphs)).first;
+    if (!openSharedGlyphs(key, it->second)) { loadGlyphFile(key, it->second); }
   }
 
   auto git = it->second.find(charcode);
-  if (git != it->second.end()) { return git->second; }
+  if (git != it->second.end()) {
+    ++cacheHits;
+    git->second.lastUse = nextUse();
+    return git->second.glyph;
+  }
+
+  ++cacheMisses;
 
-  Glyph *glyph = it->second.emplace(charcode, bitmapGlyphPool.allocate()).first->second;
+  auto sit = sharedGlyphs.find(key);
+  if (sit != sharedGlyphs.end()) {
+    Glyph *glyph = getSharedGlyph(*sit->second, charcode, glyphSize);
+    if (glyph != nullptr) { addToCache(it->second, charcode, glyph); }
+    return glyph;
+  }
+
+  Glyph *glyph = bitmapGlyphPool.allocate();
 
   if ((glyph == nullptr) || !getGlyphInternal(*glyph, charcode, glyphSize)) {
     if (glyph != nullptr) {
       bitmapGlyphPool.deleteElement(glyph);
     }
-    it->second.erase(charcode);
     return nullptr;
   }
 
+  addToCache(it->second, charcode, glyph);
+  ++renderedGlyphCount;
+
+  auto fit = glyphFiles.find(key);
+  if ((fit != glyphFiles.end()) && (fit->second->getMode() == glyphFileMode())) {
+    fit->second->add(charcode, *glyph);
+  }
+
   return glyph;
 }
 
+auto Font::glyphFileMode() const -> GlyphFile::Mode {
+  if (glyphLoadMode == GlyphLoadMode::METRICS_ONLY) { return GlyphFile::Mode::METRICS; }
+  return ((screen.getPixelResolution() == Screen::PixelResolution::ONE_BIT) && !preferAntialiasing)
+           ? GlyphFile::Mode::MONO
+           : GlyphFile::Mode::GRAY;
+}
+
+auto Font::loadGlyphFile(int16_t key, Glyphs &glyphs) -> void {
+  if ((fontHash == 0) || !GlyphFile::isEnabled()) { return; }
+
+  GlyphFilePtr file = GlyphFile::Make(fontHash, key, glyphFileMode());
+  if (!file) { return; }
+
+  loadedGlyphCount += file->load([this, &glyphs](char32_t charcode, const Glyph &src,
+                                                 const uint8_t *bitmap) -> bool {
+    if (glyphs.contains(charcode)) { return true; }
+
+    Glyph *glyph = bitmapGlyphPool.allocate();
+    if (glyph == nullptr) { return false; }
+
+    *glyph = src;
+    if (bitmap != nullptr) {
+      uint16_t size = src.pitch * src.dim.height;
+      if ((glyph->buffer = bytePoolAlloc(size)) == nullptr) {
+        bitmapGlyphPool.deleteElement(glyph);
+        return false;
+      }
+      memcpy(glyph->buffer, bitmap, size);
+    }
+
+    addToCache(glyphs, charcode, glyph);
+    return true;
+  });
+
+  glyphFiles[key] = std::move(file);
+}
+
+auto Font::openSharedGlyphs(int16_t key, Glyphs &glyphs) -> bool {
+  if ((fontHash == 0) || !glyphStore.isEnabled()) { return false; }
+
+  SharedGlyphsPtr shared = glyphStore.get(fontHash, key, glyphFileMode());
+  if (!shared) { return false; }
+
+  sharedGlyphCount += shared->acquireAll([this, &glyphs](char32_t charcode, Glyph *glyph) {
+    addToCache(glyphs, charcode, glyph);
+  });
+
+  sharedGlyphs[key] = std::move(shared);
+  return true;
+}
+
+auto Font::getSharedGlyph(SharedGlyphs &shared, char32_t charcode, int16_t glyphSize)
+-> Glyph * {
+  Glyph *glyph = shared.acquire(charcode);
+  if (glyph != nullptr) {
+    ++sharedGlyphCount;
+    return glyph;
+  }
+
+  // Another task may produce the same glyph meanwhile: insert() keeps the first.
+  Glyph rendered;
+  renderToScratch = true;
+  bool done       = getGlyphInternal(rendered, charcode, glyphSize);
+  renderToScratch = false;
+  if (!done) { return nullptr; }
+
+  ++renderedGlyphCount;
+  return shared.insert(charcode, rendered);
+}
+
+auto Font::glyphBytes(const Glyph &glyph) -> std::size_t {
+  return sizeof(Glyph) +
+         ((glyph.buffer != nullptr) ? slotBytes(slotClass(glyph.pitch * glyph.dim.height)) : 0);
+}
+
+auto Font::addToCache(Glyphs &glyphs, char32_t charcode, Glyph *glyph) -> void {
+  glyphs.emplace(charcode, CachedGlyph{ glyph, nextUse() });
+  residentBytes += glyphBytes(*glyph);
+}
+
+auto Font::dropGlyph(int16_t key, char32_t charcode, Glyph *glyph) -> void {
+  residentBytes -= glyphBytes(*glyph);
+
+  auto sit = sharedGlyphs.find(key);
+  if (sit != sharedGlyphs.end()) {
+    sit->second->release(charcode);
+    return;
+  }
+
+  if (glyph->buffer != nullptr) { bytePoolFree(glyph->buffer, glyph->pitch * glyph->dim.height); }
+  bitmapGlyphPool.deleteElement(glyph);
+}
+
+auto Font::releaseGlyphs(uint32_t mark) -> void {
+  if ((cacheBudget == 0) || (residentBytes <= cacheBudget)) { return; }
+
+  struct Victim {
+    uint32_t lastUse;
+    int16_t key;
+    uint32_t charcode;
+  };
+
+  HimemVector<Victim> victims;
+  victims.reserve(getGlyphCacheEntryCount());
+  for (auto const &bucket : cache) {
+    for (auto const &entry : bucket.second) {
+      victims.push_back(Victim{ entry.second.lastUse, bucket.first, entry.first });
+    }
+  }
+  std::sort(victims.begin(), victims.end(),
+            [](const Victim &a, const Victim &b) { return a.lastUse < b.lastUse; });
+
+  // Down to 3/4 of the budget, for the next pages not to evict again at once.
+  // Buckets left empty are kept: their glyph file is not read again.
+  const std::size_t target = cacheBudget - cacheBudget / 4;
+  for (auto const &victim : victims) {
+    if ((residentBytes <= target) || (victim.lastUse > mark)) { break; }
+    Glyphs &glyphs = cache.find(victim.key)->second;
+    auto    git    = glyphs.find(victim.charcode);
+    dropGlyph(victim.key, victim.charcode, git->second.glyph);
+    glyphs.erase(git);
+    ++cacheEvictions;
+  }
+
+  LOG_D("Glyph cache of font {} trimmed to {} bytes.", fontsCacheIndex, residentBytes);
+}
+
+auto Font::flushGlyphFiles() -> void {
+  for (auto &entry : glyphFiles) { entry.second->flush(); }
+  for (auto &entry : sharedGlyphs) { entry.second->flush(); }
+}
+
 auto Font::addBuffToBytePool() -> void {
   BytePool *pool = (BytePool *)allocate(BYTE_POOL_SIZE);
   if (pool == nullptr) {
@@ -65,30 +220,63 @@ auto Font::bytePoolAlloc(uint16_t size) -> uint8_t * {
     LOG_E("Byte Pool Size NOT BIG ENOUGH!!!");
     std::abort();
   }
-  if (bytePools.empty() || (bytePoolIdx + size) > BYTE_POOL_SIZE) {
+
+  if (renderToScratch) {
+    scratchBitmap.resize(size);
+    return scratchBitmap.data();
+  }
+
+  uint8_t idx = slotClass(size);
+  if (freeSlots[idx] != nullptr) {
+    FreeSlot *slot = freeSlots[idx];
+    freeSlots[idx] = slot->next;
+    return reinterpret_cast<uint8_t *>(slot);
+  }
+
+  // Slots are a power of two bytes: they stay aligned in the pool.
+  uint32_t bytes = slotBytes(idx);
+  if (bytePools.empty() || (bytePoolIdx + bytes) > BYTE_POOL_SIZE) {
     LOG_D("Adding new Byte Pool buffer.");
     addBuffToBytePool();
+    if (bytePools.empty() || (bytePoolIdx != 0)) { return nullptr; }
   }
 
   uint8_t *buff = &(*bytePools.front())[bytePoolIdx];
-  bytePoolIdx += size;
+  bytePoolIdx += bytes;
 
   return buff;
 }
 
+auto Font::bytePoolFree(uint8_t *buff, uint16_t size) -> void {
+  uint8_t   idx  = slotClass(size);
+  FreeSlot *slot = reinterpret_cast<FreeSlot *>(buff);
+  slot->next     = freeSlots[idx];
+  freeSlots[idx] = slot;
+}
+
 auto Font::clearCache() -> void {
 
   LOG_D("Clear cache...");
+  glyphFiles.clear(); // Their pending glyphs are written
+
   for (auto const &entry : cache) {
+    auto sit = sharedGlyphs.find(entry.first);
     for (auto const &glyph : entry.second) {
-      bitmapGlyphPool.deleteElement(glyph.second);
+      if (sit != sharedGlyphs.end()) {
+        sit->second->release(glyph.first);
+      } else {
+        bitmapGlyphPool.deleteElement(glyph.second.glyph);
+      }
     }
   }
+  sharedGlyphs.clear();
 
   for (auto *buff : bytePools) {
     free(buff);
   }
   bytePools.clear();
+  freeSlots.fill(nullptr);
+  residentBytes = 0;
 
   cache.clear();
   cache.reserve(50);
@@ -131,12 +319,35 @@ auto Font::getGlyph(char32_t charcode, char32_t nextCharcode, int16_t glyphSize)
   }
 
   if ((glyph != nullptr) && (nextCharcode != 0)) {
-    kern = getKern(*glyph, nextCharcode);
+    kern = getPairKern(*glyph, nextCharcode, glyphSize);
   }
 
   return std::make_tuple(glyph, kern, ignoreNext);
 }
 
+auto Font::getPairKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t {
+  ++kernLookups;
+  if (!hasKerning()) { return 0; }
+
+  uint64_t key = ((uint64_t)(uint16_t)toCacheKey(glyphSize, currentSizeUnit) << 48) |
+                 ((uint64_t)glyph.index << 32) | (uint32_t)nextCharcode;
+
+  auto it = kernPairs.find(key);
+  if (it != kernPairs.end()) { return it->second; }
+
+  if (kernPairs.size() >= KERN_PAIRS_MAX) {
+    LOG_D("Kerning pairs of font {} dropped.", fontsCacheIndex);
+    kernPairs.clear();
+  }
+  if (kernPairs.empty()) { kernPairs.reserve(KERN_PAIRS_RESERVE); }
+
+  ++kernFaceCalls;
+  int16_t kern = getKern(glyph, nextCharcode, glyphSize);
+  kernPairs.emplace(key, kern);
+
+  return kern;
+}
+
 // Only used for ASCII chars
 auto Font::getASCIISize(const char *str, int16_t glyphSize) -> Dim {
 
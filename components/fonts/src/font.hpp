@@ -7,9 +7,13 @@
 
 #include "char_pool.hpp"
 #include "fonts_db.hpp"
+#include "glyph_file.hpp"
+#include "glyph_store.hpp"
 #include "himem.hpp"
 #include "himem_pool.hpp"
 
+#include <array>
+#include <atomic>
 #include <forward_list>
 // #include <mutex>
 
@@ -30,10 +34,6 @@ class Font {
   private:
     static constexpr char const *TAG = "Font";
 
-    static constexpr auto toCacheKey(int16_t size, SizeUnit unit) -> int16_t {
-      return (unit == SizeUnit::PIXELS) ? static_cast<int16_t>(-size) : size;
-    }
-
   public:
     /**
      * @brief Get a glyph object
@@ -64,7 +64,11 @@ class Font {
       WITH_BITMAP ///< Full glyph including rasterized bitmap (default)
     };
 
-    auto setGlyphLoadMode(GlyphLoadMode mode) -> void { glyphLoadMode = mode; }
+    auto setGlyphLoadMode(GlyphLoadMode mode) -> void {
+      if (glyphLoadMode == mode) { return; }
+      glyphLoadMode = mode;
+      clearCache();
+    }
     [[nodiscard]] auto getGlyphLoadMode() const -> GlyphLoadMode { return glyphLoadMode; }
 
     auto setPreferAntialiasing(bool enabled) -> void {
@@ -90,6 +94,72 @@ class Font {
       return glyphsMapPool ? glyphsMapPool->getTotalFreed() : 0;
     }
 
+    [[nodiscard]] auto getGlyphCacheHits() const -> uint32_t { return cacheHits; }
+    [[nodiscard]] auto getGlyphCacheMisses() const -> uint32_t { return cacheMisses; }
+    [[nodiscard]] auto getGlyphCacheEvictions() const -> uint32_t { return cacheEvictions; }
+
+    /// Bytes taken by the glyphs in the cache: Glyph instances and bitmap slots.
+    [[nodiscard]] auto getGlyphCacheResidentBytes() const -> std::size_t { return residentBytes; }
+
+    /// Bytes allocated for the bitmap slots, in use or free.
+    [[nodiscard]] auto getBytePoolsAllocatedBytes() const -> std::size_t {
+      return std::distance(bytePools.begin(), bytePools.end()) * (std::size_t)BYTE_POOL_SIZE;
+    }
+
+    /**
+     * @brief Limit the bytes taken by the glyphs in the cache
+     *
+     * The least recently used glyphs are dropped by releaseGlyphs() when the
+     * cache holds more. 0: no limit.
+     */
+    auto setGlyphCacheBudget(std::size_t bytes) -> void { cacheBudget = bytes; }
+    [[nodiscard]] auto getGlyphCacheBudget() const -> std::size_t { return cacheBudget; }
+
+    /**
+     * @brief Tell the cache the glyphs retrieved so far are no longer in use
+     *
+     * Glyph pointers are kept by the pages built with the font: glyphs can
+     * only be dropped once these pages are gone. The owner of the pages calls
+     * this method at such a point. If over its budget, the cache then drops
+     * its least recently used glyphs, down to 3/4 of the budget.
+     *
+     * An owner with pages still in use gives the use mark taken before
+     * building the oldest of them (see getUseMark()): only the glyphs not
+     * retrieved since can go.
+     */
+    auto releaseGlyphs(uint32_t mark = UINT32_MAX) -> void;
+
+    /// The glyphs retrieved from now on, by any font, are used after this mark.
+    [[nodiscard]] static auto getUseMark() -> uint32_t {
+      return useClock.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Kerning between a glyph and the next character
+     *
+     * Values are kept by size, glyph index and next character code, so the
+     * face is asked once per pair. Faces without kerning data are not asked
+     * at all.
+     *
+     * @return int16_t The kerning in pixels, 0 if none.
+     */
+    auto getPairKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t;
+
+    /// Kerning pairs looked up, and the ones that went to the face.
+    [[nodiscard]] auto getKernLookupCount() const -> uint32_t { return kernLookups; }
+    [[nodiscard]] auto getKernFaceCallCount() const -> uint32_t { return kernFaceCalls; }
+    [[nodiscard]] auto getKernCacheEntryCount() const -> std::size_t { return kernPairs.size(); }
+
+    /// Glyphs produced by FreeType, and read from the glyph files.
+    [[nodiscard]] auto getRenderedGlyphCount() const -> uint32_t { return renderedGlyphCount; }
+    [[nodiscard]] auto getLoadedGlyphCount() const -> uint32_t { return loadedGlyphCount; }
+
+    /// Glyphs taken from the glyph store: produced by another font or read from a glyph file.
+    [[nodiscard]] auto getSharedGlyphCount() const -> uint32_t { return sharedGlyphCount; }
+
+    /// Write the glyphs produced by FreeType not yet in the glyph files.
+    auto flushGlyphFiles() -> void;
+
     inline auto setFontsCacheIndex(int16_t index) -> void { fontsCacheIndex = index; }
     [[nodiscard]] inline auto getFontsCacheIndex() -> int16_t { return fontsCacheIndex; }
 
@@ -125,6 +195,30 @@ class Font {
   protected:
     static constexpr uint16_t BYTE_POOL_SIZE = 16384 * 2;
 
+    // Bitmap slots: power-of-two size classes, 8 to BYTE_POOL_SIZE bytes,
+    // as in the CharPool. Freed slots go to a free list per class.
+    static constexpr uint8_t MIN_SLOT_LOG     = 3;
+    static constexpr uint8_t MAX_SLOT_LOG     = 15;
+    static constexpr uint8_t SLOT_CLASS_COUNT = MAX_SLOT_LOG - MIN_SLOT_LOG + 1;
+
+    static constexpr auto slotClass(uint16_t size) -> uint8_t {
+      uint8_t idx = 0;
+      while (((1U << (MIN_SLOT_LOG + idx)) < size) && (idx < SLOT_CLASS_COUNT - 1)) { ++idx; }
+      return idx;
+    }
+    static constexpr auto slotBytes(uint8_t idx) -> uint32_t { return 1U << (MIN_SLOT_LOG + idx); }
+
+    struct FreeSlot {
+      FreeSlot *next;
+    };
+
+    static constexpr std::size_t KERN_PAIRS_RESERVE = 512;  ///< About the pairs of a page of Latin text
+    static constexpr std::size_t KERN_PAIRS_MAX     = 4096; ///< Beyond, the pairs are dropped and learned again
+
+    static constexpr auto toCacheKey(int16_t size, SizeUnit unit) -> int16_t {
+      return (unit == SizeUnit::PIXELS) ? static_cast<int16_t>(-size) : size;
+    }
+
     static constexpr int32_t ligaturesSize = 22;
     static constexpr struct Ligature {
       char32_t firstChar;
@@ -155,11 +249,21 @@ class Font {
       { 0xFB00, 0x006C, 0xFB04 }, // ﬀ ,l, ﬄ
     };
 
-    using GlyphsAlloc = CharPoolAllocator<std::pair<const uint32_t, Glyph *> >;
+    struct CachedGlyph {
+      Glyph *glyph;
+      uint32_t lastUse; ///< Value of useClock when last retrieved
+    };
+
+    using GlyphsAlloc = CharPoolAllocator<std::pair<const uint32_t, CachedGlyph> >;
     using Glyphs =
-      std::unordered_map<uint32_t, Glyph *, std::hash<uint32_t>, std::equal_to<uint32_t>,
+      std::unordered_map<uint32_t, CachedGlyph, std::hash<uint32_t>, std::equal_to<uint32_t>,
                          GlyphsAlloc>; ///< Cache for glyph pointers, allocated from a pool
     using GlyphsCache = HimemUnorderedMap<int16_t, Glyphs>;
+    using GlyphFiles  = HimemUnorderedMap<int16_t, GlyphFilePtr>; ///< By cache key
+    using SharedGlyphsMap = HimemUnorderedMap<int16_t, SharedGlyphsPtr>; ///< By cache key
+
+    /// Kerning by size key (16 bits), left glyph index (16 bits) and next charcode (32 bits)
+    using KernPairs = HimemUnorderedMap<uint64_t, int16_t>;
 
     using BytePool  = uint8_t[BYTE_POOL_SIZE];
     using BytePools = std::forward_list<BytePool *>;
@@ -168,7 +272,33 @@ class Font {
     CharPoolPtr glyphsMapPool{ nullptr };
     int16_t fontsCacheIndex;
 
-    int8_t currentFontSize;
+    GlyphFiles glyphFiles;
+    uint32_t fontHash{ 0 }; ///< Of the font data, 0 if neither glyph files nor the store are used
+    uint32_t renderedGlyphCount{ 0 };
+    uint32_t loadedGlyphCount{ 0 };
+
+    SharedGlyphsMap sharedGlyphs; ///< Glyphs of the sizes kept in the glyph store
+    uint32_t sharedGlyphCount{ 0 };
+    HimemVector<uint8_t> scratchBitmap; ///< Bitmap rendered before going to the glyph store
+    bool renderToScratch{ false };
+
+    static inline std::atomic<uint32_t> useClock{ 0 }; ///< Shared by all fonts, for use marks
+
+    static auto nextUse() -> uint32_t {
+      return useClock.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    std::size_t cacheBudget{ 0 };
+    std::size_t residentBytes{ 0 };
+    uint32_t cacheHits{ 0 };
+    uint32_t cacheMisses{ 0 };
+    uint32_t cacheEvictions{ 0 };
+
+    KernPairs kernPairs;
+    uint32_t kernLookups{ 0 };
+    uint32_t kernFaceCalls{ 0 };
+
+    int16_t currentFontSize; ///< Cache key of the size set in the face, 0 if none
     bool ready;
     GlyphLoadMode glyphLoadMode{ GlyphLoadMode::WITH_BITMAP };
     bool preferAntialiasing{ false };
@@ -178,10 +308,22 @@ class Font {
 
     BytePools bytePools;
     uint16_t bytePoolIdx;
+    std::array<FreeSlot *, SLOT_CLASS_COUNT> freeSlots{};
 
     auto addBuffToBytePool() -> void;
+    auto bytePoolFree(uint8_t *buff, uint16_t size) -> void;
+    [[nodiscard]] static auto glyphBytes(const Glyph &glyph) -> std::size_t;
+    auto addToCache(Glyphs &glyphs, char32_t charcode, Glyph *glyph) -> void;
+    auto dropGlyph(int16_t key, char32_t charcode, Glyph *glyph) -> void;
     auto getOrCreateGlyph(char32_t charcode, int16_t glyphSize) -> Glyph *;
 
+    /// Render mode of the glyphs produced by getGlyphInternal().
+    [[nodiscard]] auto glyphFileMode() const -> GlyphFile::Mode;
+    auto loadGlyphFile(int16_t key, Glyphs &glyphs) -> void;
+    auto openSharedGlyphs(int16_t key, Glyphs &glyphs) -> bool;
+    auto getSharedGlyph(SharedGlyphs &shared, char32_t charcode, int16_t glyphSize) -> Glyph *;
+
     virtual auto getGlyphInternal(Glyph &glyph, char32_t charcode, int16_t glyphSize) -> bool = 0;
-    virtual auto getKern(Glyph &glyph, char32_t nextCharcode) -> int16_t                      = 0;
+    virtual auto getKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t = 0;
+    [[nodiscard]] virtual auto hasKerning() const -> bool = 0; ///< The face has kerning data
 };
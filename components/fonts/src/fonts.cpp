@@ -155,6 +155,33 @@ auto Fonts::clearGlyphCaches() -> void {
   }
 }
 
+auto Fonts::flushGlyphFiles() -> void {
+  for (auto &entry : fontCache) {
+    entry->font->flushGlyphFiles();
+  }
+}
+
+auto Fonts::setGlyphCacheBudget(std::size_t bytes) -> void {
+  glyphCacheBudget = bytes;
+  for (auto &entry : fontCache) {
+    entry->font->setGlyphCacheBudget(bytes);
+  }
+}
+
+auto Fonts::releaseGlyphs(uint32_t mark) -> void {
+  for (auto &entry : fontCache) {
+    entry->font->releaseGlyphs(mark);
+  }
+}
+
+auto Fonts::getLargestGlyphCacheBytes() const -> std::size_t {
+  std::size_t bytes = 0;
+  for (auto &entry : fontCache) {
+    bytes = std::max(bytes, entry->font->getGlyphCacheResidentBytes());
+  }
+  return bytes;
+}
+
 auto Fonts::setGlyphLoadMode(Font::GlyphLoadMode mode) -> void {
   defaultGlyphLoadMode = mode;
   for (auto &entry : fontCache) {
@@ -182,6 +209,7 @@ auto Fonts::replace(int16_t index, const FontFaceDescriptorPtr &descr) -> bool {
       f->style = descr->style;
       f->font->setFontsCacheIndex(index);
       f->font->setGlyphLoadMode(defaultGlyphLoadMode);
+      f->font->setGlyphCacheBudget(glyphCacheBudget);
       fontCache.at(index) = f;
 
       LOG_D("Font {} ({}) replacement at index {} and style {}.", f->name,
@@ -231,6 +259,7 @@ auto Fonts::add(const FontFaceDescriptorPtr &descr) -> bool {
       f->style = descr->style;
       f->font->setFontsCacheIndex(fontCache.size());
       f->font->setGlyphLoadMode(defaultGlyphLoadMode);
+      f->font->setGlyphCacheBudget(glyphCacheBudget);
       fontCache.push_back(f);
 
       LOG_D("Font {} added to cache at index {} and style {}.", f->name,
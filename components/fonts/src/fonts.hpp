@@ -165,13 +165,32 @@ class Fonts {
 
     auto clearGlyphCaches() -> void;
 
+    /// Write the new glyphs of all fonts to their glyph files.
+    auto flushGlyphFiles() -> void;
+
+    /// Glyph cache budget of each font. See Font::setGlyphCacheBudget().
+    auto setGlyphCacheBudget(std::size_t bytes) -> void;
+
+    /// The pages built with these fonts are gone. See Font::releaseGlyphs().
+    auto releaseGlyphs(uint32_t mark = UINT32_MAX) -> void;
+
+    /// Bytes held by the largest glyph cache of these fonts.
+    [[nodiscard]] auto getLargestGlyphCacheBytes() const -> std::size_t;
+
     auto adjustDefaultFont(uint8_t fontIndex) -> void;
 
     auto setGlyphLoadMode(Font::GlyphLoadMode mode) -> void;
 
   private:
+    #if EPUB_LINUX_BUILD
+      static constexpr std::size_t GLYPH_CACHE_BUDGET = 1024 * 1024;
+    #else
+      static constexpr std::size_t GLYPH_CACHE_BUDGET = 256 * 1024;
+    #endif
+
     using FontCache = std::vector<FontEntryPtr>;
     Font::GlyphLoadMode defaultGlyphLoadMode{ Font::GlyphLoadMode::WITH_BITMAP };
+    std::size_t glyphCacheBudget{ GLYPH_CACHE_BUDGET };
     FontCache fontCache;
 
     CharPoolPtr charPool{ nullptr };
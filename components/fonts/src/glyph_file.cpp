@@ -0,0 +1,222 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "glyph_file.hpp"
+
+#include "miniz.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <mutex>
+#include <sys/stat.h>
+#include <unistd.h>
+
+HimemString GlyphFile::folder;
+
+/// The files of a font can be used by more than one Fonts instance (the
+/// viewer and the page prefetcher).
+static std::mutex filesMutex;
+
+auto GlyphFile::setFolder(const HimemString &theFolder) -> void {
+  std::scoped_lock guard(filesMutex);
+
+  folder = theFolder;
+  if (!folder.empty() && (mkdir(folder.c_str(), 0775) != 0) && (errno != EEXIST)) {
+    LOG_E("Unable to create glyphs folder '{}': errno={} ({})", folder, errno,
+          std::strerror(errno));
+    folder.clear();
+  }
+}
+
+auto GlyphFile::hashOf(const uint8_t *data, size_t size) -> uint32_t {
+  // The table directory and most tables of a font are at its beginning:
+  // the first and last 32 KB, with the size, are enough to tell fonts apart.
+  const size_t PART = 32 * 1024;
+
+  uint32_t  size32 = size;
+  mz_ulong crc    = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(&size32),
+                             sizeof(size32));
+  crc             = mz_crc32(crc, data, std::min(size, PART));
+  if (size > PART) {
+    size_t tail = std::min(size - PART, PART);
+    crc         = mz_crc32(crc, data + size - tail, tail);
+  }
+  return static_cast<uint32_t>(crc);
+}
+
+auto GlyphFile::recordCrc(const Record &record, const uint8_t *bitmap) -> uint32_t {
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(&record),
+                          offsetof(Record, crc));
+  if (bitmap != nullptr) { crc = mz_crc32(crc, bitmap, record.bitmapSize); }
+  return static_cast<uint32_t>(crc);
+}
+
+GlyphFile::GlyphFile(uint32_t theFontHash, int16_t theSizeKey, Mode theMode)
+  : fontHash(theFontHash), sizeKey(theSizeKey), mode(theMode) {
+  std::scoped_lock guard(filesMutex);
+
+  if (!folder.empty()) {
+    filename = folder + std::format("/{:08X}_{}_{}.gly", fontHash, sizeKey, (int)mode).c_str();
+  }
+}
+
+auto GlyphFile::load(const Visitor &visitor) -> uint16_t {
+  if (filename.empty()) { return 0; }
+
+  HimemVector<uint8_t> content;
+  {
+    std::scoped_lock guard(filesMutex);
+
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+      LOG_D("No glyphs file '{}'.", filename);
+      return 0;
+    }
+
+    struct stat fileStat;
+    bool        ok = fstat(fileno(file), &fileStat) == 0;
+    if (ok && (fileStat.st_size > 0)) {
+      content.resize(fileStat.st_size);
+      ok = fread(content.data(), content.size(), 1, file) == 1;
+    }
+    fclose(file);
+
+    if (!ok) {
+      LOG_E("Unable to read glyphs file '{}'.", filename);
+      return 0;
+    }
+  }
+
+  Header header{};
+  if (content.size() >= sizeof(Header)) { memcpy(&header, content.data(), sizeof(Header)); }
+  if ((header.magic != MAGIC) || (header.version != VERSION) || (header.mode != (uint8_t)mode) ||
+      (header.sizeKey != sizeKey) || (header.fontHash != fontHash)) {
+    LOG_I("Glyphs file '{}' is outdated.", filename);
+    remove(filename.c_str());
+    return 0;
+  }
+
+  uint32_t offset  = sizeof(Header);
+  uint16_t count   = 0;
+  bool     stopped = false;
+
+  while (offset + sizeof(Record) <= content.size()) {
+    Record record;
+    memcpy(&record, content.data() + offset, sizeof(Record));
+
+    const uint8_t *bitmap = content.data() + offset + sizeof(Record);
+    if ((offset + sizeof(Record) + record.bitmapSize > content.size()) ||
+        (recordCrc(record, (record.bitmapSize > 0) ? bitmap : nullptr) != record.crc)) {
+      break;
+    }
+
+    Glyph glyph;
+    glyph.dim        = Dim(record.width, record.height);
+    glyph.xoff       = record.xoff;
+    glyph.yoff       = record.yoff;
+    glyph.advance    = record.advance;
+    glyph.pitch      = record.pitch;
+    glyph.lineHeight = record.lineHeight;
+    glyph.index      = record.index;
+
+    if (!visitor(record.charcode, glyph, (record.bitmapSize > 0) ? bitmap : nullptr)) {
+      stopped = true;
+      break;
+    }
+
+    offset += sizeof(Record) + record.bitmapSize;
+    count++;
+    known.push_back(record.charcode);
+  }
+
+  std::sort(known.begin(), known.end());
+
+  fileSize = content.size();
+  if (!stopped && (offset < content.size())) {
+    LOG_W("Glyphs file '{}' is damaged: {} bytes dropped.", filename, content.size() - offset);
+    std::scoped_lock guard(filesMutex);
+    if (truncate(filename.c_str(), offset) == 0) { fileSize = offset; }
+  }
+
+  LOG_D("Glyphs file '{}': {} glyphs loaded.", filename, count);
+  return count;
+}
+
+auto GlyphFile::add(char32_t charcode, const Glyph &glyph) -> void {
+  if (filename.empty() || (glyph.pitch < 0)) { return; }
+
+  uint32_t bitmapSize = (glyph.buffer != nullptr) ? glyph.pitch * glyph.dim.height : 0;
+  uint32_t size       = sizeof(Record) + bitmapSize;
+
+  if ((bitmapSize > UINT16_MAX) ||
+      (std::max(fileSize, (uint32_t)sizeof(Header)) + pending.size() + size > MAX_FILE_SIZE)) {
+    return;
+  }
+
+  auto pos = std::lower_bound(known.begin(), known.end(), (uint32_t)charcode);
+  if ((pos != known.end()) && (*pos == (uint32_t)charcode)) { return; }
+  known.insert(pos, (uint32_t)charcode);
+
+  Record record = { (uint32_t)charcode, glyph.dim.width,  glyph.dim.height,
+                    glyph.xoff,         glyph.yoff,       glyph.advance,
+                    glyph.pitch,        glyph.lineHeight, glyph.index,
+                    (uint16_t)bitmapSize, 0 };
+  record.crc    = recordCrc(record, glyph.buffer);
+
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&record);
+  pending.insert(pending.end(), bytes, bytes + sizeof(Record));
+  if (bitmapSize > 0) { pending.insert(pending.end(), glyph.buffer, glyph.buffer + bitmapSize); }
+
+  if (pending.size() >= FLUSH_SIZE) { flush(); }
+}
+
+auto GlyphFile::flush() -> bool {
+  if (pending.empty()) { return true; }
+
+  std::scoped_lock guard(filesMutex);
+
+  // Other instances (the prefetcher, the page locations workers) may have
+  // appended to the file since it was read: its size on disk is the one
+  // that counts.
+  struct stat fileStat;
+  uint32_t    onDisk = (stat(filename.c_str(), &fileStat) == 0) ? fileStat.st_size : 0;
+
+  // Whole records only, up to the size limit.
+  uint32_t room   = MAX_FILE_SIZE - std::min(std::max(onDisk, (uint32_t)sizeof(Header)),
+                                             MAX_FILE_SIZE);
+  uint32_t length = 0;
+  while (length + sizeof(Record) <= pending.size()) {
+    Record record;
+    memcpy(&record, pending.data() + length, sizeof(Record));
+    uint32_t next = length + sizeof(Record) + record.bitmapSize;
+    if (next > room) { break; }
+    length = next;
+  }
+
+  bool ok = true;
+  if (length > 0) {
+    FILE *file = fopen(filename.c_str(), "ab");
+
+    ok = file != nullptr;
+    if (ok && (onDisk == 0)) {
+      Header header = { MAGIC, VERSION, (uint8_t)mode, sizeKey, fontHash };
+      ok            = fwrite(&header, sizeof(Header), 1, file) == 1;
+    }
+    ok = ok && (fwrite(pending.data(), length, 1, file) == 1);
+    if (file != nullptr) { ok = (fclose(file) == 0) && ok; }
+
+    if (ok) {
+      fileSize = std::max(onDisk, (uint32_t)sizeof(Header)) + length;
+    } else {
+      LOG_E("Unable to write glyphs file '{}'.", filename);
+    }
+  }
+
+  // Glyphs not written are not retried: they stay out of the file.
+  pending.clear();
+  return ok;
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include <functional>
+
+using GlyphFilePtr = HimemUniquePtr<class GlyphFile>;
+
+/**
+ * class GlyphFile - Glyphs of a font at a size, kept on the SD-Card
+ *
+ * Each glyph shown goes through FreeType to get its metrics and bitmap. A
+ * font starts empty after a restart or a font change, so the first pages
+ * pay for every glyph they use. This class keeps the glyphs produced for a
+ * font, a size and a render mode in a file: when the font needs this size
+ * again, all of them are read at once and FreeType is only called for the
+ * glyphs not seen before.
+ *
+ * Files are named after the font data hash, the size (negative when in
+ * pixels) and the render mode (metrics only, 1 bit or gray levels), so the
+ * same font embedded in many books shares them. They are kept in the
+ * folder given to setFolder(). Without it, nothing is read or written.
+ *
+ * File layout: a Header, then the glyphs, each as a Record followed by its
+ * bitmap and checked with a CRC. New glyphs are kept in memory and appended
+ * in batches. A record cut short or damaged ends the file: what follows is
+ * dropped.
+ */
+class GlyphFile {
+  public:
+    enum class Mode : uint8_t { METRICS = 0, MONO = 1, GRAY = 8 };
+
+    /// Called for each glyph read from the file. The bitmap is nullptr
+    /// when the glyph has none. Returns false to stop the load.
+    using Visitor = std::function<bool(char32_t charcode, const Glyph &glyph, const uint8_t *bitmap)>;
+
+    static constexpr uint32_t MAX_FILE_SIZE = 256 * 1024;
+    static constexpr uint32_t FLUSH_SIZE    = 4096; ///< Pending bytes written at once
+
+    GlyphFile(uint32_t fontHash, int16_t sizeKey, Mode mode);
+    GlyphFile(const GlyphFile &)            = delete;
+    GlyphFile &operator=(const GlyphFile &) = delete;
+    ~GlyphFile() { flush(); }
+
+    static inline auto Make(uint32_t fontHash, int16_t sizeKey, Mode mode) -> GlyphFilePtr {
+      return makeUniqueHimem<GlyphFile>(fontHash, sizeKey, mode);
+    }
+
+    /**
+     * @brief Set the folder of the glyph files
+     *
+     * The folder is created if needed. An empty folder name stops the use
+     * of glyph files.
+     */
+    static auto setFolder(const HimemString &folder) -> void;
+    [[nodiscard]] static inline auto isEnabled() -> bool { return !folder.empty(); }
+
+    /// Hash of the font data, identifying the glyph files of a font.
+    static auto hashOf(const uint8_t *data, size_t size) -> uint32_t;
+
+    /**
+     * @brief Read all the glyphs of the file
+     *
+     * @return The number of glyphs read.
+     */
+    auto load(const Visitor &visitor) -> uint16_t;
+
+    /**
+     * @brief Add a glyph produced by FreeType
+     *
+     * The glyph is written with the next batch. A glyph already in the file
+     * (produced again after being dropped from the cache) is ignored.
+     */
+    auto add(char32_t charcode, const Glyph &glyph) -> void;
+
+    /// Write the glyphs added since the last flush.
+    auto flush() -> bool;
+
+    [[nodiscard]] inline auto getMode() const -> Mode { return mode; }
+
+  private:
+    static constexpr char const *TAG = "GlyphFile";
+
+    static constexpr uint32_t MAGIC  = 0x46594C47; // "GLYF"
+    static constexpr uint8_t VERSION = 1;
+
+    #pragma pack(push, 1)
+    struct Header {
+      uint32_t magic;
+      uint8_t version;
+      uint8_t mode;
+      int16_t sizeKey;
+      uint32_t fontHash;
+    };
+
+    struct Record {
+      uint32_t charcode;
+      uint16_t width, height;
+      int16_t xoff, yoff;
+      int16_t advance;
+      int16_t pitch;
+      int16_t lineHeight;
+      uint16_t index;
+      uint16_t bitmapSize;
+      uint32_t crc; ///< Of the record up to here and of the bitmap
+    };
+    #pragma pack(pop)
+
+    static HimemString folder;
+
+    HimemString filename;
+    uint32_t fontHash;
+    int16_t sizeKey;
+    Mode mode;
+    uint32_t fileSize{ 0 };       ///< Of the file when last read or written
+    HimemVector<uint8_t> pending; ///< Records not yet written
+    HimemVector<uint32_t> known;  ///< Sorted charcodes in the file or pending
+
+    static auto recordCrc(const Record &record, const uint8_t *bitmap) -> uint32_t;
+};
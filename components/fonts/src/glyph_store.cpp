@@ -0,0 +1,154 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#define __GLYPH_STORE__ 1
+#include "glyph_store.hpp"
+
+#include "alloc.hpp"
+
+#include <cstring>
+#include <new>
+
+SharedGlyphs::SharedGlyphs(uint32_t fontHash, int16_t sizeKey, GlyphFile::Mode theMode)
+  : mode(theMode) {
+  if (!GlyphFile::isEnabled()) { return; }
+
+  file = GlyphFile::Make(fontHash, sizeKey, mode);
+  if (!file) { return; }
+
+  file->load([this](char32_t charcode, const Glyph &glyph, const uint8_t *bitmap) -> bool {
+    return entries.contains(charcode) || (add(charcode, glyph, bitmap) != nullptr);
+  });
+}
+
+SharedGlyphs::~SharedGlyphs() {
+  file.reset(); // Its pending glyphs are written
+
+  for (auto &entry : entries) { free(entry.second); }
+}
+
+auto SharedGlyphs::add(char32_t charcode, const Glyph &glyph, const uint8_t *bitmap) -> Entry * {
+  std::size_t bitmapSize = (bitmap != nullptr) ? glyph.pitch * glyph.dim.height : 0;
+  std::size_t size       = sizeof(Entry) + bitmapSize;
+
+  void *buff = allocate(size);
+  if (buff == nullptr) {
+    LOG_E("Unable to allocate memory for shared glyph.");
+    return nullptr;
+  }
+
+  Entry *entry = new (buff) Entry{ glyph, 0 };
+  if (bitmapSize > 0) {
+    entry->glyph.buffer = reinterpret_cast<uint8_t *>(entry + 1);
+    memcpy(entry->glyph.buffer, bitmap, bitmapSize);
+  } else {
+    entry->glyph.buffer = nullptr;
+  }
+
+  entries.emplace(charcode, entry);
+  bytes += size;
+
+  return entry;
+}
+
+auto SharedGlyphs::acquire(char32_t charcode) -> Glyph * {
+  std::shared_lock guard(mutex);
+
+  auto it = entries.find(charcode);
+  if (it == entries.end()) { return nullptr; }
+
+  ++it->second->refs;
+  return &it->second->glyph;
+}
+
+auto SharedGlyphs::acquireAll(const Visitor &visitor) -> uint16_t {
+  std::shared_lock guard(mutex);
+
+  for (auto &entry : entries) {
+    ++entry.second->refs;
+    visitor(entry.first, &entry.second->glyph);
+  }
+  return entries.size();
+}
+
+auto SharedGlyphs::insert(char32_t charcode, const Glyph &glyph) -> Glyph * {
+  std::unique_lock guard(mutex);
+
+  Entry *entry;
+  auto   it = entries.find(charcode);
+  if (it != entries.end()) {
+    entry = it->second;
+  } else {
+    if ((entry = add(charcode, glyph, glyph.buffer)) == nullptr) { return nullptr; }
+    if (file) { file->add(charcode, entry->glyph); }
+  }
+
+  ++entry->refs;
+  return &entry->glyph;
+}
+
+auto SharedGlyphs::release(char32_t charcode) -> void {
+  std::unique_lock guard(mutex);
+
+  auto it = entries.find(charcode);
+  if ((it == entries.end()) || (--it->second->refs > 0)) { return; }
+
+  Entry *entry = it->second;
+  bytes -= sizeof(Entry) + ((entry->glyph.buffer != nullptr)
+                              ? entry->glyph.pitch * entry->glyph.dim.height
+                              : 0);
+  free(entry);
+  entries.erase(it);
+}
+
+auto SharedGlyphs::flush() -> void {
+  std::unique_lock guard(mutex);
+
+  if (file) { file->flush(); }
+}
+
+auto SharedGlyphs::getGlyphCount() -> std::size_t {
+  std::shared_lock guard(mutex);
+
+  return entries.size();
+}
+
+auto GlyphStore::get(uint32_t fontHash, int16_t sizeKey, GlyphFile::Mode mode)
+-> SharedGlyphsPtr {
+  uint64_t key = ((uint64_t)fontHash << 32) | ((uint64_t)(uint16_t)sizeKey << 8) | (uint8_t)mode;
+
+  std::scoped_lock guard(mutex);
+
+  auto it = shared.find(key);
+  if (it != shared.end()) {
+    if (SharedGlyphsPtr glyphs = it->second.lock()) { return glyphs; }
+  }
+
+  // The instances no longer held by a font go at the same time.
+  std::erase_if(shared, [](const auto &entry) { return entry.second.expired(); });
+
+  SharedGlyphsPtr glyphs = SharedGlyphs::Make(fontHash, sizeKey, mode);
+  if (glyphs) { shared[key] = glyphs; }
+  return glyphs;
+}
+
+auto GlyphStore::getGlyphCount() -> std::size_t {
+  std::scoped_lock guard(mutex);
+
+  std::size_t count = 0;
+  for (auto &entry : shared) {
+    if (SharedGlyphsPtr glyphs = entry.second.lock()) { count += glyphs->getGlyphCount(); }
+  }
+  return count;
+}
+
+auto GlyphStore::getBytes() -> std::size_t {
+  std::scoped_lock guard(mutex);
+
+  std::size_t count = 0;
+  for (auto &entry : shared) {
+    if (SharedGlyphsPtr glyphs = entry.second.lock()) { count += glyphs->getBytes(); }
+  }
+  return count;
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "glyph_file.hpp"
+#include "himem.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+using SharedGlyphsPtr = HimemSharedPtr<class SharedGlyphs>;
+
+/**
+ * class SharedGlyphs - Glyphs of a font at a size, shared by the Fonts instances
+ *
+ * The book viewer, the page prefetcher and the page locations workers each
+ * own an EPub, with its Fonts and FreeType faces, as a face cannot be used
+ * by two tasks at once. Each of them would render and keep the same
+ * glyphs. An instance of this class holds the glyphs of a font (by data
+ * hash), a size and a render mode for all of them: a glyph produced by one
+ * task is found by the others.
+ *
+ * Lookups take the lock in shared mode and run side by side. Adding or
+ * freeing a glyph takes it alone. Each glyph counts the fonts holding it in
+ * their cache, and is freed when the last one lets it go: only these fonts
+ * know when the pages using the glyph are gone (see Font::releaseGlyphs()).
+ *
+ * The glyph file of the font size, if any, is read when the instance is
+ * created, and receives the glyphs added.
+ */
+class SharedGlyphs {
+  public:
+    /// Called for each glyph of the instance, with a reference taken for the caller.
+    using Visitor = std::function<void(char32_t charcode, Glyph *glyph)>;
+
+    SharedGlyphs(uint32_t fontHash, int16_t sizeKey, GlyphFile::Mode mode);
+    SharedGlyphs(const SharedGlyphs &)            = delete;
+    SharedGlyphs &operator=(const SharedGlyphs &) = delete;
+    ~SharedGlyphs();
+
+    static inline auto Make(uint32_t fontHash, int16_t sizeKey, GlyphFile::Mode mode)
+    -> SharedGlyphsPtr {
+      return makeSharedHimem<SharedGlyphs>(fontHash, sizeKey, mode);
+    }
+
+    /**
+     * @brief Take a reference on the glyph of a charcode
+     *
+     * @return The glyph, nullptr if not there.
+     */
+    auto acquire(char32_t charcode) -> Glyph *;
+
+    /**
+     * @brief Take a reference on all the glyphs
+     *
+     * @return The number of glyphs given to the visitor.
+     */
+    auto acquireAll(const Visitor &visitor) -> uint16_t;
+
+    /**
+     * @brief Add a glyph produced by FreeType and take a reference on it
+     *
+     * The glyph and its bitmap are copied. If another task added the glyph
+     * first, its copy is returned instead.
+     *
+     * @return The glyph kept, nullptr if out of memory.
+     */
+    auto insert(char32_t charcode, const Glyph &glyph) -> Glyph *;
+
+    /// Let go of a glyph. It is freed with the last reference.
+    auto release(char32_t charcode) -> void;
+
+    /// Write the glyphs added since the last flush to the glyph file.
+    auto flush() -> void;
+
+    [[nodiscard]] inline auto getMode() const -> GlyphFile::Mode { return mode; }
+    [[nodiscard]] auto getGlyphCount() -> std::size_t;
+
+    /// Bytes taken by the glyphs and their bitmaps.
+    [[nodiscard]] inline auto getBytes() const -> std::size_t { return bytes.load(); }
+
+  private:
+    static constexpr char const *TAG = "SharedGlyphs";
+
+    /// Followed by the bitmap of the glyph, in the same allocation.
+    struct Entry {
+      Glyph glyph;
+      std::atomic<uint16_t> refs;
+    };
+
+    GlyphFile::Mode mode;
+    GlyphFilePtr file{ nullptr };
+    std::shared_mutex mutex;
+    HimemUnorderedMap<uint32_t, Entry *> entries;
+    std::atomic<std::size_t> bytes{ 0 };
+
+    /// Copy of the glyph with no reference. Called with the lock held alone.
+    auto add(char32_t charcode, const Glyph &glyph, const uint8_t *bitmap) -> Entry *;
+};
+
+/**
+ * class GlyphStore - The SharedGlyphs in use, by font data hash, size and render mode
+ *
+ * A SharedGlyphs is kept for as long as a font holds it: the next font to
+ * ask for the same key, in any task, gets the same instance.
+ */
+class GlyphStore {
+  public:
+    /// When not enabled, each font keeps its own glyphs.
+    inline auto setEnabled(bool enable) -> void { enabled = enable; }
+    [[nodiscard]] inline auto isEnabled() const -> bool { return enabled; }
+
+    /// The glyphs of a font size, created (and read from its glyph file) if needed.
+    auto get(uint32_t fontHash, int16_t sizeKey, GlyphFile::Mode mode) -> SharedGlyphsPtr;
+
+    /// Glyphs in use, and the bytes they take, for all the fonts.
+    [[nodiscard]] auto getGlyphCount() -> std::size_t;
+    [[nodiscard]] auto getBytes() -> std::size_t;
+
+  private:
+    static constexpr char const *TAG = "GlyphStore";
+
+    std::atomic<bool> enabled{ false };
+    std::mutex mutex;
+    HimemUnorderedMap<uint64_t, std::weak_ptr<SharedGlyphs>> shared;
+};
+
+#if __GLYPH_STORE__
+  GlyphStore glyphStore;
+#else
+  extern GlyphStore glyphStore;
+#endif
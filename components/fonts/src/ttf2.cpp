@@ -28,8 +28,9 @@ auto TTF::clearFace() -> void {
     face = nullptr;
   }
 
+  kernPairs.clear();
   ready           = false;
-  currentFontSize = -1;
+  currentFontSize = 0;
 }
 
 auto TTF::getGlyphInternal(Glyph &glyph, char32_t charcode, int16_t glyphSize) -> bool {
@@ -38,9 +39,7 @@ auto TTF::getGlyphInternal(Glyph &glyph, char32_t charcode, int16_t glyphSize) -
 
   if (face == nullptr) { return false; }
 
-  if (currentFontSize != glyphSize) {
-    if (!setFontSize(glyphSize)) { return false; }
-  }
+  if (!setFontSize(glyphSize)) { return false; }
 
   int glyphIndex = FT_Get_Char_Index(face, (uint32_t)charcode);
   if (glyphIndex == 0) {
@@ -129,10 +128,13 @@ auto TTF::getGlyphInternal(Glyph &glyph, char32_t charcode, int16_t glyphSize) -
   return true;
 }
 
-auto TTF::getKern(Glyph &glyph, char32_t nextCharcode) -> int16_t {
+auto TTF::getKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t {
 
   int16_t kern{ 0 };
 
+  // The glyph may come from the cache: the face is not at its size yet.
+  if (!setFontSize(glyphSize)) { return kern; }
+
   int     glyphIndex = FT_Get_Char_Index(face, nextCharcode);
   if (glyphIndex != 0) {
     FT_Vector kerning;
@@ -157,6 +159,11 @@ auto TTF::getKern(Glyph &glyph, char32_t nextCharcode) -> int16_t {
 }
 
 auto TTF::setFontSize(int16_t size) -> bool {
+  if (face == nullptr) { return false; }
+
+  int16_t key = toCacheKey(size, currentSizeUnit);
+  if (currentFontSize == key) { return true; }
+
   int error = (currentSizeUnit == SizeUnit::POINTS)
                   ? FT_Set_Char_Size(face,               // handle to face object
                                      0,                  // char_width in 1/64th of points
@@ -166,9 +173,11 @@ auto TTF::setFontSize(int16_t size) -> bool {
                   : FT_Set_Pixel_Sizes(face, 0, static_cast<FT_UInt>(size));
   if (error) {
     LOG_E("Unable to set font size Error code: {}", error);
+    currentFontSize = 0;
     return false;
   }
 
+  currentFontSize = key;
   return true;
 }
 
@@ -182,6 +191,10 @@ auto TTF::setFontFace(const FontFaceDescriptorPtr &descr, FT_Library &library) -
     return false;
   }
 
+  if (GlyphFile::isEnabled() || glyphStore.isEnabled()) {
+    fontHash = GlyphFile::hashOf((const uint8_t *)descr->fontData.get(), descr->fontDataSize);
+  }
+
   ready = true;
 
   return true;
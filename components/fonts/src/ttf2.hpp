@@ -37,7 +37,12 @@ public:
     return makeUniqueHimem<TTF>(descr, library);
   }
 
-  auto getKern(Glyph &glyph, char32_t nextCharcode) -> int16_t;
+  /**
+   * @brief Kerning between a glyph and the next character, from the face
+   *
+   * Font::getPairKern() keeps the values: use it instead.
+   */
+  auto getKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t;
 
   /**
    * @brief Face normal line height
@@ -46,8 +51,8 @@ public:
    * @return int32_t Normal line height of the face in pixels
    */
   auto getLineHeight(int16_t glyphSize) -> int32_t {
-    if (currentFontSize != glyphSize) setFontSize(glyphSize);
-    return (face == nullptr) ? 0 : (face->size->metrics.height >> 6);
+    if (!setFontSize(glyphSize)) return 0;
+    return face->size->metrics.height >> 6;
   }
 
   /**
@@ -57,11 +62,16 @@ public:
    *                 the current font size.
    */
   auto getDescenderHeight(int16_t glyphSize) -> int32_t {
-    if (currentFontSize != glyphSize) setFontSize(glyphSize);
-    return (face == nullptr) ? 0 : (face->size->metrics.descender >> 6);
+    if (!setFontSize(glyphSize)) return 0;
+    return face->size->metrics.descender >> 6;
   }
 
 private:
+  /// FreeType only reads the 'kern' table: fonts with GPOS kerning only have none.
+  [[nodiscard]] auto hasKerning() const -> bool {
+    return (face != nullptr) && FT_HAS_KERNING(face);
+  }
+
   auto clearFace() -> void;
 
   /**
@@ -81,7 +91,8 @@ private:
    * @brief Set the font size
    *
    * Set the font size. This will be used to set various general metrics
-   * required from the font structure.
+   * required from the font structure. Nothing is done if the face is already
+   * at this size, in the current size unit.
    *
    * @param size The size of the glyphs in points (1/72th of an inch).
    * @return true The font was resized.
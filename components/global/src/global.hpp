@@ -42,6 +42,7 @@
 #endif
 
 #define FONTS_FOLDER MAIN_FOLDER "/fonts"
+#define GLYPHS_FOLDER MAIN_FOLDER "/glyphs"
 #define BOOKS_FOLDER MAIN_FOLDER "/books"
 
 #ifndef DEBUGGING
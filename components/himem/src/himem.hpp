@@ -10,7 +10,8 @@
 // On EPUB_INKPLATE_BUILD targets every allocation hits SPIRAM via
 // heap_caps_malloc(MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT).
 // On host/Linux builds the implementation silently falls back to the
-// default heap so that unit-tests can run unmodified.
+// default heap so that unit-tests can run unmodified, and counts the
+// allocations in himemAllocationCount.
 //
 // Provided utilities
 // ------------------
@@ -49,7 +50,19 @@
   #define HIMEM_MALLOC(size_) heap_caps_malloc((size_), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
   #define HIMEM_FREE(ptr_) heap_caps_free(ptr_)
 #else
-  #define HIMEM_MALLOC(size_) std::malloc(size_)
+  #include <atomic>
+  #include <cstdint>
+
+  // Number of himem allocations made since the start. Sampled before and
+  // after a piece of code to follow its allocations (Linux build only).
+  inline std::atomic<uint32_t> himemAllocationCount{ 0 };
+
+  inline auto himemMalloc(std::size_t size) -> void * {
+    himemAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size);
+  }
+
+  #define HIMEM_MALLOC(size_) himemMalloc(size_)
   #define HIMEM_FREE(ptr_) std::free(ptr_)
 #endif
 
@@ -0,0 +1,245 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Glyph drawing into the e-ink frame buffers
+ *
+ * Drawing a glyph pixel by pixel costs a frame buffer address computation
+ * (with a multiply) for every pixel. But in every screen orientation, the
+ * pixels of a glyph row (BOTTOM and TOP orientations) or of a glyph column
+ * (LEFT and RIGHT orientations) are consecutive in the frame buffer, going
+ * up or down in memory. Numbering the frame buffer bits (1 bit) or nibbles
+ * (3 bits) from the start of the buffer, such a run of pixels starts at a
+ * given bit or nibble index and then goes forward or backward by one.
+ *
+ * In 1 bit mode, the glyph bitmap has 8 pixels per byte, leftmost pixel in
+ * the most significant bit: a run is drawn one source byte at a time,
+ * shifted and ORed into the two frame buffer bytes it overlaps. For the
+ * LEFT and RIGHT orientations, blocks of 8 x 8 glyph pixels are transposed
+ * first to get bytes of glyph columns. In 3 bits mode, the glyph bitmap has
+ * a byte per pixel: a run is drawn a nibble pair (one frame buffer byte) at
+ * a time.
+ *
+ * The frame buffer layouts are the ones addressed by the Screen::setPixelO*
+ * methods. This is kept apart from the Screen class to be usable without
+ * the e-ink driver.
+ */
+class GlyphBlitter {
+  public:
+    /// Same order as Screen::Orientation.
+    enum class Orientation : int8_t { LEFT, RIGHT, BOTTOM, TOP };
+
+    struct FrameBuffer {
+      uint8_t *data;
+      int32_t lineSize; ///< Bytes per frame buffer line
+      int32_t dataSize; ///< Bytes in the frame buffer
+      uint16_t yOffset; ///< Screen::yOffset, used in the TOP orientation
+    };
+
+    /**
+     * @brief Draw a glyph, already clipped to the screen.
+     *
+     * @param bits1 true for a 1 bit frame buffer and glyph bitmap, false for 3 bits.
+     * @param cols, rows Number of glyph pixels to draw in each direction.
+     * @param pitch Bytes per glyph bitmap row.
+     */
+    static auto drawGlyph(const FrameBuffer &fb, Orientation orientation, bool bits1,
+                          const uint8_t *bitmap, uint16_t pitch, uint16_t x, uint16_t y,
+                          uint16_t cols, uint16_t rows) -> void {
+      if (bits1) {
+        switch (orientation) {
+          case Orientation::BOTTOM:
+            for (uint16_t q = 0; q < rows; q++) {
+              rowRun1Bit(fb.data, (fb.lineSize * (y + q)) * 8 + x, true, bitmap + (q * pitch), cols);
+            }
+            break;
+          case Orientation::TOP:
+            for (uint16_t q = 0; q < rows; q++) {
+              rowRun1Bit(fb.data, (fb.dataSize - (fb.lineSize * (y + q))) * 8 + 7 - (x + fb.yOffset),
+                         false, bitmap + (q * pitch), cols);
+            }
+            break;
+          case Orientation::LEFT:
+          case Orientation::RIGHT:
+            colRuns1Bit(fb, orientation == Orientation::LEFT, bitmap, pitch, x, y, cols, rows);
+            break;
+        }
+      } else {
+        switch (orientation) {
+          case Orientation::BOTTOM:
+            for (uint16_t q = 0; q < rows; q++) {
+              run3Bit(fb.data, (fb.lineSize * (y + q)) * 2 + x, true, bitmap + (q * pitch), 1, cols);
+            }
+            break;
+          case Orientation::TOP:
+            for (uint16_t q = 0; q < rows; q++) {
+              run3Bit(fb.data, (fb.dataSize - (fb.lineSize * (y + q))) * 2 + 1 - (x + fb.yOffset),
+                      false, bitmap + (q * pitch), 1, cols);
+            }
+            break;
+          case Orientation::LEFT:
+            for (uint16_t k = 0; k < cols; k++) {
+              run3Bit(fb.data, (fb.dataSize - (fb.lineSize * (x + k + 1))) * 2 + y, true, bitmap + k,
+                      pitch, rows);
+            }
+            break;
+          case Orientation::RIGHT:
+            for (uint16_t k = 0; k < cols; k++) {
+              run3Bit(fb.data, (fb.lineSize * (x + k + 1)) * 2 - 1 - y, false, bitmap + k, pitch,
+                      rows);
+            }
+            break;
+        }
+      }
+    }
+
+    // Pixel bytes helpers, also used by PictureBlitter.
+
+    /// The pixels of a byte in the reverse order.
+    static inline auto reversed(uint8_t pixels) -> uint8_t;
+
+    /**
+     * Transpose a block of 8 x 8 pixels, a row per byte, the first row in the
+     * most significant byte. The result has a column per byte.
+     */
+    static inline auto transpose8x8(uint64_t x) -> uint64_t {
+      uint64_t t;
+      t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+      x = x ^ t ^ (t << 7);
+      t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+      x = x ^ t ^ (t << 14);
+      t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+      x = x ^ t ^ (t << 28);
+      return x;
+    }
+
+  private:
+    static constexpr auto makeReversed() -> std::array<uint8_t, 256> {
+      std::array<uint8_t, 256> table{};
+      for (int i = 0; i < 256; i++) {
+        uint8_t r = 0;
+        for (int b = 0; b < 8; b++) {
+          if (i & (1 << b)) { r |= 0x80 >> b; }
+        }
+        table[i] = r;
+      }
+      return table;
+    }
+
+    /**
+     * OR 8 pixels (leftmost in the most significant bit) into the frame
+     * buffer, the first one at bit index pos, the others following it
+     * (forward) or preceding it.
+     */
+    static inline auto put8Pixels(uint8_t *data, int32_t pos, bool forward, uint8_t pixels)
+    -> void {
+      uint16_t w;
+      if (forward) {
+        w = reversed(pixels);
+      } else {
+        w    = pixels;
+        pos -= 7;
+      }
+      w <<= (pos & 7);
+      uint8_t *p = data + (pos >> 3);
+      if (w & 0xFF) { p[0] |= w; }
+      if (w >> 8) { p[1] |= w >> 8; }
+    }
+
+    static inline auto rowRun1Bit(uint8_t *data, int32_t pos, bool forward, const uint8_t *src,
+                                  uint16_t count) -> void {
+      for (uint16_t k = 0; k < count; k += 8, src++) {
+        uint8_t pixels = *src;
+        if ((count - k) < 8) { pixels &= 0xFF << (8 - (count - k)); }
+        if (pixels) { put8Pixels(data, forward ? (pos + k) : (pos - k), forward, pixels); }
+      }
+    }
+
+    /**
+     * In the LEFT and RIGHT orientations, a glyph column is a run in the
+     * frame buffer. The glyph is taken by blocks of 8 x 8 pixels, transposed
+     * to get 8 bits of 8 columns.
+     */
+    static inline auto colRuns1Bit(const FrameBuffer &fb, bool left, const uint8_t *bitmap,
+                                   uint16_t pitch, uint16_t x, uint16_t y, uint16_t cols,
+                                   uint16_t rows) -> void {
+      for (uint16_t k = 0; k < rows; k += 8) {
+        uint16_t n = ((rows - k) < 8) ? (rows - k) : 8;
+        for (uint16_t col = 0; col < cols; col += 8) {
+          const uint8_t *src   = bitmap + (k * pitch) + (col >> 3);
+          uint64_t       block = 0;
+          for (uint16_t b = 0; b < n; b++, src += pitch) {
+            block |= static_cast<uint64_t>(*src) << (56 - (b << 3));
+          }
+          if (block == 0) { continue; }
+          block = transpose8x8(block);
+
+          uint16_t last = ((cols - col) < 8) ? cols : (col + 8);
+          for (uint16_t c = col; c < last; c++) {
+            uint8_t pixels = block >> (56 - ((c & 7) << 3));
+            if (pixels == 0) { continue; }
+            if (left) {
+              put8Pixels(fb.data, (fb.dataSize - (fb.lineSize * (x + c + 1))) * 8 + y + k, true,
+                         pixels);
+            } else {
+              put8Pixels(fb.data, (fb.lineSize * (x + c + 1)) * 8 - 1 - y - k, false, pixels);
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * Draw count pixels of 8 bits gray levels, step bytes apart in the
+     * glyph bitmap, from nibble index pos. An even nibble index is the
+     * high nibble of its byte. White pixels leave the frame buffer as is.
+     */
+    static inline auto run3Bit(uint8_t *data, int32_t pos, bool forward, const uint8_t *src,
+                               uint16_t step, uint16_t count) -> void {
+      constexpr uint8_t WHITE = 7;
+      const int32_t     dir   = forward ? 1 : -1;
+
+      uint16_t k = 0;
+      while (k < count) {
+        uint8_t c0 = 7 - (*src >> 5);
+
+        // A nibble pair shares a byte when starting at the high nibble going
+        // forward, or at the low nibble going backward.
+        if (((pos & 1) == (forward ? 0 : 1)) && ((k + 1) < count)) {
+          uint8_t  c1   = 7 - (src[step] >> 5);
+          uint8_t  high = forward ? c0 : c1;
+          uint8_t  low  = forward ? c1 : c0;
+          uint8_t *p    = data + (pos >> 1);
+          if ((high != WHITE) && (low != WHITE)) {
+            *p = (high << 4) | low;
+          } else if (high != WHITE) {
+            *p = (*p & 0x0F) | (high << 4);
+          } else if (low != WHITE) {
+            *p = (*p & 0xF0) | low;
+          }
+          k   += 2;
+          pos += 2 * dir;
+          src += 2 * step;
+        } else {
+          if (c0 != WHITE) {
+            uint8_t *p = data + (pos >> 1);
+            *p = (pos & 1) ? ((*p & 0xF0) | c0) : ((*p & 0x0F) | (c0 << 4));
+          }
+          k++;
+          pos += dir;
+          src += step;
+        }
+      }
+    }
+};
+
+inline auto GlyphBlitter::reversed(uint8_t pixels) -> uint8_t {
+  static constexpr std::array<uint8_t, 256> REVERSED = makeReversed();
+  return REVERSED[pixels];
+}
@@ -0,0 +1,294 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "glyph_blitter.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Picture drawing into the e-ink frame buffers
+ *
+ * Pictures are 8 bits (one byte per pixel) or 4 bits (two pixels per byte,
+ * first one in the high nibble) gray levels, 0 being black.
+ *
+ * For a 1 bit frame buffer, a picture row is first dithered into a row of
+ * bits, 8 pixels per byte, with the error diffusion of the former
+ * Screen::drawPicture code. In the BOTTOM and TOP orientations, a picture row
+ * is a run of consecutive frame buffer bits (see GlyphBlitter): each byte of
+ * the dithered row is stored with a single read-modify-write. In the LEFT
+ * and RIGHT orientations, a picture column is such a run: 8 dithered rows
+ * are kept and transposed by blocks of 8 x 8 pixels before being stored.
+ *
+ * For a 3 bits frame buffer, the pixels are stored by nibble pairs in the
+ * BOTTOM and TOP orientations.
+ *
+ * The dithering and storing code is specialized for each orientation and
+ * picture depth through templates.
+ */
+class PictureBlitter {
+  public:
+    using Orientation = GlyphBlitter::Orientation;
+    using FrameBuffer = GlyphBlitter::FrameBuffer;
+
+    static constexpr uint16_t MAX_WIDTH = 1200; ///< The largest width of all Inkplate devices
+
+    /**
+     * @brief Draw a picture, already clipped to the screen.
+     *
+     * @param bits1 true for a 1 bit frame buffer, false for 3 bits.
+     * @param bpp Bits per picture pixel, 4 or 8.
+     * @param stride Bytes per picture row.
+     * @param cols, rows Number of picture pixels to draw in each direction.
+     */
+    static auto drawPicture(const FrameBuffer &fb, Orientation orientation, bool bits1,
+                            const uint8_t *bitmap, uint8_t bpp, uint16_t stride, uint16_t x,
+                            uint16_t y, uint16_t cols, uint16_t rows) -> void {
+      if (cols > MAX_WIDTH) { cols = MAX_WIDTH; }
+
+      if (bits1) {
+        if (bpp == 4) {
+          dispatch1Bit<4>(fb, orientation, bitmap, stride, x, y, cols, rows);
+        } else {
+          dispatch1Bit<8>(fb, orientation, bitmap, stride, x, y, cols, rows);
+        }
+      } else {
+        if (bpp == 4) {
+          draw3Bit<4>(fb, orientation, bitmap, stride, x, y, cols, rows);
+        } else {
+          draw3Bit<8>(fb, orientation, bitmap, stride, x, y, cols, rows);
+        }
+      }
+    }
+
+  private:
+    template <uint8_t BPP>
+    static auto dispatch1Bit(const FrameBuffer &fb, Orientation orientation, const uint8_t *bitmap,
+                             uint16_t stride, uint16_t x, uint16_t y, uint16_t cols,
+                             uint16_t rows) -> void {
+      switch (orientation) {
+        case Orientation::LEFT:
+          draw1Bit<Orientation::LEFT, BPP>(fb, bitmap, stride, x, y, cols, rows);
+          break;
+        case Orientation::RIGHT:
+          draw1Bit<Orientation::RIGHT, BPP>(fb, bitmap, stride, x, y, cols, rows);
+          break;
+        case Orientation::BOTTOM:
+          draw1Bit<Orientation::BOTTOM, BPP>(fb, bitmap, stride, x, y, cols, rows);
+          break;
+        case Orientation::TOP:
+          draw1Bit<Orientation::TOP, BPP>(fb, bitmap, stride, x, y, cols, rows);
+          break;
+      }
+    }
+
+    /**
+     * Dither count pixels of a picture row into bits (1 = black), 8 pixels
+     * per byte, first pixel in the most significant bit. err is the error
+     * line buffer, with one more entry before its start.
+     *
+     * Pixel k gets err[k + 1] and spreads its error over err[k - 1 .. k + 2],
+     * as the former code did. Here, the entries still receiving errors from
+     * the following pixels are kept in variables: only the entry read for
+     * the next pixel and the one completed by the current pixel are accessed
+     * in memory.
+     */
+    template <uint8_t BPP>
+    static inline auto ditherRow(const uint8_t *src, int16_t *err, uint16_t count, uint8_t *out)
+    -> void {
+      uint8_t  acc  = 0;
+      uint16_t k    = 0;
+      int16_t  prev = err[-1]; // Sum for err[k - 1], err[-1] is a scratch entry
+      int16_t  cur  = err[0];  // Sum for err[k]
+      int16_t  next = 0;       // Error carried to the pixel k
+
+      auto step = [&](int32_t v) {
+        v += err[k + 1] + next;
+        // Without branches, as they are hardly predictable in a picture.
+        uint8_t black = v <= 128;
+        int16_t error = v - (black ? 0 : 255);
+        acc           = (acc << 1) | black;
+        err[k - 1] = prev + (error / 8);
+        prev       = cur + (3 * error / 8);
+        cur        = error / 8;
+        next       = 3 * error / 8;
+        if ((++k & 7) == 0) { *out++ = acc; }
+      };
+
+      if constexpr (BPP == 4) {
+        // Two pixels per source byte, no nibble selection per pixel.
+        for (; (k + 1) < count; src++) {
+          step(*src & 0xF0);
+          step((*src & 0x0F) << 4);
+        }
+        if (k < count) { step(*src & 0xF0); }
+      } else {
+        while (k < count) { step(*src++); }
+      }
+
+      err[k - 1]  = prev;
+      err[k]      = cur;
+      err[k + 1] += next;
+
+      if (k & 7) { *out = acc << (8 - (k & 7)); }
+    }
+
+    /**
+     * Store count (1 to 8) pixels (first one in the most significant bit) in
+     * the frame buffer, the first one at bit index pos, the others following
+     * it (forward) or preceding it.
+     */
+    static inline auto store8Pixels(uint8_t *data, int32_t pos, bool forward, uint8_t pixels,
+                                    uint8_t count) -> void {
+      uint8_t  mask = 0xFF << (8 - count);
+      uint16_t w, m;
+      if (forward) {
+        w = GlyphBlitter::reversed(pixels & mask);
+        m = GlyphBlitter::reversed(mask);
+      } else {
+        w    = pixels & mask;
+        m    = mask;
+        pos -= 7;
+      }
+      w <<= (pos & 7);
+      m <<= (pos & 7);
+      uint8_t *p = data + (pos >> 3);
+      if (m & 0xFF) { p[0] = (p[0] & ~m) | w; }
+      if (m >> 8) { p[1] = (p[1] & ~(m >> 8)) | (w >> 8); }
+    }
+
+    template <Orientation O, uint8_t BPP>
+    static auto draw1Bit(const FrameBuffer &fb, const uint8_t *bitmap, uint16_t stride, uint16_t x,
+                         uint16_t y, uint16_t cols, uint16_t rows) -> void {
+      static int16_t err[MAX_WIDTH + 3];
+      static uint8_t bits[8][(MAX_WIDTH + 7) >> 3];
+
+      memset(err, 0, sizeof(err));
+
+      for (uint16_t q = 0; q < rows; q++) {
+        uint8_t *row = bits[q & 7];
+        ditherRow<BPP>(bitmap + (q * stride), err + 1, cols, row);
+
+        if constexpr ((O == Orientation::BOTTOM) || (O == Orientation::TOP)) {
+          constexpr bool forward = (O == Orientation::BOTTOM);
+          int32_t pos = forward ? ((fb.lineSize * (y + q)) * 8 + x)
+                                : ((fb.dataSize - (fb.lineSize * (y + q))) * 8 + 7 - (x + fb.yOffset));
+          for (uint16_t k = 0; k < cols; k += 8) {
+            uint8_t n = ((cols - k) < 8) ? (cols - k) : 8;
+            store8Pixels(fb.data, forward ? (pos + k) : (pos - k), forward, row[k >> 3], n);
+          }
+        } else {
+          if (((q & 7) == 7) || ((q + 1) == rows)) {
+            storeColumns<O>(fb, bits, x, y, cols, q & ~7, (q & 7) + 1);
+          }
+        }
+      }
+    }
+
+    /**
+     * LEFT and RIGHT orientations: store the count (1 to 8) dithered rows
+     * kept in bits, starting at picture row k.
+     */
+    template <Orientation O>
+    static inline auto storeColumns(const FrameBuffer &fb, const uint8_t (&bits)[8][(MAX_WIDTH + 7) >> 3],
+                                    uint16_t x, uint16_t y, uint16_t cols, uint16_t k,
+                                    uint8_t count) -> void {
+      constexpr bool forward = (O == Orientation::LEFT);
+
+      for (uint16_t col = 0; col < cols; col += 8) {
+        uint64_t block = 0;
+        for (uint8_t b = 0; b < count; b++) {
+          block |= static_cast<uint64_t>(bits[b][col >> 3]) << (56 - (b << 3));
+        }
+        block = GlyphBlitter::transpose8x8(block);
+
+        uint16_t last = ((cols - col) < 8) ? cols : (col + 8);
+        for (uint16_t c = col; c < last; c++) {
+          uint8_t pixels = block >> (56 - ((c & 7) << 3));
+          int32_t pos    = forward ? ((fb.dataSize - (fb.lineSize * (x + c + 1))) * 8 + y + k)
+                                   : ((fb.lineSize * (x + c + 1)) * 8 - 1 - y - k);
+          store8Pixels(fb.data, pos, forward, pixels, count);
+        }
+      }
+    }
+
+    template <uint8_t BPP>
+    static auto draw3Bit(const FrameBuffer &fb, Orientation orientation, const uint8_t *bitmap,
+                         uint16_t stride, uint16_t x, uint16_t y, uint16_t cols, uint16_t rows)
+    -> void {
+      // Nibble index of picture pixel (i, j) is n0 + i * di + j * dj. An even
+      // nibble index is the high nibble of its byte.
+      int32_t n0, di, dj;
+      switch (orientation) {
+        case Orientation::BOTTOM:
+          n0 = (fb.lineSize * y) * 2 + x;
+          di = 1;
+          dj = fb.lineSize * 2;
+          break;
+        case Orientation::TOP:
+          n0 = (fb.dataSize - (fb.lineSize * y)) * 2 + 1 - (x + fb.yOffset);
+          di = -1;
+          dj = -fb.lineSize * 2;
+          break;
+        case Orientation::LEFT:
+          n0 = (fb.dataSize - (fb.lineSize * (x + 1))) * 2 + y;
+          di = -fb.lineSize * 2;
+          dj = 1;
+          break;
+        default: // RIGHT
+          n0 = (fb.lineSize * (x + 1)) * 2 - 1 - y;
+          di = fb.lineSize * 2;
+          dj = -1;
+          break;
+      }
+
+      for (uint16_t q = 0; q < rows; q++) {
+        const uint8_t *src = bitmap + (q * stride);
+        int32_t        pos = n0 + (q * dj);
+
+        auto value = [&](uint16_t i) -> uint8_t {
+          if constexpr (BPP == 4) {
+            return (i & 1) ? ((src[i >> 1] & 0x0F) >> 1) : (src[i >> 1] >> 5);
+          } else {
+            return src[i] >> 5;
+          }
+        };
+
+        uint16_t i = 0;
+        if ((di == 1) || (di == -1)) {
+          // Nibble pairs sharing a byte: starting at the high nibble going
+          // forward, or at the low nibble going backward.
+          if ((cols > 0) && ((pos & 1) != ((di == 1) ? 0 : 1))) {
+            setNibble(fb.data, pos, value(0));
+            pos += di;
+            i++;
+          }
+          if constexpr (BPP == 4) {
+            if ((i & 1) == 0) {
+              // Source nibble pairs and frame buffer nibble pairs are aligned.
+              for (; (i + 1) < cols; i += 2, pos += 2 * di) {
+                uint8_t s = src[i >> 1];
+                uint8_t a = s >> 5;
+                uint8_t b = (s & 0x0F) >> 1;
+                fb.data[pos >> 1] = (di == 1) ? ((a << 4) | b) : ((b << 4) | a);
+              }
+            }
+          }
+          for (; (i + 1) < cols; i += 2, pos += 2 * di) {
+            uint8_t a = value(i);
+            uint8_t b = value(i + 1);
+            fb.data[pos >> 1] = (di == 1) ? ((a << 4) | b) : ((b << 4) | a);
+          }
+        }
+        for (; i < cols; i++, pos += di) { setNibble(fb.data, pos, value(i)); }
+      }
+    }
+
+    static inline auto setNibble(uint8_t *data, int32_t pos, uint8_t value) -> void {
+      uint8_t *p = data + (pos >> 1);
+      *p = (pos & 1) ? ((*p & 0xF0) | value) : ((*p & 0x0F) | (value << 4));
+    }
+};
@@ -11,11 +11,18 @@
 #include "screen.hpp"
 
 #include "esp.hpp"
+#include "glyph_blitter.hpp"
+#include "picture_blitter.hpp"
 
 #include <iomanip>
 
 #define BYTES_PER_PIXEL 3
 
+static_assert((int)Screen::Orientation::LEFT == (int)GlyphBlitter::Orientation::LEFT &&
+              (int)Screen::Orientation::RIGHT == (int)GlyphBlitter::Orientation::RIGHT &&
+              (int)Screen::Orientation::BOTTOM == (int)GlyphBlitter::Orientation::BOTTOM &&
+              (int)Screen::Orientation::TOP == (int)GlyphBlitter::Orientation::TOP);
+
 Screen        Screen::singleton;
 
 uint16_t      Screen::width;
@@ -36,9 +43,6 @@ const uint8_t Screen::LUT1BIT_INV[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x4
           CODE(resolution, Top);                                                                         \
         }
 
-#define NIBBLE(k, p) (((k & 1) ? (bitmapData[p] & 0x0F) : (bitmapData[p] >> 4)) << 4)
-#define NIBBLE2(k, p) (((k & 1) ? ((bitmapData[p] & 0x0F) >> 1) : (bitmapData[p] >> 5)))
-
 auto Screen::drawPicture(PicturePtr &picture, Pos pos) -> void {
 
   auto dim        = picture->getDim();
@@ -48,98 +52,37 @@ auto Screen::drawPicture(PicturePtr &picture, Pos pos) -> void {
   if (pos.x > width) { pos.x = 0; }
   if (pos.y > height) { pos.y = 0; }
 
-  uint32_t xMax = pos.x + dim.width;
-  uint32_t yMax = pos.y + dim.height;
+  int32_t xMax = pos.x + dim.width;
+  int32_t yMax = pos.y + dim.height;
 
   if (yMax > height) { yMax = height; }
   if (xMax > width) { xMax = width; }
 
-  if (pixelResolution == PixelResolution::ONE_BIT) {
-    static int16_t err[1201]; // This is the maximum width of all Inkplate devices + 1
-    int16_t        error;
-    memset(err, 0, 1201 * 2);
-
-    if (bpp == 4) {
-      uint16_t w = ((dim.width + 1) & 0xFFFE) >> 1; // Round up to even number of pixels
-      // LOG_I("Two last nibbles from the first line: {:#04x} {:#04x}", NIBBLE(0, w-1), NIBBLE(1, w-1));
-      #define CODE(resolution, orientation)                                                                    \
-              for (int j = pos.y, q = 0; j < yMax; j++, q++) {                                                 \
-                for (int i = pos.x, p = q * w, k = 0; i < (xMax - 1); i++, k++) {                              \
-                  int32_t v = NIBBLE(k, p) + err[k + 1];                                                       \
-                  if (v > 128) {                                                                               \
-                    error = (v - 255);                                                                         \
-                    setPixelO ## orientation ## resolution(i, j, 0);                                           \
-                  } else {                                                                                     \
-                    error = v;                                                                                 \
-                    setPixelO ## orientation ## resolution(i, j, 1);                                           \
-                  }                                                                                            \
-                  if (k != 0) {                                                                                \
-                    err[k - 1] += error / 8;                                                                   \
-                  }                                                                                            \
-                  err[k] += 3 * error / 8;                                                                     \
-                  err[k + 1] = error / 8;                                                                      \
-                  err[k + 2] += 3 * error / 8;                                                                 \
-                  if (k & 1) { ++p; }                                                                          \
-                }                                                                                              \
-              }
+  bool bits1 = pixelResolution == PixelResolution::ONE_BIT;
 
-      SELECT(1Bit);
-      #undef CODE
-    }
-    else {
-      #define CODE(resolution, orientation)                                                                    \
-              for (int j = pos.y, q = 0; j < yMax; j++, q++) {                                                 \
-                for (int i = pos.x, p = q * dim.width, k = 0; i < (xMax - 1); i++, p++, k++) {                 \
-                  int32_t v = bitmapData[p] + err[k + 1];                                                      \
-                  if (v > 128) {                                                                               \
-                    error = (v - 255);                                                                         \
-                    setPixelO ## orientation ## resolution(i, j, 0);                                           \
-                  } else {                                                                                     \
-                    error = v;                                                                                 \
-                    setPixelO ## orientation ## resolution(i, j, 1);                                           \
-                  }                                                                                            \
-                  if (k != 0) {                                                                                \
-                    err[k - 1] += error / 8;                                                                   \
-                  }                                                                                            \
-                  err[k] += 3 * error / 8;                                                                     \
-                  err[k + 1] = error / 8;                                                                      \
-                  err[k + 2] += 3 * error / 8;                                                                 \
-                }                                                                                              \
-              }
+  // The last column is not drawn in 1 bit mode, as the error diffusion
+  // would write past the end of the line buffer.
+  int32_t cols = (bits1 ? xMax - 1 : xMax) - pos.x;
+  int32_t rows = yMax - pos.y;
 
-      SELECT(1Bit);
-      #undef CODE
-    }
-  } else {
-    if (bpp == 4) {
-      uint16_t w = ((dim.width + 1) & 0xFFFE) >> 1; // Round up to even number of pixels
-      #define CODE(resolution, orientation)                                                                    \
-              for (int j = pos.y, q = 0; j < yMax; j++, q++) {                                                 \
-                for (int i = pos.x, p = q * w, k = 0; i < xMax; i++, k++) {                                    \
-                  int8_t v = NIBBLE2(k, p);                                                                    \
-                  setPixelO ## orientation ## resolution(i, j, v);                                             \
-                  if (k & 1) { ++p; }                                                                          \
-                }                                                                                              \
-              }
+  if ((pos.x < 0) || (pos.y < 0) || (cols <= 0) || (rows <= 0)) { return; }
 
-      SELECT(3Bit);
-      #undef CODE
-    } else {
-      #define CODE(resolution, orientation)                                                                    \
-              for (int j = pos.y, q = 0; j < yMax; j++, q++) {                                                 \
-                for (int i = pos.x, p = q * dim.width; i < xMax; i++, p++) {                                   \
-                  int8_t v = bitmapData[p] >> 5;                                                               \
-                  setPixelO ## orientation ## resolution(i, j, v);                                             \
-                }                                                                                              \
-              }
-      SELECT(3Bit);
-      #undef CODE
-    }
+  // Rows are dithered and stored 8 pixels at a time instead of setting
+  // the frame buffer pixels one at a time.
+  GlyphBlitter::FrameBuffer fb;
+  if (bits1) {
+    fb = { frameBuffer1Bit->get_data(), (int32_t)frameBuffer1Bit->get_line_size(),
+           (int32_t)frameBuffer1Bit->get_data_size(), yOffset };
+  } else {
+    fb = { frameBuffer3Bit->get_data(), (int32_t)frameBuffer3Bit->get_line_size(),
+           (int32_t)frameBuffer3Bit->get_data_size(), yOffset };
   }
-}
 
-#undef NIBBLE
-#undef NIBBLE2
+  uint16_t stride = (bpp == 4) ? ((dim.width + 1) >> 1) : dim.width;
+
+  PictureBlitter::drawPicture(fb, static_cast<GlyphBlitter::Orientation>(orientation), bits1,
+                              bitmapData, bpp, stride, pos.x, pos.y, cols, rows);
+}
 
 auto Screen::drawRectangle(Dim dim, Pos pos, uint8_t color) -> void {
   uint32_t xMax = pos.x + dim.width;
@@ -450,27 +393,22 @@ auto Screen::drawGlyph(const unsigned char *bitmapData, Dim dim, Pos pos, uint16
   if (yMax > height) { yMax = height; }
   if (xMax > width) { xMax = width; }
 
+  if ((pos.x < 0) || (pos.y < 0) || (xMax <= pos.x) || (yMax <= pos.y)) { return; }
+
+  // Whole bytes of the glyph are ORed into the frame buffer instead of
+  // setting its pixels one at a time.
+  GlyphBlitter::FrameBuffer fb;
   if (pixelResolution == PixelResolution::ONE_BIT) {
-    #define CODE(resolution, orientation)                                                              \
-            for (uint32_t j = pos.y, q = 0; j < yMax; j++, q++) {                                            \
-              for (uint32_t i = pos.x, p = (q * pitch) << 3; i < xMax; i++, p++) {                           \
-                uint8_t v = bitmapData[p >> 3] &LUT1BIT[p & 7];                                             \
-                if (v) setPixelO ## orientation ## resolution(i, j, 1);                                          \
-              }                                                                                              \
-            }
-    SELECT(1Bit);
-    #undef CODE
+    fb = { frameBuffer1Bit->get_data(), (int32_t)frameBuffer1Bit->get_line_size(),
+           (int32_t)frameBuffer1Bit->get_data_size(), yOffset };
   } else {
-    #define CODE(resolution, orientation)                                                              \
-            for (uint32_t j = pos.y, q = 0; j < yMax; j++, q++) {                                            \
-              for (uint32_t i = pos.x, p = q * pitch; i < xMax; i++, p++) {                                  \
-                uint8_t v = 7 - (bitmapData[p] >> 5);                                                        \
-                if (v != 7) setPixelO ## orientation ## resolution(i, j, v);                                     \
-              }                                                                                              \
-            }
-    SELECT(3Bit);
-    #undef CODE
+    fb = { frameBuffer3Bit->get_data(), (int32_t)frameBuffer3Bit->get_line_size(),
+           (int32_t)frameBuffer3Bit->get_data_size(), yOffset };
   }
+
+  GlyphBlitter::drawGlyph(fb, static_cast<GlyphBlitter::Orientation>(orientation),
+                          pixelResolution == PixelResolution::ONE_BIT, bitmapData, pitch, pos.x,
+                          pos.y, xMax - pos.x, yMax - pos.y);
 }
 
 auto Screen::setup(PixelResolution resolution, Orientation orientation) -> void {
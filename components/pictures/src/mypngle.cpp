@@ -117,6 +117,24 @@ struct _pngle_t {
 	pngle_draw_callback_t draw_callback;
 	pngle_done_callback_t done_callback;
 
+	// row output (buffers allocated on the first IDAT data)
+	pngle_row_callback_t row_callback;
+	uint32_t row_out_width; // as requested, 0 for the picture width
+	uint32_t row_out_height;
+	uint8_t *row_mem; // single allocation for all the buffers below
+	uint32_t *row_sums; // box filter sums of the output row being built
+	uint8_t *row_cur; // scanline being received, preceded by bytes_per_pixel zeros
+	uint8_t *row_prev; // previous unfiltered scanline, same layout
+	uint8_t *row_gray; // unfiltered scanline as gray pixels
+	uint8_t *row_out; // output row given to the callback
+	uint8_t *row_palette; // gray of each palette entry, alpha applied
+	size_t row_stride; // bytes of a scanline, without the filter type byte
+	size_t row_pos; // bytes of the current scanline received so far
+	uint32_t row_w; // output size
+	uint32_t row_h;
+	uint32_t row_y; // output row being built
+	uint32_t row_count; // scanlines summed in it
+
 	void *user_data;
 };
 
@@ -161,10 +179,12 @@ void mypngle_reset(pngle_t *pngle)
 	if (pngle->scanline_ringbuf) free(pngle->scanline_ringbuf);
 	if (pngle->palette) free(pngle->palette);
 	if (pngle->trans_palette) free(pngle->trans_palette);
+	if (pngle->row_mem) free(pngle->row_mem);
 #ifndef PNGLE_NO_GAMMA_CORRECTION
 	if (pngle->gamma_table) free(pngle->gamma_table);
 #endif
 
+	pngle->row_mem = NULL;
 	pngle->scanline_ringbuf = NULL;
 	pngle->palette = NULL;
 	pngle->trans_palette = NULL;
@@ -444,9 +464,209 @@ static int setup_gamma_table(pngle_t *pngle, uint32_t png_gamma)
 	return 0;
 }
 
+// ----------------
+// Row output
+// ----------------
+
+// One past the last source index summed in output index o
+static inline uint32_t box_end(uint32_t o, uint32_t n, uint32_t out_n)
+{
+	return (uint32_t)(((uint64_t)(o + 1) * n + out_n - 1) / out_n);
+}
+
+static inline uint8_t over_white(uint32_t pix, uint32_t alpha)
+{
+	return (uint8_t)((alpha * pix + (255 - alpha) * 255) / 255);
+}
+
+static inline uint16_t row_sample(const uint8_t *row, size_t idx, uint8_t depth)
+{
+	switch (depth) {
+	case 16: return (row[idx * 2] << 8) | row[idx * 2 + 1];
+	case 8:  return row[idx];
+	default: {
+		size_t bit = idx * depth;
+		return (row[bit >> 3] >> (8 - depth - (bit & 7))) & ((1U << depth) - 1);
+	}
+	}
+}
+
+static int row_output_init(pngle_t *pngle)
+{
+	if (pngle->hdr.interlace) return PNGLE_ERROR("Row output of an interlaced picture is not supported");
+
+	uint32_t w = pngle->hdr.width;
+	uint32_t h = pngle->hdr.height;
+
+	pngle->row_w = (pngle->row_out_width  == 0 || pngle->row_out_width  > w) ? w : pngle->row_out_width;
+	pngle->row_h = (pngle->row_out_height == 0 || pngle->row_out_height > h) ? h : pngle->row_out_height;
+
+	uint_fast8_t bytes_per_pixel = (pngle->channels * pngle->hdr.depth + 7) / 8;
+	pngle->row_stride = ((size_t)w * pngle->channels * pngle->hdr.depth + 7) / 8;
+
+	size_t line = bytes_per_pixel + pngle->row_stride;
+	size_t size = (size_t)pngle->row_w * sizeof(uint32_t) + 2 * line + w + pngle->row_w + 256;
+
+	if ((pngle->row_mem = (uint8_t *)PNGLE_CALLOC(size, 1, "row buffers")) == NULL) return PNGLE_ERROR("Insufficient memory");
+
+	uint8_t *p = pngle->row_mem;
+	pngle->row_sums    = (uint32_t *)p;                 p += (size_t)pngle->row_w * sizeof(uint32_t);
+	pngle->row_cur     = p + bytes_per_pixel;           p += line;
+	pngle->row_prev    = p + bytes_per_pixel;           p += line;
+	pngle->row_gray    = p;                             p += w;
+	pngle->row_out     = p;                             p += pngle->row_w;
+	pngle->row_palette = p;
+
+	memset(pngle->row_palette, 255, 256);
+	for (size_t i = 0; i < pngle->n_palettes && i < 256; i++) {
+		uint32_t pix = (pngle->palette[i * 3 + 0] + pngle->palette[i * 3 + 1] + pngle->palette[i * 3 + 2]) / 3;
+		uint32_t alpha = i < pngle->n_trans_palettes ? pngle->trans_palette[i] : 255;
+		pngle->row_palette[i] = over_white(pix, alpha);
+	}
+
+	pngle->row_pos = 0;
+	pngle->row_y = 0;
+	pngle->row_count = 0;
+
+	return 0;
+}
+
+static void row_unfilter(pngle_t *pngle)
+{
+	uint8_t *x = pngle->row_cur;
+	const uint8_t *b = pngle->row_prev;
+	size_t n = pngle->row_stride;
+	size_t bpp = (pngle->channels * pngle->hdr.depth + 7) / 8;
+
+	// x[-bpp] and b[-bpp] are the zeros in front of the scanlines
+	switch (pngle->filter_type) {
+	case 1: for (size_t i = 0; i < n; i++) x[i] += x[i - bpp]; break; // Sub
+	case 2: for (size_t i = 0; i < n; i++) x[i] += b[i]; break; // Up
+	case 3: for (size_t i = 0; i < n; i++) x[i] += (x[i - bpp] + b[i]) / 2; break; // Average
+	case 4: for (size_t i = 0; i < n; i++) x[i] += paeth(x[i - bpp], b[i], b[i - bpp]); break; // Paeth
+	default: break; // None
+	}
+}
+
+static void row_to_gray(pngle_t *pngle)
+{
+	const uint8_t *src = pngle->row_cur;
+	uint8_t *dst = pngle->row_gray;
+	uint32_t w = pngle->hdr.width;
+	uint8_t depth = pngle->hdr.depth;
+	uint8_t color_type = pngle->hdr.color_type;
+
+	if (color_type == 3) {
+		for (uint32_t x = 0; x < w; x++) dst[x] = pngle->row_palette[row_sample(src, x, depth)];
+		return;
+	}
+
+	if (depth == 8 && pngle->n_trans_palettes == 0) {
+		switch (color_type) {
+		case 0: memcpy(dst, src, w); return;
+		case 2: for (uint32_t x = 0; x < w; x++, src += 3) dst[x] = (src[0] + src[1] + src[2]) / 3; return;
+		case 4: for (uint32_t x = 0; x < w; x++, src += 2) dst[x] = over_white(src[0], src[1]); return;
+		case 6: for (uint32_t x = 0; x < w; x++, src += 4) dst[x] = over_white((src[0] + src[1] + src[2]) / 3, src[3]); return;
+		}
+	}
+
+	// Other depths, or a tRNS color
+	uint32_t maxval = (1UL << depth) - 1;
+	uint16_t v[4];
+	size_t idx = 0;
+
+	for (uint32_t x = 0; x < w; x++) {
+		for (uint_fast8_t c = 0; c < pngle->channels; c++) v[c] = row_sample(src, idx++, depth);
+
+		uint32_t pix = (color_type & 2) ? (v[0] + v[1] + v[2]) / 3 : v[0];
+		uint32_t alpha = (color_type & 4) ? v[pngle->channels - 1] : is_trans_color(pngle, v, (color_type & 2) ? 3 : 1) ? 0 : maxval;
+
+		dst[x] = over_white((pix * 255 + maxval / 2) / maxval, (alpha * 255 + maxval / 2) / maxval);
+	}
+}
+
+static void row_accumulate(pngle_t *pngle)
+{
+	uint32_t w = pngle->hdr.width;
+	uint32_t out_w = pngle->row_w;
+	const uint8_t *gray = pngle->row_gray;
+	uint32_t *sums = pngle->row_sums;
+
+	if (out_w == w) {
+		for (uint32_t x = 0; x < w; x++) sums[x] += gray[x];
+	} else {
+		uint32_t x = 0;
+		for (uint32_t ox = 0; ox < out_w; ox++) {
+			uint32_t end = box_end(ox, w, out_w);
+			uint32_t sum = 0;
+			for (; x < end; x++) sum += gray[x];
+			sums[ox] += sum;
+		}
+	}
+	pngle->row_count++;
+
+	if (pngle->drawing_y + 1 < box_end(pngle->row_y, pngle->hdr.height, pngle->row_h)) return;
+
+	uint32_t x = 0;
+	for (uint32_t ox = 0; ox < out_w; ox++) {
+		uint32_t end = box_end(ox, w, out_w);
+		uint32_t n = (end - x) * pngle->row_count;
+		pngle->row_out[ox] = (uint8_t)((sums[ox] + n / 2) / n);
+		x = end;
+	}
+
+	pngle->row_callback(pngle, pngle->row_y, pngle->row_out, out_w);
+
+	memset(sums, 0, out_w * sizeof(uint32_t));
+	pngle->row_count = 0;
+	pngle->row_y++;
+}
+
+static int pngle_on_row_data(pngle_t *pngle, const uint8_t *p, int len)
+{
+	const uint8_t *ep = p + len;
+
+	if (pngle->row_mem == NULL && row_output_init(pngle) < 0) return -1;
+
+	while (p < ep) {
+		if (pngle->drawing_y >= pngle->hdr.height) return len; // Do nothing further
+
+		if (pngle->filter_type < 0) {
+			if (*p > 4) {
+				debug_printf("[pngle] Invalid filter type is found; 0x%02x\n", *p);
+				return PNGLE_ERROR("Invalid filter type is found");
+			}
+			pngle->filter_type = (int_fast8_t)*p++; // 0 - 4
+			pngle->row_pos = 0;
+			continue;
+		}
+
+		size_t n = MIN((size_t)(ep - p), pngle->row_stride - pngle->row_pos);
+		memcpy(pngle->row_cur + pngle->row_pos, p, n);
+		p += n;
+		pngle->row_pos += n;
+
+		if (pngle->row_pos == pngle->row_stride) {
+			row_unfilter(pngle);
+			row_to_gray(pngle);
+			row_accumulate(pngle);
+
+			uint8_t *prev = pngle->row_prev;
+			pngle->row_prev = pngle->row_cur;
+			pngle->row_cur = prev;
+
+			pngle->filter_type = -1;
+			pngle->drawing_y++;
+		}
+	}
+
+	return len;
+}
 
 static int pngle_on_data(pngle_t *pngle, const uint8_t *p, int len)
 {
+	if (pngle->row_callback) return pngle_on_row_data(pngle, p, len);
+
 	const uint8_t *ep = p + len;
 
 	uint_fast8_t bytes_per_pixel = (pngle->channels * pngle->hdr.depth + 7) / 8; // 1 if depth <= 8
@@ -893,6 +1113,14 @@ void mypngle_set_done_callback(pngle_t *pngle, pngle_done_callback_t callback)
 	pngle->done_callback = callback;
 }
 
+void mypngle_set_row_callback(pngle_t *pngle, uint32_t w, uint32_t h, pngle_row_callback_t callback)
+{
+	if (!pngle) return ;
+	pngle->row_out_width = w;
+	pngle->row_out_height = h;
+	pngle->row_callback = callback;
+}
+
 void mypngle_set_user_data(pngle_t *pngle, void *user_data)
 {
 	if (!pngle) return ;
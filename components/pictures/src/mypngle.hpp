@@ -37,6 +37,7 @@ typedef void (*pngle_init_callback_t)(pngle_t *pngle, uint32_t w, uint32_t h);
   typedef void (*pngle_draw_callback_t)(pngle_t *pngle, uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint8_t rgba[4]);
 #endif
 typedef void (*pngle_done_callback_t)(pngle_t *pngle);
+typedef void (*pngle_row_callback_t)(pngle_t *pngle, uint32_t y, const uint8_t *row, uint32_t w);
 
 // ----------------
 // Basic interfaces
@@ -54,6 +55,12 @@ void mypngle_set_init_callback(pngle_t *png, pngle_init_callback_t callback);
 void mypngle_set_draw_callback(pngle_t *png, pngle_draw_callback_t callback);
 void mypngle_set_done_callback(pngle_t *png, pngle_done_callback_t callback);
 
+// Row output: replaces the draw callback. Whole scanlines are unfiltered at once,
+// converted to gray (alpha applied over white) and box filtered down to w x h
+// pixels (0 or larger than the picture: picture size). The callback gets each
+// output row once, in order. Non-interlaced pictures only.
+void mypngle_set_row_callback(pngle_t *png, uint32_t w, uint32_t h, pngle_row_callback_t callback);
+
 void mypngle_set_display_gamma(pngle_t *pngle, double display_gamma); // enables gamma correction by specifying display gamma, typically 2.2. No effect when gAMA chunk is missing
 
 void mypngle_set_user_data(pngle_t *pngle, void *user_data);
@@ -25,6 +25,8 @@ class Picture {
   public:
     Picture() = default;
     Picture(Dim d, FileContentPtr b) : dim(d), bitmap(std::move(b)) {}
+    Picture(Dim d, FileContentPtr b, uint32_t size, uint8_t bpp)
+      : dim(d), bitmap(std::move(b)), fileSize(size), bitsPerPixel(bpp) {}
     Picture(Dim d, const uint8_t *b, uint32_t size, uint8_t bpp = 8)
       : dim(d), bitmap(makeUniqueHimem<uint8_t[]>(size)), fileSize(size), bitsPerPixel(bpp) {
       memcpy(bitmap.get(), b, size);
@@ -46,6 +48,9 @@ class Picture {
     static inline auto Make(Dim d, FileContentPtr b) {
       return makeUniqueHimem<Picture>(d, std::move(b));
     }
+    static inline auto Make(Dim d, FileContentPtr b, uint32_t size, uint8_t bpp) {
+      return makeUniqueHimem<Picture>(d, std::move(b), size, bpp);
+    }
     static inline auto Make(Dim d, const uint8_t *b, uint32_t size, uint8_t bpp = 8) {
       return makeUniqueHimem<Picture>(d, b, size, bpp);
     }
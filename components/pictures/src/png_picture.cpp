@@ -40,6 +40,14 @@ static auto onDraw(pngle_t *pngle, uint32_t x, uint32_t y, uint8_t pix, uint8_t
   }
 }
 
+static auto onRow(pngle_t *pngle, uint32_t y, const uint8_t *row, uint32_t w) -> void {
+  auto data = ((PngPicture *)mypngle_get_user_data(pngle))->getPictureData();
+
+  if ((y < data->dim.height) && (w == data->dim.width)) {
+    memcpy(&data->bitmap[y * data->dim.width], row, w);
+  }
+}
+
 PngPicture::PngPicture(const HimemString &filename, Dim max, bool loadBitmap) : Picture() {
   LOG_D("Loading PNG picture file {}", filename);
 
@@ -65,8 +73,6 @@ PngPicture::PngPicture(const HimemString &filename, Dim max, bool loadBitmap) :
 
     mypngle_set_user_data(pngle, this);
 
-    mypngle_set_draw_callback(pngle, onDraw);
-
     #if EPUB_INKPLATE_BUILD
       // load_start_time   = ESP::millis();
       // waiting_msg_shown = false;
@@ -81,9 +87,10 @@ PngPicture::PngPicture(const HimemString &filename, Dim max, bool loadBitmap) :
       if (first) {
         first = false;
 
-        if (size < 24) { break; }
-        uint32_t width  = getIntBigEndian(&work[16]);
-        uint32_t height = getIntBigEndian(&work[20]);
+        if (size < 29) { break; }
+        uint32_t width      = getIntBigEndian(&work[16]);
+        uint32_t height     = getIntBigEndian(&work[20]);
+        bool     interlaced = work[28] != 0;
 
         uint32_t h = height;
         uint32_t w;
@@ -125,6 +132,14 @@ PngPicture::PngPicture(const HimemString &filename, Dim max, bool loadBitmap) :
         if (loadBitmap) {
           if ((bitmap = makeUniqueHimem<uint8_t[]>(w * h)) == nullptr) { break; }
           dim = Dim(w, h);
+
+          // Whole rows, box filtered down to the picture size by the decoder. The
+          // interlaced pictures are drawn one pixel at a time.
+          if (interlaced) {
+            mypngle_set_draw_callback(pngle, onDraw);
+          } else {
+            mypngle_set_row_callback(pngle, w, h, onRow);
+          }
         } else {
           dim = Dim(w, h);
           break;
@@ -0,0 +1,65 @@
+// Copyright (c) 2020 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+// DMA-safe I/O helpers, shared by SimpleDB and SlotStore
+// ---------------------------------------------------------------------------
+#if EPUB_INKPLATE_BUILD
+  #include "esp_heap_caps.h"
+  #include "esp_memory_utils.h"
+  // Cover bitmaps can be 50KB+; allocate a fixed bounce buffer and chunk the I/O
+  // rather than trying to heap_caps_malloc the full record size at once.
+  static constexpr size_t DMA_BOUNCE_SIZE = 4096;
+  static inline auto fread_dma(void *dest, size_t elemSize, size_t count, FILE *f) -> size_t {
+    if (esp_ptr_dma_capable(dest)) { return fread(dest, elemSize, count, f); }
+    void *tmp = heap_caps_malloc(DMA_BOUNCE_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (tmp == nullptr) { return 0; }
+    size_t   remaining = elemSize * count;
+    uint8_t *d       = static_cast<uint8_t *>(dest);
+    while (remaining > 0) {
+      size_t chunk = remaining < DMA_BOUNCE_SIZE ? remaining : DMA_BOUNCE_SIZE;
+      if (fread(tmp, 1, chunk, f) != chunk) {
+        heap_caps_free(tmp);
+        return 0;
+      }
+      std::memcpy(d, tmp, chunk);
+      d += chunk;
+      remaining -= chunk;
+    }
+    heap_caps_free(tmp);
+    return count;
+  }
+  static inline auto fwrite_dma(const void *src, size_t elemSize, size_t count, FILE *f) -> size_t {
+    if (esp_ptr_dma_capable(src)) { return fwrite(src, elemSize, count, f); }
+    void *tmp = heap_caps_malloc(DMA_BOUNCE_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (tmp == nullptr) { return 0; }
+    size_t         remaining = elemSize * count;
+    const uint8_t *s = static_cast<const uint8_t *>(src);
+    while (remaining > 0) {
+      size_t chunk = remaining < DMA_BOUNCE_SIZE ? remaining : DMA_BOUNCE_SIZE;
+      std::memcpy(tmp, s, chunk);
+      if (fwrite(tmp, 1, chunk, f) != chunk) {
+        heap_caps_free(tmp);
+        return 0;
+      }
+      s += chunk;
+      remaining -= chunk;
+    }
+    heap_caps_free(tmp);
+    return count;
+  }
+#else
+  static inline auto fread_dma(void *dest, size_t elemSize, size_t count, FILE *f) -> size_t {
+    return fread(dest, elemSize, count, f);
+  }
+  static inline auto fwrite_dma(const void *src, size_t elemSize, size_t count, FILE *f) -> size_t {
+    return fwrite(src, elemSize, count, f);
+  }
+#endif
@@ -4,130 +4,197 @@
 
 #define __SIMPLE_DB__ 1
 #include "simple_db.hpp"
+#include "dma_io.hpp"
 
+#include "miniz.h"
+
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <inttypes.h>
 #include <iostream>
 #include <sys/stat.h>
+#include <unistd.h>
+
+auto SimpleDB::trailerCrc(const int32_t *offsets, uint32_t count, uint32_t dataEnd) -> uint32_t {
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(offsets),
+                          count * sizeof(int32_t));
+  crc          = mz_crc32(crc, reinterpret_cast<const uint8_t *>(&count), sizeof(count));
+  crc          = mz_crc32(crc, reinterpret_cast<const uint8_t *>(&dataEnd), sizeof(dataEnd));
+  return static_cast<uint32_t>(crc);
+}
+
+auto SimpleDB::readTrailer(uint32_t size) -> bool {
+  if (size < trailerSizeFor(0)) { return false; }
+
+  // Most trailers are read at once with their footer.
+  uint32_t             tail = std::min(size, TAIL_READ);
+  HimemVector<uint8_t> buffer(tail);
+  if (fseek(dbFile, size - tail, SEEK_SET) || (fread(buffer.data(), tail, 1, dbFile) != 1)) {
+    return false;
+  }
+
+  TrailerFooter footer;
+  memcpy(&footer, buffer.data() + tail - sizeof(TrailerFooter), sizeof(TrailerFooter));
+  if ((footer.magic != TRAILER_MAGIC) || (footer.recordCount > MAX_RECORD_COUNT)) { return false; }
+
+  uint32_t theTrailerSize = trailerSizeFor(footer.recordCount);
+  if (((uint64_t)footer.dataEnd + theTrailerSize) != size) { return false; }
 
-// ---------------------------------------------------------------------------
-// DMA-safe I/O helpers
-// ---------------------------------------------------------------------------
-#if EPUB_INKPLATE_BUILD
-  #include "esp_heap_caps.h"
-  #include "esp_memory_utils.h"
-  // Cover bitmaps can be 50KB+; allocate a fixed bounce buffer and chunk the I/O
-  // rather than trying to heap_caps_malloc the full record size at once.
-  static constexpr size_t DMA_BOUNCE_SIZE = 4096;
-  static auto fread_dma(void *dest, size_t elemSize, size_t count, FILE *f) -> size_t {
-    if (esp_ptr_dma_capable(dest)) { return fread(dest, elemSize, count, f); }
-    void *tmp = heap_caps_malloc(DMA_BOUNCE_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-    if (tmp == nullptr) { return 0; }
-    size_t   remaining = elemSize * count;
-    uint8_t *d       = static_cast<uint8_t *>(dest);
-    while (remaining > 0) {
-      size_t chunk = remaining < DMA_BOUNCE_SIZE ? remaining : DMA_BOUNCE_SIZE;
-      if (fread(tmp, 1, chunk, f) != chunk) {
-        heap_caps_free(tmp);
-        return 0;
-      }
-      std::memcpy(d, tmp, chunk);
-      d += chunk;
-      remaining -= chunk;
+  if (theTrailerSize > tail) {
+    buffer.resize(theTrailerSize);
+    if (fseek(dbFile, footer.dataEnd, SEEK_SET) ||
+        (fread(buffer.data(), theTrailerSize, 1, dbFile) != 1)) {
+      return false;
     }
-    heap_caps_free(tmp);
-    return count;
   }
-  static auto fwrite_dma(const void *src, size_t elemSize, size_t count, FILE *f) -> size_t {
-    if (esp_ptr_dma_capable(src)) { return fwrite(src, elemSize, count, f); }
-    void *tmp = heap_caps_malloc(DMA_BOUNCE_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
-    if (tmp == nullptr) { return 0; }
-    size_t         remaining = elemSize * count;
-    const uint8_t *s = static_cast<const uint8_t *>(src);
-    while (remaining > 0) {
-      size_t chunk = remaining < DMA_BOUNCE_SIZE ? remaining : DMA_BOUNCE_SIZE;
-      std::memcpy(tmp, s, chunk);
-      if (fwrite(tmp, 1, chunk, f) != chunk) {
-        heap_caps_free(tmp);
-        return 0;
-      }
-      s += chunk;
-      remaining -= chunk;
+
+  const uint8_t *trailer = buffer.data() + buffer.size() - theTrailerSize;
+  int32_t        marker;
+  memcpy(&marker, trailer, sizeof(int32_t));
+  if (marker != -(int32_t)theTrailerSize) { return false; }
+
+  recordOffset.resize(footer.recordCount);
+  memcpy(recordOffset.data(), trailer + sizeof(int32_t), footer.recordCount * sizeof(int32_t));
+
+  bool ok = (trailerCrc(recordOffset.data(), footer.recordCount, footer.dataEnd) == footer.crc) &&
+            ((footer.recordCount == 0) ? (footer.dataEnd == 0) : (recordOffset[0] == 0));
+  for (uint32_t idx = 0; ok && (idx < footer.recordCount); idx++) {
+    uint32_t next = (idx + 1 < footer.recordCount) ? recordOffset[idx + 1] : footer.dataEnd;
+    ok = (recordOffset[idx] >= 0) && (((uint32_t)recordOffset[idx] + sizeof(int32_t)) <= next);
+  }
+  if (!ok) {
+    LOG_W("Database trailer is corrupted. Records will be scanned.");
+    recordOffset.clear();
+    return false;
+  }
+
+  recordCount    = footer.recordCount;
+  fileSize       = footer.dataEnd;
+  trailerSize    = theTrailerSize;
+  trailerIsValid = true;
+  return true;
+}
+
+auto SimpleDB::scanRecords(uint32_t size) -> bool {
+  if (fseek(dbFile, 0, SEEK_SET)) { return false; }
+
+  uint32_t offset = 0;
+
+  while (offset < size) {
+    int32_t recSize;
+    if (fread(&recSize, sizeof(int32_t), 1, dbFile) != 1) { return false; }
+    // A negative size starts a trailer left behind (stale or partially
+    // written). It is dropped at the next addRecord() or close().
+    if (recSize < 0) { break; }
+    if (recordOffset.size() >= MAX_RECORD_COUNT) {
+      LOG_E("Database has too many records. Only {} retrieved.", MAX_RECORD_COUNT);
+      break;
+    }
+    recordOffset.push_back(offset);
+    offset += recSize + sizeof(int32_t);
+    if (offset < size) {
+      if (fseek(dbFile, offset, SEEK_SET)) { return false; }
     }
-    heap_caps_free(tmp);
-    return count;
   }
-#else
-  static auto fread_dma(void *dest, size_t elemSize, size_t count, FILE *f) -> size_t {
-    return fread(dest, elemSize, count, f);
+
+  recordCount = recordOffset.size();
+  fileSize    = std::min(offset, size);
+  trailerSize = size - fileSize;
+  return true;
+}
+
+auto SimpleDB::writeTrailer() -> bool {
+  if (recordCount == 0) { return removeTrailer(); }
+
+  uint32_t             theTrailerSize = trailerSizeFor(recordCount);
+  HimemVector<uint8_t> buffer(theTrailerSize);
+
+  int32_t       marker = -(int32_t)theTrailerSize;
+  TrailerFooter footer = { recordCount, fileSize,
+                           trailerCrc(recordOffset.data(), recordCount, fileSize), TRAILER_MAGIC };
+
+  memcpy(buffer.data(), &marker, sizeof(int32_t));
+  memcpy(buffer.data() + sizeof(int32_t), recordOffset.data(), recordCount * sizeof(int32_t));
+  memcpy(buffer.data() + theTrailerSize - sizeof(TrailerFooter), &footer, sizeof(TrailerFooter));
+
+  if (fseek(dbFile, fileSize, SEEK_SET) ||
+      (fwrite(buffer.data(), theTrailerSize, 1, dbFile) != 1) || fflush(dbFile)) {
+    LOG_E("Unable to write the database trailer.");
+    return false;
+  }
+  if ((trailerSize > theTrailerSize) && ftruncate(fileno(dbFile), fileSize + theTrailerSize)) {
+    LOG_E("Unable to truncate the database: errno={} ({})", errno, std::strerror(errno));
+    return false;
   }
-  static auto fwrite_dma(const void *src, size_t elemSize, size_t count, FILE *f) -> size_t {
-    return fwrite(src, elemSize, count, f);
+
+  trailerSize    = theTrailerSize;
+  trailerIsValid = true;
+  return true;
+}
+
+auto SimpleDB::removeTrailer() -> bool {
+  if (trailerSize == 0) { return true; }
+
+  if (fflush(dbFile) || ftruncate(fileno(dbFile), fileSize)) {
+    LOG_E("Unable to truncate the database: errno={} ({})", errno, std::strerror(errno));
+    return false;
   }
-#endif
+
+  trailerSize    = 0;
+  trailerIsValid = false;
+  return true;
+}
 
 auto SimpleDB::open(const HimemString &filename) -> bool {
   std::scoped_lock guard(mutex);
   LOG_D("Opening database file: {}", filename);
 
-  if (dbIsOpen) {
-    fclose(dbFile);
-    dbIsOpen = false;
-  }
+  close();
 
   if ((dbFile = fopen(filename.c_str(), "r+")) == nullptr) { return create(filename); }
 
-  bool        done = false;
-
   struct stat stat_buf;
   fstat(fileno(dbFile), &stat_buf);
-  fileSize = stat_buf.st_size;
+  uint32_t size = stat_buf.st_size;
 
-  uint16_t idx    = 0;
-  uint32_t offset = 0;
+  recordOffset.clear();
+  trailerSize    = 0;
+  trailerIsValid = false;
 
-  while ((idx < MAX_RECORD_COUNT) && (offset < fileSize)) {
-    recordOffset[idx] = offset;
-    isDeleted[idx]    = false;
-    uint32_t size;
-    if (fread(&size, sizeof(uint32_t), 1, dbFile) != 1) { goto error; }
-    offset += size + sizeof(uint32_t);
-    if (offset < fileSize) {
-      if (fseek(dbFile, offset, SEEK_SET)) { goto error; } }
-    idx++;
-  }
-  done        = true;
-  recordCount = idx;
-
-error:
-  if (!done) {
+  if (!readTrailer(size) && !scanRecords(size)) {
     fclose(dbFile);
     LOG_E("Database error!!");
     return false;
-  } else {
-    dbIsOpen           = true;
-    someRecordsDeleted = false;
-    currentRecordIdx   = 0;
-    LOG_D("Record count: {}", recordCount);
-    return true;
   }
+
+  isDeleted.assign(recordCount, false);
+
+  dbIsOpen           = true;
+  someRecordsDeleted = false;
+  currentRecordIdx   = 0;
+  LOG_D("Record count: {}{}", recordCount, trailerIsValid ? " (from trailer)" : "");
+  return true;
 }
 
 auto SimpleDB::create(const HimemString &filename) -> bool {
   std::scoped_lock guard(mutex);
   LOG_D("Creating database file: {}", filename);
-  if (dbIsOpen) {
-    fclose(dbFile);
-    dbIsOpen = false;
-  }
+
+  close();
 
   if ((dbFile = fopen(filename.c_str(), "w+")) == nullptr) { return false; }
 
+  recordOffset.clear();
+  isDeleted.clear();
+
   dbIsOpen           = true;
   someRecordsDeleted = false;
   currentRecordIdx   = 0;
   recordCount        = 0;
   fileSize           = 0;
+  trailerSize        = 0;
+  trailerIsValid     = false;
 
   return true;
 }
@@ -136,18 +203,28 @@ auto SimpleDB::close() -> void {
   std::scoped_lock guard(mutex);
   if (dbIsOpen) {
     dbIsOpen = false;
+    if (!trailerIsValid) { writeTrailer(); }
     fclose(dbFile);
   }
 }
 
+auto SimpleDB::sync() -> bool {
+  std::scoped_lock guard(mutex);
+  if (!dbIsOpen) { return false; }
+  return (fflush(dbFile) == 0) && (fsync(fileno(dbFile)) == 0);
+}
+
 auto SimpleDB::addRecord(void *record, int32_t size) -> bool {
   std::scoped_lock guard(mutex);
   LOG_D("Adding record of size {}", size);
 
   if (recordCount >= MAX_RECORD_COUNT) { return false; }
-  if (fseek(dbFile, 0, SEEK_END)) { return false; }
-  recordOffset[recordCount] = ftell(dbFile);
-  isDeleted[recordCount++]  = false;
+  if (!removeTrailer()) { return false; }
+  if (fseek(dbFile, fileSize, SEEK_SET)) { return false; }
+  recordOffset.push_back(fileSize);
+  isDeleted.push_back(false);
+  recordCount++;
+  trailerIsValid = false;
   if (fwrite(&size, sizeof(int32_t), 1, dbFile) != 1) { return false; }
   if ((size != 0) && (fwrite_dma(record, size, 1, dbFile) != 1)) { return false; }
   fflush(dbFile);
@@ -183,10 +260,11 @@ auto SimpleDB::show() -> void {
     std::cout << "===== Database content: ====" << std::endl;
     std::cout << "Record count: " << recordCount << std::endl;
 
-    for (int16_t idx = 0; idx < recordCount; idx++) {
+    for (uint16_t idx = 0; idx < recordCount; idx++) {
+      int32_t end = (idx + 1 < recordCount) ? recordOffset[idx + 1] : (int32_t)fileSize;
       std::cout << idx << ":"
                 << " offset: " << recordOffset[idx]
-                << " size: " << recordOffset[idx + 1] - recordOffset[idx] - sizeof(int32_t)
+                << " size: " << end - recordOffset[idx] - sizeof(int32_t)
                 << (isDeleted[idx] ? " DELETED" : "") << std::endl;
     }
 
@@ -15,20 +15,26 @@
  * A *very* simple, one table database tool. Each record is having a single size that can
  * be different from each other.
  *
- * The tool maintains the location of each record in an array in RAM. No
- * index beyond that. When a database file is open, the tool computes the
- * location of each record. All record in file are considered valid.
+ * The tool maintains the location of each record in a table in RAM (PSRAM
+ * on the device), grown as records are added. No index beyond that. When a
+ * database file is open, the tool retrieves the location of each record.
+ * All record in file are considered valid.
  *
  * A record can be marked as deleted using the setDeleted() method. This
  * will only mark it as deleted in memory. A new database needs to be
  * created and filled with valid records by the application to get rid of
  * marked as deleted records.
  *
- * No memory allocation is done in the tool. This is the responsability
- * of the calling application.
+ * The memory for the records is the responsability of the calling
+ * application.
  *
- * Each record is preceeded with its size in file. Nothing else is kept in file
- * then the data associated with the record.
+ * Each record is preceeded with its size in file. When the database is
+ * closed, a trailer is appended after the last record: the offset of each
+ * record, their count, a CRC and a magic number. The next open() gets the
+ * record locations with a single read at the end of the file instead of a
+ * read and a seek per record. A missing, partial or stale trailer is
+ * ignored and the records are scanned as before. The trailer is cut off the
+ * file before a record is added.
  *
  * (c) 2020, Guy Turcotte
  */
@@ -39,26 +45,50 @@ class SimpleDB {
 private:
   static constexpr char const *TAG = "SimpleDB";
 
-  static const uint16_t MAX_RECORD_COUNT = 2000;
+  static constexpr uint16_t MAX_RECORD_COUNT = UINT16_MAX;
+
+  static constexpr uint32_t TRAILER_MAGIC = 0x58444253; // "SBDX"
+  static constexpr uint32_t TAIL_READ     = 4096;       ///< Read at once to get the trailer
+
+#pragma pack(push, 1)
+  /// End of the trailer. The trailer starts with its size, negated, in place
+  /// of a record size, followed by the record offsets.
+  struct TrailerFooter {
+    uint32_t recordCount;
+    uint32_t dataEnd; ///< Offset of the trailer
+    uint32_t crc;     ///< Of the record offsets, recordCount and dataEnd
+    uint32_t magic;
+  };
+#pragma pack(pop)
 
   FILE *dbFile{nullptr};
   mutable std::recursive_mutex mutex;
 
   bool dbIsOpen;
   bool someRecordsDeleted{false};
-  int32_t recordOffset[MAX_RECORD_COUNT]{}; ///< record offset in file
-  bool isDeleted[MAX_RECORD_COUNT]{};       ///< true if record is deleted
+  HimemVector<int32_t> recordOffset; ///< record offset in file
+  HimemVector<bool> isDeleted;       ///< true if record is deleted
   uint16_t recordCount;
-  uint32_t fileSize{0};
+  uint32_t fileSize{0};      ///< End of the last record
+  uint32_t trailerSize{0};   ///< Bytes in file after the last record
+  bool trailerIsValid{false}; ///< The bytes after the last record are an up to date trailer
   uint16_t currentRecordIdx; ///< Index of current record in recordOffset
 
+  static auto trailerSizeFor(uint32_t count) -> uint32_t {
+    return sizeof(int32_t) + count * sizeof(int32_t) + sizeof(TrailerFooter);
+  }
+
+  static auto trailerCrc(const int32_t *offsets, uint32_t count, uint32_t dataEnd) -> uint32_t;
+  auto readTrailer(uint32_t size) -> bool;
+  auto scanRecords(uint32_t size) -> bool;
+  auto writeTrailer() -> bool;
+  auto removeTrailer() -> bool;
+
 public:
   SimpleDB() : dbIsOpen(false), recordCount(0), currentRecordIdx(0) {};
   SimpleDB(const SimpleDB &)            = delete;
   SimpleDB &operator=(const SimpleDB &) = delete;
-  ~SimpleDB() {
-    if (dbIsOpen) fclose(dbFile);
-  }
+  ~SimpleDB() { close(); }
 
   static inline auto Make() { return makeUniqueHimem<SimpleDB>(); }
 
@@ -87,12 +117,24 @@ public:
    */
   auto create(const HimemString &filename) -> bool;
 
+  /**
+   * @brief Write the trailer if the records changed and close the file.
+   */
   auto close() -> void;
 
+  /**
+   * @brief Write the records added so far to the storage.
+   *
+   * Records survive a reset once this method returned true.
+   */
+  auto sync() -> bool;
+
   [[nodiscard]] inline auto getCurrentIdx() -> uint16_t { return currentRecordIdx; }
   inline auto setCurrentIdx(int16_t index) -> void { currentRecordIdx = index; }
   [[nodiscard]] inline auto getRecordCount() -> uint16_t { return recordCount; }
   [[nodiscard]] inline auto getFileSize() -> uint16_t { return fileSize; }
+  /// For tests: the file ends with a trailer matching the records.
+  [[nodiscard]] inline auto hasValidTrailer() -> bool { return trailerIsValid; }
   [[nodiscard]] inline auto someRecordsWereDeleted() -> bool { return someRecordsDeleted; }
   [[nodiscard]] inline auto isDbOpen() -> bool { return dbIsOpen; }
 
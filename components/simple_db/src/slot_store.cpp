@@ -0,0 +1,114 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "slot_store.hpp"
+#include "dma_io.hpp"
+
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+auto SlotStore::open(const HimemString &filename, uint32_t cap) -> bool {
+  std::scoped_lock guard(mutex);
+  LOG_D("Opening slot store file: {}", filename);
+
+  close();
+
+  if ((file = fopen(filename.c_str(), "r+")) == nullptr) { return false; }
+
+  Header header;
+  if ((fread(&header, sizeof(Header), 1, file) != 1) || (header.magic != MAGIC) ||
+      (header.version != VERSION) || (header.capacity != cap) || (header.slotSize < cap) ||
+      (header.slotSize == 0) || ((header.slotSize % PAGE_SIZE) != 0)) {
+    LOG_D("Not a slot store of capacity {}: {}", cap, filename);
+    close();
+    return false;
+  }
+
+  struct stat statBuf;
+  fstat(fileno(file), &statBuf);
+
+  capacity = header.capacity;
+  slotSize = header.slotSize;
+
+  // A partial last slot (interrupted write) is ignored.
+  uint32_t count = (statBuf.st_size > PAGE_SIZE) ? (statBuf.st_size - PAGE_SIZE) / slotSize : 0;
+  slotCount      = (count > MAX_SLOT_COUNT) ? MAX_SLOT_COUNT : count;
+
+  LOG_D("Slot count: {}", slotCount);
+  return true;
+}
+
+auto SlotStore::create(const HimemString &filename, uint32_t cap) -> bool {
+  std::scoped_lock guard(mutex);
+  LOG_D("Creating slot store file: {}", filename);
+
+  close();
+
+  if ((cap == 0) || ((file = fopen(filename.c_str(), "w+")) == nullptr)) { return false; }
+
+  capacity = cap;
+  slotSize = ((cap + PAGE_SIZE - 1) / PAGE_SIZE) * PAGE_SIZE;
+
+  uint8_t page[PAGE_SIZE];
+  memset(page, 0, PAGE_SIZE);
+
+  Header header = {
+    .magic    = MAGIC,
+    .version  = VERSION,
+    .capacity = capacity,
+    .slotSize = slotSize,
+  };
+  memcpy(page, &header, sizeof(Header));
+
+  if (fwrite(page, PAGE_SIZE, 1, file) != 1) {
+    close();
+    return false;
+  }
+  fflush(file);
+
+  return true;
+}
+
+auto SlotStore::close() -> void {
+  std::scoped_lock guard(mutex);
+  if (file != nullptr) {
+    fclose(file);
+    file = nullptr;
+  }
+  slotCount = 0;
+}
+
+auto SlotStore::sync() -> bool {
+  std::scoped_lock guard(mutex);
+  if (file == nullptr) { return false; }
+  return (fflush(file) == 0) && (fsync(fileno(file)) == 0);
+}
+
+auto SlotStore::addSlot(const void *data, uint32_t size, uint16_t &slot) -> bool {
+  std::scoped_lock guard(mutex);
+
+  if ((file == nullptr) || (size > capacity) || (slotCount >= MAX_SLOT_COUNT)) { return false; }
+  if (fseek(file, slotOffset(slotCount), SEEK_SET)) { return false; }
+  if ((size != 0) && (fwrite_dma(data, size, 1, file) != 1)) { return false; }
+
+  static const uint8_t zeros[PAGE_SIZE] = {};
+  for (uint32_t remaining = slotSize - size; remaining > 0;) {
+    uint32_t chunk = (remaining < PAGE_SIZE) ? remaining : PAGE_SIZE;
+    if (fwrite_dma(zeros, chunk, 1, file) != 1) { return false; }
+    remaining -= chunk;
+  }
+  fflush(file);
+
+  slot = slotCount++;
+  return true;
+}
+
+auto SlotStore::getSlot(uint16_t slot, void *data, uint32_t size) -> bool {
+  std::scoped_lock guard(mutex);
+
+  if ((file == nullptr) || (slot >= slotCount) || (size == 0) || (size > slotSize)) { return false; }
+  if (fseek(file, slotOffset(slot), SEEK_SET)) { return false; }
+  return fread_dma(data, size, 1, file) == 1;
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+#include "global.hpp"
+#include "himem.hpp"
+
+#include <cstdio>
+#include <mutex>
+
+/**
+ * @brief Store of fixed size blobs
+ *
+ * A companion of SimpleDB for large blobs of bounded size, like the cover
+ * bitmaps of the books list. The file is a header page followed by slots of
+ * the same size, each slot starting on a page boundary. A blob is known by
+ * its slot number, kept by the application in a SimpleDB record, and is
+ * read with a single seek and read.
+ *
+ * The capacity (largest blob size) is written in the header: a file is
+ * opened only with the capacity it was created with. Slots are added at
+ * the end of the file. To get rid of unused slots, the application copies
+ * the blobs it keeps into a new store.
+ *
+ * No memory allocation is done in the tool. This is the responsability
+ * of the calling application.
+ */
+
+using SlotStorePtr = HimemUniquePtr<class SlotStore>;
+
+class SlotStore {
+private:
+  static constexpr char const *TAG = "SlotStore";
+
+  static constexpr uint32_t MAGIC   = 0x544F4C53; // "SLOT"
+  static constexpr uint16_t VERSION = 1;
+
+#pragma pack(push, 1)
+  struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint32_t capacity;
+    uint32_t slotSize;
+  };
+#pragma pack(pop)
+
+  FILE *file{nullptr};
+  mutable std::recursive_mutex mutex;
+
+  uint32_t capacity{0};
+  uint32_t slotSize{0};
+  uint16_t slotCount{0};
+
+  [[nodiscard]] inline auto slotOffset(uint16_t slot) const -> long {
+    return PAGE_SIZE + static_cast<long>(slot) * slotSize;
+  }
+
+public:
+  static constexpr uint16_t PAGE_SIZE      = 512; ///< SD card sector size
+  static constexpr uint16_t NO_SLOT        = 0xFFFF;
+  static constexpr uint16_t MAX_SLOT_COUNT = NO_SLOT;
+
+  SlotStore() = default;
+  SlotStore(const SlotStore &)            = delete;
+  SlotStore &operator=(const SlotStore &) = delete;
+  ~SlotStore() { close(); }
+
+  static inline auto Make() { return makeUniqueHimem<SlotStore>(); }
+
+  /**
+   * @brief Open an existing store.
+   *
+   * @param filename
+   * @param cap The largest blob size.
+   * @return false The file doesn't exist, is not a store or was created
+   *         with another capacity. The store is closed.
+   */
+  auto open(const HimemString &filename, uint32_t cap) -> bool;
+
+  /**
+   * @brief Create a new empty store.
+   *
+   * The current store is closed. If a file already exists, it will be overided.
+   *
+   * @param filename
+   * @param cap The largest blob size. Slots are this size rounded up to a page.
+   */
+  auto create(const HimemString &filename, uint32_t cap) -> bool;
+
+  auto close() -> void;
+
+  /// Write the slots added so far to the storage. Same as SimpleDB::sync().
+  auto sync() -> bool;
+
+  [[nodiscard]] inline auto isOpen() const -> bool { return file != nullptr; }
+  [[nodiscard]] inline auto getCapacity() const -> uint32_t { return capacity; }
+  [[nodiscard]] inline auto getSlotSize() const -> uint32_t { return slotSize; }
+  [[nodiscard]] inline auto getSlotCount() const -> uint16_t { return slotCount; }
+
+  /**
+   * @brief Add a blob in a new slot at the end of the file.
+   *
+   * The slot is padded to its full size, keeping the next one page aligned.
+   *
+   * @param data
+   * @param size At most the capacity.
+   * @param slot The slot number of the blob.
+   * @return false Potential file access issue, or the blob is too large.
+   */
+  auto addSlot(const void *data, uint32_t size, uint16_t &slot) -> bool;
+
+  /**
+   * @brief Read the first size bytes of a slot.
+   *
+   * @return false Slot doesn't exist or file access issue.
+   */
+  auto getSlot(uint16_t slot, void *data, uint32_t size) -> bool;
+};
@@ -22,44 +22,134 @@
   #include <iostream>
 #endif
 
-#if EPUB_LINUX_BUILD
-  #include <thread>
-#else
-  #include "freertos/FreeRTOS.h"
-  #include "freertos/task.h"
-#endif
-
 bool         Unzip::alive = false;
 
-static void *zipMem = nullptr;
+// An inflate state is about 43 KB. The ones released by closed readers are
+// kept for the next readers, to not fragment the heap with repeated
+// allocations. One per core is enough, as readers are used by the book
+// viewer and the background tasks. The size of a block is kept in front of
+// it, as miniz does not give it back when freeing.
+static constexpr int    SPARE_INFLATE_MEM_COUNT = 2;
+static constexpr size_t INFLATE_MEM_HEADER      = 16;
+
+static std::mutex spareInflateMemMutex;
+static uint8_t   *spareInflateMem[SPARE_INFLATE_MEM_COUNT] = { nullptr };
 
 static auto myZAlloc(void *opaque, size_t items, size_t size) -> void * {
-  if (zipMem != nullptr) {
-    return zipMem;
-  } else {
-    #if EPUB_INKPLATE_BUILD
-      return zipMem = heap_caps_malloc(items * size, MALLOC_CAP_SPIRAM);
-    #else
-      // const char *TAG = "myZAlloc";
-      // LOG_I("Allocating {} bytes for zlib", items * size);
-      return zipMem = malloc(items * size);
-    #endif
+  size_t bytes = items * size;
+
+  {
+    std::scoped_lock guard(spareInflateMemMutex);
+    for (auto &mem : spareInflateMem) {
+      if ((mem != nullptr) && (*reinterpret_cast<size_t *>(mem) == bytes)) {
+        uint8_t *block = mem;
+        mem            = nullptr;
+        return block + INFLATE_MEM_HEADER;
+      }
+    }
   }
+
+  #if EPUB_INKPLATE_BUILD
+    auto *block = static_cast<uint8_t *>(heap_caps_malloc(bytes + INFLATE_MEM_HEADER, MALLOC_CAP_SPIRAM));
+  #else
+    auto *block = static_cast<uint8_t *>(malloc(bytes + INFLATE_MEM_HEADER));
+  #endif
+  if (block == nullptr) { return nullptr; }
+
+  *reinterpret_cast<size_t *>(block) = bytes;
+  return block + INFLATE_MEM_HEADER;
 }
 
 static void myZFree(void *opaque, void *address) {
-// Do nothing
-  #if 0
-    #if EPUB_INKPLATE_BUILD
-      heap_caps_free(address);
-    #else
-      const char *TAG = "myZFree";
-      LOG_I("Freeing memory for zlib");
-      free(address);
-    #endif
+  if (address == nullptr) { return; }
+
+  uint8_t *block = static_cast<uint8_t *>(address) - INFLATE_MEM_HEADER;
+
+  {
+    std::scoped_lock guard(spareInflateMemMutex);
+    for (auto &mem : spareInflateMem) {
+      if (mem == nullptr) {
+        mem = block;
+        return;
+      }
+    }
+  }
+
+  #if EPUB_INKPLATE_BUILD
+    heap_caps_free(block);
+  #else
+    free(block);
   #endif
 }
 
+/**
+ * @brief Skip the local header of a file in the zip.
+ *
+ * @param file The zip file.
+ * @param startPos The position of the local header, from the central directory.
+ * @param buffer At least 26 bytes of work space.
+ * @return int 0 if the file is positioned at the file data, an error code otherwise.
+ */
+static auto skipLocalHeader(std::ifstream &file, uint32_t startPos, char *buffer) -> int {
+  constexpr char const *TAG = "Unzip";
+
+  // Local header record.
+
+  // local file header signature     4 bytes  (0x04034b50)
+  // version needed to extract       2 bytes   0
+  // general purpose bit flag        2 bytes   2
+  // compression method              2 bytes   4
+  // last mod file time              2 bytes   6
+  // last mod file date              2 bytes   8
+  // crc-32                          4 bytes  10
+  // compressed size                 4 bytes  14
+  // uncompressed size               4 bytes  18
+  // file name length                2 bytes  22
+  // extra field length              2 bytes  24
+
+  // file name (variable size)
+  // extra field (variable size)
+
+  const int LOCAL_HEADER_SIZE = 26;
+
+  auto      seekAbs = [&file](std::streamoff pos) -> bool {
+                        file.clear();
+                        file.seekg(pos, std::ios::beg);
+                        if (!file.good()) {
+                          LOG_E("Error seeking to file data at pos: {}", pos);
+                        }
+                        return file.good();
+                      };
+
+  auto readExact = [&file](void *dst, std::size_t size) -> bool {
+                     if (size == 0) { return true; }
+                     file.read(static_cast<char *>(dst), static_cast<std::streamsize>(size));
+                     if (!file.good()) {
+                       LOG_E("Error reading file data at pos: {}", (int)file.tellg());
+                     }
+                     return file.good();
+                   };
+
+  if (!(seekAbs(startPos) && readExact(buffer, 4))) { return 13; }
+
+  if (!((buffer[0] == 'P') && (buffer[1] == 'K') && (buffer[2] == 3) && (buffer[3] == 4))) {
+    return 15;
+  }
+  if (!readExact(buffer, LOCAL_HEADER_SIZE)) { return 16; }
+
+  uint16_t filename_size = ((uint16_t)(uint8_t)buffer[22]) | (((uint16_t)(uint8_t)buffer[23]) << 8);
+  uint16_t extra_size    = ((uint16_t)(uint8_t)buffer[24]) | (((uint16_t)(uint8_t)buffer[25]) << 8);
+
+  std::streamoff headerEndPos = static_cast<std::streamoff>(file.tellg());
+  if (headerEndPos < 0) { return 18; }
+
+  std::streamoff dataPos = headerEndPos + static_cast<std::streamoff>(filename_size) +
+                           static_cast<std::streamoff>(extra_size);
+  if (!seekAbs(dataPos)) { return 17; }
+
+  return 0;
+}
+
 /**
  * @brief Seeks to the central directory of a ZIP file.
  *
@@ -175,10 +265,10 @@ auto Unzip::seekToCentralDirectory() -> bool {
  *
  * @note
  * - Allocates memory dynamically for each filename and FileEntry object
- * - Stores entries in a front-insertion container (push_front)
+ * - Stores entries in an append-only list, then builds the filename hash index
  * - Logs errors if the central directory cannot be completely read
  *
- * @see FileEntry, getUint16(), getUint32()
+ * @see FileEntry, getUint16(), getUint32(), buildFileIndex()
  */
 auto Unzip::readFileEntries(uint32_t offset, uint16_t count) -> bool {
 
@@ -281,11 +371,73 @@ auto Unzip::readFileEntries(uint32_t offset, uint16_t count) -> bool {
   }
   if (!completed) {
     LOG_E("Unable to read central directory.");
+  } else {
+    completed = buildFileIndex();
   }
 
   return completed;
 }
 
+/**
+ * @brief Builds the filename lookup index over the central directory entries.
+ *
+ * The index is an open-addressing table (linear probing) whose size is the
+ * smallest power of two holding at least twice the entry count. Every slot
+ * stores the FNV-1a hash of the filename so that most probes are rejected
+ * without a string comparison.
+ *
+ * @return true if the index was built, false if memory was not available.
+ */
+auto Unzip::buildFileIndex() -> bool {
+  uint32_t tableSize = 16;
+  while (tableSize < (filenameEntryCount << 1)) { tableSize <<= 1; }
+
+  fileIndex.clear();
+  fileIndex.resize(tableSize);
+  if (fileIndex.size() != tableSize) {
+    LOG_E("Unable to allocate zip file index ({} slots).", tableSize);
+    return false;
+  }
+  fileIndexMask = tableSize - 1;
+
+  for (auto &fe : fileEntries) {
+    uint32_t hash = fnvHash(fe.filename.data(), fe.filename.size());
+    uint32_t idx  = hash & fileIndexMask;
+    while (fileIndex[idx].entry != nullptr) {
+      idx = (idx + 1) & fileIndexMask;
+    }
+    fileIndex[idx].hash  = hash;
+    fileIndex[idx].entry = &fe;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Retrieves the central directory entry of a file.
+ *
+ * @param filename The cleaned up filename (as returned by cleanFname()).
+ * @return FileEntry * The entry or nullptr if not present in the zip file.
+ */
+auto Unzip::findFileEntry(const char *filename) -> FileEntry * {
+  if (fileIndex.empty()) { return nullptr; }
+
+  size_t   len  = strlen(filename);
+  uint32_t hash = fnvHash(filename, len);
+  uint32_t idx  = hash & fileIndexMask;
+
+  while (fileIndex[idx].entry != nullptr) {
+    if ((fileIndex[idx].hash == hash) &&
+        (fileIndex[idx].entry->filename.size() == len) &&
+        (memcmp(fileIndex[idx].entry->filename.data(), filename, len) == 0)) {
+      return fileIndex[idx].entry;
+    }
+    idx = (idx + 1) & fileIndexMask;
+  }
+
+  return nullptr;
+}
+
 auto Unzip::openZipFile(const char *zipFilename) -> bool {
   std::scoped_lock guard(mutex);
 
@@ -347,13 +499,11 @@ auto Unzip::openZipFile(const char *zipFilename) -> bool {
 }
 
 auto Unzip::closeZipFileUnsafe() -> void {
-  // 1. Clean up any active stream session that might still be open
-  if (activeSession != nullptr) {
-    if (activeSession->streamInflateInitialized) {
-      mz_inflateEnd(&activeSession->zstr);
-    }
-    activeSession.reset(); // Free the memory allocated for the session
-  }
+  // 1. Clean up the stream that might still be open (the caller holds the
+  //    stream mutex)
+  #if !STB
+    activeReader.reset();
+  #endif
 
   // Clear out lock ownership if held
   if (streamLock.owns_lock()) {
@@ -368,6 +518,8 @@ auto Unzip::closeZipFileUnsafe() -> void {
       // LOG_I("Closing ZIP: entries={} filenameBytes={}", filenameEntryCount, totalFilenameBytes);
     }
 
+    HimemVector<IndexSlot>().swap(fileIndex);
+    fileIndexMask = 0;
     fileEntries.clear();
     PoolContext<FilenamePoolTag>::reset();
     filenamePool.reset();
@@ -383,11 +535,9 @@ auto Unzip::closeZipFileUnsafe() -> void {
   }
 
   // 3. Reset internal state iterators and cache names
-  currentFileEntry = fileEntries.end();
+  currentFileEntry = nullptr;
   currentFilename.clear();
 
-  // NOTE: All old streamOwnerThread, streamMutexHeld, and aborted assignments
-  // are completely removed since they are now handled by activeSession or the mutex!
 }
 
 /**
@@ -435,16 +585,11 @@ auto Unzip::getFileSize(const char *filename) -> int32_t {
   }
 
   auto theFilename = cleanFname(filename);
-  currentFileEntry = fileEntries.begin();
-
-  while (currentFileEntry != fileEntries.end()) {
-    if (currentFileEntry->filename == theFilename.get()) { break; }
-    ++currentFileEntry;
-  }
+  currentFileEntry = findFileEntry(theFilename.get());
 
   int32_t size = 0;
 
-  if (currentFileEntry == fileEntries.end()) {
+  if (currentFileEntry == nullptr) {
     LOG_E("Unzip getFileSize: File not found: {}", theFilename.get());
     #if DEBUGGING
       std::cout << "---- Files available: ----" << std::endl;
@@ -462,24 +607,18 @@ auto Unzip::fileExists(const char *filename) -> bool {
   std::scoped_lock guard(mutex); // Safe reentrant protection
   if (!zipFileIsOpen) { return false; }
 
-  auto                         theFilename = cleanFname(filename);
-  Unzip::FileEntries::iterator fe = fileEntries.begin();
-
-  while (fe != fileEntries.end()) {
-    if (fe->filename == theFilename.get()) { break; }
-    ++fe;
-  }
-  return fe != fileEntries.end();
+  auto theFilename = cleanFname(filename);
+  return findFileEntry(theFilename.get()) != nullptr;
 }
 
 auto Unzip::closeZipFile() -> void {
-  std::scoped_lock guard(mutex); // Automatically avoids deadlocks on thread deletion hooks
+  // Waits for a stream opened by another thread to be closed.
+  std::scoped_lock guard(streamMutex, mutex);
   closeZipFileUnsafe();
 }
 
 auto Unzip::openFile(const char *filename) -> bool {
-
-  int err = 0;
+  std::scoped_lock guard(mutex);
 
   if (!zipFileIsOpen) {
     LOG_E("Zip file is not open.");
@@ -491,14 +630,9 @@ auto Unzip::openFile(const char *filename) -> bool {
   }
 
   auto theFilename = cleanFname(filename);
-  currentFileEntry = fileEntries.begin();
-
-  while (currentFileEntry != fileEntries.end()) {
-    if (currentFileEntry->filename == theFilename.get()) { break; }
-    ++currentFileEntry;
-  }
+  currentFileEntry = findFileEntry(theFilename.get());
 
-  if (currentFileEntry == fileEntries.end()) {
+  if (currentFileEntry == nullptr) {
     LOG_E("Unzip Get: File not found: {}", theFilename.get());
     #if DEBUGGING
       std::cout << "---- Files available: ----" << std::endl;
@@ -511,73 +645,9 @@ auto Unzip::openFile(const char *filename) -> bool {
   //   LOG_D("File: {} at pos: {}", (*fe)->filename, (*fe)->startPos);
   // }
 
-  bool completed = false;
-
-  // Local header record.
-
-  // local file header signature     4 bytes  (0x04034b50)
-  // version needed to extract       2 bytes   0
-  // general purpose bit flag        2 bytes   2
-  // compression method              2 bytes   4
-  // last mod file time              2 bytes   6
-  // last mod file date              2 bytes   8
-  // crc-32                          4 bytes  10
-  // compressed size                 4 bytes  14
-  // uncompressed size               4 bytes  18
-  // file name length                2 bytes  22
-  // extra field length              2 bytes  24
-
-  // file name (variable size)
-  // extra field (variable size)
-
-  const int LOCAL_HEADER_SIZE = 26;
+  int err = skipLocalHeader(file, currentFileEntry->startPos, buffer);
 
-  auto      seekAbs = [this](std::streamoff pos) -> bool {
-                        file.clear();
-                        file.seekg(pos, std::ios::beg);
-                        if (!file.good()) {
-                          LOG_E("Error seeking to file data at pos: {}", pos);
-                        }
-                        return file.good();
-                      };
-
-  auto readExact = [this](void *dst, std::size_t size) -> bool {
-                     if (size == 0) { return true; }
-                     file.read(static_cast<char *>(dst), static_cast<std::streamsize>(size));
-                     if (!file.good()) {
-                       LOG_E("Error reading file data at pos: {}", (int)file.tellg());
-                     }
-                     return file.good();
-                   };
-
-  if (seekAbs(currentFileEntry->startPos) && readExact(buffer, 4)) {
-
-    if (!((buffer[0] == 'P') && (buffer[1] == 'K') && (buffer[2] == 3) && (buffer[3] == 4))) {
-      err = 15;
-    } else if (!readExact(buffer, LOCAL_HEADER_SIZE)) {
-      err = 16;
-    } else {
-      uint16_t       filename_size = getUint16((const unsigned char *)&buffer[22]);
-      uint16_t       extra_size    = getUint16((const unsigned char *)&buffer[24]);
-
-      std::streamoff headerEndPos = static_cast<std::streamoff>(file.tellg());
-      if (headerEndPos < 0) {
-        err = 18;
-      } else {
-        std::streamoff dataPos = headerEndPos + static_cast<std::streamoff>(filename_size) +
-                                 static_cast<std::streamoff>(extra_size);
-        if (!seekAbs(dataPos)) {
-          err = 17;
-        } else {
-          completed = true;
-        }
-      }
-    }
-  } else {
-    err = 13;
-  }
-
-  if (completed) {
+  if (err == 0) {
     currentFileEntry->currentPos = 0;
     return true;
   } else {
@@ -590,207 +660,221 @@ auto Unzip::closeFile() -> void {}
 
 #if !STB
 
-  auto Unzip::openStreamFile(const char *filename, uint32_t &fileSize) -> bool {
-    // 1. Acquire the lock safely using a standard transparent retry loop
-    std::unique_lock<std::recursive_mutex> localLock(mutex, std::defer_lock);
-    while (true) {
-      if (localLock.try_lock()) {
-        break;
+  Unzip::Reader::~Reader() {
+    if (session.streamInflateInitialized) {
+      mz_inflateEnd(&session.zstr);
+    }
+  }
+
+  auto Unzip::openReader(const char *filename, uint32_t &fileSize) -> ReaderPtr {
+    uint32_t    startPos, compressedSize;
+    ReaderPtr   reader = std::make_unique<Reader>();
+    std::string zipFilename;
+
+    {
+      std::scoped_lock guard(mutex);
+
+      if (!zipFileIsOpen) {
+        LOG_E("Zip file is not open.");
+        return nullptr;
       }
-      #if EPUB_LINUX_BUILD
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-      #else
-        vTaskDelay(pdMS_TO_TICKS(2));
-      #endif
+
+      auto       theFilename = cleanFname(filename);
+      FileEntry *fe          = findFileEntry(theFilename.get());
+
+      if (fe == nullptr) {
+        LOG_E("Unzip Get: File not found: {}", theFilename.get());
+        return nullptr;
+      }
+
+      startPos       = fe->startPos;
+      compressedSize = fe->compressedSize;
+      reader->size   = fe->size;
+      reader->method = fe->method;
+      zipFilename    = currentFilename;
     }
 
-    // 2. Enforce stream exclusivity
-    if (activeSession != nullptr) {
-      LOG_E("openStreamFile called while a stream is already open.");
-      return false; // localLock goes out of scope and unlocks automatically!
+    if ((reader->buffer = makeUniqueHimem<char[]>(BUFFER_SIZE)) == nullptr) {
+      LOG_E("Unable to allocate a zip reader buffer.");
+      return nullptr;
     }
 
-    if (!openFile(filename)) {
-      return false; // localLock goes out of scope and unlocks automatically!
+    reader->file.open(zipFilename, std::ios::binary);
+    if (!reader->file.is_open()) {
+      LOG_E("openReader: Unable to open file: {}", zipFilename);
+      return nullptr;
     }
 
-    // 3. Move the ownership of the active lock to our class variable
-    streamLock = std::move(localLock);
+    int err;
+    if ((err = skipLocalHeader(reader->file, startPos, reader->buffer.get())) != 0) {
+      LOG_E("Unzip openReader: Error!: {}", err);
+      return nullptr;
+    }
+
+    StreamSession &session = reader->session;
 
-    // 4. Set up the active session
-    activeSession = std::make_unique<StreamSession>();
-    activeSession->repeat  = currentFileEntry->compressedSize / BUFFER_SIZE;
-    activeSession->remains = currentFileEntry->compressedSize % BUFFER_SIZE;
-    activeSession->current = 0;
-    activeSession->aborted = false;
-
-    activeSession->zstr.zalloc    = myZAlloc;
-    activeSession->zstr.zfree     = myZFree;
-    activeSession->zstr.opaque    = nullptr;
-    activeSession->zstr.next_in   = nullptr;
-    activeSession->zstr.next_out  = nullptr;
-    activeSession->zstr.avail_in  = 0;
-    activeSession->zstr.avail_out = 0;
+    session.repeat  = compressedSize / BUFFER_SIZE;
+    session.remains = compressedSize % BUFFER_SIZE;
+    session.current = 0;
+    session.aborted = false;
+
+    session.zstr.zalloc    = myZAlloc;
+    session.zstr.zfree     = myZFree;
+    session.zstr.opaque    = nullptr;
+    session.zstr.next_in   = nullptr;
+    session.zstr.next_out  = nullptr;
+    session.zstr.avail_in  = 0;
+    session.zstr.avail_out = 0;
 
     int zret;
-    if ((zret = mz_inflateInit2(&activeSession->zstr, -15)) != MZ_OK) {
+    if ((zret = mz_inflateInit2(&session.zstr, -15)) != MZ_OK) {
       LOG_E("Error initializing zlib inflate: {}", zret);
-      activeSession.reset();
-      streamLock.unlock(); // Safely drop the saved class lock
-      return false;
+      return nullptr;
     }
-    activeSession->streamInflateInitialized = true;
-    fileSize = currentFileEntry->size;
+    session.streamInflateInitialized = true;
 
-    auto readExact = [this](void *dst, std::size_t size) -> bool {
-                       if (size == 0) { return true; }
-                       file.read(static_cast<char *>(dst), static_cast<std::streamsize>(size));
-                       return file.good();
-                     };
-
-    uint16_t size = activeSession->current < activeSession->repeat ? BUFFER_SIZE : activeSession->remains;
-    if (!readExact(buffer, size)) {
+    if (!reader->readNextBlock()) {
       LOG_E("Error reading zip content.");
-      mz_inflateEnd(&activeSession->zstr);
-      activeSession.reset();
-      streamLock.unlock(); // Safely drop the saved class lock
-      return false;
+      return nullptr;
     }
 
-    ++activeSession->current;
-    activeSession->zstr.avail_in = size;
-    activeSession->zstr.next_in  = (unsigned char *)buffer;
-
-    return true;
+    fileSize = reader->size;
+    return reader;
   }
 
-  auto Unzip::closeStreamFile() -> void {
-    if (activeSession == nullptr) { return; }
-
-    if (activeSession->streamInflateInitialized) {
-      mz_inflateEnd(&activeSession->zstr);
+  auto Unzip::Reader::readNextBlock() -> bool {
+    uint16_t blockSize = session.current < session.repeat ? BUFFER_SIZE : session.remains;
+    if (blockSize > 0) {
+      file.read(buffer.get(), static_cast<std::streamsize>(blockSize));
+      if (!file.good()) { return false; }
     }
 
-    closeFile();
-    activeSession.reset();
-
-    // 5. Explicitly release the lock context safely via RAII out of scope rules
-    if (streamLock.owns_lock()) {
-      streamLock.unlock();
-    }
+    ++session.current;
+    session.zstr.avail_in = blockSize;
+    session.zstr.next_in  = (unsigned char *)buffer.get();
+    return true;
   }
 
+  auto Unzip::Reader::read(char *data, uint32_t dataSize) -> uint32_t {
+    if (dataSize == 0) { return 0; }
 
-  auto Unzip::streamSkip(uint32_t byteCount) -> bool {
-    auto     tmp      = makeUniqueHimem<char[]>(byteCount);
-    uint32_t size = byteCount;
+    session.zstr.next_out  = (unsigned char *)data;
+    session.zstr.avail_out = dataSize;
 
-    do {
-      uint32_t s = size;
-      if ((s = getStreamData(tmp.get(), s)) == 0) {
-        return false;
-      }
-      size -= s;
-    } while (size > 0);
-    return true;
-  }
+    if (method == 0) {
+      while (!session.aborted && (session.zstr.avail_out > 0)) {
+        uint16_t copy_size = session.zstr.avail_in <= session.zstr.avail_out ? session.zstr.avail_in : session.zstr.avail_out;
+        memcpy(session.zstr.next_out, session.zstr.next_in, copy_size);
 
-  auto Unzip::getStreamData(char *data, uint32_t dataSize) -> uint32_t {
-    if (dataSize == 0) { return 0; }
-    if (activeSession == nullptr || !file.is_open()) {
-      LOG_E("Unzip getStreamData called outside stream session.");
-      return 0;
-    }
+        session.zstr.next_out += copy_size;
+        session.zstr.next_in += copy_size;
+        session.zstr.avail_out -= copy_size;
+        session.zstr.avail_in -= copy_size;
 
-    auto readExact = [this](void *dst, std::size_t size) -> bool {
-                       if (size == 0) { return true; }
-                       file.read(static_cast<char *>(dst), static_cast<std::streamsize>(size));
-                       return file.good();
-                     };
-
-    activeSession->zstr.next_out  = (unsigned char *)data;
-    activeSession->zstr.avail_out = dataSize;
-
-    if (currentFileEntry->method == 0) {
-      while (!activeSession->aborted && (activeSession->zstr.avail_out > 0)) {
-        uint16_t copy_size = activeSession->zstr.avail_in <= activeSession->zstr.avail_out ? activeSession->zstr.avail_in : activeSession->zstr.avail_out;
-        memcpy(activeSession->zstr.next_out, activeSession->zstr.next_in, copy_size);
-
-        activeSession->zstr.next_out += copy_size;
-        activeSession->zstr.next_in += copy_size;
-        activeSession->zstr.avail_out -= copy_size;
-        activeSession->zstr.avail_in -= copy_size;
-
-        if (activeSession->zstr.avail_in == 0) {
-          if (activeSession->current > activeSession->repeat) { break; }
-          uint16_t size = activeSession->current < activeSession->repeat ? BUFFER_SIZE : activeSession->remains;
-          if (!readExact(buffer, size)) {
+        if (session.zstr.avail_in == 0) {
+          if (session.current > session.repeat) { break; }
+          if (!readNextBlock()) {
             LOG_E("Error reading zip content.");
-            activeSession->aborted = true;
+            session.aborted = true;
             break;
           }
-          ++activeSession->current;
-          activeSession->zstr.avail_in = size;
-          activeSession->zstr.next_in  = (unsigned char *)buffer;
         }
       }
-    } else if (currentFileEntry->method == 8) {
-      while (!activeSession->aborted && (activeSession->zstr.avail_out == dataSize)) {
-        int zret = mz_inflate(&activeSession->zstr, MZ_NO_FLUSH);
+    } else if (method == 8) {
+      while (!session.aborted && (session.zstr.avail_out == dataSize)) {
+        int zret = mz_inflate(&session.zstr, MZ_NO_FLUSH);
         if (zret < 0) {
           LOG_E("Error inflating data: {}", zret);
-          activeSession->aborted = true;
+          session.aborted = true;
         }
 
-        if (!activeSession->aborted && (activeSession->zstr.avail_out != 0)) {
-          if ((activeSession->zstr.avail_in == 0) && (activeSession->current <= activeSession->repeat)) {
-            uint16_t size = activeSession->current < activeSession->repeat ? BUFFER_SIZE : activeSession->remains;
-            if (!readExact(buffer, size)) {
+        if (!session.aborted && (session.zstr.avail_out != 0)) {
+          if ((session.zstr.avail_in == 0) && (session.current <= session.repeat)) {
+            if (!readNextBlock()) {
               LOG_E("Error reading zip content.");
-              activeSession->aborted = true;
-            } else {
-              ++activeSession->current;
-              activeSession->zstr.avail_in = size;
-              activeSession->zstr.next_in  = (unsigned char *)buffer;
+              session.aborted = true;
             }
           }
         }
       }
     }
 
-    return !activeSession->aborted ? dataSize - activeSession->zstr.avail_out : 0;
+    return !session.aborted ? dataSize - session.zstr.avail_out : 0;
   }
 
-  auto Unzip::getFile(const char *filename, uint32_t &fileSize) -> FileContentPtr {
-    // 1. Transparent Retry Loop
-    // Loop indefinitely (or you can add a counter if you want a safety timeout)
-    while (true) {
-      if (mutex.try_lock()) {
-        break; // Successfully acquired the lock! Exit the retry loop.
+  auto Unzip::Reader::skip(uint32_t byteCount) -> bool {
+    auto     tmp  = makeUniqueHimem<char[]>(byteCount);
+    uint32_t size = byteCount;
+
+    do {
+      uint32_t s = size;
+      if ((s = read(tmp.get(), s)) == 0) {
+        return false;
       }
+      size -= s;
+    } while (size > 0);
+    return true;
+  }
+
+  auto Unzip::openStreamFile(const char *filename, uint32_t &fileSize) -> bool {
+    // Only one stream at a time through this interface: wait for a stream
+    // opened by another thread to be closed.
+    std::unique_lock<std::recursive_mutex> localLock(streamMutex);
 
-      // If we couldn't get the lock, the other thread is busy.
-      // Yield or sleep briefly to let the other thread finish its chunk.
-      #if EPUB_LINUX_BUILD
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-      #else
-        // FreeRTOS equivalent: delay for 2 ticks (usually 2ms depending on configTICK_RATE_HZ)
-        vTaskDelay(pdMS_TO_TICKS(2));
-      #endif
+    if (activeReader != nullptr) {
+      LOG_E("openStreamFile called while a stream is already open.");
+      return false; // localLock goes out of scope and unlocks automatically!
     }
 
-    // 2. Resource Protection Guarantee
-    // Wrap the manually acquired mutex in a lock_guard with std::adopt_lock.
-    // This guarantees that if this function exits early (due to errors or memory issues),
-    // the mutex is automatically unlocked via RAII.
-    std::lock_guard<std::recursive_mutex> lock(mutex, std::adopt_lock);
+    if ((activeReader = openReader(filename, fileSize)) == nullptr) {
+      return false;
+    }
 
-    // 3. Original Data Retrieval Logic (Now fully safe)
+    // The lock is kept until closeStreamFile()
+    streamLock = std::move(localLock);
+
+    return true;
+  }
+
+  auto Unzip::closeStreamFile() -> void {
+    if (activeReader == nullptr) { return; }
+
+    activeReader.reset();
+
+    // Explicitly release the lock context safely via RAII out of scope rules
+    if (streamLock.owns_lock()) {
+      streamLock.unlock();
+    }
+  }
+
+  auto Unzip::streamSkip(uint32_t byteCount) -> bool {
+    if (activeReader == nullptr) {
+      LOG_E("Unzip streamSkip called outside stream session.");
+      return false;
+    }
+    return activeReader->skip(byteCount);
+  }
+
+  auto Unzip::getStreamData(char *data, uint32_t dataSize) -> uint32_t {
+    if (dataSize == 0) { return 0; }
+    if (activeReader == nullptr) {
+      LOG_E("Unzip getStreamData called outside stream session.");
+      return 0;
+    }
+
+    return activeReader->read(data, dataSize);
+  }
+
+  auto Unzip::getFile(const char *filename, uint32_t &fileSize) -> FileContentPtr {
+    // A reader of its own: files retrieved by separate threads (the book
+    // viewer and the background tasks) are decompressed in parallel.
     uint32_t       total = 0;
     bool           completed = false;
     FileContentPtr data{ nullptr };
 
-    if (!openStreamFile(filename, fileSize)) {
+    ReaderPtr reader = openReader(filename, fileSize);
+
+    if (reader == nullptr) {
       LOG_E("Unable to retrieve file {}", filename);
     } else {
       if ((data = makeUniqueHimem<uint8_t[]>(fileSize + 1)) == nullptr) {
@@ -801,7 +885,7 @@ auto Unzip::closeFile() -> void {}
         uint8_t *data_ptr = data.get();
         uint32_t size     = fileSize;
 
-        while (((size = getStreamData((char *)data_ptr, size)) != 0) &&
+        while (((size = reader->read((char *)data_ptr, size)) != 0) &&
                ((total + size) <= fileSize)) {
 
           data_ptr += size;
@@ -812,7 +896,6 @@ auto Unzip::closeFile() -> void {}
         }
         completed = true;
       }
-      closeStreamFile(); // This internally resets activeSession but leaves our global mutex locked
     }
 
     if (!completed) {
@@ -823,8 +906,6 @@ auto Unzip::closeFile() -> void {}
     }
 
     return data;
-    // 'lock' goes out of scope here -> mutex is safely and automatically unlocked!
   }
 
-
-#endif
\ No newline at end of file
+#endif
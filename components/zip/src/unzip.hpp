@@ -29,6 +29,42 @@ class Unzip {
       mz_stream zstr{};
     };
 
+    #if !STB
+      /**
+       * @brief An independent reader of a file in the zip
+       *
+       * Each reader has its own file handle, inflate state and buffer, so
+       * readers used by separate threads decompress in parallel. The central
+       * directory is only consulted by openReader(): a reader stays usable
+       * after closeZipFile().
+       */
+      class Reader {
+        public:
+          Reader() = default;
+          ~Reader();
+          Reader(const Reader &)                     = delete;
+          auto operator=(const Reader &) -> Reader & = delete;
+
+          /// Same as getStreamData(), for this reader.
+          auto read(char *data, uint32_t dataSize) -> uint32_t;
+          auto skip(uint32_t byteCount) -> bool;
+
+          [[nodiscard]] inline auto getSize() const -> uint32_t { return size; }
+
+        private:
+          friend class Unzip;
+
+          std::ifstream file{};
+          HimemUniquePtr<char[]> buffer{ nullptr };
+          StreamSession session{};
+          uint32_t size{ 0 };
+          uint16_t method{ 0 };
+
+          auto readNextBlock() -> bool;
+      };
+      using ReaderPtr = std::unique_ptr<Reader>;
+    #endif
+
   private:
     static constexpr char const *TAG = "Unzip";
 
@@ -40,7 +76,8 @@ class Unzip {
     char buffer[BUFFER_SIZE]; // DMA Target for SPI/SD reads
 
     // Using recursive_mutex handles reentrancy automatically and safely
-    std::recursive_mutex mutex;
+    std::recursive_mutex mutex;       ///< Guards the central directory
+    std::recursive_mutex streamMutex; ///< Held by the thread using the openStreamFile() stream
 
     class FileEntry {
       public:
@@ -56,7 +93,18 @@ class Unzip {
 
     using FileEntries = HimemSimpleList<FileEntry>;
     FileEntries fileEntries{};
-    FileEntries::iterator currentFileEntry{};
+    FileEntry *currentFileEntry{ nullptr };
+
+    // Open-addressing index over fileEntries, built once by readFileEntries().
+    // Each slot keeps the filename FNV-1a hash and a pointer to its entry
+    // (SimpleList nodes never move). The table size is a power of two at
+    // least twice the entry count, so linear probing stays short.
+    struct IndexSlot {
+      uint32_t hash{ 0 };
+      FileEntry *entry{ nullptr };
+    };
+    HimemVector<IndexSlot> fileIndex{};
+    uint32_t fileIndexMask{ 0 };
     CharPoolPtr filenamePool{};
     uint32_t filenameEntryCount{ 0 };
     uint32_t totalFilenameBytes{ 0 };
@@ -73,12 +121,16 @@ class Unzip {
     bool zipFileIsOpen{ false };
     std::string currentFilename{};
 
-    // Added a session pointer to manage active sessions safely across methods
-    std::unique_ptr<StreamSession> activeSession{ nullptr };
+    #if !STB
+      // The reader behind the openStreamFile() / getStreamData() interface
+      ReaderPtr activeReader{ nullptr };
+    #endif
 
     std::unique_lock<std::recursive_mutex> streamLock{};
 
     auto closeZipFileUnsafe() -> void;
+    auto buildFileIndex() -> bool;
+    auto findFileEntry(const char *filename) -> FileEntry *;
     static bool alive;
 
   public:
@@ -90,6 +142,15 @@ class Unzip {
 
     static inline auto isAlive() -> bool { return alive; }
 
+    static inline auto fnvHash(const char *str, size_t len) -> uint32_t {
+      uint32_t h = 2166136261u;
+      while (len--) {
+        h ^= (uint8_t)*str++;
+        h *= 16777619u;
+      }
+      return h;
+    }
+
     auto seekToCentralDirectory() -> bool;
     auto readFileEntries(uint32_t offset, uint16_t count) -> bool;
     auto openZipFile(const char *zipFilename) -> bool;
@@ -102,6 +163,17 @@ class Unzip {
     auto closeFile() -> void;
 
     #if !STB
+      /**
+       * @brief Open an independent reader of a file.
+       *
+       * The mutex is held only while looking up the central directory: the
+       * decompression through the reader is not serialized with the other
+       * readers.
+       *
+       * @return The reader, or nullptr if the file cannot be found or read.
+       */
+      auto openReader(const char *filename, uint32_t &fileSize) -> ReaderPtr;
+
       auto openStreamFile(const char *filename, uint32_t &fileSize) -> bool;
       auto getStreamData(char *data, uint32_t size) -> uint32_t;
       auto streamSkip(uint32_t byteCount) -> bool;
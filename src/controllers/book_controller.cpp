@@ -32,8 +32,6 @@ auto BookController::enter() -> void {
 
   pageLocs.checkForFormatChanges(epub, currentPageId.itemrefIndex);
 
-  readyForDisplayPageId.reset();
-
   const PageId *id = pageLocs.getPageId(currentPageId);
   if (id != nullptr) {
     currentPageId.itemrefIndex = id->itemrefIndex;
@@ -59,6 +57,25 @@ auto BookController::leave(bool goingToDeepSleep) -> void {
   LOG_D("===> leave()...");
 
   booksDirController.saveLastBook(currentPageId, goingToDeepSleep);
+
+  #if EPUB_LINUX_BUILD
+    if (bookViewer != nullptr) {
+      auto stats = bookViewer->getPrefetchStats();
+      if ((stats.hits + stats.misses) > 0) {
+        LOG_I("Page prefetch: {} hits, {} misses, {} us per hit, {} us per miss.", stats.hits,
+              stats.misses, (stats.hits > 0) ? (stats.hitMicros / stats.hits) : 0,
+              (stats.misses > 0) ? (stats.missMicros / stats.misses) : 0);
+        LOG_I("Page turns: {} allocations per hit, {} allocations per miss.",
+              (stats.hits > 0) ? (stats.hitAllocations / stats.hits) : 0,
+              (stats.misses > 0) ? (stats.missAllocations / stats.misses) : 0);
+      }
+      if (stats.builds > 0) {
+        LOG_I("Page prefetch: {} pages built, {} us per page.", stats.builds,
+              stats.buildMicros / stats.builds);
+      }
+    }
+  #endif
+
   bookViewer.reset();
 
   if (goingToDeepSleep && (epub != nullptr)) { epub.reset(); }
@@ -120,25 +137,15 @@ auto BookController::openBook(const HimemString &bookTitle, const HimemString &b
 /**
  * @brief Show a page given its ID.
  *
- * This method is called when a new page needs to be shown.
- * It first checks if the page is already prepared and ready for display. If it is, it directly
- * displays it. If the page is not ready, it tries to prepare it. If the preparation is successful,
- * it then displays the page. After displaying the page, it also tries to prepare the next page in
- * the background, so that if the user goes to the next page, it can be displayed more quickly. If
- * the next page cannot be prepared, it resets the readyForDisplayPageId to an invalid value.
+ * This method is called when a new page needs to be shown. The page is prepared (taken from the
+ * page prefetcher if it was built in the background) and displayed. Once it is on screen, the
+ * pages around it are prefetched, so that if the user goes to the next or previous page, it
+ * only has to be painted.
  */
 auto BookController::showPage(const PageId &pageId, EPubPtr &epub) -> void {
   if (bookViewer != nullptr) {
-    if ((pageId == readyForDisplayPageId) || bookViewer->preparePage(pageId, epub)) {
-      bookViewer->displayPage(pageId);
-      auto nextPageId = pageLocs.getNextPageId(currentPageId);
-      if ((nextPageId != nullptr) && !nextPageId->firstPage() &&
-          bookViewer->preparePage(*nextPageId, epub)) {
-        readyForDisplayPageId = *nextPageId;
-      } else {
-        readyForDisplayPageId = PageId{ -1, -1 };
-      }
-    }
+    if (bookViewer->preparePage(pageId, epub)) { bookViewer->displayPage(pageId); }
+    bookViewer->prefetchAround(pageId, epub);
   }
 }
 
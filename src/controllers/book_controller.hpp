@@ -34,7 +34,6 @@ private:
   EPubPtr epub{nullptr};
 
   PageId currentPageId{0, 0};
-  PageId readyForDisplayPageId{-1, -1};
 
   BookViewerPtr bookViewer{nullptr};
 };
@@ -371,6 +371,22 @@ auto BookParamController::inputEvent(const EventMgr::Event &event) -> void {
               unlink(tocFilePath.c_str());
             }
 
+            HimemString csscFilePath = filePath;
+            csscFilePath.replace(dotPos, 5, ".cssc");
+
+            if (stat(csscFilePath.c_str(), &fileStat) != -1) {
+              LOG_I("Deleting file : {}", csscFilePath);
+              unlink(csscFilePath.c_str());
+            }
+
+            HimemString picsFilePath = filePath;
+            picsFilePath.replace(dotPos, 5, ".pics");
+
+            if (stat(picsFilePath.c_str(), &fileStat) != -1) {
+              LOG_I("Deleting file : {}", picsFilePath);
+              unlink(picsFilePath.c_str());
+            }
+
             int16_t refreshIndex;
             booksDir.refresh(nullptr, refreshIndex, false);
 
@@ -43,6 +43,7 @@ static int8_t                  defaultFont;
 static int8_t                  showTitle;
 static int8_t                  dirView;
 static int8_t                  coverSize;
+static int8_t                  booksSort;
 static int8_t                  done;
 static int8_t                  columnCount;
 
@@ -58,6 +59,7 @@ static int8_t                  oldDefaultFont;
 static int8_t                  oldShowTitle;
 static int8_t                  oldDirView;
 static int8_t                  oldCoverSize;
+static int8_t                  oldBooksSort;
 static int8_t                  oldColumnCount;
 
 static double                  oldBatteryTrim;
@@ -71,9 +73,9 @@ static double                  oldBatteryTrim;
 #endif
 
 #if INKPLATE_6PLUS || INKPLATE_6PLUS_V2 || INKPLATE_6FLICK || TOUCH_TRIAL || TOUCH_MENU
-  static constexpr int8_t MAIN_FORM_SIZE = 10;
+  static constexpr int8_t MAIN_FORM_SIZE = 11;
 #else
-  static constexpr int8_t MAIN_FORM_SIZE = 9;
+  static constexpr int8_t MAIN_FORM_SIZE = 10;
 #endif
 
 static FormEntry mainParamsFormEntries[MAIN_FORM_SIZE] = {
@@ -88,6 +90,11 @@ static FormEntry mainParamsFormEntries[MAIN_FORM_SIZE] = {
                            .choiceCount = 3,
                            .choices     = FormChoiceField::coverSizeChoices } },
     .entryType = FormEntryType::HORIZONTAL },
+  { .caption   = "Books Sorted By :",
+    .u         = { .ch = { .value       = &booksSort,
+                           .choiceCount = 3,
+                           .choices     = FormChoiceField::booksSortChoices } },
+    .entryType = FormEntryType::HORIZONTAL },
   #if INKPLATE_6PLUS || INKPLATE_6PLUS_V2 || INKPLATE_6FLICK || INKPLATE_6_V2 || INKPLATE_10_V2 || TOUCH_TRIAL
     { .caption   = "uSDCard Position (*):",
       .u         = { .ch = { .value       = (int8_t *)&orientation,
@@ -226,6 +233,7 @@ auto OptionController::mainParameters() -> void {
   config.  get(Config::Ident::ORIENTATION,      (int8_t *)&orientation);
   config.  get(Config::Ident::DIR_VIEW,         &dirView);
   config.  get(Config::Ident::COVER_SIZE,       &coverSize);
+  config.  get(Config::Ident::BOOKS_SORT,       &booksSort);
   config.  get(Config::Ident::PIXEL_RESOLUTION, (int8_t *)&resolution);
   config.  get(Config::Ident::BATTERY,          &showBattery);
   config.  get(Config::Ident::SHOW_TITLE,       &showTitle);
@@ -245,6 +253,7 @@ auto OptionController::mainParameters() -> void {
   oldOrientation = orientation;
   oldDirView     = dirView;
   oldCoverSize   = coverSize;
+  oldBooksSort   = booksSort;
   oldResolution  = resolution;
   oldShowTitle   = showTitle;
   oldBatteryTrim = batteryTrim;
@@ -507,6 +516,7 @@ auto OptionController::inputEvent(const EventMgr::Event &event) -> void {
       config.  put(Config::Ident::ORIENTATION,      static_cast<int8_t>(orientation));
       config.  put(Config::Ident::DIR_VIEW,         dirView);
       config.  put(Config::Ident::COVER_SIZE,       coverSize);
+      config.  put(Config::Ident::BOOKS_SORT,       booksSort);
       config.  put(Config::Ident::PIXEL_RESOLUTION, static_cast<int8_t>(resolution));
       config.  put(Config::Ident::BATTERY,          showBattery);
       config.  put(Config::Ident::SHOW_TITLE,       showTitle);
@@ -529,7 +539,11 @@ auto OptionController::inputEvent(const EventMgr::Event &event) -> void {
         booksDirController.newOrientation();
       }
 
-      if (oldDirView != dirView) {
+      if (oldBooksSort != booksSort) {
+        booksDir.setSortOrder(static_cast<BooksIndex::SortOrder>(booksSort));
+      }
+
+      if ((oldDirView != dirView) || (oldBooksSort != booksSort)) {
         booksDirController.setCurrentBookIndex(-1);
       }
 
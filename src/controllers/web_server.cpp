@@ -476,6 +476,20 @@
         LOG_I("Deleting file : {}", filepath);
         unlink(filepath.c_str());
       }
+
+      filepath.replace(dotPos, 5, ".cssc");
+
+      if (stat(filepath.c_str(), &fileStat) != -1) {
+        LOG_I("Deleting file : {}", filepath);
+        unlink(filepath.c_str());
+      }
+
+      filepath.replace(dotPos, 5, ".pics");
+
+      if (stat(filepath.c_str(), &fileStat) != -1) {
+        LOG_I("Deleting file : {}", filepath);
+        unlink(filepath.c_str());
+      }
     }
 
     /* Redirect onto root to see the updated file list */
@@ -2,6 +2,7 @@
 
   #include "goto_deep_sleep.hpp"
 
+  #include "fonts.hpp"
   #include "screen.hpp"
 
   #include "controllers/app_controller.hpp"
@@ -51,6 +52,7 @@
     }
 
     appController.goingToDeepSleep();
+    appFonts.flushGlyphFiles();
 
     auto screen_saver = ScreenSaver::Make();
     screen_saver->show();
@@ -136,6 +136,9 @@
       // which is more efficient and has more capacity than the C++ heap.
       pugi::set_memory_management_functions(allocate, free);
 
+      GlyphFile::setFolder(GLYPHS_FOLDER);
+      glyphStore.setEnabled(true); // Glyphs shared by the viewer, prefetcher and retrievers
+
       // The appFonts only contains the icon and system fonts. Books related fonts are
       // instanciated inside the epub class when a book is open.
       if (appFonts.setup()) {
@@ -282,6 +285,9 @@
       }
     #endif
 
+    GlyphFile::setFolder(GLYPHS_FOLDER);
+    glyphStore.setEnabled(true); // Glyphs shared by the viewer, prefetcher and retrievers
+
     if (appFonts.setup()) {
 
       Screen::Orientation     orientation{ Screen::Orientation::RIGHT };
@@ -0,0 +1,109 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/atoms.hpp"
+
+#include "logging.hpp"
+
+#include <algorithm>
+#include <limits>
+
+static constexpr const char *TAG = "Atoms";
+
+auto Atoms::clear() -> void {
+  names.clear();
+  names.emplace_back(); // NO_ATOM
+  slots.assign(64, Slot{ 0, NO_ATOM });
+  slotMask = 63;
+}
+
+auto Atoms::lookup(const char *str, size_t len, uint32_t hash) const -> uint32_t {
+  uint32_t idx = hash & slotMask;
+  while (true) {
+    const Slot &slot = slots[idx];
+    if (slot.atom == NO_ATOM) { return idx; }
+    if ((slot.hash == hash) && (names[slot.atom].size() == len) &&
+        (memcmp(names[slot.atom].data(), str, len) == 0)) {
+      return idx;
+    }
+    idx = (idx + 1) & slotMask;
+  }
+}
+
+auto Atoms::find(const char *str, size_t len) const -> Atom {
+  if (len == 0) { return NO_ATOM; }
+  return slots[lookup(str, len, hashOf(str, len))].atom;
+}
+
+auto Atoms::intern(const char *str, size_t len) -> Atom {
+  if (len == 0) { return NO_ATOM; }
+
+  uint32_t hash = hashOf(str, len);
+  uint32_t idx  = lookup(str, len, hash);
+  if (slots[idx].atom != NO_ATOM) { return slots[idx].atom; }
+
+  if (names.size() > std::numeric_limits<Atom>::max()) {
+    LOG_E("Atom table full, name ignored.");
+    return NO_ATOM;
+  }
+
+  Atom atom = names.size();
+  names.emplace_back(str, len);
+  slots[idx] = Slot{ hash, atom };
+
+  // Keep the load factor under 1/2.
+  if ((names.size() * 2) > slots.size()) { grow(); }
+
+  return atom;
+}
+
+auto Atoms::grow() -> void {
+  HimemVector<Slot> old(std::move(slots));
+  slots.assign(old.size() * 2, Slot{ 0, NO_ATOM });
+  slotMask = slots.size() - 1;
+
+  for (const Slot &slot : old) {
+    if (slot.atom == NO_ATOM) { continue; }
+    uint32_t idx = slot.hash & slotMask;
+    while (slots[idx].atom != NO_ATOM) { idx = (idx + 1) & slotMask; }
+    slots[idx] = slot;
+  }
+}
+
+AtomList &AtomList::operator=(const AtomList &other) {
+  if (this == &other) { return *this; }
+  clear();
+  for (Atom atom : other) { add(atom); }
+  return *this;
+}
+
+AtomList &AtomList::operator=(AtomList &&other) noexcept {
+  if (this == &other) { return *this; }
+  std::copy(other.inlineAtoms, other.inlineAtoms + INLINE_CAPACITY, inlineAtoms);
+  heap     = std::move(other.heap);
+  count    = other.count;
+  capacity = other.capacity;
+  other.clear();
+  return *this;
+}
+
+auto AtomList::add(Atom atom) -> void {
+  if ((atom == Atoms::NO_ATOM) || contains(atom)) { return; }
+
+  if (count == capacity) {
+    if (capacity == UINT8_MAX) { return; }
+    uint8_t newCapacity = (capacity > (UINT8_MAX / 2)) ? UINT8_MAX : (capacity * 2);
+    auto    newHeap     = makeUniqueHimem<Atom[]>(newCapacity);
+    if (newHeap == nullptr) {
+      LOG_E("Unable to allocate atom list.");
+      return;
+    }
+    std::copy(begin(), end(), newHeap.get());
+    heap     = std::move(newHeap);
+    capacity = newCapacity;
+  }
+
+  // begin() is the inline storage until the first spill to the heap.
+  const_cast<Atom *>(begin())[count++] = atom;
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include <cstring>
+
+/**
+ * class Atoms - Interned class and id names
+ *
+ * Every class or id name found in the CSS files and in the HTML of a book is
+ * turned into a small integer (an atom). Selector matching then compares
+ * integers instead of strings, and DOM nodes do not have to keep a copy of
+ * their class names.
+ *
+ * An atom table is owned by a CSSPools instance and shared with the
+ * DOMPools instance of the same EPub, so atoms from both sides are
+ * comparable. Like the pools, it is not thread-safe: it is used by the
+ * thread owning the EPub instance.
+ */
+class Atoms {
+  public:
+    using Atom = uint16_t;
+
+    /// Returned for an empty name, or when the table is full. Never matches.
+    static constexpr Atom NO_ATOM = 0;
+
+    Atoms() { clear(); }
+
+    /// Return the atom of a name, adding it to the table if not already there.
+    auto intern(const char *str, size_t len) -> Atom;
+    auto intern(const char *str) -> Atom { return intern(str, strlen(str)); }
+
+    /// Return the atom of a name, or NO_ATOM if the name is unknown.
+    [[nodiscard]] auto find(const char *str, size_t len) const -> Atom;
+    [[nodiscard]] auto find(const char *str) const -> Atom { return find(str, strlen(str)); }
+
+    /// Name of an atom (empty string for NO_ATOM or an unknown atom).
+    [[nodiscard]] auto name(Atom atom) const -> const char * {
+      return (atom < names.size()) ? names[atom].c_str() : "";
+    }
+
+    /// Number of atoms in the table, NO_ATOM included.
+    [[nodiscard]] auto size() const -> uint32_t { return names.size(); }
+
+    auto clear() -> void;
+
+  private:
+    struct Slot {
+      uint32_t hash;
+      Atom atom; // NO_ATOM for an empty slot
+    };
+
+    HimemVector<HimemString> names;
+    HimemVector<Slot> slots;
+    uint32_t slotMask{ 0 };
+
+    static inline auto hashOf(const char *str, size_t len) -> uint32_t {
+      uint32_t hash = 2166136261u; // FNV-1a
+      for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(str[i]);
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+    auto lookup(const char *str, size_t len, uint32_t hash) const -> uint32_t;
+    auto grow() -> void;
+};
+
+/**
+ * class AtomList - Small set of atoms
+ *
+ * Keeps up to INLINE_CAPACITY atoms inline, which covers nearly all class
+ * attributes and selectors, and spills to the heap past that. Duplicates and
+ * NO_ATOM are ignored.
+ */
+class AtomList {
+  public:
+    using Atom = Atoms::Atom;
+
+    static constexpr uint8_t INLINE_CAPACITY = 4;
+
+    AtomList() = default;
+    AtomList(const AtomList &other) { *this = other; }
+    AtomList &operator=(const AtomList &other);
+    AtomList(AtomList &&other) noexcept { *this = std::move(other); }
+    AtomList &operator=(AtomList &&other) noexcept;
+
+    auto add(Atom atom) -> void;
+
+    [[nodiscard]] auto contains(Atom atom) const -> bool {
+      for (Atom a : *this) {
+        if (a == atom) { return true; }
+      }
+      return false;
+    }
+
+    [[nodiscard]] inline auto size() const -> uint8_t { return count; }
+    [[nodiscard]] inline auto empty() const -> bool { return count == 0; }
+
+    [[nodiscard]] inline auto begin() const -> const Atom * {
+      return (heap != nullptr) ? heap.get() : inlineAtoms;
+    }
+    [[nodiscard]] inline auto end() const -> const Atom * { return begin() + count; }
+
+    auto clear() -> void {
+      heap.reset();
+      count    = 0;
+      capacity = INLINE_CAPACITY;
+    }
+
+  private:
+    Atom inlineAtoms[INLINE_CAPACITY]{};
+    HimemUniquePtr<Atom[]> heap{ nullptr };
+    uint8_t count{ 0 };
+    uint8_t capacity{ INLINE_CAPACITY };
+};
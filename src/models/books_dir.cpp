@@ -10,10 +10,9 @@
 
 #include "config.hpp"
 #include "controllers/book_controller.hpp"
-#include "models/default_cover.hpp"
+#include "models/books_scanner.hpp"
 #include "models/epub.hpp"
 #include "models/page_locs.hpp"
-#include "picture_factory.hpp"
 #include "viewers/book_viewer.hpp"
 #include "viewers/msg_viewer.hpp"
 
@@ -27,6 +26,7 @@ extern "C" {
 }
 
 #include "books_dir.hpp"
+#include <chrono>
 #include <sstream>
 #include <stdlib.h>
 #include <sys/stat.h>
@@ -156,6 +156,20 @@ Dim BooksDir::coverDim{ BooksDir::SMALL_COVER_WIDTH, BooksDir::SMALL_COVER_HEIGH
 
 #endif
 
+auto BooksDir::addVersionRecord(SimpleDB &theDb) -> bool {
+  VersionRecord versionRecord;
+
+  memset(&versionRecord, 0, sizeof(versionRecord));
+  versionRecord.version = BOOKS_DIR_DB_VERSION;
+  strcpy(versionRecord.appName, APP_NAME);
+
+  if (!theDb.addRecord(&versionRecord, sizeof(versionRecord))) {
+    LOG_E("Not able to set DB Version.");
+    return false;
+  }
+  return true;
+}
+
 auto BooksDir::readBooksDirectory(char *bookFilename, int16_t &bookIndex) -> bool {
   LOG_D("Reading books directory: {}.", BOOKS_DIR_FILE);
 
@@ -168,29 +182,27 @@ auto BooksDir::readBooksDirectory(char *bookFilename, int16_t &bookIndex) -> boo
     showDb();
   #endif
 
+  setCoverSize();
+
   // We first verify if the database content is of the current version
 
   bool          versionOk = false;
   VersionRecord versionRecord;
 
   if (db->getRecordCount() == 0) {
-    memset(&versionRecord, 0, sizeof(versionRecord));
-
-    versionRecord.version = BOOKS_DIR_DB_VERSION;
-    strcpy(versionRecord.appName, APP_NAME);
-
-    if (!db->addRecord(&versionRecord, sizeof(versionRecord))) {
-      LOG_E("Not able to set DB Version.");
-      return false;
-    }
+    if (!addVersionRecord(*db)) { return false; }
     versionOk = true;
   } else {
     db->gotoFirst();
     if (db->getRecordSize() == sizeof(versionRecord)) {
       db->getRecord(&versionRecord, sizeof(versionRecord));
-      if ((versionRecord.version == BOOKS_DIR_DB_VERSION) &&
-          (strcmp(versionRecord.appName, APP_NAME) == 0)) {
-        versionOk = true;
+      if (strcmp(versionRecord.appName, APP_NAME) == 0) {
+        if (versionRecord.version == BOOKS_DIR_DB_VERSION) {
+          versionOk = true;
+        } else if (versionRecord.version == V7_DB_VERSION) {
+          LOG_I("Database of version {}. Migrating...", V7_DB_VERSION);
+          versionOk = migrateFromV7();
+        }
       }
     }
   }
@@ -204,17 +216,25 @@ auto BooksDir::readBooksDirectory(char *bookFilename, int16_t &bookIndex) -> boo
       return false;
     }
 
-    memset(&versionRecord, 0, sizeof(versionRecord));
-    versionRecord.version = BOOKS_DIR_DB_VERSION;
-    strcpy(versionRecord.appName, APP_NAME);
+    if (!addVersionRecord(*db)) { return false; }
+  }
+
+  // The covers store must be of the current cover size. If not, the covers of the books
+  // in the database are lost and all books are indexed again.
 
-    if (!db->addRecord(&versionRecord, sizeof(versionRecord))) {
-      LOG_E("Not able to set DB Version.");
+  bool forceInit = false;
+
+  if ((!covers->isOpen() || (covers->getCapacity() != coverCapacity())) &&
+      !covers->open(COVERS_FILE, coverCapacity())) {
+    LOG_I("Covers store is of a wrong size or doesn't exists. Initializing...");
+    if (!covers->create(COVERS_FILE, coverCapacity())) {
+      LOG_E("Unable to create covers store: {}", COVERS_FILE);
       return false;
     }
+    forceInit = db->getRecordCount() > 1;
   }
 
-  if (!refresh(bookFilename, bookIndex)) {
+  if (!refresh(bookFilename, bookIndex, forceInit)) {
     LOG_E("Unable to complete DB refresh");
     return false;
   }
@@ -225,83 +245,153 @@ auto BooksDir::readBooksDirectory(char *bookFilename, int16_t &bookIndex) -> boo
   return true;
 }
 
-auto BooksDir::getBookData(uint16_t idx) -> EBookRecordPtr {
-  if (idx >= sortedIndex.size()) {
-    LOG_E("Idx too large: {}", idx);
-    return nullptr;
+/**
+ * @brief Migrates a database of version 7 to the current version.
+ *
+ * In version 7, each record was holding the description and the cover bitmap after the
+ * meta-data. The meta-data and the description are copied into a new database, the
+ * cover bitmaps into a new covers store. A book whose cover doesn't fit the current cover
+ * size is left out: it will be seen as a new book by the refresh process.
+ *
+ * @return true The database is of the current version.
+ */
+auto BooksDir::migrateFromV7() -> bool {
+
+  #pragma pack(push, 1)
+    struct V7Record {
+      char filename[FILENAME_SIZE];
+      int32_t fileSize;
+      uint32_t id;
+      char title[TITLE_SIZE];
+      char author[AUTHOR_SIZE];
+      char description[DESCRIPTION_SIZE];
+      Dim coverDim;
+      uint8_t coverBitmap[];
+    };
+  #pragma pack(pop)
+
+  SimpleDBPtr  newDb = SimpleDB::Make();
+  BookEntryPtr entry = BookEntry::Make();
+
+  if (!newDb || !entry) {
+    LOG_E("Unable to allocate migration data");
+    return false;
   }
 
-  int     i         = 0;
-  int16_t index = -1;
+  if (!newDb->create(NEW_DIR_FILE) || !addVersionRecord(*newDb)) {
+    LOG_E("Unable to create database: {}", NEW_DIR_FILE);
+    return false;
+  }
+
+  if (!covers->create(COVERS_FILE, coverCapacity())) {
+    LOG_E("Unable to create covers store: {}", COVERS_FILE);
+    return false;
+  }
+
+  db->gotoFirst();
+  while (db->gotoNext()) { // Go pass the DB version record
+    int32_t size = db->getRecordSize();
+    if (size < static_cast<int32_t>(sizeof(V7Record))) { continue; }
+
+    auto data = makeUniqueHimem<uint8_t[]>(size);
+    if (!data || !db->getRecord(data.get(), size)) {
+      LOG_E("Unable to get record of size {} from db", size);
+      return false;
+    }
 
-  for (auto &entry : sortedIndex) {
-    if (idx == i) {
-      index = entry.second.dbIndex;
-      break;
+    auto    *old       = reinterpret_cast<V7Record *>(data.get());
+    uint32_t coverSize = old->coverDim.width * old->coverDim.height;
+    if ((old->coverDim.width > coverDim.width) || (old->coverDim.height > coverDim.height) ||
+        (size < static_cast<int32_t>(sizeof(V7Record) + coverSize))) {
+      LOG_D("Cover not of the current size: {}", old->filename);
+      continue;
+    }
+
+    memset((void *)entry.get(), 0, sizeof(BookEntry));
+    memcpy(entry->book.filename, old->filename, FILENAME_SIZE);
+    entry->book.fileSize = old->fileSize;
+    entry->book.id       = old->id;
+    memcpy(entry->book.title, old->title, TITLE_SIZE);
+    memcpy(entry->book.author, old->author, AUTHOR_SIZE);
+    memcpy(entry->description, old->description, DESCRIPTION_SIZE);
+    entry->book.coverDim = old->coverDim;
+
+    if (!covers->addSlot(old->coverBitmap, coverSize, entry->book.coverSlot) ||
+        !newDb->addRecord(entry.get(), sizeof(BookEntry))) {
+      LOG_E("Unable to migrate record of {}", old->filename);
+      return false;
     }
-    ++i;
   }
-  if (index == -1) {
-    LOG_E("Unable to find idx: {}", idx);
+
+  db->close();
+  newDb->close();
+
+  if (remove(BOOKS_DIR_FILE) || rename(NEW_DIR_FILE, BOOKS_DIR_FILE)) {
+    LOG_E("Unable to replace directory DB file.");
+    return false;
+  }
+
+  return db->open(BOOKS_DIR_FILE);
+}
+
+auto BooksDir::getBookData(uint16_t idx) -> EBookRecordPtr {
+  int16_t index = sortedIndex.dbIndexAt(idx);
+  if (index == BooksIndex::NOT_FOUND) {
+    LOG_E("Idx too large: {}", idx);
     return nullptr;
   }
 
   db->setCurrentIdx(index);
 
-  size_t                   recordSize = db->getRecordSize();
+  // Only the meta-data at the beginning of the record is read.
 
   BooksDir::EBookRecordPtr book{ nullptr };
 
-  if (recordSize >= sizeof(EBookRecord)) {
-    book = EBookRecord::Make(recordSize);
-    if (book && !db->getRecord(book.get(), recordSize)) {
+  if (db->getRecordSize() >= static_cast<int32_t>(sizeof(EBookRecord))) {
+    book = EBookRecord::Make();
+    if (book && !db->getRecord(book.get(), sizeof(EBookRecord))) {
       LOG_E("Unable to get record at index {}", index);
       book.reset();
     }
   } else {
-    LOG_E("Record size too small: {}", recordSize);
+    LOG_E("Record size too small: {}", db->getRecordSize());
   }
 
   return book;
 }
 
-auto BooksDir::getBookId(uint16_t idx, uint32_t &id) -> bool {
-  if (idx >= sortedIndex.size()) {
-    LOG_E("Idx too large: {}", idx);
-    return false;
+auto BooksDir::getCover(const EBookRecord &book) -> PicturePtr {
+  uint32_t size = book.coverSize();
+  if ((size == 0) || (size > covers->getCapacity())) {
+    LOG_E("Wrong cover size: {}", size);
+    return nullptr;
   }
 
-  int  i      = 0;
-  bool found = false;
-
-  for (auto &entry : sortedIndex) {
-    if (idx == i) {
-      id    = entry.second.id;
-      found = true;
-      break;
-    }
-    ++i;
+  FileContentPtr bitmap = makeUniqueHimem<uint8_t[]>(size);
+  if (!bitmap || !covers->getSlot(book.coverSlot, bitmap.get(), size)) {
+    LOG_E("Unable to get cover at slot {}", book.coverSlot);
+    return nullptr;
   }
-  if (!found) { LOG_E("Unable to find idx: {}", idx); }
 
-  return found;
+  return Picture::Make(book.coverDim, std::move(bitmap), size, 4);
 }
 
-auto BooksDir::getBookIndex(uint32_t id, uint16_t &idx) -> bool {
-  int  i      = 0;
-  bool found = false;
-
-  for (auto &entry : sortedIndex) {
-    if (entry.second.id == id) {
-      idx   = i;
-      found = true;
-      break;
-    }
-    ++i;
+auto BooksDir::getBookId(uint16_t idx, uint32_t &id) -> bool {
+  if (!sortedIndex.idAt(idx, id)) {
+    LOG_E("Idx too large: {}", idx);
+    return false;
   }
-  if (!found) { LOG_E("Unable to find id: {:#010x}", id); }
+  return true;
+}
 
-  return found;
+auto BooksDir::getBookIndex(uint32_t id, uint16_t &idx) -> bool {
+  int16_t i = sortedIndex.sortedIdxOfId(id);
+  if (i == BooksIndex::NOT_FOUND) {
+    LOG_E("Unable to find id: {:#010x}", id);
+    return false;
+  }
+  idx = i;
+  return true;
 }
 
 auto BooksDir::setTrackOrder(uint32_t id, int8_t pos) -> void {
@@ -309,24 +399,8 @@ auto BooksDir::setTrackOrder(uint32_t id, int8_t pos) -> void {
   if (noRecurse) { return; }
 
   LOG_D("-------------------------> setTrackOrder({}, {})", id, pos);
-  bool found = false;
-
-  for (auto &entry : sortedIndex) {
-    if (entry.second.id == id) {
-      char ch = (pos >= 0) ? 'a' + pos : 'z';
-      LOG_D("Old key: {}", entry.first);
-      if (entry.first.front() != ch) {
-        auto e          = sortedIndex.extract(entry.first);
-        e.key().front() = ch;
-        LOG_D("New key: {}", e.key());
-        sortedIndex.insert(std::move(e));
-      }
-      found = true;
-      break;
-    }
-  }
 
-  if (!found) {
+  if (!sortedIndex.setPos(id, pos)) {
     #if EPUB_INKPLATE_BUILD
       noRecurse = true;
       nvsMgr.erase(id);
@@ -336,6 +410,15 @@ auto BooksDir::setTrackOrder(uint32_t id, int8_t pos) -> void {
   }
 }
 
+// Position of a book in the recently read list kept by the NVS manager, -1 if not in it.
+auto BooksDir::posOf(uint32_t id) -> int8_t {
+  #if EPUB_INKPLATE_BUILD
+    return nvsMgr.getPos(id);
+  #else
+    return -1;
+  #endif
+}
+
 auto BooksDir::clearDb() -> void {
   db->gotoFirst();
   while (db->gotoNext()) {
@@ -377,25 +460,25 @@ auto BooksDir::setCoverSize() -> void {
  *                          If nullptr, no specific book search is performed.
  * @param[out] bookIndex   The database index of the book matching bookFilename.
  *                          Only set if bookFilename is provided and a match is found.
- * @param[out] tempIndex   A temporary index mapping filenames to their IndexInfo (id and
- * dbIndex). Used for intermediate storage during the validation process.
+ * @param[out] knownFiles  The filenames of the books kept in the database, used to
+ * identify the new books in the books folder.
  *
  * @details
- * - Allocates a temporary PartialRecord structure to read database entries
- * - Removes database records if the corresponding file doesn't exist or has mismatched file size
- * - For valid books, constructs a sorted index with a special prefix character:
- *   - On EPUB_INKPLATE_BUILD: prefix is based on position from NVS manager ('a'-'z')
- *   - Otherwise: prefix is 'z'
+ * - Allocates a temporary EBookRecord structure to read database entries
+ * - Removes database records if the corresponding file doesn't exist or has mismatched file size,
+ *   and incomplete records
+ * - Adds valid books to the sorted index, with their position in the recently read list
+ *   (from the NVS manager on EPUB_INKPLATE_BUILD, none otherwise)
  * - Logs book availability and title information
  *
  * @note If memory allocation fails, calls msg_viewer.outOfMemory() and does not return.
  *
  * @see nvsMgr, db, sortedIndex, BOOKS_FOLDER, FILENAME_SIZE, TITLE_SIZE
  */
-auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, SortedIndex &tempIndex)
+auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, FilenameSet &knownFiles)
 -> void {
 
-  auto partialRecord = PartialRecord::Make();
+  auto partialRecord = EBookRecord::Make();
 
   if (!partialRecord) {
     MsgViewer::outOfMemory("partial record allocation");
@@ -405,7 +488,14 @@ auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, SortedInde
   db->gotoFirst();
 
   while (db->gotoNext()) { // Go pass the DB version record
-    db->getRecord(partialRecord.get(), sizeof(PartialRecord));
+
+    // A record cut by a reset while new books were written is removed: the book is scanned again
+    if ((db->getRecordSize() != sizeof(BookEntry)) ||
+        !db->getRecord(partialRecord.get(), sizeof(EBookRecord))) {
+      LOG_D("Incomplete record at index {}", db->getCurrentIdx());
+      db->setDeleted();
+      continue;
+    }
 
     std::string fname = BOOKS_FOLDER "/";
     fname.append(partialRecord->filename);
@@ -413,26 +503,18 @@ auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, SortedInde
     struct stat statBuffer;
 
     // if file with filename not found or the file size is not the same,
-    // remove the database entry
+    // or its cover is not in the covers store, remove the database entry
     if ((stat(fname.c_str(), &statBuffer) != 0) ||
-        (statBuffer.st_size != partialRecord->fileSize)) {
+        (statBuffer.st_size != partialRecord->fileSize) ||
+        (partialRecord->coverSlot >= covers->getSlotCount())) {
       LOG_D("Book no longer available: {}", partialRecord->filename);
       db->setDeleted();
     } else {
       LOG_D("Title: {}", partialRecord->title);
-      tempIndex[partialRecord->filename] = IndexInfo{ .id = 0, .dbIndex = 0 };
-
-      #if EPUB_INKPLATE_BUILD
-        int8_t      pos        = nvsMgr.getPos(partialRecord->id);
-        HimemString title = " ";
-        title += partialRecord->title;
-        title.front() = (pos >= 0) ? 'a' + pos : 'z';
-      #else
-        HimemString title = "z";
-        title += partialRecord->title;
-      #endif
-
-      sortedIndex[title] = IndexInfo{ .id = partialRecord->id, .dbIndex = db->getCurrentIdx() };
+      knownFiles.insert(partialRecord->filename);
+
+      sortedIndex.add(partialRecord->id, db->getCurrentIdx(), partialRecord->title,
+                      partialRecord->author, posOf(partialRecord->id));
       if (bookFilename) {
         if (strcmp(bookFilename, partialRecord->filename) == 0) { bookIndex = db->getCurrentIdx(); }
       }
@@ -445,7 +527,8 @@ auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, SortedInde
  *
  * This method defragments the internal database by creating a new database file,
  * copying all records from the old database, and rebuilding the sorted index.
- * The sorted index uses book titles with position prefixes for ordering.
+ * The covers store is defragmented the same way: the cover of each record is copied
+ * into a new store, the slots of the removed books being left behind.
  *
  * @param bookFilename Optional filename to search for in the database. If provided and found,
  *                       its corresponding database index will be stored in bookIndex.
@@ -455,29 +538,35 @@ auto BooksDir::checkDbContent(char *bookFilename, int16_t &bookIndex, SortedInde
  *
  * @return true if the cleanup operation completed successfully, false otherwise.
  *         Returns false if any of the following fail:
- *         - Creating the new database
- *         - Reading from the old database
+ *         - Creating the new database or covers store
+ *         - Reading from the old database or covers store
  *         - Allocating memory for records
- *         - Writing records to the new database
+ *         - Writing records to the new database or covers to the new store
  *         - File system operations (remove/rename)
- *         - Opening the reorganized database
+ *         - Opening the reorganized database or covers store
  *
  * @note The first record in the database is treated as a version record and is
  *       not included in the sorted index.
- * @note On EPUB_INKPLATE_BUILD, book titles are prefixed with a position indicator
- *       ('a'-'z' from NVS manager, or 'z' if position not found).
- *       On other builds, titles are simply prefixed with 'z'.
- * @note This operation closes and recreates the database file on disk.
+ * @note This operation closes and recreates the database and covers files on disk.
  */
 auto BooksDir::cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool {
-  SimpleDBPtr newDb = SimpleDB::Make();
+  SimpleDBPtr  newDb     = SimpleDB::Make();
+  SlotStorePtr newCovers = SlotStore::Make();
   sortedIndex.clear();
 
-  if (newDb->create(NEW_DIR_FILE)) {
+  if (newDb->create(NEW_DIR_FILE) && newCovers->create(NEW_COVERS_FILE, coverCapacity())) {
     if (!db->gotoFirst()) {
       LOG_E("db->gotoFirst() failed");
       return false;
     }
+
+    BookEntryPtr   data   = BookEntry::Make();
+    FileContentPtr bitmap = makeUniqueHimem<uint8_t[]>(coverCapacity());
+    if (!data || !bitmap) {
+      LOG_E("Unable to allocate {} bytes for ebook record", sizeof(BookEntry) + coverCapacity());
+      return false;
+    }
+
     bool first = true; // First record is the version record, we want to keep it as is and not put
                        // it in the sorted index
     do {
@@ -488,70 +577,65 @@ auto BooksDir::cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool {
           LOG_E("Unable to get proper record size: {} from db", size);
           return false;
         }
-        VersionRecordPtr data = VersionRecord::Make();
-        if (!data) {
+        VersionRecordPtr version = VersionRecord::Make();
+        if (!version) {
           LOG_E("Unable to allocate {} bytes for version record", size);
           return false;
         }
-        if (!db->getRecord(data.get(), size)) {
+        if (!db->getRecord(version.get(), size)) {
           LOG_E("Unable to get version record of size {} from db", size);
           return false;
         }
-        if (!newDb->addRecord(data.get(), size)) {
+        if (!newDb->addRecord(version.get(), size)) {
           LOG_E("Unable to add version record to db");
           return false;
         }
 
         first = false;
       } else {
-        if (size < sizeof(EBookRecord)) {
+        if (size != sizeof(BookEntry)) {
           LOG_E("Unable to get proper record size: {} from db", size);
           return false;
         }
-        EBookRecordPtr data = EBookRecord::Make(size);
-        if (!data) {
-          LOG_E("Unable to allocate {} bytes for ebook record", size);
-          return false;
-        }
         if (!db->getRecord(data.get(), size)) {
           LOG_E("Unable to get record of size {} from db", size);
           return false;
         }
+        EBookRecord &book = data->book;
+        if ((book.coverSize() > coverCapacity()) ||
+            !covers->getSlot(book.coverSlot, bitmap.get(), book.coverSize()) ||
+            !newCovers->addSlot(bitmap.get(), book.coverSize(), book.coverSlot)) {
+          LOG_E("Unable to copy cover of {}", book.filename);
+          return false;
+        }
         if (!newDb->addRecord(data.get(), size)) {
           LOG_E("Unable to add record to db");
           return false;
         }
 
         uint16_t idx = newDb->getRecordCount() - 1;
-        #if EPUB_INKPLATE_BUILD
-          int8_t      pos        = nvsMgr.getPos(data->id);
-          HimemString title = " ";
-          title += data->title;
-          title.front() = (pos >= 0) ? 'a' + pos : 'z';
-        #else
-          HimemString title = "z";
-          title += data->title;
-        #endif
-        sortedIndex[title] = IndexInfo{ .id = data->id, .dbIndex = idx };
+        sortedIndex.add(book.id, idx, book.title, book.author, posOf(book.id));
         if (bookFilename) {
-          if (strcmp(bookFilename, data->filename) == 0) { bookIndex = newDb->getRecordCount() - 1; }
+          if (strcmp(bookFilename, book.filename) == 0) { bookIndex = newDb->getRecordCount() - 1; }
         }
       }
     } while (db->gotoNext());
 
     db->close();
     newDb->close();
+    covers->close();
+    newCovers->close();
 
-    if (remove(BOOKS_DIR_FILE)) {
-      LOG_E("Unable to remove directory DB file.");
+    if (remove(BOOKS_DIR_FILE) || remove(COVERS_FILE)) {
+      LOG_E("Unable to remove directory DB files.");
       return false;
     }
-    if (rename(NEW_DIR_FILE, BOOKS_DIR_FILE)) {
-      LOG_E("Unable to rename new directory DB file");
+    if (rename(NEW_DIR_FILE, BOOKS_DIR_FILE) || rename(NEW_COVERS_FILE, COVERS_FILE)) {
+      LOG_E("Unable to rename new directory DB files");
       return false;
     }
-    if (!db->open(BOOKS_DIR_FILE)) {
-      LOG_E("Inable to open directory DB File.");
+    if (!db->open(BOOKS_DIR_FILE) || !covers->open(COVERS_FILE, coverCapacity())) {
+      LOG_E("Inable to open directory DB Files.");
       return false;
     }
   }
@@ -559,13 +643,58 @@ auto BooksDir::cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool {
   return true;
 }
 
+/**
+ * @brief Writes a batch of scanned books to the covers store and the database.
+ *
+ * The cover of each book is added to the covers store, then its record to the database, and
+ * both files are synced: the books of the batch survive a reset. A book whose record is not
+ * complete after a reset is removed by checkDbContent() and scanned again.
+ *
+ * @return false if a cover or a record cannot be written.
+ */
+auto BooksDir::commitBatch(ScannedBooks &batch, char *bookFilename, int16_t &bookIndex) -> bool {
+  for (auto &scanned : batch) {
+    EBookRecord &theBook = scanned->entry.book;
+
+    theBook.id = generateId((uint8_t *)theBook.filename, strlen(theBook.filename));
+
+    if (!covers->addSlot(scanned->cover->getBitmap(), theBook.coverSize(), theBook.coverSlot)) {
+      LOG_E("Unable to add a new cover to covers file.");
+      return false;
+    }
+
+    if (!db->addRecord(&scanned->entry, sizeof(BookEntry))) {
+      LOG_E("Unable to add a new record to DB file.");
+      return false;
+    }
+
+    uint16_t idx = db->getRecordCount() - 1;
+    sortedIndex.add(theBook.id, idx, theBook.title, theBook.author, posOf(theBook.id));
+
+    if (bookFilename) {
+      if (strcmp(bookFilename, theBook.filename) == 0) { bookIndex = idx; }
+    }
+  }
+  batch.clear();
+
+  if (!covers->sync() || !db->sync()) {
+    LOG_E("Unable to write the books to the SD Card.");
+    return false;
+  }
+  return true;
+}
+
 /**
  * @brief Loads new e-book files from the books folder into the database.
  *
  * Scans the books folder for new EPUB files that are not yet in the database.
- * For each new book found, extracts metadata (title, author, description),
- * retrieves and resizes the cover image, and adds a new record to the database.
- * Updates the sorted index with the newly added books.
+ * For each new book found, the BooksScanner worker extracts metadata (title, author,
+ * description) and retrieves and resizes the cover image. Meanwhile, the books already
+ * scanned are written in batches of BATCH_SIZE to the covers store and the database
+ * and the progress page is updated. Updates the sorted index with the newly added books.
+ *
+ * Each batch is synced to the SD Card: if the device is reset during the process, the books
+ * already written are known at the next refresh and only the others are scanned again.
  *
  * @param bookFilename Optional filename to search for and return its database index.
  *                       If provided and found, bookIndex will be set to its position.
@@ -573,7 +702,7 @@ auto BooksDir::cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool {
  * @param bookIndex    Output parameter. Set to the database index if bookFilename
  *                      matches a newly added book. Only modified if bookFilename is provided
  *                      and a matching book is added.
- * @param tempIndex    Reference to a sorted index (map) containing existing books in the database.
+ * @param knownFiles   The filenames of the books already in the database.
  *                      Used to identify which EPUB files are new.
  *
  * @return std::pair<bool, bool>
@@ -582,12 +711,10 @@ auto BooksDir::cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool {
  *                   false if no new books were found or if the operation failed)
  *
  * @note Displays user messages through msg_viewer during the metadata retrieval process.
- *       Closes and reopens the database file after adding records to ensure data is
- *       properly written to storage.
  *       Resizes book covers to match coverDim dimensions while maintaining aspect ratio.
  */
 auto BooksDir::loadNewBooksToDb(const char *theTitle, char *bookFilename, int16_t &bookIndex,
-                                BooksDir::SortedIndex &tempIndex) -> std::pair<bool, bool> {
+                                FilenameSet &knownFiles) -> std::pair<bool, bool> {
 
   struct dirent *de = nullptr;
   DIR *          dp           = nullptr;
@@ -598,19 +725,20 @@ auto BooksDir::loadNewBooksToDb(const char *theTitle, char *bookFilename, int16_
     ESP::show_heaps_info();
   #endif
 
-  bool someAddedRecord = false;
-  bool result          = true;
+  HimemVector<HimemString> newFiles;
 
-  int  fileCount = 0;
-  dp            = opendir(BOOKS_FOLDER);
-  while ((de = readdir(dp))) {
-    int16_t size = strlen(de->d_name);
-    if ((size > 5) && (strcasecmp(&de->d_name[size - 5], ".epub") == 0) &&
-        (tempIndex.find(de->d_name) == tempIndex.end())) {
-      fileCount++;
+  if ((dp = opendir(BOOKS_FOLDER)) != nullptr) {
+    while ((de = readdir(dp))) {
+      int16_t size = strlen(de->d_name);
+      if ((size > 5) && (strcasecmp(&de->d_name[size - 5], ".epub") == 0) &&
+          (knownFiles.find(de->d_name) == knownFiles.end())) {
+        newFiles.push_back(de->d_name);
+      }
     }
+    closedir(dp);
   }
-  closedir(dp);
+
+  int fileCount = newFiles.size();
 
   LOG_D("Found {} new book files in the folder.", fileCount);
 
@@ -618,185 +746,54 @@ auto BooksDir::loadNewBooksToDb(const char *theTitle, char *bookFilename, int16_
     return { true, false };
   }
 
-  dp = opendir(BOOKS_FOLDER);
-
   auto [pagerPtr, progressDataPtr] =
     MsgViewer::showProgress("%s Please wait while we retrieve e-books metadata.", theTitle);
 
-  int cptr = 0;
+  auto start = std::chrono::steady_clock::now();
 
-  if (dp != nullptr) {
+  BooksScanner scanner;
+  if (!scanner.start(BOOKS_FOLDER, std::move(newFiles), coverDim)) { return { false, false }; }
 
-    // bool first = true;
+  bool         result = true;
+  int          cptr   = 0;
+  ScannedBooks batch;
 
-    while ((de = readdir(dp))) {
-
-      int16_t size = strlen(de->d_name);
-      if ((size > 5) && (strcasecmp(&de->d_name[size - 5], ".epub") == 0)) {
-
-        HimemString fname = de->d_name;
-
-        // check if ebook file named fname is in the database
-
-        if (tempIndex.find(fname) == tempIndex.end()) {
-
-          // The book is not in the database, we add it now
-
-          // if (first) {
-          //   first = false;
-          //   // MsgViewer::showProgress("Computing new books pages location...");
-          //   if (db->getRecordCount() == 1) {
-          //     MsgViewer::showProgress("E-books metadata retrieval",
-          //                             "System parameters changed requiring metadata retrieval. "
-          //                             "It will take between 5 and 10 seconds for each book.");
-          //   } else {
-          //     MsgViewer::show(
-          //         MsgViewer::MsgType::INFO, false, true, "New e-books metadata retrieval",
-          //         "New e-books have been found (%s). Please wait while we retrieve some metadata.
-          //         " "It will take between 5 and 10 seconds for each e-book.", de->d_name);
-          //   }
-          // }
-
-          someAddedRecord = true;
-
-          LOG_D("New book found: {}", de->d_name);
-
-          fname = BOOKS_FOLDER "/";
-          fname.append(de->d_name);
-
-          int32_t     fileSize = 0;
-          struct stat statBuffer;
-          if (stat(fname.c_str(), &statBuffer) != 0) {
-            LOG_E("Unable to get stats for file: {}", fname);
-            result = false;
-            break;
-          } else {
-            fileSize = statBuffer.st_size;
-          }
+  while (auto scanned = scanner.next()) {
 
-          LOG_D("Opening file through the EPub class: {}", fname);
-
-          auto epub = EPub::Make();
-
-          if (epub->open(fname)) {
-            HimemString filename = epub->getCoverFilename();
-
-            PicturePtr  pict;
-            if (!filename.empty()) {
-
-              // LOG_D("Cover filename: {}", filename);
-              pict = epub->getPicture(filename, true);
-              if (!pict) {
-                LOG_D("Unable to retrieve cover file: {}", filename);
-                pict = PictureFactory::create(defaultCoverDim, defaultCover,
-                                              defaultCoverDim.width * defaultCoverDim.height);
-              }
-            } else {
-              pict = PictureFactory::create(defaultCoverDim, defaultCover,
-                                            defaultCoverDim.width * defaultCoverDim.height);
-            }
-            LOG_D("Picture: width: {} height: {}", pict->getDim().width, pict->getDim().height);
-
-            int32_t w = coverDim.width;
-            int32_t h = pict->getDim().height * coverDim.width / pict->getDim().width;
-
-            if (h > coverDim.height) {
-              h = coverDim.height;
-              w = pict->getDim().width * coverDim.height / pict->getDim().height;
-            }
-
-            pict->convert_to_4bpp();
-            pict->resize(Dim(w, h));
-
-            auto           bookRecordSize    = sizeof(EBookRecord) + w * h;
-            EBookRecordPtr theBook = EBookRecord::Make(bookRecordSize);
-
-            if (!theBook) {
-              LOG_E("Not enough memory for new book: {} bytes required.", bookRecordSize);
-              result = false;
-              break;
-            }
-
-            memset((void *)theBook.get(), 0, sizeof(EBookRecord));
-            memcpy(theBook->coverBitmap, pict->getBitmap(), w * h);
-
-            theBook->coverDim = Dim(w, h);
-
-            LOG_D("Retrieving metadata");
-            strlcpy(theBook->filename, de->d_name, FILENAME_SIZE);
-            theBook->fileSize = fileSize;
-            theBook->id       = generateId((uint8_t *)theBook->filename, strlen(theBook->filename));
-
-            const char *str;
-
-            if ((str = epub->getTitle())) { strlcpy(theBook->title, str, TITLE_SIZE); }
-            if ((str = epub->getAuthor())) { strlcpy(theBook->author, str, AUTHOR_SIZE); }
-            if ((str = epub->getDescription())) {
-              strlcpy(theBook->description, str, DESCRIPTION_SIZE);
-            }
-
-            if (!db->addRecord(theBook.get(), bookRecordSize)) {
-              LOG_E("Unable to add a new record to DB file.");
-              result = false;
-              break;
-            }
-
-            uint16_t idx = db->getRecordCount() - 1;
-            #if EPUB_INKPLATE_BUILD
-              int8_t      pos        = nvsMgr.getPos(theBook->id);
-              HimemString title = " ";
-              title += theBook->title;
-              title.front() = (pos >= 0) ? 'a' + pos : 'z';
-            #else
-              HimemString title = "z";
-              title += theBook->title;
-            #endif
-            sortedIndex[title] = { .id = theBook->id, .dbIndex = idx };
-
-            if (bookFilename) {
-              if (strcmp(bookFilename, theBook->filename) == 0) {
-                bookIndex = db->getRecordCount() - 1;
-              }
-            }
-
-            epub->closeFile();
-
-            #if EPUB_INKPLATE_BUILD && (LOG_LOCAL_LEVEL == ESP_LOG_VERBOSE)
-              ESP::show_heaps_info();
-            #endif
-          }
-
-          if (pagerPtr) {
-            ++cptr;
-            if (cptr <= fileCount) {
-              std::tie(pagerPtr, progressDataPtr) = MsgViewer::updateProgress(
-                std::move(pagerPtr), std::move(progressDataPtr), (cptr * 100) / (fileCount + 1),
-                "%d / %d", cptr, fileCount);
-            }
-          }
-        }
+    if (scanned->ok) {
+      LOG_D("New book scanned: {}", scanned->entry.book.filename);
+      batch.push_back(std::move(scanned));
+      if ((batch.size() >= BATCH_SIZE) && !(result = commitBatch(batch, bookFilename, bookIndex))) {
+        break;
       }
     }
 
     if (pagerPtr) {
-      std::tie(pagerPtr, progressDataPtr) =
-        MsgViewer::updateProgress(std::move(pagerPtr), std::move(progressDataPtr), 100,
-                                  "Completing... Writing to the SD Card...");
+      ++cptr;
+      if (cptr <= fileCount) {
+        std::tie(pagerPtr, progressDataPtr) = MsgViewer::updateProgress(
+          std::move(pagerPtr), std::move(progressDataPtr), (cptr * 100) / (fileCount + 1),
+          "%d / %d", cptr, fileCount);
+      }
     }
-
-    closedir(dp);
   }
 
-  if (someAddedRecord) {
+  if (scanner.failed()) { result = false; }
+  scanner.stop();
 
-    db->close(); // To ensure that data is well written on SD Card
-    if (!db->open(BOOKS_DIR_FILE)) {
-      LOG_E("Unable to open db file");
-      result = false;
-    }
+  if (pagerPtr) {
+    std::tie(pagerPtr, progressDataPtr) =
+      MsgViewer::updateProgress(std::move(pagerPtr), std::move(progressDataPtr), 100,
+                                "Completing... Writing to the SD Card...");
   }
 
-  return { result, someAddedRecord };
+  if (result && !batch.empty()) { result = commitBatch(batch, bookFilename, bookIndex); }
+
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  LOG_I("{} new books scanned in {:.1f} s: {:.1f} books/minute", fileCount, secs,
+        (secs > 0) ? (fileCount * 60.0 / secs) : 0.0);
+
+  return { result, true };
 }
 
 /**
@@ -839,7 +836,7 @@ auto BooksDir::refresh(char *bookFilename, int16_t &bookIndex, bool forceInit) -
   pageLocs.stopControlTask();
   bookController.leave(true); // true -> reset epub
 
-  SortedIndex tempIndex;
+  FilenameSet knownFiles;
 
   sortedIndex.clear();
 
@@ -856,7 +853,7 @@ auto BooksDir::refresh(char *bookFilename, int16_t &bookIndex, bool forceInit) -
 
   } else {
 
-    checkDbContent(bookFilename, bookIndex, tempIndex);
+    checkDbContent(bookFilename, bookIndex, knownFiles);
   }
 
   if (db->someRecordsWereDeleted()) {
@@ -865,46 +862,61 @@ auto BooksDir::refresh(char *bookFilename, int16_t &bookIndex, bool forceInit) -
     // with the cleaned records
 
     if (!cleanupDb(bookFilename, bookIndex)) {
-      tempIndex.clear();
+      sortedIndex.build();
+      return false;
+    }
+  }
+
+  // The cover size may have been changed with no book in the database
+
+  if (!covers->isOpen() || (covers->getCapacity() != coverCapacity())) {
+    if (!covers->create(COVERS_FILE, coverCapacity())) {
+      LOG_E("Unable to create covers store: {}", COVERS_FILE);
+      sortedIndex.build();
       return false;
     }
   }
 
   // Find ebooks that are new since last database refresh
 
-  auto [result, someAddedRecord] = loadNewBooksToDb(theTitle, bookFilename, bookIndex, tempIndex);
+  auto [result, someAddedRecord] = loadNewBooksToDb(theTitle, bookFilename, bookIndex, knownFiles);
+
+  // All sort orders are built now, the books list is then paged without sorting.
 
-  tempIndex.clear();
+  int8_t sortOrder = 0;
+  config.get(Config::Ident::BOOKS_SORT, &sortOrder);
+  sortedIndex.setSortOrder(static_cast<BooksIndex::SortOrder>(sortOrder));
+  sortedIndex.build();
 
   return result;
 }
 
 auto BooksDir::showDb() -> void {
   #if DEBUGGING
-    VersionRecord  versionRecord;
-    EBookRecordPtr book;
+    VersionRecord versionRecord;
+    BookEntry     entry;
 
     if (!db->gotoFirst()) { return; }
 
     if (!db->getRecord(&versionRecord, sizeof(VersionRecord))) { return; }
 
     std::cout << "DB Version: " << versionRecord.version << " app: " << versionRecord.appName
-              << " record count: " << db->getRecordCount() - 1 << std::endl;
+              << " record count: " << db->getRecordCount() - 1
+              << " cover slots: " << covers->getSlotCount() << std::endl;
 
     while (db->gotoNext()) {
       size_t recordSize = db->getRecordSize();
-      if (recordSize >= sizeof(EBookRecord)) {
-        book = EBookRecord::Make(recordSize);
-        if (!db->getRecord(book.get(), recordSize)) { return; }
-        std::cout << "Book: " << book->filename << std::endl
-                  << "  id: " << book->id << std::endl
-                  << "  title: " << book->title << std::endl
-                  << "  author: " << book->author << std::endl
-                  << "  description: " << book->description << std::endl
-                  << "  bitmap size: " << +book->coverDim.width << " " << +book->coverDim.height
-                  << std::endl;
+      if (recordSize == sizeof(BookEntry)) {
+        if (!db->getRecord(&entry, recordSize)) { return; }
+        std::cout << "Book: " << entry.book.filename << std::endl
+                  << "  id: " << entry.book.id << std::endl
+                  << "  title: " << entry.book.title << std::endl
+                  << "  author: " << entry.book.author << std::endl
+                  << "  description: " << entry.description << std::endl
+                  << "  bitmap size: " << +entry.book.coverDim.width << " "
+                  << +entry.book.coverDim.height << " slot: " << entry.book.coverSlot << std::endl;
       } else {
-        std::cout << "Record size too small: " << recordSize << std::endl;
+        std::cout << "Record size not of the current version: " << recordSize << std::endl;
         continue;
       }
     }
@@ -7,8 +7,11 @@
 #include "global.hpp"
 #include "himem.hpp"
 #include "simple_db.hpp"
+#include "slot_store.hpp"
 
+#include "models/books_index.hpp"
 #include "models/epub.hpp"
+#include "picture.hpp"
 
 #include <algorithm>
 #include <fstream>
@@ -16,6 +19,8 @@
 #include <utility>
 #include <vector>
 
+struct ScannedBook;
+
 /**
  * @brief Books Directory class
  *
@@ -26,7 +31,7 @@
  */
 class BooksDir {
 public:
-  static constexpr uint16_t BOOKS_DIR_DB_VERSION = 7;
+  static constexpr uint16_t BOOKS_DIR_DB_VERSION = 8;
 
   static constexpr uint8_t FILENAME_SIZE     = 128;
   static constexpr uint8_t TITLE_SIZE        = 128;
@@ -46,57 +51,44 @@ public:
  * @brief Single EBook Record
  *
  * This represents the meta-data contained in the database for each epub book.
- * These are required to present the list of books to the user.
+ * These are required to present the list of books to the user. The record is
+ * of fixed width: the cover bitmap is kept in the covers store, in the slot
+ * indicated by coverSlot, and is retrieved with *getCover()* when required.
  * One element is not present in the structure: the list of pages location.
  * The *get_page_locs()* method is retrieving the pages location when required
  * by the epub class.
  */
 #pragma pack(push, 1)
-  class EBookRecord;
-  using EBookRecordPtr = HimemUniquePtr<EBookRecord>;
-
   class EBookRecord {
-  private:
-    EBookRecord() = default;
-
   public:
+    char filename[FILENAME_SIZE]; ///< Ebook filename, no folder
+                                  ///  MUST STAY AS FIRST ITEM IN EBookRecord
+    int32_t fileSize;             ///< File size in bytes
+    uint32_t id;                  ///< (Almost) Unique id computed from the filename
+    char title[TITLE_SIZE];       ///< Title from epub meta-data
+    char author[AUTHOR_SIZE];     ///< Author from epub meta-data
+    Dim coverDim;                 ///< Dimensions of the cover bitmap
+    uint16_t coverSlot;           ///< Slot of the cover bitmap in the covers store
+
+    EBookRecord()  = default;
     ~EBookRecord() = default;
-
-    template <typename T>
-      requires(!std::is_array_v<T>)
-    friend auto makeUniqueHimem(himemSizedT sz) -> HimemUniquePtr<T>;
-
-    static inline auto Make(int32_t size) -> HimemUniquePtr<EBookRecord> {
-      if (size >= static_cast<int32_t>(sizeof(EBookRecord))) {
-        return makeUniqueHimem<EBookRecord>(himemSized(size));
-      }
-      return nullptr;
-    }
-
-    char filename[FILENAME_SIZE];       ///< Ebook filename, no folder
-                                        ///  MUST STAY AS FIRST ITEM IN EBookRecord
-    int32_t fileSize;                   ///< File size in bytes
-    uint32_t id;                        ///< (Almost) Unique id computed from the filename
-    char title[TITLE_SIZE];             ///< Title from epub meta-data
-    char author[AUTHOR_SIZE];           ///< Author from epub meta-data
-    char description[DESCRIPTION_SIZE]; ///< Description from epub meta-data
-    Dim coverDim;                       ///< Dimensions of the cover bitmap
-    uint8_t coverBitmap[];              ///< Cover bitmap shrinked for books list presentation
+    static inline auto Make() { return makeUniqueHimem<EBookRecord>(); }
 
     auto coverSize() const -> uint32_t { return coverDim.width * coverDim.height; }
   };
+  using EBookRecordPtr = HimemUniquePtr<EBookRecord>;
 
-  class PartialRecord {
+  // A database record is the EBookRecord followed by the description, rarely used.
+  // Reading the EBookRecord alone is enough to present the list of books.
+  class BookEntry {
   public:
-    char filename[FILENAME_SIZE];
-    int32_t fileSize;
-    uint32_t id;
-    char title[TITLE_SIZE];
-    PartialRecord()  = default;
-    ~PartialRecord() = default;
-    static inline auto Make() { return makeUniqueHimem<PartialRecord>(); }
+    EBookRecord book;
+    char description[DESCRIPTION_SIZE]; ///< Description from epub meta-data
+    BookEntry()  = default;
+    ~BookEntry() = default;
+    static inline auto Make() { return makeUniqueHimem<BookEntry>(); }
   };
-  using PartialRecordPtr = HimemUniquePtr<PartialRecord>;
+  using BookEntryPtr = HimemUniquePtr<BookEntry>;
 
   // The version record is used to identify the version of the database. In case of structure
   // update, the version will be changed in the application and will trigger the reconstruction of
@@ -116,42 +108,41 @@ public:
 #pragma pack(pop)
 
 private:
-  static constexpr char const *TAG            = "BooksDir";
-  static constexpr char const *BOOKS_DIR_FILE = MAIN_FOLDER "/books_dir.db";
-  static constexpr char const *NEW_DIR_FILE   = MAIN_FOLDER "/new_dir.db";
-  static constexpr char const *APP_NAME       = "EPUB-INKPLATE";
-
-  SimpleDBPtr db; ///< The SimpleDB database
-
-  /// @struct IndexInfo
-  /// @brief Stores index information for book entries in the database.
-  ///
-  /// This struct maintains a mapping between a book's unique identifier and its
-  /// corresponding database index position, allowing efficient lookup and retrieval
-  /// of book data from the database.
-  ///
-  /// @var IndexInfo::id
-  ///   The unique identifier for the book entry.
-  ///
-  /// @var IndexInfo::dbIndex
-  ///   The index position of this entry in the database.
-  struct IndexInfo {
-    uint32_t id;
-    uint16_t dbIndex;
-  };
+  static constexpr char const *TAG             = "BooksDir";
+  static constexpr char const *BOOKS_DIR_FILE  = MAIN_FOLDER "/books_dir.db";
+  static constexpr char const *NEW_DIR_FILE    = MAIN_FOLDER "/new_dir.db";
+  static constexpr char const *COVERS_FILE     = MAIN_FOLDER "/books_covers.db";
+  static constexpr char const *NEW_COVERS_FILE = MAIN_FOLDER "/new_covers.db";
+  static constexpr char const *APP_NAME        = "EPUB-INKPLATE";
+
+  static constexpr uint16_t V7_DB_VERSION = 7; ///< Covers inside the records, migrated
+
+  static constexpr uint8_t BATCH_SIZE = 8; ///< New books written to the SD Card at once
+
+  SimpleDBPtr db;      ///< The SimpleDB database
+  SlotStorePtr covers; ///< The cover bitmaps, one slot of coverDim size per book
+
+  using FilenameSet  = HimemSet<HimemString>; ///< Filenames of the books found in the database
+  using ScannedBooks = HimemVector<HimemUniquePtr<ScannedBook>>;
 
-  using SortedIndex = HimemMap<HimemString, IndexInfo>; ///< Sorted map of book names and indexes.
-  SortedIndex sortedIndex; ///< Books index pointing at the db index of each book
+  BooksIndex sortedIndex; ///< Books index pointing at the db index of each book, in every order
 
   auto clearDb() -> void;
   auto setCoverSize() -> void;
-  auto checkDbContent(char *bookFilename, int16_t &bookIndex, SortedIndex &tempIndex) -> void;
+  [[nodiscard]] static inline auto coverCapacity() -> uint32_t {
+    return coverDim.width * coverDim.height;
+  }
+  auto addVersionRecord(SimpleDB &theDb) -> bool;
+  auto migrateFromV7() -> bool;
+  auto posOf(uint32_t id) -> int8_t;
+  auto checkDbContent(char *bookFilename, int16_t &bookIndex, FilenameSet &knownFiles) -> void;
   auto cleanupDb(char *bookFilename, int16_t &bookIndex) -> bool;
+  auto commitBatch(ScannedBooks &batch, char *bookFilename, int16_t &bookIndex) -> bool;
   auto loadNewBooksToDb(const char *theTitle, char *bookFilename, int16_t &bookIndex,
-                        SortedIndex &tempIndex) -> std::pair<bool, bool>;
+                        FilenameSet &knownFiles) -> std::pair<bool, bool>;
 
 public:
-  BooksDir() : db(SimpleDB::Make()) {}
+  BooksDir() : db(SimpleDB::Make()), covers(SlotStore::Make()) {}
   ~BooksDir() {
     sortedIndex.clear();
     closeDb();
@@ -167,7 +158,9 @@ public:
   /**
    * @brief Get an ebook meta-data
    *
-   * This method retrieve the meta-data related to an ebook index.
+   * This method retrieve the meta-data related to an ebook index. The index is
+   * translated to a database record index in constant time. Neither the description
+   * nor the cover bitmap are read.
    *
    * @param idx The index is a sequential number in the sorted list of ebooks, ranging 0 ..
    * getBookCount()-1.
@@ -176,32 +169,32 @@ public:
    * retrieve the data.
    */
   auto getBookData(uint16_t idx) -> EBookRecordPtr;
+
+  /**
+   * @brief Get the cover of an ebook
+   *
+   * The bitmap is read from the covers store with a single seek and read.
+   *
+   * @param book The ebook meta-data, from getBookData().
+   * @return PicturePtr The 4 bits per pixel cover, or nullptr if not able to retrieve it.
+   */
+  auto getCover(const EBookRecord &book) -> PicturePtr;
   // auto getBookDataFromDbIndex(uint16_t idx) -> EBookRecordPtr;
   auto getBookId(uint16_t idx, uint32_t &id) -> bool;
   auto getBookIndex(uint32_t id, uint16_t &idx) -> bool;
   auto setTrackOrder(uint32_t id, int8_t pos) -> void;
 
-  auto getSortedIdx(uint16_t dbIdx) -> int16_t {
-    int i = 0;
-    for (auto &entry : sortedIndex) {
-      if (entry.second.dbIndex == dbIdx) {
-        return i;
-      }
-      ++i;
-    }
-    return -1;
-  }
+  auto getSortedIdx(uint16_t dbIdx) -> int16_t { return sortedIndex.sortedIdxOfDbIndex(dbIdx); }
 
-  auto getSortedIdxFromId(uint32_t id) -> int16_t {
-    int i = 0;
-    for (auto entry : sortedIndex) {
-      if (entry.second.id == id) {
-        return i;
-      }
-      ++i;
-    }
-    return -1;
-  }
+  auto getSortedIdxFromId(uint32_t id) -> int16_t { return sortedIndex.sortedIdxOfId(id); }
+
+  /**
+   * @brief Select the order of the books list
+   *
+   * All orders are built by refresh(): changing the order is done without
+   * reading the database. The sorted indexes of the books change.
+   */
+  auto setSortOrder(BooksIndex::SortOrder order) -> void { sortedIndex.setSortOrder(order); }
 
   static Dim coverDim;
 
@@ -215,7 +208,9 @@ public:
    * the database are not scanned again).
    *
    * A version record is present in the database. In case of structure update, the version will be
-   * changed in the application and will trigger the reconstruction of the database.
+   * changed in the application and will trigger the reconstruction of the database. A database
+   * of version 7, with the covers inside the records, is migrated instead. The cover bitmaps are
+   * kept in a separate covers store, of the cover size selected in the configuration.
    *
    * Each book is identified using the file name and the file size.
    *
@@ -246,6 +241,7 @@ public:
    */
   auto closeDb() -> void {
     if (db) db->close();
+    if (covers) covers->close();
   }
 
   auto showDb() -> void;
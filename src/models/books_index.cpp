@@ -0,0 +1,117 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/books_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+auto BooksIndex::clear() -> void {
+  books.clear();
+  for (auto &order : orders) { order.clear(); }
+  ranks.clear();
+  positions.clear();
+}
+
+auto BooksIndex::add(uint32_t id, uint16_t dbIndex, const char *title, const char *author,
+                     int8_t pos) -> void {
+  positions.emplace(id, (uint16_t)books.size()); // The first book of an id is kept
+  books.push_back(Book{ .title   = title,
+                        .author  = author,
+                        .id      = id,
+                        .dbIndex = dbIndex,
+                        .pos     = pos });
+}
+
+auto BooksIndex::less(SortOrder order, uint16_t a, uint16_t b) const -> bool {
+  const Book &x = books[a];
+  const Book &y = books[b];
+  int         res;
+
+  switch (order) {
+    case SortOrder::RECENTLY_READ: {
+      // Same key as the former title map: 'a' + pos for recently read books, 'z' otherwise.
+      char kx = (x.pos >= 0) ? 'a' + x.pos : 'z';
+      char ky = (y.pos >= 0) ? 'a' + y.pos : 'z';
+      if (kx != ky) { return kx < ky; }
+      res = std::strcmp(x.title.c_str(), y.title.c_str());
+      break;
+    }
+    case SortOrder::TITLE:
+      if ((res = std::strcmp(x.title.c_str(), y.title.c_str())) == 0) {
+        res = std::strcmp(x.author.c_str(), y.author.c_str());
+      }
+      break;
+    case SortOrder::AUTHOR:
+      if ((res = std::strcmp(x.author.c_str(), y.author.c_str())) == 0) {
+        res = std::strcmp(x.title.c_str(), y.title.c_str());
+      }
+      break;
+    default:
+      res = 0;
+  }
+  return (res != 0) ? (res < 0) : (a < b);
+}
+
+auto BooksIndex::build() -> void {
+  for (uint8_t o = 0; o < SORT_ORDER_COUNT; ++o) {
+    Order &order = orders[o];
+    order.resize(books.size());
+    for (uint16_t i = 0; i < order.size(); ++i) { order[i] = i; }
+    std::sort(order.begin(), order.end(),
+              [this, o](uint16_t a, uint16_t b) { return less((SortOrder)o, a, b); });
+  }
+  rankBooks();
+}
+
+auto BooksIndex::rankBooks() -> void {
+  const Order &order = orders[(uint8_t)sortOrder];
+  ranks.resize(order.size());
+  for (uint16_t i = 0; i < order.size(); ++i) { ranks[order[i]] = i; }
+}
+
+auto BooksIndex::setSortOrder(SortOrder order) -> void {
+  if ((uint8_t)order >= SORT_ORDER_COUNT) { order = SortOrder::RECENTLY_READ; }
+  if (order != sortOrder) {
+    sortOrder = order;
+    rankBooks();
+  }
+}
+
+auto BooksIndex::sortedIdxOfId(uint32_t id) const -> int16_t {
+  auto it = positions.find(id);
+  return ((it != positions.end()) && (it->second < ranks.size())) ? ranks[it->second] : NOT_FOUND;
+}
+
+auto BooksIndex::sortedIdxOfDbIndex(uint16_t dbIndex) const -> int16_t {
+  for (uint16_t i = 0; i < ranks.size(); ++i) {
+    if (books[i].dbIndex == dbIndex) { return ranks[i]; }
+  }
+  return NOT_FOUND;
+}
+
+auto BooksIndex::setPos(uint32_t id, int8_t pos) -> bool {
+  auto it = positions.find(id);
+  if (it == positions.end()) { return false; }
+
+  uint16_t book = it->second;
+  if (books[book].pos == pos) { return true; }
+  if (book >= ranks.size()) { // Not sorted yet: the next build() will place it.
+    books[book].pos = pos;
+    return true;
+  }
+
+  // Take the book out of the RECENTLY_READ order and put it back at its new place.
+  Order &order = orders[(uint8_t)SortOrder::RECENTLY_READ];
+  order.erase(std::find(order.begin(), order.end(), book));
+  books[book].pos = pos;
+  order.insert(std::upper_bound(order.begin(), order.end(), book,
+                                [this](uint16_t a, uint16_t b) {
+                                  return less(SortOrder::RECENTLY_READ, a, b);
+                                }),
+               book);
+
+  if (sortOrder == SortOrder::RECENTLY_READ) { rankBooks(); }
+  return true;
+}
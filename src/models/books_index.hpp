@@ -0,0 +1,100 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+/**
+ * class BooksIndex - Sorted index of the books of the library
+ *
+ * The books are kept in a contiguous vector in the order they are added
+ * (the database order). Every sort order is a vector of positions in that
+ * vector, built once by build(), so that the book at a sorted index is
+ * reached with two indexing operations. An id to position hash table and
+ * the rank of every book in the current sort order give the sorted index
+ * of a book in constant time.
+ *
+ * The RECENTLY_READ order puts the books tracked by the NVS manager first,
+ * most recent first, then the other ones by title. TITLE and AUTHOR sort
+ * by these fields, the other one breaking ties. Equal books stay in the
+ * database order.
+ *
+ * This class is not thread-safe. BooksDir is used by the main task only.
+ */
+class BooksIndex {
+  public:
+    enum class SortOrder : uint8_t { RECENTLY_READ, TITLE, AUTHOR };
+    static constexpr uint8_t SORT_ORDER_COUNT = 3;
+
+    static constexpr int16_t NOT_FOUND = -1;
+
+    BooksIndex() = default;
+
+    auto clear() -> void;
+    auto reserve(uint16_t count) -> void { books.reserve(count); }
+
+    /**
+     * Add a book. It is part of the sort orders once build() is called.
+     *
+     * @param pos Position of the book in the recently read list, -1 if not in it.
+     */
+    auto add(uint32_t id, uint16_t dbIndex, const char *title, const char *author, int8_t pos)
+    -> void;
+
+    /// Sort the books added since the last clear() in every sort order.
+    auto build() -> void;
+
+    auto setSortOrder(SortOrder order) -> void;
+    [[nodiscard]] inline auto getSortOrder() const -> SortOrder { return sortOrder; }
+
+    /// Number of books in the sort orders.
+    [[nodiscard]] inline auto size() const -> int16_t { return ranks.size(); }
+
+    /// Database index of the book at a sorted index, or NOT_FOUND.
+    [[nodiscard]] inline auto dbIndexAt(uint16_t idx) const -> int16_t {
+      return (idx < ranks.size()) ? books[orders[(uint8_t)sortOrder][idx]].dbIndex : NOT_FOUND;
+    }
+
+    [[nodiscard]] inline auto idAt(uint16_t idx, uint32_t &id) const -> bool {
+      if (idx >= ranks.size()) { return false; }
+      id = books[orders[(uint8_t)sortOrder][idx]].id;
+      return true;
+    }
+
+    /// Sorted index of a book, or NOT_FOUND.
+    [[nodiscard]] auto sortedIdxOfId(uint32_t id) const -> int16_t;
+
+    /// Sorted index of the book at a database index, or NOT_FOUND.
+    [[nodiscard]] auto sortedIdxOfDbIndex(uint16_t dbIndex) const -> int16_t;
+
+    /**
+     * Change the position of a book in the recently read list, moving it in
+     * the RECENTLY_READ order.
+     *
+     * @return false if the book is not in the index.
+     */
+    auto setPos(uint32_t id, int8_t pos) -> bool;
+
+  private:
+    struct Book {
+      HimemString title;
+      HimemString author;
+      uint32_t id;
+      uint16_t dbIndex;
+      int8_t pos;
+    };
+
+    using Order = HimemVector<uint16_t>; ///< Positions in books
+
+    HimemVector<Book> books;
+    Order orders[SORT_ORDER_COUNT];
+    Order ranks; ///< Sorted index of every book in the current sort order
+    HimemUnorderedMap<uint32_t, uint16_t> positions; ///< Id to position in books
+    SortOrder sortOrder{ SortOrder::RECENTLY_READ };
+
+    [[nodiscard]] auto less(SortOrder order, uint16_t a, uint16_t b) const -> bool;
+    auto rankBooks() -> void;
+};
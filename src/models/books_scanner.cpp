@@ -0,0 +1,185 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/books_scanner.hpp"
+
+#include "models/default_cover.hpp"
+#include "models/epub.hpp"
+#include "picture_factory.hpp"
+
+#if EPUB_INKPLATE_BUILD
+  #include "esp.hpp"
+#endif
+
+#include <sys/stat.h>
+
+auto BooksScanner::start(const char *theFolder, HimemVector<HimemString> &&theFilenames,
+                         Dim theCoverDim) -> bool {
+  stop();
+
+  folder        = theFolder;
+  filenames     = std::move(theFilenames);
+  coverDim      = theCoverDim;
+  finished      = false;
+  stopRequested = false;
+  outOfMemory   = false;
+
+  #if EPUB_LINUX_BUILD
+    worker = std::thread(&BooksScanner::task, this);
+  #else
+    if (pdPASS != xTaskCreatePinnedToCore(
+          [](void *param) {
+    static_cast<BooksScanner *>(param)->task();
+    vTaskDelete(nullptr);
+  }, "scannerTask", 25 * 1024, this, (configMAX_PRIORITIES - 2) | portPRIVILEGE_BIT,
+          &workerHandle, 1)) {
+      LOG_E("Unable to create scanner task");
+      return false;
+    }
+  #endif
+
+  started = true;
+  return true;
+}
+
+auto BooksScanner::task() -> void {
+  for (auto &filename : filenames) {
+    {
+      std::unique_lock lock(mutex);
+      cv.wait(lock, [this] { return stopRequested || (ready.size() < QUEUE_SIZE); });
+      if (stopRequested) { break; }
+    }
+
+    ScannedBookPtr book = scan(folder, filename, coverDim);
+
+    std::scoped_lock guard(mutex);
+    if (!book) {
+      outOfMemory = true;
+      break;
+    }
+    ready.push_back(std::move(book));
+    cv.notify_all();
+  }
+
+  std::scoped_lock guard(mutex);
+  finished = true;
+  cv.notify_all();
+}
+
+auto BooksScanner::next() -> ScannedBookPtr {
+  std::unique_lock lock(mutex);
+  if (!started) { return nullptr; }
+
+  cv.wait(lock, [this] { return !ready.empty() || finished; });
+  if (ready.empty()) { return nullptr; }
+
+  ScannedBookPtr book = std::move(ready.front());
+  ready.pop_front();
+  cv.notify_all();
+  return book;
+}
+
+auto BooksScanner::stop() -> void {
+  if (!started) { return; }
+
+  {
+    std::unique_lock lock(mutex);
+    stopRequested = true;
+    cv.notify_all();
+    cv.wait(lock, [this] { return finished; });
+  }
+
+  #if EPUB_LINUX_BUILD
+    if (worker.joinable()) { worker.join(); }
+  #else
+    while (eTaskGetState(workerHandle) != eDeleted) { vTaskDelay(pdMS_TO_TICKS(10)); }
+  #endif
+
+  ready.clear();
+  started = false;
+}
+
+auto BooksScanner::scan(const HimemString &folder, const HimemString &filename, Dim coverDim)
+-> ScannedBookPtr {
+
+  ScannedBookPtr book = makeUniqueHimem<ScannedBook>();
+  if (!book) {
+    LOG_E("Not enough memory for new book: {} bytes required.", sizeof(ScannedBook));
+    return nullptr;
+  }
+
+  memset((void *)&book->entry, 0, sizeof(BooksDir::BookEntry));
+
+  HimemString fname = folder + "/" + filename;
+
+  struct stat statBuffer;
+  if (stat(fname.c_str(), &statBuffer) != 0) {
+    LOG_E("Unable to get stats for file: {}", fname);
+    return book;
+  }
+
+  LOG_D("Opening file through the EPub class: {}", fname);
+
+  auto epub = EPub::Make();
+  if (!epub) {
+    LOG_E("Not enough memory to open book: {}", fname);
+    return nullptr;
+  }
+
+  if (!epub->open(fname)) { return book; }
+
+  const char *coverFilename = epub->getCoverFilename();
+  HimemString coverName     = (coverFilename != nullptr) ? coverFilename : "";
+
+  PicturePtr  pict;
+  if (!coverName.empty()) {
+
+    // LOG_D("Cover filename: {}", coverName);
+    pict = epub->getPicture(coverName, true);
+    if (!pict) { LOG_D("Unable to retrieve cover file: {}", coverName); }
+  }
+  if (!pict) {
+    pict = PictureFactory::create(defaultCoverDim, defaultCover,
+                                  defaultCoverDim.width * defaultCoverDim.height);
+    if (!pict) { return nullptr; }
+  }
+  LOG_D("Picture: width: {} height: {}", pict->getDim().width, pict->getDim().height);
+
+  int32_t w = coverDim.width;
+  int32_t h = pict->getDim().height * coverDim.width / pict->getDim().width;
+
+  if (h > coverDim.height) {
+    h = coverDim.height;
+    w = pict->getDim().width * coverDim.height / pict->getDim().height;
+  }
+
+  pict->convert_to_4bpp();
+  pict->resize(Dim(w, h));
+
+  BooksDir::EBookRecord &record = book->entry.book;
+
+  record.coverDim = Dim(w, h);
+  book->cover     = std::move(pict);
+
+  LOG_D("Retrieving metadata");
+  strlcpy(record.filename, filename.c_str(), BooksDir::FILENAME_SIZE);
+  record.fileSize = statBuffer.st_size;
+
+  const char *str;
+
+  if ((str = epub->getTitle())) { strlcpy(record.title, str, BooksDir::TITLE_SIZE); }
+  if ((str = epub->getAuthor())) { strlcpy(record.author, str, BooksDir::AUTHOR_SIZE); }
+  if ((str = epub->getDescription())) {
+    strlcpy(book->entry.description, str, BooksDir::DESCRIPTION_SIZE);
+  }
+
+  epub->closeFile();
+  book->ok = true;
+
+  #if EPUB_INKPLATE_BUILD && (LOG_LOCAL_LEVEL == ESP_LOG_VERBOSE)
+    ESP::show_heaps_info();
+  #endif
+
+  return book;
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include "models/books_dir.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#if EPUB_LINUX_BUILD
+  #include <thread>
+#else
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+#endif
+
+/// Meta-data and cover of a book retrieved by the BooksScanner
+struct ScannedBook {
+  bool ok{ false };            ///< false if the book cannot be opened
+  BooksDir::BookEntry entry;   ///< All but id and coverSlot are set
+  PicturePtr cover{ nullptr }; ///< 4 bits per pixel, of entry.book.coverDim
+};
+using ScannedBookPtr = HimemUniquePtr<ScannedBook>;
+
+/**
+ * class BooksScanner - Retrieval of the meta-data and cover of new books
+ *
+ * Opening a book, parsing its OPF and decoding and resizing its cover takes
+ * seconds per book on the device. The scanner does it on a worker (on the
+ * second core of the ESP32) while the caller writes the books already
+ * scanned to the database and updates the progress page.
+ *
+ * The books are delivered by next() in the order of the file names given
+ * to start(). The worker keeps at most QUEUE_SIZE books ahead of the
+ * caller.
+ *
+ * There is a single worker: the EPub class and the pictures read the book
+ * through the global unzip instance, so only one book can be open at a
+ * time.
+ */
+class BooksScanner {
+  public:
+    static constexpr uint8_t QUEUE_SIZE = 4;
+
+    BooksScanner() = default;
+    BooksScanner(const BooksScanner &)            = delete;
+    BooksScanner &operator=(const BooksScanner &) = delete;
+    ~BooksScanner() { stop(); }
+
+    /**
+     * @brief Start scanning books
+     *
+     * @param folder The folder of the books.
+     * @param filenames The book file names, no folder.
+     * @param coverDim The largest cover size. Covers keep their aspect ratio.
+     * @return false if the worker cannot be started.
+     */
+    auto start(const char *folder, HimemVector<HimemString> &&filenames, Dim coverDim) -> bool;
+
+    /**
+     * @brief The next scanned book, waiting for it if required
+     *
+     * @return nullptr when all books were delivered, or if the worker ran out
+     *         of memory (failed() is true then).
+     */
+    auto next() -> ScannedBookPtr;
+
+    /// Stop the worker and wait for it to end. The books not delivered are dropped.
+    auto stop() -> void;
+
+    [[nodiscard]] inline auto failed() const -> bool { return outOfMemory; }
+
+    /**
+     * @brief Retrieve the meta-data and cover of a book
+     *
+     * This is what the worker does for each book.
+     *
+     * @return nullptr if out of memory.
+     */
+    static auto scan(const HimemString &folder, const HimemString &filename, Dim coverDim)
+    -> ScannedBookPtr;
+
+  private:
+    static constexpr char const *TAG = "BooksScanner";
+
+    HimemString folder;
+    HimemVector<HimemString> filenames;
+    Dim coverDim{ 0, 0 };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<ScannedBookPtr> ready; ///< Scanned books not yet delivered
+    bool started{ false };
+    bool finished{ false };
+    bool stopRequested{ false };
+    bool outOfMemory{ false };
+
+    #if EPUB_LINUX_BUILD
+      std::thread worker;
+    #else
+      TaskHandle_t workerHandle{ nullptr };
+    #endif
+
+    auto task() -> void;
+};
@@ -5,7 +5,9 @@
 #include "models/css.hpp"
 #include "models/css_parser.hpp"
 
-CSS::PropertyMap CSS::propertyMap = {
+#include <algorithm>
+
+constinit const CSS::PropertyMap CSS::propertyMap = {
   { "not-used",       CSS::PropertyId::NOT_USED       },
   { "font-family",    CSS::PropertyId::FONT_FAMILY    },
   { "font-size",      CSS::PropertyId::FONT_SIZE      },
@@ -27,7 +29,7 @@ CSS::PropertyMap CSS::propertyMap = {
   { "border",         CSS::PropertyId::BORDER         },
   { "vertical-align", CSS::PropertyId::VERTICAL_ALIGN } };
 
-CSS::FontSizeMap CSS::fontSizeMap = {
+constinit const CSS::FontSizeMap CSS::fontSizeMap = {
   { "xx-small", 6 }, { "x-small",  7 }, { "smaller",   9 },
   { "small",   10 }, { "medium",  12 }, { "large",    14 },
   { "larger",  15 }, { "x-large", 18 }, { "xx-large", 24 } };
@@ -37,14 +39,15 @@ const char *CSS::valueTypeStr[25] = {
   "",    "em", "ex",   "%",    "",    "px",  "cm",   "mm",   "in",  "pt", "pc",  "vh", "vw",
   "rem", "ch", "vmin", "vmax", "deg", "rad", "grad", "msec", "sec", "hz", "khz", "url" };
 
+thread_local Atoms *CSS::boundAtoms = nullptr;
+
 auto CSS::defaultPools() -> CSSPools & {
   static CSSPools pools;
   return pools;
 }
 
 auto CSS::bindPools(CSSPools &poolsRef) -> void {
-  using Tag                                                       = ScopedListPoolTag;
-  ScopedHimemPoolBinding<CSSPools::ClassListNode, Tag, 256>::pool = &poolsRef.classListPool;
+  using Tag = ScopedListPoolTag;
   ScopedHimemPoolBinding<CSSPools::SelectorNodeListNode, Tag, 512>::pool =
     &poolsRef.selectorNodeListPool;
   ScopedHimemPoolBinding<CSSPools::ValuesNode, Tag, 512>::pool     = &poolsRef.valuesPool;
@@ -56,11 +59,11 @@ auto CSS::bindPools(CSSPools &poolsRef) -> void {
     &poolsRef.selectorSuiteListPool;
   ScopedHimemPoolBinding<CSSPools::SelectorSingleListNode, Tag, 128>::pool =
     &poolsRef.selectorSingleListPool;
+  boundAtoms = &poolsRef.atoms;
 }
 
 auto CSS::unbindPools() -> void {
   using Tag                                                                = ScopedListPoolTag;
-  ScopedHimemPoolBinding<CSSPools::ClassListNode, Tag, 256>::pool          = nullptr;
   ScopedHimemPoolBinding<CSSPools::SelectorNodeListNode, Tag, 512>::pool   = nullptr;
   ScopedHimemPoolBinding<CSSPools::ValuesNode, Tag, 512>::pool             = nullptr;
   ScopedHimemPoolBinding<CSSPools::SelectorsNode, Tag, 256>::pool          = nullptr;
@@ -68,6 +71,7 @@ auto CSS::unbindPools() -> void {
   ScopedHimemPoolBinding<CSSPools::PropertySuiteListNode, Tag, 128>::pool  = nullptr;
   ScopedHimemPoolBinding<CSSPools::SelectorSuiteListNode, Tag, 128>::pool  = nullptr;
   ScopedHimemPoolBinding<CSSPools::SelectorSingleListNode, Tag, 128>::pool = nullptr;
+  boundAtoms                                                               = nullptr;
 }
 
 CSS::PoolsGuard::PoolsGuard(CSSPools &poolsRef) : poolsRef(poolsRef) { bindPools(poolsRef); }
@@ -107,8 +111,21 @@ CSS::CSS(const char *cssId, CSSPools &poolsRef)
   priority   = 0;
 }
 
+CSS::CSS(const char *cssId, const char *fileFolderPath, uint8_t prio, CSSPools &poolsRef)
+  : pools(&poolsRef), guard(new PoolsGuard(poolsRef)) {
+
+  id         = cssId;
+  folderPath = fileFolderPath;
+  ghost      = false;
+  priority   = prio;
+}
+
 CSS::~CSS() {
   rulesMap.clear();
+  idRules.clear();
+  classRules.clear();
+  tagRules.clear();
+  universalRules.clear();
   selectorSuites.clear();
   selectorSingles.clear();
   propertySuites.clear();
@@ -117,24 +134,41 @@ CSS::~CSS() {
   guard = nullptr;
 }
 
+auto CSS::indexRule(Selector *sel, Properties *props) -> void {
+  IndexedRule rule{ sel, props, ruleSeq++ };
+
+  if (sel->selectorNodeList.empty()) {
+    universalRules.push_back(rule);
+    return;
+  }
+
+  // The selectorNodeList is in reverse order: front() is the rightmost simple selector.
+  auto bucket = [](RuleBuckets &buckets, size_t idx) -> RuleBucket & {
+    if (idx >= buckets.size()) { buckets.resize(idx + 1); }
+    return buckets[idx];
+  };
+
+  const SelectorNode &key = sel->selectorNodeList.front();
+  if (key.idCount > 0) {
+    bucket(idRules, key.id).push_back(rule);
+  } else if (!key.classList.empty()) {
+    bucket(classRules, *key.classList.begin()).push_back(rule);
+  } else if ((key.tag != DOM::Tag::NONE) && (key.tag != DOM::Tag::ANY)) {
+    bucket(tagRules, static_cast<size_t>(key.tag)).push_back(rule);
+  } else {
+    universalRules.push_back(rule);
+  }
+}
+
 auto CSS::matchSimpleSelector(DOM::Node &node, SelectorNode &simpleSel) -> bool {
-  if (simpleSel.classCount > 0) {
-    for (auto &selClass : simpleSel.classList) {
-      bool found = false;
-      for (auto &nodeClass : node.classList) {
-        if (selClass.compare(nodeClass.c_str()) == 0) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) { return false; }
-    }
+  for (auto selClass : simpleSel.classList) {
+    if (!node.classList.contains(selClass)) { return false; }
   }
   if ((simpleSel.tag != DOM::Tag::NONE) && (simpleSel.tag != DOM::Tag::ANY) &&
       (simpleSel.tag != node.tag)) {
     return false;
   }
-  if ((simpleSel.idCount > 0) && (simpleSel.id.compare(node.id.c_str()) != 0)) { return false; }
+  if ((simpleSel.idCount > 0) && (simpleSel.id != node.id)) { return false; }
   if ((simpleSel.qualifier == Qualifier::FIRST_CHILD) && !node.firstChild) { return false; }
   return true;
 }
@@ -171,11 +205,39 @@ auto CSS::matchSelector(DOM::Node *node, Selector &sel) -> bool {
   return true;
 }
 
+/**
+ * Only the rules of the buckets the node can hit (its id, each of its
+ * classes, its tag and the universal bucket) are tested with matchSelector().
+ */
 auto CSS::match(DOM::Node *node, RulesMap &toRules) -> void {
-  for (auto &rule : rulesMap) {
-    if (matchSelector(node, *rule.first)) {
-      toRules.insert(std::pair<Selector *, Properties *>(rule.first, rule.second));
+  static thread_local HimemVector<IndexedRule> matched;
+  matched.clear();
+
+  auto collect = [&](const RuleBucket &bucket) {
+    for (const auto &rule : bucket) {
+      if (matchSelector(node, *rule.selector)) { matched.push_back(rule); }
     }
+  };
+
+  if ((node->id != Atoms::NO_ATOM) && (node->id < idRules.size())) { collect(idRules[node->id]); }
+  for (auto nodeClass : node->classList) {
+    if (nodeClass < classRules.size()) { collect(classRules[nodeClass]); }
+  }
+  if (static_cast<size_t>(node->tag) < tagRules.size()) {
+    collect(tagRules[static_cast<size_t>(node->tag)]);
+  }
+  collect(universalRules);
+
+  if (matched.empty()) { return; }
+
+  std::sort(matched.begin(), matched.end(), [](const IndexedRule &r1, const IndexedRule &r2) {
+    return (r1.selector->specificity.value < r2.selector->specificity.value) ||
+           ((r1.selector->specificity.value == r2.selector->specificity.value) &&
+            (r1.seq < r2.seq));
+  });
+
+  for (const auto &rule : matched) {
+    toRules.insert(std::pair<Selector *, Properties *>(rule.selector, rule.properties));
   }
 }
 
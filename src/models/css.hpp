@@ -153,6 +153,9 @@ class CSS {
     CSSPools *pools;
     PoolsGuard *guard;
 
+    // Atom table of the currently bound pools, used by the show() methods.
+    static thread_local Atoms *boundAtoms;
+
     HimemString id;       // Unique identifier (filename) for this CSS instance
     HimemString folderPath; // Path used for all other files access (relative)
     bool ghost;           // True if this instance rules content came from other instances
@@ -163,6 +166,8 @@ class CSS {
 
     CSS(const char *cssId, CSSPools &poolsRef);
 
+    CSS(const char *cssId, const char *fileFolderPath, uint8_t prio, CSSPools &poolsRef);
+
     CSS(const char *cssId, DOM::Tag tag, const char *buffer, int32_t size, uint8_t prio,
         CSSPools &poolsRef);
 
@@ -181,6 +186,12 @@ class CSS {
       return makeUniqueHimem<CSS>(cssId, poolsRef);
     }
 
+    /// An empty stylesheet, filled with rules by CSSStore::deserialize().
+    static inline auto Make(const char *cssId, const char *fileFolderPath, uint8_t prio,
+                            CSSPools &poolsRef) {
+      return makeUniqueHimem<CSS>(cssId, fileFolderPath, prio, poolsRef);
+    }
+
     static inline auto Make(const char *cssId, DOM::Tag tag, const char *buffer, int32_t size,
                             uint8_t prio, CSSPools &poolsRef) {
       return makeUniqueHimem<CSS>(cssId, tag, buffer, size, prio, poolsRef);
@@ -200,6 +211,7 @@ class CSS {
     auto getId() const -> const HimemString & { return id; }
     auto getFolderPath() const -> const HimemString & { return folderPath; }
     auto getPriority() const -> uint8_t { return priority; }
+    auto isGhost() const -> bool { return ghost; }
     auto getPools() -> CSSPools & { return *pools; }
 
     static auto defaultPools() -> CSSPools &;
@@ -218,11 +230,12 @@ class CSS {
 
     static const char *valueTypeStr[25];
 
-    using PropertyMap = HimemMap<HimemString, PropertyId>;
-    using FontSizeMap = HimemMap<HimemString, int16_t>;
+    // Perfect-hash maps built at compile time, looked up with string views.
+    using PropertyMap = frozen::unordered_map<frozen::string, PropertyId, 20>;
+    using FontSizeMap = frozen::unordered_map<frozen::string, int16_t, 9>;
 
-    static PropertyMap propertyMap;
-    static FontSizeMap fontSizeMap;
+    static const PropertyMap propertyMap;
+    static const FontSizeMap fontSizeMap;
 
     // ---- Selector definition ----
 
@@ -233,7 +246,7 @@ class CSS {
       NONE, FIRST_CHILD
     };
 
-    using ClassList = SimpleListSinglePool<HimemString, 256>;
+    using ClassList = AtomList;
 
     #pragma pack(push, 1)
     // The following is OK in a little endian context.
@@ -252,13 +265,14 @@ class CSS {
     #pragma pack(pop)
 
     struct SelectorNode {
-      HimemString id;
-      ClassList classList;
+      Atoms::Atom id;
+      ClassList classList; // Atoms of the CSSPools table
       Qualifier qualifier;
       uint8_t classCount, idCount;
       SelOp op;
       DOM::Tag tag;
       SelectorNode() {
+        id         = Atoms::NO_ATOM;
         op         = SelOp::NONE;
         tag        = DOM::Tag::NONE;
         qualifier  = Qualifier::NONE;
@@ -272,11 +286,11 @@ class CSS {
       SelectorNode(const SelectorNode &)                = default;
       SelectorNode &operator=(const SelectorNode &)     = default;
 
-      auto addClass(HimemString className) -> void {
-        classList.pushBack(std::move(className));
+      auto addClass(Atoms::Atom className) -> void {
+        classList.add(className);
         classCount += 1;
       }
-      auto addId(const HimemString &theId) -> void {
+      auto addId(Atoms::Atom theId) -> void {
         id = theId;
         idCount += 1;
       }
@@ -290,13 +304,15 @@ class CSS {
           if (tag != DOM::Tag::NONE) {
             for (const auto &[key, value] : DOM::tags) {
               if (value == tag) {
-                std::cout << key;
+                std::cout << std::string_view(key);
                 break;
               }
             }
           }
-          if (idCount > 0) { std::cout << "#" << id; }
-          for (auto &cl : classList) std::cout << "." << cl;
+          if (boundAtoms != nullptr) {
+            if (idCount > 0) { std::cout << "#" << boundAtoms->name(id); }
+            for (auto cl : classList) std::cout << "." << boundAtoms->name(cl);
+          }
           if (qualifier == Qualifier::FIRST_CHILD) { std::cout << ":first_child"; }
         #endif
       }
@@ -416,7 +432,7 @@ class CSS {
           std::cout << "  ";
           for (const auto &[key, value] : propertyMap) {
             if (value == id) {
-              std::cout << key;
+              std::cout << std::string_view(key);
               break;
             }
           }
@@ -451,6 +467,22 @@ class CSS {
 
     RulesMap rulesMap;
 
+    /**
+     * @brief Entry of the rule index used by match().
+     *
+     * seq is the rank of the rule insertion in this instance. RulesMap keeps
+     * rules of equal specificity in insertion order; match() sorts its
+     * candidates on (specificity, seq) to deliver them in that same order.
+     */
+    struct IndexedRule {
+      Selector *selector;
+      Properties *properties;
+      uint32_t seq;
+    };
+
+    using RuleBucket  = HimemVector<IndexedRule>;
+    using RuleBuckets = HimemVector<RuleBucket>;
+
     // Owning lists — element destructors fire automatically on clear() / destruction.
     PropertySuiteList propertySuites;
     SelectorSuiteList selectorSuites;
@@ -458,7 +490,6 @@ class CSS {
 
     class CSSPools {
       public:
-        using ClassListNode          = ClassList::Node;
         using SelectorNodeListNode   = SelectorNodeList::Node;
         using ValuesNode             = Values::Node;
         using SelectorsNode          = Selectors::Node;
@@ -467,7 +498,7 @@ class CSS {
         using SelectorSuiteListNode  = SelectorSuiteList::Node;
         using SelectorSingleListNode = SelectorSingleList::Node;
 
-        HimemPool<ClassListNode> classListPool{ 256 };
+        Atoms atoms; ///< Shared with the DOMPools of the same EPub instance
         HimemPool<SelectorNodeListNode> selectorNodeListPool{ 512 };
         HimemPool<ValuesNode> valuesPool{ 512 };
         HimemPool<SelectorsNode> selectorsPool{ 256 };
@@ -491,6 +522,7 @@ class CSS {
 
     auto addRule(Selector *sel, Properties *props) -> void {
       rulesMap.insert(std::pair<Selector *, Properties *>(sel, props));
+      indexRule(sel, props);
     }
 
     static auto getValuesFromRules(const RulesMap &rules, PropertyId id) -> const Values * {
@@ -514,6 +546,7 @@ class CSS {
     auto retrieveDataFromCss(CSS &css) -> void {
       for (auto &rule : css.rulesMap) {
         rulesMap.insert(rule);
+        indexRule(rule.first, rule.second);
       }
     }
 
@@ -524,9 +557,19 @@ class CSS {
     }
 
   private:
+    // Rule index, bucketed on the rightmost simple selector of each rule: by
+    // id if it has one, else by its first class, else by its tag. Rules
+    // without any of these (`*`, `:first-child`, ...) are universal.
+    RuleBuckets idRules;    // Indexed by atom
+    RuleBuckets classRules; // Indexed by atom
+    RuleBuckets tagRules;   // Indexed by DOM::Tag
+    RuleBucket universalRules;
+    uint32_t ruleSeq{ 0 };
+
     static auto bindPools(CSSPools &poolsRef) -> void;
     static auto unbindPools() -> void;
 
+    auto indexRule(Selector *sel, Properties *props) -> void;
     auto matchSimpleSelector(DOM::Node &node, SelectorNode &simpleSel) -> bool;
     auto matchSelector(DOM::Node *node, Selector &sel) -> bool;
 };
@@ -843,15 +843,10 @@ class CSSParser {
           case CSS::PropertyId::FONT_SIZE:
             if (v.valueType == CSS::ValueType::STR) {
               v.valueType = CSS::ValueType::PT;
-              bool found  = false;
-              for (const auto &[key, value] : css.fontSizeMap) {
-                if (std::strcmp(key.c_str(), v.str.c_str()) == 0) {
-                  v.num = value;
-                  found = true;
-                  break;
-                }
-              }
-              if (!found) {
+              auto it     = CSS::fontSizeMap.find(std::string_view(v.str));
+              if (it != CSS::fontSizeMap.end()) {
+                v.num = it->second;
+              } else {
                 // int8_t fontSize;
                 // config.get(Config::Ident::FONT_SIZE, &fontSize);
                 // v->num = fontSize;
@@ -921,15 +916,9 @@ end:
       bool done = false;
       while (true) {
         // process IDENT property
-        bool found = false;
-        for (const auto &[key, value] : css.propertyMap) {
-          if (std::strcmp(key.c_str(), ident) == 0) {
-            prop.id = value;
-            found   = true;
-            break;
-          }
-        }
-        if (!found) { break; }
+        auto it = CSS::propertyMap.find(std::string_view(ident));
+        if (it == CSS::propertyMap.end()) { break; }
+        prop.id = it->second;
         skipBlanks();
 
         if (token == Token::COLON) {
@@ -1081,12 +1070,16 @@ end:
     auto subSelectorNode(CSS::SelectorNode &node) -> bool {
       for (;;) {
         if (token == Token::HASH) {
-          node.addId(name);
+          Atoms::Atom atom = css.getPools().atoms.intern(name);
+          if (atom == Atoms::NO_ATOM) { return false; }
+          node.addId(atom);
           nextToken();
         } else if (token == Token::DOT) {
           nextToken();
           if (token == Token::IDENT) {
-            node.addClass(ident);
+            Atoms::Atom atom = css.getPools().atoms.intern(ident);
+            if (atom == Atoms::NO_ATOM) { return false; }
+            node.addClass(atom);
             nextToken();
           }
         } else if (token == Token::LBRACK) {
@@ -1108,7 +1101,7 @@ end:
       bool              done = false;
       while (true) {
         if (token == Token::IDENT) {
-          DOM::Tags::const_iterator it = DOM::tags.find(ident);
+          DOM::Tags::const_iterator it = DOM::tags.find(std::string_view(ident));
           if (it != DOM::tags.end()) {
             node.setTag(it->second);
             nextToken();
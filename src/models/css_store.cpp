@@ -0,0 +1,410 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/css_store.hpp"
+
+#include "miniz.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sys/stat.h>
+
+namespace {
+
+// Values are written in the host byte order (little endian), as the .locs
+// file and the Specificity union of CSS.
+
+struct Writer {
+  HimemVector<uint8_t> &out;
+
+  template <typename T> auto put(T value) -> void {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+  }
+
+  auto putString(const char *str, uint16_t len) -> void {
+    put<uint16_t>(len);
+    out.insert(out.end(), str, str + len);
+  }
+};
+
+struct Reader {
+  const uint8_t *p;
+  const uint8_t *end;
+  bool ok{ true };
+
+  template <typename T> auto get() -> T {
+    T value{};
+    if (ok && ((size_t)(end - p) >= sizeof(T))) {
+      memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+    } else {
+      ok = false;
+    }
+    return value;
+  }
+
+  auto getString(const char *&str) -> uint16_t {
+    uint16_t len = get<uint16_t>();
+    if (ok && ((size_t)(end - p) >= len)) {
+      str = reinterpret_cast<const char *>(p);
+      p  += len;
+    } else {
+      ok  = false;
+      str = "";
+      len = 0;
+    }
+    return len;
+  }
+};
+
+// Strings of a stylesheet being serialized, each one kept once.
+struct StringTable {
+  HimemMap<HimemString, uint16_t> index;
+  HimemVector<const HimemString *> strings;
+  bool full{ false };
+
+  auto add(const char *str, size_t len) -> uint16_t {
+    if (len > 0xFFFF) {
+      full = true;
+      return 0;
+    }
+    auto [it, added] = index.try_emplace(HimemString(str, len), (uint16_t)strings.size());
+    if (added) {
+      if (strings.size() >= 0xFFFF) { // NO_STRING is reserved
+        full = true;
+        return 0;
+      }
+      strings.push_back(&it->first);
+    }
+    return it->second;
+  }
+};
+
+} // namespace
+
+auto CSSStore::serialize(CSS &css, HimemVector<uint8_t> &out) -> bool {
+  const Atoms &atoms = css.getPools().atoms;
+
+  StringTable strings;
+  auto atomString = [&](Atoms::Atom atom) -> uint16_t {
+    if (atom == Atoms::NO_ATOM) { return NO_STRING; }
+    const char *name = atoms.name(atom);
+    return strings.add(name, strlen(name));
+  };
+
+  // Property lists are shared by the rules of a same ruleset.
+  HimemMap<const CSS::Properties *, uint16_t> propsIndex;
+  HimemVector<const CSS::Properties *> propsList;
+  for (auto &[sel, props] : css.rulesMap) {
+    if (propsIndex.try_emplace(props, (uint16_t)propsList.size()).second) {
+      propsList.push_back(props);
+    }
+  }
+  if ((propsList.size() > 0xFFFF) || (css.rulesMap.size() > 0xFFFF)) { return false; }
+
+  HimemVector<uint8_t> body;
+  Writer w{ body };
+
+  w.put<uint16_t>(propsList.size());
+  for (auto *props : propsList) {
+    if (props->size() > 0xFFFF) { return false; }
+    w.put<uint16_t>(props->size());
+    for (auto &prop : *props) {
+      if (prop.values.size() > 0xFFFF) { return false; }
+      w.put<uint8_t>(static_cast<uint8_t>(prop.id));
+      w.put<uint16_t>(prop.values.size());
+      for (auto &value : prop.values) {
+        w.put<uint8_t>(static_cast<uint8_t>(value.valueType));
+        w.put<float>(value.num);
+        w.put<uint16_t>(value.str.empty() ? NO_STRING
+                                          : strings.add(value.str.c_str(), value.str.size()));
+        w.put(value.choice);
+      }
+    }
+  }
+
+  w.put<uint16_t>(css.rulesMap.size());
+  for (auto &[sel, props] : css.rulesMap) {
+    if (sel->selectorNodeList.size() > 0xFF) { return false; }
+    w.put<uint32_t>(sel->specificity.value);
+    w.put<uint16_t>(propsIndex[props]);
+    w.put<uint8_t>(sel->selectorNodeList.size());
+    for (auto &node : sel->selectorNodeList) {
+      w.put<uint8_t>(static_cast<uint8_t>(node.op));
+      w.put<uint8_t>(static_cast<uint8_t>(node.tag));
+      w.put<uint8_t>(static_cast<uint8_t>(node.qualifier));
+      w.put<uint8_t>(node.classCount);
+      w.put<uint8_t>(node.idCount);
+      w.put<uint16_t>(atomString(node.id));
+      w.put<uint8_t>(node.classList.size());
+      for (Atoms::Atom atom : node.classList) { w.put<uint16_t>(atomString(atom)); }
+    }
+  }
+
+  if (strings.full || (css.getId().size() > 0xFFFF) || (css.getFolderPath().size() > 0xFFFF)) {
+    return false;
+  }
+
+  Writer o{ out };
+  o.putString(css.getId().c_str(), css.getId().size());
+  o.putString(css.getFolderPath().c_str(), css.getFolderPath().size());
+  o.put<uint8_t>(css.getPriority());
+  o.put<uint16_t>(strings.strings.size());
+  for (auto *str : strings.strings) { o.putString(str->c_str(), str->size()); }
+  out.insert(out.end(), body.begin(), body.end());
+
+  return true;
+}
+
+auto CSSStore::deserialize(const uint8_t *&data, const uint8_t *end, CSS::CSSPools &pools)
+-> CSSPtr {
+  Reader      r{ data, end };
+  const char *str;
+  uint16_t    len;
+
+  len = r.getString(str);
+  HimemString id(str, len);
+  len = r.getString(str);
+  HimemString folderPath(str, len);
+  uint8_t priority = r.get<uint8_t>();
+
+  struct Str {
+    const char *str;
+    uint16_t len;
+  };
+  uint16_t         stringCount = r.get<uint16_t>();
+  HimemVector<Str> strings(stringCount);
+  for (auto &s : strings) { s.len = r.getString(s.str); }
+
+  if (!r.ok) { return nullptr; }
+
+  CSSPtr css = CSS::Make(id.c_str(), folderPath.c_str(), priority, pools);
+  if (css == nullptr) { return nullptr; }
+
+  // Class and id names are interned when first used.
+  HimemVector<int32_t> atomOfString(stringCount, -1);
+  auto atomOf = [&](uint16_t idx) -> Atoms::Atom {
+    if (idx == NO_STRING) { return Atoms::NO_ATOM; }
+    if (idx >= stringCount) {
+      r.ok = false;
+      return Atoms::NO_ATOM;
+    }
+    if (atomOfString[idx] < 0) {
+      atomOfString[idx] = pools.atoms.intern(strings[idx].str, strings[idx].len);
+    }
+    return atomOfString[idx];
+  };
+
+  uint16_t                       propsCount = r.get<uint16_t>();
+  HimemVector<CSS::Properties *> propsList;
+  propsList.reserve(propsCount);
+
+  for (uint16_t i = 0; r.ok && (i < propsCount); ++i) {
+    size_t oldPropertySuiteCount = css->propertySuites.size();
+    css->propertySuites.pushBack(CSS::Properties{});
+    if (css->propertySuites.size() == oldPropertySuiteCount) { return nullptr; }
+    auto &props = css->propertySuites.back();
+    propsList.push_back(&props);
+
+    uint16_t propCount = r.get<uint16_t>();
+    for (uint16_t j = 0; r.ok && (j < propCount); ++j) {
+      CSS::Property prop;
+      prop.id             = static_cast<CSS::PropertyId>(r.get<uint8_t>());
+      uint16_t valueCount = r.get<uint16_t>();
+      for (uint16_t k = 0; r.ok && (k < valueCount); ++k) {
+        CSS::Value value;
+        value.valueType = static_cast<CSS::ValueType>(r.get<uint8_t>());
+        value.num       = r.get<float>();
+        uint16_t idx    = r.get<uint16_t>();
+        if (idx != NO_STRING) {
+          if (idx >= stringCount) { return nullptr; }
+          value.str.assign(strings[idx].str, strings[idx].len);
+        }
+        value.choice = r.get<decltype(value.choice)>();
+        if (!prop.addValue(std::move(value))) { return nullptr; }
+      }
+      size_t oldSize = props.size();
+      props.pushBack(std::move(prop));
+      if (props.size() == oldSize) { return nullptr; }
+    }
+  }
+
+  uint16_t ruleCount = r.get<uint16_t>();
+
+  for (uint16_t i = 0; r.ok && (i < ruleCount); ++i) {
+    CSS::Selector sel;
+    sel.specificity.value = r.get<uint32_t>();
+    uint16_t propsIdx     = r.get<uint16_t>();
+    uint8_t  nodeCount    = r.get<uint8_t>();
+
+    for (uint8_t j = 0; r.ok && (j < nodeCount); ++j) {
+      CSS::SelectorNode node;
+      node.op               = static_cast<CSS::SelOp>(r.get<uint8_t>());
+      node.tag              = static_cast<DOM::Tag>(r.get<uint8_t>());
+      node.qualifier        = static_cast<CSS::Qualifier>(r.get<uint8_t>());
+      uint8_t classCount    = r.get<uint8_t>();
+      uint8_t idCount       = r.get<uint8_t>();
+      node.id               = atomOf(r.get<uint16_t>());
+      uint8_t classListSize = r.get<uint8_t>();
+      for (uint8_t k = 0; r.ok && (k < classListSize); ++k) {
+        node.classList.add(atomOf(r.get<uint16_t>()));
+      }
+      node.classCount = classCount;
+      node.idCount    = idCount;
+
+      size_t oldSize = sel.selectorNodeList.size();
+      sel.selectorNodeList.pushBack(std::move(node));
+      if (sel.selectorNodeList.size() == oldSize) { return nullptr; }
+    }
+
+    if (!r.ok || (propsIdx >= propsList.size())) { return nullptr; }
+
+    size_t oldSingleCount = css->selectorSingles.size();
+    css->selectorSingles.pushBack(std::move(sel));
+    if (css->selectorSingles.size() == oldSingleCount) { return nullptr; }
+    css->addRule(&css->selectorSingles.back(), propsList[propsIdx]);
+  }
+
+  if (!r.ok) { return nullptr; }
+
+  data = r.p;
+  return css;
+}
+
+auto CSSStore::epubSizeOf(const HimemString &epubFilename) -> uint32_t {
+  struct stat fileStat;
+  return (stat(epubFilename.c_str(), &fileStat) != -1) ? (uint32_t)fileStat.st_size : 0;
+}
+
+auto CSSStore::headerCrc(const Header &header, const uint8_t *data) -> uint32_t {
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(&header),
+                          offsetof(Header, crc));
+  crc = mz_crc32(crc, data, header.dataSize);
+  return static_cast<uint32_t>(crc);
+}
+
+auto CSSStore::load(const HimemString &epubFilename, const BinUUID &uuid, CSS::CSSPools &pools,
+                    CSSList &sheets) -> bool {
+  HimemString   filename = filenameOf(epubFilename);
+  std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+  if (!file.is_open()) {
+    LOG_D("No stylesheets file '{}'.", filename);
+    return false;
+  }
+
+  bool   ok = false;
+  Header header;
+
+  while (true) {
+    if (file.read(reinterpret_cast<char *>(&header), sizeof(header)).fail()) { break; }
+
+    if ((header.version != FILE_VERSION) || (memcmp(header.uuid, uuid, sizeof(BinUUID)) != 0) ||
+        (header.epubSize != epubSizeOf(epubFilename))) {
+      LOG_I("Stylesheets file '{}' is outdated.", filename);
+      break;
+    }
+
+    HimemUniquePtr<uint8_t[]> data = makeUniqueHimem<uint8_t[]>(header.dataSize);
+    if ((header.dataSize > 0) && (data == nullptr)) {
+      LOG_E("Not enough memory to load {} bytes of stylesheets.", header.dataSize);
+      break;
+    }
+    if (file.read(reinterpret_cast<char *>(data.get()), header.dataSize).fail()) { break; }
+    if (headerCrc(header, data.get()) != header.crc) {
+      LOG_E("Stylesheets file '{}' CRC mismatch.", filename);
+      break;
+    }
+
+    CSSList        loaded;
+    const uint8_t *p   = data.get();
+    const uint8_t *end = p + header.dataSize;
+    while ((loaded.size() < header.sheetCount) && (p < end)) {
+      CSSPtr css = deserialize(p, end, pools);
+      if (css == nullptr) { break; }
+      loaded.push_back(std::move(css));
+    }
+    if ((loaded.size() != header.sheetCount) || (p != end)) {
+      LOG_E("Stylesheets file '{}' is corrupted.", filename);
+      break;
+    }
+
+    sheets.splice(sheets.end(), loaded);
+    ok = true;
+    break;
+  }
+
+  file.close();
+
+  LOG_D("Stylesheets load {}.", ok ? "Success" : "Error");
+
+  return ok;
+}
+
+auto CSSStore::save(const HimemString &epubFilename, const BinUUID &uuid, const CSSList &sheets)
+-> bool {
+  // The EPub instances of a book may save at the same time.
+  static std::mutex saveMutex;
+
+  HimemVector<uint8_t> data;
+  Header               header;
+
+  header.version = FILE_VERSION;
+  memcpy(header.uuid, uuid, sizeof(BinUUID));
+  header.epubSize   = epubSizeOf(epubFilename);
+  header.sheetCount = 0;
+
+  for (auto &css : sheets) {
+    if (css->isGhost()) { continue; }
+    if (serialize(*css, data)) {
+      header.sheetCount += 1;
+    } else {
+      LOG_W("Stylesheet {} is too large to be saved.", css->getId());
+    }
+  }
+
+  if (header.sheetCount == 0) { return false; }
+
+  header.dataSize = data.size();
+  header.crc      = headerCrc(header, data.data());
+
+  HimemString filename = filenameOf(epubFilename);
+  HimemString tmpName  = filename + ".tmp";
+
+  std::scoped_lock guard(saveMutex);
+
+  std::ofstream file(tmpName.c_str(), std::ios::out | std::ios::binary);
+
+  if (!file.is_open()) {
+    LOG_E("Not able to open stylesheets file '{}': errno={} ({})", tmpName, errno,
+          std::strerror(errno));
+    return false;
+  }
+
+  if (!file.write(reinterpret_cast<const char *>(&header), sizeof(header)).fail()) {
+    file.write(reinterpret_cast<const char *>(data.data()), header.dataSize);
+  }
+
+  bool res = !file.fail();
+  file.close();
+
+  if (res) {
+    remove(filename.c_str()); // The rename doesn't replace a file on FAT
+    if (rename(tmpName.c_str(), filename.c_str())) {
+      LOG_E("Unable to rename stylesheets file '{}'.", tmpName);
+      res = false;
+    }
+  }
+  if (!res) {
+    LOG_E("Stylesheets save failed for '{}'.", filename);
+    remove(tmpName.c_str());
+  }
+
+  return res;
+}
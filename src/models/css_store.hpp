@@ -0,0 +1,107 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include "models/css.hpp"
+
+#include <list>
+
+/**
+ * class CSSStore - Parsed stylesheets of a book, kept in a file
+ *
+ * The stylesheets of a book are inflated and parsed again every time the
+ * book is opened, and by every EPub instance working on it (viewer, page
+ * locations retrievers, prefetcher). This class saves the CSS instances
+ * built by the parser in a compact binary form, in a file next to the .locs
+ * and .toc files of the book (.cssc extension), and rebuilds them from it
+ * without parsing.
+ *
+ * File layout: a Header, then the stylesheets one after the other, all read
+ * with a single block read and checked with a CRC. The file is tied to the
+ * book by its binary UUID and size, and each stylesheet is known by its id
+ * (the href used by the items to refer to it).
+ *
+ * A stylesheet is its id, folder path and priority, a string table, the
+ * property lists of its rules and its selectors. Class and id names and
+ * string values are written once in the string table and referred to by
+ * index; class and id names are interned again in the atom table of the
+ * CSSPools receiving the stylesheet.
+ *
+ * Rules are written in the order of CSS::rulesMap, so the rules of equal
+ * specificity keep their relative order when added back.
+ */
+class CSSStore {
+  public:
+    using BinUUID = uint8_t[16]; ///< Same as EPub::BinUUID
+    using CSSList = std::list<CSSPtr>; ///< Same as EPub::CSSList
+
+    /**
+     * @brief Read the stylesheets saved for a book
+     *
+     * @param epubFilename The book file name.
+     * @param uuid The book binary UUID.
+     * @param pools The pools receiving the stylesheets.
+     * @param sheets Where the stylesheets are appended.
+     * @return false if the file is absent, of another version, of another
+     *         book or corrupted. Nothing is appended to sheets then.
+     */
+    static auto load(const HimemString &epubFilename, const BinUUID &uuid, CSS::CSSPools &pools,
+                     CSSList &sheets) -> bool;
+
+    /**
+     * @brief Save the stylesheets of a book
+     *
+     * Ghost instances (merged from other stylesheets) are skipped. The file
+     * is written under a temporary name and renamed, as several EPub
+     * instances of the same book may save it.
+     */
+    static auto save(const HimemString &epubFilename, const BinUUID &uuid, const CSSList &sheets)
+    -> bool;
+
+    /**
+     * @brief Append the binary form of a stylesheet to a buffer
+     *
+     * @return false if the stylesheet is too large for the format. The
+     *         buffer is left as it was.
+     */
+    static auto serialize(CSS &css, HimemVector<uint8_t> &out) -> bool;
+
+    /**
+     * @brief Rebuild a stylesheet from its binary form
+     *
+     * @param data Start of the binary form, moved past it on success.
+     * @param end End of the available data.
+     * @return The stylesheet, or nullptr if the data is not valid.
+     */
+    static auto deserialize(const uint8_t *&data, const uint8_t *end, CSS::CSSPools &pools)
+    -> CSSPtr;
+
+    static auto filenameOf(const HimemString &epubFilename) -> HimemString {
+      return epubFilename.substr(0, epubFilename.find_last_of('.')) + ".cssc";
+    }
+
+  private:
+    static constexpr char const *TAG     = "CSSStore";
+    static constexpr int8_t FILE_VERSION = 1; ///< To be changed with CSS or DOM::Tag enums
+
+    static constexpr uint16_t NO_STRING = 0xFFFF;
+
+    #pragma pack(push, 1)
+    struct Header {
+      int8_t version;
+      uint8_t uuid[16];
+      uint32_t epubSize;
+      uint16_t sheetCount;
+      uint32_t dataSize;
+      uint32_t crc;
+    };
+    #pragma pack(pop)
+
+    static auto epubSizeOf(const HimemString &epubFilename) -> uint32_t;
+    static auto headerCrc(const Header &header, const uint8_t *data) -> uint32_t;
+};
@@ -3,10 +3,11 @@
 // MIT License. Look at file licenses.txt for details.
 
 #include "models/dom.hpp"
+#include "models/css.hpp"
 
 #include <cstring>
 
-DOM::Tags DOM::tags = {
+constinit const DOM::Tags DOM::tags = {
   { "p",      Tag::P      },  { "div",        Tag::DIV        },  { "span",     Tag::SPAN     },  { "br",      Tag::BREAK   },
   { "h1",     Tag::H1     },  { "h2",         Tag::H2         },  { "h3",       Tag::H3       },  { "h4",      Tag::H4      },
   { "h5",     Tag::H5     },  { "h6",         Tag::H6         },  { "b",        Tag::B        },  { "i",       Tag::I       },
@@ -19,23 +20,25 @@ DOM::Tags DOM::tags = {
   { "@font-face", Tag::FONT_FACE  },
 };
 
+thread_local Atoms *DOM::boundAtoms = nullptr;
+
 auto DOM::defaultPools() -> DOMPools & {
-  static DOMPools pools;
+  static DOMPools pools(CSS::defaultPools().atoms);
   return pools;
 }
 
 auto DOM::bindPools(DOMPools &poolsRef) -> void {
-  using Tag                                                           = ScopedListPoolTag;
-  ScopedHimemPoolBinding<DOMPools::NodeClassListNode, Tag, 256>::pool = &poolsRef.nodeClassListPool;
-  ScopedHimemPoolBinding<DOMPools::NodeNodeListNode, Tag, 512>::pool  = &poolsRef.nodeNodeListPool;
-  ScopedHimemPoolBinding<DOMPools::DomNodeListNode, Tag, 100>::pool   = &poolsRef.domNodeListPool;
+  using Tag                                                          = ScopedListPoolTag;
+  ScopedHimemPoolBinding<DOMPools::NodeNodeListNode, Tag, 512>::pool = &poolsRef.nodeNodeListPool;
+  ScopedHimemPoolBinding<DOMPools::DomNodeListNode, Tag, 100>::pool  = &poolsRef.domNodeListPool;
+  boundAtoms                                                         = &poolsRef.atoms;
 }
 
 auto DOM::unbindPools() -> void {
-  using Tag                                                           = ScopedListPoolTag;
-  ScopedHimemPoolBinding<DOMPools::NodeClassListNode, Tag, 256>::pool = nullptr;
-  ScopedHimemPoolBinding<DOMPools::NodeNodeListNode, Tag, 512>::pool  = nullptr;
-  ScopedHimemPoolBinding<DOMPools::DomNodeListNode, Tag, 100>::pool   = nullptr;
+  using Tag                                                          = ScopedListPoolTag;
+  ScopedHimemPoolBinding<DOMPools::NodeNodeListNode, Tag, 512>::pool = nullptr;
+  ScopedHimemPoolBinding<DOMPools::DomNodeListNode, Tag, 100>::pool  = nullptr;
+  boundAtoms                                                         = nullptr;
 }
 
 DOM::PoolsGuard::PoolsGuard(DOMPools &poolsRef) : poolsRef(poolsRef) { bindPools(poolsRef); }
@@ -67,13 +70,13 @@ DOM::Node::Node(Node *theFather, Tag theTag) {
 DOM::Node::~Node() { children.clear(); }
 
 auto DOM::Node::addClass(const char *theClass) -> Node * {
-  if ((theClass == nullptr) || (*theClass == '\0')) { return this; }
-  classList.pushFront(HimemString(theClass));
+  if ((theClass == nullptr) || (*theClass == '\0') || (boundAtoms == nullptr)) { return this; }
+  classList.add(boundAtoms->intern(theClass));
   return this;
 }
 
 auto DOM::Node::addClasses(const char *theClasses) -> Node * {
-  if (theClasses == nullptr) { return this; }
+  if ((theClasses == nullptr) || (boundAtoms == nullptr)) { return this; }
 
   const char *p = theClasses;
   while (*p != '\0') {
@@ -84,18 +87,14 @@ auto DOM::Node::addClasses(const char *theClasses) -> Node * {
     while ((*p != '\0') && (*p != ' ') && (*p != '\t') && (*p != '\n') && (*p != '\r')) ++p;
 
     const size_t len = static_cast<size_t>(p - start);
-    if (len > 0) {
-      HimemString cls;
-      cls.assign(start, len);
-      classList.pushFront(std::move(cls));
-    }
+    if (len > 0) { classList.add(boundAtoms->intern(start, len)); }
   }
   return this;
 }
 
 auto DOM::Node::addId(const char *theId) -> Node * {
-  if (theId == nullptr) { return this; }
-  id = theId;
+  if ((theId == nullptr) || (boundAtoms == nullptr)) { return this; }
+  id = boundAtoms->intern(theId);
   return this;
 }
 
@@ -114,13 +113,15 @@ auto DOM::Node::show(uint8_t level) -> void const {
     std::cout << std::string(level * 2, ' ');
     for (auto &t : tags) {
       if (t.second == tag) {
-        std::cout << t.first;
+        std::cout << std::string_view(t.first);
         break;
       }
     }
     std::cout << " ";
-    if (!id.empty()) { std::cout << "#" << id; }
-    for (auto &c : classList) std::cout << '.' << c;
+    if (boundAtoms != nullptr) {
+      if (id != Atoms::NO_ATOM) { std::cout << "#" << boundAtoms->name(id); }
+      for (auto c : classList) std::cout << '.' << boundAtoms->name(c);
+    }
     if (firstChild) { std::cout << ":first_child"; }
     std::cout << std::endl;
 
@@ -11,8 +11,13 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <string_view>
+
+#include <frozen/string.h>
+#include <frozen/unordered_map.h>
 
 #include "himem_pool.hpp"
+#include "models/atoms.hpp"
 #include "simple_list.hpp"
 
 using DOMPtr = HimemUniquePtr<class DOM>;
@@ -50,20 +55,27 @@ class DOM {
     };
 
 
-    using Tags = std::map<std::string, Tag>;
+    /**
+     * @brief Tag names to Tag
+     *
+     * A perfect-hash map built at compile time, looked up for every XML
+     * element and CSS selector. Keys are taken as string views, so no
+     * temporary string is built: use tags.find(std::string_view(name)).
+     */
+    using Tags = frozen::unordered_map<frozen::string, Tag, 37>;
 
-    static Tags tags;
+    static const Tags tags;
 
     class Node {
       public:
-        using ClassList = SimpleListSinglePool<HimemString, 256>;
+        using ClassList = AtomList;
         using NodeList  = SimpleListSinglePool<Node *, 512>;
 
         Node *father;
         Node *predecessor;
         NodeList children;
-        ClassList classList;
-        HimemString id;
+        ClassList classList; ///< Class names, as atoms of the bound DOMPools table
+        Atoms::Atom id{ Atoms::NO_ATOM };
         Tag tag;
         bool firstChild;
 
@@ -81,6 +93,9 @@ class DOM {
     DOMPools *pools{ nullptr };
     PoolsGuard *guard{ nullptr };
 
+    // Atom table of the currently bound pools, used by Node::addClasses() / addId().
+    static thread_local Atoms *boundAtoms;
+
     SimpleListSinglePool<Node, 100> nodeList{};
 
     DOM(DOMPools &poolsRef);
@@ -88,11 +103,13 @@ class DOM {
   public:
     class DOMPools {
       public:
-        using NodeClassListNode = Node::ClassList::Node;
-        using NodeNodeListNode  = Node::NodeList::Node;
-        using DomNodeListNode   = SimpleListSinglePool<Node, 100>::Node;
+        using NodeNodeListNode = Node::NodeList::Node;
+        using DomNodeListNode  = SimpleListSinglePool<Node, 100>::Node;
+
+        /// The atom table is shared with the CSSPools of the same EPub instance.
+        explicit DOMPools(Atoms &atomsRef) : atoms(atomsRef) {}
 
-        HimemPool<NodeClassListNode> nodeClassListPool{ 256 };
+        Atoms &atoms;
         HimemPool<NodeNodeListNode> nodeNodeListPool{ 512 };
         HimemPool<DomNodeListNode> domNodeListPool{ 100 };
     };
@@ -117,6 +134,8 @@ class DOM {
 
     static auto defaultPools() -> DOMPools &;
 
+    auto getAtoms() -> Atoms & { return pools->atoms; }
+
     Node *body{ nullptr };
 
     auto addChild(Node *parentNode, Tag theTag) -> Node * {
@@ -7,6 +7,8 @@
 #include "config.hpp"
 #include "fonts.hpp"
 #include "models/books_dir.hpp"
+#include "models/css_store.hpp"
+#include "models/picture_cache.hpp"
 #include "viewers/book_viewer.hpp"
 #include "viewers/msg_viewer.hpp"
 
@@ -523,7 +525,7 @@ auto EPub::retrieveFontsFromCss(CSSPtr &css) -> void {
           if ((values = css->getValuesFromProps(*rule.second, CSS::PropertyId::SRC)) &&
               (!values->empty()) && (values->front().valueType == CSS::ValueType::URL)) {
 
-            if (!pageLocsInstance) {
+            if (!isSecondaryInstance()) {
               if (first) {
                 first = false;
                 LOG_D("Displaying font loading msg.");
@@ -583,6 +585,11 @@ auto EPub::retrieveCss(ItemInfo &item) -> void {
         }
         if (css_cache_it == cssCache.end()) {
 
+          if (findStoredCss(css_id)) {
+            item.cssList.push_back(*cssCache.back());
+            continue;
+          }
+
           // The css file was not found. Load it in the cache.
           uint32_t    size;
           HimemString fname = item.filePath;
@@ -607,6 +614,7 @@ auto EPub::retrieveCss(ItemInfo &item) -> void {
             retrieveFontsFromCss(css_tmp);
             cssCache.push_back(std::move(css_tmp));
             item.cssList.push_back(*cssCache.back());
+            cssStoreDirty = true;
           }
         } else {
           item.cssList.push_back(**css_cache_it); // The css file was found in the cache. Just add
@@ -657,6 +665,41 @@ auto EPub::retrieveCss(ItemInfo &item) -> void {
   #endif
 }
 
+/**
+ * Move a css file read from the book's CSSStore file to the cssCache. The
+ * file is read the first time a css file is needed, so that books opened
+ * only for their metadata don't pay for it. The fonts of the css file are
+ * retrieved as for a parsed one.
+ */
+auto EPub::findStoredCss(const std::string &cssId) -> bool {
+  if (!cssStoreLoaded) {
+    cssStoreLoaded = true;
+    CSSStore::load(currentFilename, binUuid, cssPools, storedCss);
+  }
+
+  for (auto it = storedCss.begin(); it != storedCss.end(); ++it) {
+    if ((*it)->getId().compare(cssId) == 0) {
+      cssCache.splice(cssCache.end(), storedCss, it);
+      retrieveFontsFromCss(cssCache.back());
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Save the css files of the book when some were parsed, with the stored
+ * ones not used during this session, so that they are all kept.
+ */
+auto EPub::saveCssStore() -> void {
+  if (cssStoreDirty) {
+    cssCache.splice(cssCache.end(), storedCss);
+    CSSStore::save(currentFilename, binUuid, cssCache);
+  }
+  storedCss.clear();
+  cssStoreLoaded = cssStoreDirty = false;
+}
+
 auto EPub::getItem(pugi::xml_node itemref, ItemInfo &item) -> bool {
   int err = 0;
   #define ERR(e)                                                                                     \
@@ -715,6 +758,7 @@ auto EPub::getItem(pugi::xml_node itemref, ItemInfo &item) -> bool {
     // LOG_D("item.filePath: {}.", item.filePath);
 
     if ((item.data = retrieveFile(attr.value(), size)) == nullptr) { ERR(6); }
+    item.dataSize = size;
 
     if (item.mediaType == MediaType::XML) {
 
@@ -878,13 +922,17 @@ auto EPub::open(const HimemString &epubFilename) -> bool {
                       encryptionData.reset();
                     }
 
-                    // Unzip is shared for pageLocs instances; only the owner closes it.
-                    if (!pageLocsInstance) {
+                    // Unzip is shared with the secondary instances; only the owner closes it.
+                    if (!isSecondaryInstance()) {
                       unzip.closeZipFile();
                     }
 
                     fonts.clear();
                     cssCache.clear();
+                    storedCss.clear();
+                    cssStoreLoaded = cssStoreDirty = false;
+                    memset(binUuid, 0, sizeof(binUuid));
+                    memset(shaUuid, 0, sizeof(shaUuid));
                     encryptionPresent = false;
                     currentFilename.clear();
 
@@ -964,6 +1012,7 @@ auto EPub::clearItemData(ItemInfo &item) -> void {
   if (item.data != nullptr) {
     item.data.reset();
   }
+  item.dataSize = 0;
 
   // for (auto * css : current_item_css_list) {
   //   delete css;
@@ -981,7 +1030,7 @@ auto EPub::clearItemData(ItemInfo &item) -> void {
 auto EPub::closeFile() -> bool {
   if (!fileIsOpen) { return true; }
 
-  if (!pageLocsInstance) {
+  if (!isSecondaryInstance()) {
     pageLocs.stopControlTask();
   }
 
@@ -999,17 +1048,25 @@ auto EPub::closeFile() -> bool {
     encryptionData.reset();
   }
 
-  // Unzip is shared across EPub instances: pageLocsInstance must not close it.
-  if (!pageLocsInstance) {
+  // Unzip is shared across EPub instances: secondary instances must not close it.
+  if (!isSecondaryInstance()) {
     if (Unzip::isAlive()) {
       unzip.closeZipFile();
     }
+    if (pictureCache.isOpenFor(currentFilename)) { pictureCache.close(); }
   }
 
   // Fonts are EPub-instance-owned and must always be released.
   fonts.clear();
 
+  clearItemCache();
+  saveCssStore();
   cssCache.clear();
+  memset(binUuid, 0, sizeof(binUuid)); // Not set by the next book if not encrypted
+  memset(shaUuid, 0, sizeof(shaUuid));
+
+  // No CSS or DOM instance of this book is left: the class/id atoms can go.
+  cssPools.atoms.clear();
 
   fileIsOpen        = false;
   encryptionPresent = false;
@@ -1127,12 +1184,78 @@ auto EPub::getItemAtIndex(int16_t itemrefIndex) -> bool {
   bool res = false;
 
   if ((currentItemInfo.data == nullptr) || (currentItemRef != node)) {
+    auto it = std::find_if(itemCache.begin(), itemCache.end(),
+                           [&node](const CachedItem &c) { return c.itemRef == node; });
+
+    if (it != itemCache.end()) {
+      // Already parsed: no decompression nor parsing required.
+      auto info = std::move(it->info);
+      itemCacheBytes -= it->cost;
+      itemCache.erase(it);
+      itemCacheHits++;
+
+      stashCurrentItem();
+      currentItemInfo = std::move(*info);
+      currentItemRef  = node;
+      return true;
+    }
+
+    itemCacheMisses++;
+    stashCurrentItem();
+
     if ((res = getItem(node, currentItemInfo))) { currentItemRef = node; }
     currentItemInfo.itemrefIndex = itemrefIndex;
   }
   return res;
 }
 
+// Move the current item, if any, to the parsed items cache, evicting the
+// least recently used items to keep the cache within its budget.
+auto EPub::stashCurrentItem() -> void {
+  if ((currentItemInfo.data == nullptr) || (currentItemInfo.itemrefIndex < 0)) { return; }
+
+  // The XHTML buffer, plus as much for the XML document nodes and the item
+  // CSS, which are not accounted for by their allocators.
+  uint32_t cost = currentItemInfo.dataSize * 2;
+
+  if (cost <= itemCacheBudget) {
+    evictItems(itemCacheBudget - cost);
+
+    auto info = makeUniqueHimem<ItemInfo>();
+    if (info != nullptr) {
+      *info = std::move(currentItemInfo);
+      itemCache.push_back(CachedItem{ std::move(info), currentItemRef, cost });
+      itemCacheBytes += cost;
+    } else {
+      LOG_W("Unable to allocate a parsed item cache entry.");
+    }
+  }
+
+  clearItemData(currentItemInfo);
+  currentItemRef = pugi::xml_node(nullptr);
+}
+
+auto EPub::evictItems(uint32_t budget) -> void {
+  auto it = itemCache.begin();
+  while ((itemCacheBytes > budget) && (it != itemCache.end())) {
+    itemCacheBytes -= it->cost;
+    clearItemData(*it->info);
+    ++it;
+  }
+  itemCache.erase(itemCache.begin(), it);
+}
+
+auto EPub::setItemCacheBudget(uint32_t bytes) -> void {
+  itemCacheBudget = bytes;
+  evictItems(bytes);
+}
+
+auto EPub::clearItemCache() -> void {
+  evictItems(0);
+  itemCacheHits   = 0;
+  itemCacheMisses = 0;
+}
+
 // This is in support of the pages location retrieval mechanism. The ItemInfo
 // is being used to retrieve asynchroniously the book page numbers without
 // interfering with the main book viewer thread.
@@ -1180,5 +1303,31 @@ auto EPub::getPicture(HimemString &fname, bool load) -> PicturePtr {
   //   std::cout << std::endl << "-----" << std::endl;
   // }
 
+  return pict;
+}
+
+auto EPub::getSizedPicture(HimemString &fname, const std::function<Dim(Dim)> &targetOf,
+                           Dim &srcDim) -> PicturePtr {
+
+  HimemString filename = filenameLocate(fname.c_str());
+
+  pictureCache.open(currentFilename, binUuid);
+
+  PicturePtr pict = pictureCache.get(filename, targetOf, srcDim);
+  if (pict != nullptr) { return pict; }
+
+  if ((pict = getPicture(fname, true)) == nullptr) { return nullptr; }
+
+  srcDim     = pict->getDim();
+  Dim target = targetOf(srcDim);
+
+  // Same conditions as Page::addPicture() for resizing
+  if ((target.width != 0) && (target.height != 0) && ((srcDim.width > 2) || (srcDim.height > 2))) {
+    if ((target.width != srcDim.width) || (target.height != srcDim.height)) {
+      pict->resize(target);
+    }
+    pictureCache.put(filename, srcDim, *pict);
+  }
+
   return pict;
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "viewers/page.hpp"
 
 #include <forward_list>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -45,10 +46,21 @@ class EPub {
                           ///< inside cssCache.
       CSSPtr css{};     ///< Ghost CSS created through merging css suites from cssList and cssCache.
       FileContentPtr data{};
+      uint32_t dataSize{ 0 }; ///< Size of the item file content in data
       MediaType mediaType{};
 
       ItemInfo()  = default;
       ~ItemInfo() = default;
+      ItemInfo(ItemInfo &&) = default;
+      ItemInfo &operator=(ItemInfo &&) = default;
+    };
+
+    /// Parsed items cache usage, see setItemCacheBudget().
+    struct ItemCacheStats {
+      uint32_t hits;
+      uint32_t misses;
+      uint32_t bytes;   ///< Estimated memory used by the cached items
+      uint16_t count;   ///< Number of items in the cache
     };
 
 // This struct contains the current parameters that influence
@@ -79,6 +91,12 @@ class EPub {
 
     static constexpr float lineHeightFactors[3] = { 0.75, 0.9, 1.2 };
 
+    #if EPUB_LINUX_BUILD
+      static constexpr uint32_t ITEM_CACHE_BUDGET = 4 * 1024 * 1024;
+    #else
+      static constexpr uint32_t ITEM_CACHE_BUDGET = 512 * 1024;
+    #endif
+
     pugi::xml_document opf; ///< The OPF document description.
     pugi::xml_document encryption;
     pugi::xml_node currentItemRef{ pugi::xml_node(nullptr) };
@@ -100,15 +118,35 @@ class EPub {
                  ///< cleared when a new book is loaded.
 
     CSS::CSSPools cssPools;
-    DOM::DOMPools domPools;
+    DOM::DOMPools domPools{ cssPools.atoms };
 
     CSSList cssCache; ///< All css files in the ebook are maintained here.
+    CSSList storedCss; ///< Css files read from the book's CSSStore file, not used yet.
+    bool cssStoreLoaded{ false };
+    bool cssStoreDirty{ false }; ///< A css file was parsed: the CSSStore file is to be saved.
+
+    // Parsed items recently left by getItemAtIndex(), least recently used
+    // first. Their css lists refer to cssCache entries.
+    struct CachedItem {
+      HimemUniquePtr<ItemInfo> info;
+      pugi::xml_node itemRef;
+      uint32_t cost;
+    };
+    HimemVector<CachedItem> itemCache;
+    uint32_t itemCacheBudget{ ITEM_CACHE_BUDGET };
+    uint32_t itemCacheBytes{ 0 };
+    uint32_t itemCacheHits{ 0 };
+    uint32_t itemCacheMisses{ 0 };
+
+    auto stashCurrentItem() -> void;
+    auto evictItems(uint32_t budget) -> void;
 
     bool fileIsOpen{ false };
     bool encryptionPresent{ false };
     bool fontsSizeTooLarge{ false };
     int32_t fontsSize{ 0 };
     bool pageLocsInstance{ false };
+    bool prefetchInstance{ false };
 
     auto getMeta(const std::string &name) -> const char *;
     auto getOpf(std::string &filename) -> bool;
@@ -116,6 +154,8 @@ class EPub {
     auto getOpfFilename(std::string &filename) -> bool;
     auto getEncryptionXml() -> bool;
     auto retrieveFontsFromCss(CSSPtr &css) -> void;
+    auto findStoredCss(const std::string &cssId) -> bool;
+    auto saveCssStore() -> void;
     auto sha1(const std::string &data) -> void;
 
 
@@ -137,6 +177,21 @@ class EPub {
     auto open(const HimemString &epubFilename) -> bool;
     auto closeFile() -> bool;
     auto getPicture(HimemString &fname, bool load) -> PicturePtr;
+
+    /**
+     * @brief Retrieve a picture sized for a page
+     *
+     * The picture is taken from the book's PictureCache when it was already
+     * shown at that size. It is decoded, resized and added to the cache
+     * otherwise.
+     *
+     * @param fname The picture path in the book.
+     * @param targetOf Gives the size on the page from the decoded size.
+     * @param srcDim Set to the decoded size.
+     * @return The picture, or nullptr if not found or not compatible.
+     */
+    auto getSizedPicture(HimemString &fname, const std::function<Dim(Dim)> &targetOf, Dim &srcDim)
+    -> PicturePtr;
     auto retrieveFile(const char *fname, uint32_t &size) -> HimemUniquePtr<uint8_t[]>;
     auto getItem(pugi::xml_node itemref, ItemInfo &item) -> bool;
     auto getItemAtIndex(int16_t itemrefIndex) -> bool;
@@ -177,7 +232,26 @@ class EPub {
     auto getCoverFilename() -> const char *;
 
     [[nodiscard]] inline auto getCssCache() const -> const CSSList & { return cssCache; }
-    inline auto clearCssCache() -> void { cssCache.clear(); }
+    inline auto clearCssCache() -> void {
+      clearItemCache(); // Cached items refer to cssCache entries
+      cssCache.clear();
+    }
+
+    /**
+     * @brief Set the memory budget of the parsed items cache
+     *
+     * When getItemAtIndex() moves to another item, the parsed item it leaves
+     * (XHTML buffer, XML document and item CSS) is kept in a LRU cache, so that
+     * going back to it costs no decompression nor parsing. Items are evicted
+     * when their estimated size exceeds the budget. A budget of 0 disables the
+     * cache.
+     */
+    auto setItemCacheBudget(uint32_t bytes) -> void;
+    auto clearItemCache() -> void;
+    [[nodiscard]] inline auto getItemCacheStats() const -> ItemCacheStats {
+      return ItemCacheStats{ itemCacheHits, itemCacheMisses, itemCacheBytes,
+                             (uint16_t)itemCache.size() };
+    }
     [[nodiscard]] inline auto getCurrentItemCss() const -> const CSSPtr & {
       return currentItemInfo.css;
     }
@@ -211,6 +285,12 @@ class EPub {
     [[nodiscard]] inline auto getBinUuid() const -> const BinUUID & { return binUuid; }
 
     inline auto setPageLocsInstance(bool val) -> void { pageLocsInstance = val; }
+    inline auto setPrefetchInstance(bool val) -> void { prefetchInstance = val; }
+
+    /// Instances other than the viewer's one share its unzip and stay off the screen.
+    [[nodiscard]] inline auto isSecondaryInstance() const -> bool {
+      return pageLocsInstance || prefetchInstance;
+    }
 };
 
 #include "models/toc.hpp"
\ No newline at end of file
@@ -0,0 +1,60 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/layout_checkpoints.hpp"
+
+#include <algorithm>
+#include <limits>
+
+auto LayoutCheckpoints::record(int16_t itemrefIndex, int32_t offset, const Path &path) -> void {
+  if ((itemrefIndex < 0) || (offset < 0) || path.empty() ||
+      (path.size() > std::numeric_limits<uint8_t>::max())) {
+    return;
+  }
+
+  std::scoped_lock guard(mutex);
+
+  if (itemrefIndex >= (int16_t)items.size()) { items.resize(itemrefIndex + 1); }
+  Item &item = items[itemrefIndex];
+
+  auto it = std::lower_bound(item.checkpoints.begin(), item.checkpoints.end(), offset,
+                             [](const Checkpoint &c, int32_t off) { return c.offset < off; });
+  if ((it != item.checkpoints.end()) && (it->offset == offset)) { return; }
+
+  // Steps are only appended: a checkpoint inserted before others still
+  // refers to its own steps at the end of the vector.
+  uint32_t firstStep = item.steps.size();
+  item.steps.insert(item.steps.end(), path.begin(), path.end());
+  item.checkpoints.insert(it, Checkpoint{ offset, firstStep, (uint8_t)path.size() });
+  count++;
+}
+
+auto LayoutCheckpoints::nearest(int16_t itemrefIndex, int32_t offset, Path &path) -> int32_t {
+  path.clear();
+
+  std::scoped_lock guard(mutex);
+
+  if ((itemrefIndex < 0) || (itemrefIndex >= (int16_t)items.size())) { return -1; }
+  const Item &item = items[itemrefIndex];
+
+  auto it = std::upper_bound(item.checkpoints.begin(), item.checkpoints.end(), offset,
+                             [](int32_t off, const Checkpoint &c) { return off < c.offset; });
+  if (it == item.checkpoints.begin()) { return -1; }
+  --it;
+
+  auto first = item.steps.begin() + it->firstStep;
+  path.assign(first, first + it->depth);
+  return it->offset;
+}
+
+auto LayoutCheckpoints::clear() -> void {
+  std::scoped_lock guard(mutex);
+  items.clear();
+  count = 0;
+}
+
+auto LayoutCheckpoints::size() -> uint32_t {
+  std::scoped_lock guard(mutex);
+  return count;
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include <mutex>
+
+/**
+ * class LayoutCheckpoints - Resumable positions in the layout of items
+ *
+ * Laying out page N of an item requires walking the item's XML tree from the
+ * start: every node before the page is visited only to advance the offset
+ * counter. A checkpoint keeps, for a page start offset, the path of XML nodes
+ * leading to the position where the page starts: for each level below the
+ * body tag, the index of the child entered and the offset at which it was
+ * entered. The HTMLInterpreter can then skip the preceding siblings at each
+ * level instead of walking them.
+ *
+ * Checkpoints are recorded by the page locations computation and by the book
+ * viewer, from two different threads: all methods are guarded by a mutex.
+ */
+class LayoutCheckpoints {
+  public:
+    #pragma pack(push, 1)
+    struct Step {
+      uint16_t childIndex;  ///< Index of the child node entered at this level
+      int32_t  entryOffset; ///< Item offset when the child node was entered
+    };
+    #pragma pack(pop)
+
+    using Path = HimemVector<Step>;
+
+    /**
+     * Record the path leading to the start of the page at offset in item
+     * itemrefIndex. An already known offset is ignored.
+     */
+    auto record(int16_t itemrefIndex, int32_t offset, const Path &path) -> void;
+
+    /**
+     * Retrieve the path of the checkpoint nearest to, but not after, offset.
+     *
+     * @return The offset of that checkpoint, or -1 if there is none.
+     */
+    auto nearest(int16_t itemrefIndex, int32_t offset, Path &path) -> int32_t;
+
+    auto clear() -> void;
+
+    [[nodiscard]] auto size() -> uint32_t;
+
+  private:
+    struct Checkpoint {
+      int32_t  offset;
+      uint32_t firstStep;
+      uint8_t  depth;
+    };
+
+    struct Item {
+      HimemVector<Checkpoint> checkpoints; ///< Sorted by offset
+      HimemVector<Step> steps;             ///< Paths of all checkpoints, back to back
+    };
+
+    std::mutex mutex;
+    HimemVector<Item> items;
+    uint32_t count{ 0 };
+};
@@ -23,6 +23,7 @@
 #include <atomic>
 #include <cerrno>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
 #include <fstream>
 #include <ios>
@@ -89,16 +90,20 @@ auto PageLocs::retrieveAsap(int16_t itemrefIndex) -> bool {
                                   .itemrefCount  = 0,
                                   .correlationId = requestId };
 
+  // Callers of retrieveAsap() hold PageLocs::mutex while waiting for ASAP_READY.
+  // The worker of the requested item merges it without the mutex in that
+  // phase (see commitPendingItem()). Recorded before the request is sent, as
+  // the item may already be about to be committed.
+  asapWaitItemref.store(itemrefIndex);
+  relax.fetch_add(1);
+
   if (PageLocsControl::send(cmd) < 0) {
     LOG_W("retrieveAsap: failed to send GET_ASAP");
     telemetry.queueSendFailures.fetch_add(1);
+    endAsapWait();
     return false;
   }
 
-  // Callers of retrieveAsap() hold PageLocs::mutex while waiting for ASAP_READY.
-  // Allow retriever inserts to bypass mutex acquisition in that specific phase.
-  relax.fetch_add(1, std::memory_order_relaxed);
-
   bool      gotReply = false;
   bool      matched  = false;
   QueueData queueData;
@@ -150,7 +155,7 @@ auto PageLocs::retrieveAsap(int16_t itemrefIndex) -> bool {
           static_cast<unsigned long long>(telemetry.asapRepliesMatched.load()),
           static_cast<unsigned long long>(telemetry.asapRepliesMismatched.load()),
           static_cast<unsigned long long>(telemetry.asapReplyTimeouts.load()));
-    relax.fetch_sub(1, std::memory_order_relaxed);
+    endAsapWait();
     return false;
   }
 
@@ -158,11 +163,26 @@ auto PageLocs::retrieveAsap(int16_t itemrefIndex) -> bool {
     telemetry.asapRepliesMatched.fetch_add(1);
   }
 
-  relax.fetch_sub(1, std::memory_order_relaxed);
+  endAsapWait();
 
   return matched;
 }
 
+/**
+ * End the wait of retrieveAsap(): the merges deferred by the other workers
+ * while waiting are done here, as the caller still holds PageLocs::mutex.
+ * Under commitMutex, no worker can be merging, nor defer a merge afterwards.
+ */
+auto PageLocs::endAsapWait() -> void {
+  std::scoped_lock commitGuard(commitMutex);
+
+  asapWaitItemref.store(-1);
+  relax.fetch_sub(1);
+
+  for (auto &item : deferredItems) { mergePendingItem(item); }
+  deferredItems.clear();
+}
+
 /**
  * Stop control/retriever pipeline, wait for STOPPED, and flush deferred save.
  */
@@ -252,9 +272,9 @@ auto PageLocs::stopControlTask() -> void {
 auto PageLocs::getPageCountOrPercent() -> int16_t {
   if (isControlTaskReadyToBeStopped()) { stopControlTask(); }
 
-  // LOG_I("getPageCountOrPercent: completed={} aborted={} controlTask={} itemsSet.size()={} "
+  // LOG_I("getPageCountOrPercent: completed={} aborted={} controlTask={} presentItems={} "
   //       "itemCount={}",
-  //       completed, aborted, controlTask ? "yes" : "no", static_cast<int>(itemsSet.size()),
+  //       completed, aborted, controlTask ? "yes" : "no", static_cast<int>(pagesTable.presentItemCount()),
   //       static_cast<int>(itemCount));
 
   if (completed) { return pageCount; }
@@ -270,9 +290,9 @@ auto PageLocs::getPageCountOrPercent() -> int16_t {
     std::scoped_lock guard(mutex);
     if (itemCount <= 0) { return 0; }
 
-    int16_t percent = static_cast<int16_t>((itemsSet.size() * 100) / itemCount);
+    int16_t percent = static_cast<int16_t>((pagesTable.presentItemCount() * 100) / itemCount);
 
-    // LOG_I("Progress: {}%% ({}/{} items)", percent, static_cast<int>(itemsSet.size()),
+    // LOG_I("Progress: {}%% ({}/{} items)", percent, static_cast<int>(pagesTable.presentItemCount()),
     //       static_cast<int>(itemCount));
 
     if (percent < 0) { percent = 0; }
@@ -292,34 +312,65 @@ auto PageLocs::startNewDocument(EPubPtr &epub, int16_t itemrefIndex) -> void {
 }
 
 /**
- * Insert one computed page boundary into shared map/set under strict locking.
+ * Stage one computed page boundary for the item being computed by a retriever
+ * worker. Boundaries reach the shared table when the item is committed.
  */
-auto PageLocs::insert(PageId &id, PageInfo &info) -> void {
+auto PageLocs::insert(PendingItem &pending, PageId &id, PageInfo &info) -> void {
   // LOG_I("Inserting page: PageId{itemref={} offset={}} PageInfo{size={} pageNumber={}}",
   //       id.itemrefIndex, id.offset, info.size, info.pageNumber);
-  if (controlTask && (relax.load(std::memory_order_relaxed) > 0)) {
-    // A waiter is blocked in retrieveAsap() while holding PageLocs::mutex.
-    // Insert directly to avoid starving retriever progress until timeout.
-    auto inserted = pagesMap.insert(std::make_pair(id, info));
-    if (inserted.second) {
-      itemsSet.insert(id.itemrefIndex);
-      generatedPageEntryCount.fetch_add(1, std::memory_order_relaxed);
-      telemetry.mapInsertions.fetch_add(1);
-    }
-    return;
+  if (id.itemrefIndex != pending.itemrefIndex) {
+    commitPendingItem(pending);
+    pending.itemrefIndex = id.itemrefIndex;
+  }
+  if (pending.entries.empty() || (pending.entries.back().offset < id.offset)) {
+    pending.entries.push_back(
+      PageEntry{ .itemrefIndex = id.itemrefIndex, .offset = id.offset, .size = info.size,
+                 .pageNumber = info.pageNumber });
   }
+}
+
+auto PageLocs::mergePendingItem(PendingItem &pending) -> void {
+  uint32_t added =
+    pagesTable.appendItem(pending.itemrefIndex, pending.entries.data(), pending.entries.size());
+  generatedPageEntryCount.fetch_add(added, std::memory_order_relaxed);
+  telemetry.mapInsertions.fetch_add(added);
+}
+
+/**
+ * Merge the staged boundaries of an item into the shared table under strict
+ * locking. Called by a retriever worker when an item is done (or interrupted:
+ * merging a partial item again later is harmless). The workers merge one at
+ * a time.
+ *
+ * While a caller of retrieveAsap() waits with PageLocs::mutex held, the worker
+ * of the requested item merges without the mutex: the caller is blocked until
+ * that worker reports the item. Any other worker cannot know whether the
+ * caller is still blocked, and cannot wait for the mutex either (an ASAP
+ * request may need it to stop first): its merge is deferred to endAsapWait().
+ */
+auto PageLocs::commitPendingItem(PendingItem &pending) -> void {
+  if (pending.entries.empty()) { return; }
+
+  std::scoped_lock commitGuard(commitMutex);
 
   bool contentious = false;
-  int  attempts     = 0;
+  int  attempts    = 0;
 
   while (true) {
-    if (mutex.try_lock_for(std::chrono::milliseconds(2))) {
-      auto inserted = pagesMap.insert(std::make_pair(id, info));
-      if (inserted.second) {
-        itemsSet.insert(id.itemrefIndex);
-        generatedPageEntryCount.fetch_add(1, std::memory_order_relaxed);
-        telemetry.mapInsertions.fetch_add(1);
+    if (controlTask && (relax.load() > 0)) {
+      // A waiter is in retrieveAsap() while holding PageLocs::mutex. This is
+      // checked again on every attempt, as the waiter may have taken the
+      // mutex after the first one.
+      if (pending.itemrefIndex == asapWaitItemref.load()) {
+        mergePendingItem(pending);
+      } else {
+        deferredItems.push_back(std::move(pending));
+        telemetry.deferredMerges.fetch_add(1);
       }
+      break;
+    }
+    if (mutex.try_lock_for(std::chrono::milliseconds(2))) {
+      mergePendingItem(pending);
       mutex.unlock();
       if (contentious) {
         telemetry.mapLockContentions.fetch_add(1);
@@ -329,101 +380,102 @@ auto PageLocs::insert(PageId &id, PageInfo &info) -> void {
     attempts++;
     contentious = (attempts > 1);
   }
+
+  pending.entries.clear();
+  pending.itemrefIndex = -1;
 }
 
 /**
  * Lookup helper that triggers ASAP retrieval when data is missing and
  * computation is still active.
  */
-auto PageLocs::checkAndFind(const PageId &pageId) -> PageLocs::PagesMap::iterator {
-  if (pageId.itemrefIndex < 0) { return pagesMap.end(); }
+auto PageLocs::checkAndFind(const PageId &pageId) -> int32_t {
+  if (pageId.itemrefIndex < 0) { return PagesTable::NOT_FOUND; }
 
-  PagesMap::iterator it = pagesMap.find(pageId);
-  if (!completed && (it == pagesMap.end())) {
-    if (retrieveAsap(pageId.itemrefIndex)) { it = pagesMap.find(pageId); }
+  int32_t idx = pagesTable.find(pageId);
+  if (!completed && (idx == PagesTable::NOT_FOUND)) {
+    if (retrieveAsap(pageId.itemrefIndex)) { idx = pagesTable.find(pageId); }
   }
-  return it;
+  return idx;
 }
 
 /**
  * Resolve next navigable page from current page id, optionally stepping by
  * multiple pages and crossing item boundaries.
+ *
+ * The returned PageId is a per-thread copy, valid until the next call from
+ * the same thread.
  */
 auto PageLocs::getNextPageId(const PageId &pageId, int16_t count) -> const PageId * {
+  static thread_local PageId result;
 
   if (isControlTaskReadyToBeStopped()) { stopControlTask(); }
 
   {
-    std::scoped_lock   guard(mutex);
-    PagesMap::iterator it = checkAndFind(pageId);
-    if (it == pagesMap.end()) {
-      it = checkAndFind(PageId(0, 0));
+    std::scoped_lock guard(mutex);
+    int32_t          idx = checkAndFind(pageId);
+    if (idx == PagesTable::NOT_FOUND) {
+      idx = checkAndFind(PageId(0, 0));
     } else {
-      PageId id = pageId;
-      bool   done = false;
+      bool done = false;
       for (int16_t cptr = count; cptr > 0; cptr--) {
-        PagesMap::iterator prev = it;
+        // Kept as a PageId: an ASAP retrieval below may shift table indexes.
+        PageId prev = pagesTable.pageIdAt(idx);
         do {
-          id.offset += abs(it->second.size);
-          it = pagesMap.find(id);
-          if (it == pagesMap.end()) {
+          int16_t itemrefIndex = pagesTable[idx].itemrefIndex;
+          if (idx < pagesTable.lastOfItem(itemrefIndex)) {
+            idx++;
+          } else {
             // We have reached the end of the current item. Move to the next
             // item and try again.
-            id.itemrefIndex += 1;
-            id.offset = 0;
-            it        = checkAndFind(id);
-            if (it == pagesMap.end()) {
+            idx = checkAndFind(PageId(itemrefIndex + 1, 0));
+            if (idx == PagesTable::NOT_FOUND) {
               // We have reached the end of the list. If stepping one page at
               // a time, go to the first page.
-              it   = (count > 1) ? prev : checkAndFind(PageId(0, 0));
+              idx  = (count > 1) ? pagesTable.find(prev) : checkAndFind(PageId(0, 0));
               done = true;
             }
           }
-        } while (!done && (it->second.size < 0));
+        } while (!done && (pagesTable[idx].size < 0));
         if (done) { break; }
       }
     }
-    return (it == pagesMap.end()) ? nullptr : &it->first;
+    if (idx == PagesTable::NOT_FOUND) { return nullptr; }
+    result = pagesTable.pageIdAt(idx);
+    return &result;
   }
 }
 
 /**
  * Resolve previous navigable page from current page id, optionally stepping by
  * multiple pages and crossing item boundaries.
+ *
+ * The returned PageId is a per-thread copy, valid until the next call from
+ * the same thread.
  */
 auto PageLocs::getPrevPageId(const PageId &pageId, int count) -> const PageId * {
+  static thread_local PageId result;
 
   if (isControlTaskReadyToBeStopped()) { stopControlTask(); }
 
   {
-    std::scoped_lock   guard(mutex);
+    std::scoped_lock guard(mutex);
 
-    PagesMap::iterator it = checkAndFind(pageId);
-    if (it == pagesMap.end()) {
-      it = checkAndFind(PageId(0, 0));
+    int32_t idx = checkAndFind(pageId);
+    if (idx == PagesTable::NOT_FOUND) {
+      idx = checkAndFind(PageId(0, 0));
     } else {
-      PageId id           = it->first;
-      auto   stepBackNoWrap = [&](PagesMap::iterator &iter, PageId &page) -> bool {
-                                if (iter == pagesMap.begin()) { return false; }
-                                iter--;
-                                page = iter->first;
-                                return true;
-                              };
-
       bool done = false;
       for (int16_t cptr = count; cptr > 0; cptr--) {
         do {
-          if (id.offset == 0) {
-            int16_t targetItemref = id.itemrefIndex;
+          int16_t itemrefIndex = pagesTable[idx].itemrefIndex;
+
+          if (idx == pagesTable.firstOfItem(itemrefIndex)) {
+            int16_t targetItemref = itemrefIndex;
 
             if (targetItemref == 0) {
-              if (count == 1) {
-                if (itemCount > 0) {
-                  targetItemref = itemCount - 1;
-                }
-                else {
-                  done = true;
-                }
+              if ((count == 1) && (itemCount > 0)) {
+                targetItemref = itemCount - 1;
               } else {
                 done = true;
               }
@@ -432,66 +484,51 @@ auto PageLocs::getPrevPageId(const PageId &pageId, int count) -> const PageId *
             }
 
             if (!done) {
-              PagesMap::iterator firstInItem = checkAndFind(PageId(targetItemref, 0));
-              if ((firstInItem != pagesMap.end()) &&
-                  (firstInItem->first.itemrefIndex == targetItemref)) {
-                PagesMap::iterator nextItem =
-                  pagesMap.lower_bound(PageId(static_cast<int16_t>(targetItemref + 1), 0));
-                if (nextItem == pagesMap.begin()) {
-                  it   = pagesMap.end();
-                  done = true;
-                } else {
-                  it = nextItem;
-                  it--;
-                  if (it->first.itemrefIndex != targetItemref) {
-                    it   = pagesMap.end();
-                    done = true;
-                  } else {
-                    id = it->first;
-                  }
-                }
+              if (checkAndFind(PageId(targetItemref, 0)) != PagesTable::NOT_FOUND) {
+                idx = pagesTable.lastOfItem(targetItemref);
               } else {
-                it   = pagesMap.end();
+                idx  = PagesTable::NOT_FOUND;
                 done = true;
               }
             }
           } else {
-            if (!stepBackNoWrap(it, id)) {
-              it   = pagesMap.end();
-              done = true;
-            }
+            idx--;
           }
 
-        } while (!done && (it->second.size < 0));
+        } while (!done && (pagesTable[idx].size < 0));
         if (done) { break; }
       }
     }
-    return (it == pagesMap.end()) ? nullptr : &it->first;
+    if (idx == PagesTable::NOT_FOUND) { return nullptr; }
+    result = pagesTable.pageIdAt(idx);
+    return &result;
   }
 }
 
 /**
  * Resolve the page entry containing a specific item offset.
+ *
+ * The returned PageId is a per-thread copy, valid until the next call from
+ * the same thread.
  */
 auto PageLocs::getPageId(const PageId &pageId) -> const PageId * {
+  static thread_local PageId result;
 
   if (isControlTaskReadyToBeStopped()) { stopControlTask(); }
 
   {
-    std::scoped_lock   guard(mutex);
-
-    PagesMap::iterator it     = checkAndFind(PageId(pageId.itemrefIndex, 0));
-    PagesMap::iterator result = pagesMap.end();
-    while ((it != pagesMap.end()) && (it->first.itemrefIndex == pageId.itemrefIndex)) {
-      if ((it->first.offset == pageId.offset) ||
-          ((it->first.offset < pageId.offset) &&
-           ((it->first.offset + abs(it->second.size)) > pageId.offset))) {
-        result = it;
-        break;
-      }
-      ++it;
+    std::scoped_lock guard(mutex);
+
+    if (checkAndFind(PageId(pageId.itemrefIndex, 0)) == PagesTable::NOT_FOUND) { return nullptr; }
+
+    int32_t idx = pagesTable.findFloor(pageId);
+    if ((idx == PagesTable::NOT_FOUND) ||
+        ((pagesTable[idx].offset != pageId.offset) &&
+         ((pagesTable[idx].offset + abs(pagesTable[idx].size)) <= pageId.offset))) {
+      return nullptr;
     }
-    return (result == pagesMap.end()) ? nullptr : &result->first;
+    result = pagesTable.pageIdAt(idx);
+    return &result;
   }
 }
 
@@ -503,8 +540,8 @@ auto PageLocs::computationCompleted() -> void {
 
   if (!completed) {
     int16_t pageNbr = 0;
-    for (auto &entry : pagesMap) {
-      if (entry.second.size >= 0) { entry.second.pageNumber = pageNbr++; }
+    for (auto &entry : pagesTable) {
+      if (entry.size >= 0) { entry.pageNumber = pageNbr++; }
     }
 
     pageCount = pageNbr;
@@ -554,9 +591,9 @@ auto PageLocs::computationAborted(std::string reason) -> void {
 #if DEBUGGING
   auto PageLocs::show() -> void {
     std::cout << "----- Page Locations -----" << std::endl;
-    for (auto &entry : pagesMap) {
-      std::cout << " idx: " << entry.first.itemrefIndex << " off: " << entry.first.offset
-                << " siz: " << entry.second.size << " pg: " << entry.second.pageNumber << std::endl;
+    for (auto &entry : pagesTable) {
+      std::cout << " idx: " << entry.itemrefIndex << " off: " << entry.offset
+                << " siz: " << entry.size << " pg: " << entry.pageNumber << std::endl;
     }
     std::cout << "----- End Page Locations -----" << std::endl;
   }
@@ -629,8 +666,62 @@ auto PageLocs::checkForFormatChanges(EPubPtr &epub, int16_t itemrefIndex, bool f
   }
 }
 
+/**
+ * CRC-32 of a v5 .locs image: header fields preceding the crc, then records.
+ */
+auto PageLocs::locsCrc(const LocsHeader &header, const LocsRecord *records) -> uint32_t {
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const uint8_t *>(&header),
+                          offsetof(LocsHeader, crc));
+  crc = mz_crc32(crc, reinterpret_cast<const uint8_t *>(records),
+                 header.recordCount * sizeof(LocsRecord));
+  return static_cast<uint32_t>(crc);
+}
+
+/**
+ * Read the v4 layout (one small read per field and entry). The version byte
+ * has already been consumed. Kept only to migrate files saved by older
+ * releases.
+ */
+auto PageLocs::loadV4(std::ifstream &file) -> bool {
+  int16_t pgCount;
+
+  if (file.read(reinterpret_cast<char *>(&currentFormatParams), sizeof(currentFormatParams))
+      .fail()) {
+    return false;
+  }
+  if (file.read(reinterpret_cast<char *>(&pgCount), sizeof(pgCount)).fail()) { return false; }
+
+  pagesTable.clear();
+  generatedPageEntryCount.store(0);
+
+  int16_t pageNbr = 0;
+
+  for (int16_t i = 0; i < pgCount; ++i) {
+    PageId   pageId;
+    PageInfo pageInfo;
+
+    if (file.read(reinterpret_cast<char *>(&pageId.itemrefIndex), sizeof(pageId.itemrefIndex))
+        .fail()) {
+      break;
+    }
+    if (file.read(reinterpret_cast<char *>(&pageId.offset), sizeof(pageId.offset)).fail()) { break; }
+    if (file.read(reinterpret_cast<char *>(&pageInfo.size), sizeof(pageInfo.size)).fail()) { break; }
+    pageInfo.pageNumber = (pageInfo.size >= 0) ? pageNbr++ : -1;
+
+    insert(pendingItem, pageId, pageInfo);
+  }
+  commitPendingItem(pendingItem);
+
+  pageCount = pageNbr;
+  return !file.fail();
+}
+
 /**
  * Load persisted page locations and associated format metadata from .locs file.
+ *
+ * The v5 layout is read with two block reads (header, then all records) and
+ * checked against its CRC before the pages table is rebuilt in one pass.
+ * A v4 file is read with the legacy reader and immediately rewritten as v5.
  */
 auto PageLocs::load(const std::string &epubFilename) -> bool {
   std::string   filename = epubFilename.substr(0, epubFilename.find_last_of('.')) + ".locs";
@@ -638,48 +729,66 @@ auto PageLocs::load(const std::string &epubFilename) -> bool {
 
   LOG_D("Loading pages location from file {}.", filename);
 
-  int8_t  version;
-  int16_t pgCount;
-
   if (!file.is_open()) {
     LOG_I("Unable to open pages location file '{}': errno{}d ({}). Calculating locations...",
           filename, errno, std::strerror(errno));
     return false;
   }
 
-  bool ok = false;
+  bool       ok = false;
+  bool       migrate = false;
+  LocsHeader header;
+
   while (true) {
-    if (file.read(reinterpret_cast<char *>(&version), 1).fail()) { break; }
-    if (version != LOCS_FILE_VERSION) { break; }
+    if (file.read(reinterpret_cast<char *>(&header.version), 1).fail()) { break; }
 
-    if (file.read(reinterpret_cast<char *>(&currentFormatParams), sizeof(currentFormatParams))
-        .fail()) {
+    if (header.version == LOCS_V4_VERSION) {
+      ok = migrate = loadV4(file);
       break;
     }
-    if (file.read(reinterpret_cast<char *>(&pgCount), sizeof(pgCount)).fail()) { break; }
+    if (header.version != LOCS_FILE_VERSION) { break; }
 
-    pagesMap.clear();
-    generatedPageEntryCount.store(0);
+    if (file.read(reinterpret_cast<char *>(&header) + 1, sizeof(header) - 1).fail()) { break; }
 
-    int16_t pageNbr = 0;
+    HimemUniquePtr<LocsRecord[]> records = makeUniqueHimem<LocsRecord[]>(header.recordCount);
+    if ((header.recordCount > 0) && (records == nullptr)) {
+      LOG_E("Not enough memory to load {} page locations.", header.recordCount);
+      break;
+    }
+    if (file.read(reinterpret_cast<char *>(records.get()),
+                  header.recordCount * sizeof(LocsRecord)).fail()) {
+      break;
+    }
+    if (locsCrc(header, records.get()) != header.crc) {
+      LOG_E("Page locations file '{}' CRC mismatch.", filename);
+      break;
+    }
 
-    for (int16_t i = 0; i < pgCount; ++i) {
-      PageId   pageId;
-      PageInfo pageInfo;
+    std::scoped_lock guard(mutex);
 
-      if (file.read(reinterpret_cast<char *>(&pageId.itemrefIndex), sizeof(pageId.itemrefIndex))
-          .fail()) {
-        break;
-      }
-      if (file.read(reinterpret_cast<char *>(&pageId.offset), sizeof(pageId.offset)).fail()) { break; }
-      if (file.read(reinterpret_cast<char *>(&pageInfo.size), sizeof(pageInfo.size)).fail()) { break; }
-      pageInfo.pageNumber = (pageInfo.size >= 0) ? pageNbr++ : -1;
+    currentFormatParams = header.formatParams;
+    pagesTable.clear();
+    pagesTable.reserve(header.recordCount);
 
-      pageLocs.insert(pageId, pageInfo);
+    int16_t pageNbr = 0;
+    bool    sorted  = true;
+
+    for (uint32_t i = 0; sorted && (i < header.recordCount); ++i) {
+      const LocsRecord &rec = records[i];
+      sorted = pagesTable.pushBackSorted(
+        PageEntry{ .itemrefIndex = rec.itemrefIndex, .offset = rec.offset, .size = rec.size,
+                   .pageNumber = (int16_t)((rec.size >= 0) ? pageNbr++ : -1) });
     }
 
+    if (!sorted) {
+      LOG_E("Page locations file '{}' records are not sorted.", filename);
+      pagesTable.clear();
+      break;
+    }
+
+    generatedPageEntryCount.store(header.recordCount);
     pageCount = pageNbr;
-    ok        = !file.fail();
+    ok        = true;
     break;
   }
 
@@ -694,56 +803,56 @@ auto PageLocs::load(const std::string &epubFilename) -> bool {
 
   completed = ok;
 
+  if (migrate) {
+    LOG_I("Migrating pages location file '{}' to version {}.", filename, LOCS_FILE_VERSION);
+    save(epubFilename);
+  }
+
   return ok;
 }
 
 /**
  * Persist current page locations and format metadata to .locs file.
+ *
+ * The records are packed into one PSRAM buffer, in PageId order, and written
+ * after the header with a single write.
  */
 auto PageLocs::save(const std::string &epubFilename) -> bool {
-  std::string   filename = epubFilename.substr(0, epubFilename.find_last_of('.')) + ".locs";
-  std::ofstream file(filename, std::ios::out | std::ios::binary);
+  std::string filename = epubFilename.substr(0, epubFilename.find_last_of('.')) + ".locs";
 
   LOG_D("Saving pages location to file {}", filename);
 
-  if (!file.is_open()) {
-    LOG_E("Not able to open pages location file '{}': errno={} ({})", filename, errno,
-          std::strerror(errno));
+  LocsHeader header;
+  header.version      = LOCS_FILE_VERSION;
+  header.formatParams = currentFormatParams;
+  header.recordCount  = pagesTable.size();
+
+  HimemUniquePtr<LocsRecord[]> records = makeUniqueHimem<LocsRecord[]>(header.recordCount);
+  if ((header.recordCount > 0) && (records == nullptr)) {
+    LOG_E("Not enough memory to save {} page locations.", header.recordCount);
     return false;
   }
 
-  int16_t savedPageCount = pagesMap.size();
+  LocsRecord *rec = records.get();
+  for (auto &entry : pagesTable) {
+    rec->itemrefIndex = entry.itemrefIndex;
+    rec->offset       = entry.offset;
+    rec->size         = entry.size;
+    ++rec;
+  }
+  header.crc = locsCrc(header, records.get());
 
-  while (true) {
-    if (file.write(reinterpret_cast<const char *>(&LOCS_FILE_VERSION), 1).fail()) { break; }
-    if (file.write(reinterpret_cast<const char *>(&currentFormatParams),
-                   sizeof(currentFormatParams))
-        .fail()) {
-      break;
-    }
-    if (file.write(reinterpret_cast<const char *>(&savedPageCount), sizeof(savedPageCount)).fail()) {
-      break;
-    }
+  std::ofstream file(filename, std::ios::out | std::ios::binary);
 
-    for (auto &pageMapEntry : pagesMap) {
-      if (file.write(reinterpret_cast<const char *>(&pageMapEntry.first.itemrefIndex),
-                     sizeof(pageMapEntry.first.itemrefIndex))
-          .fail()) {
-        break;
-      }
-      if (file.write(reinterpret_cast<const char *>(&pageMapEntry.first.offset),
-                     sizeof(pageMapEntry.first.offset))
-          .fail()) {
-        break;
-      }
-      if (file.write(reinterpret_cast<const char *>(&pageMapEntry.second.size),
-                     sizeof(pageMapEntry.second.size))
-          .fail()) {
-        break;
-      }
-    }
+  if (!file.is_open()) {
+    LOG_E("Not able to open pages location file '{}': errno={} ({})", filename, errno,
+          std::strerror(errno));
+    return false;
+  }
 
-    break;
+  if (!file.write(reinterpret_cast<const char *>(&header), sizeof(header)).fail()) {
+    file.write(reinterpret_cast<const char *>(records.get()),
+               header.recordCount * sizeof(LocsRecord));
   }
 
   bool res = !file.fail();
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <fstream>
 #include <mutex>
 #include <thread>
 
@@ -24,7 +25,9 @@
 #endif
 
 #include "models/epub.hpp"
+#include "models/layout_checkpoints.hpp"
 #include "models/page_locs_control.hpp"
+#include "models/pages_table.hpp"
 #include "viewers/html_interpreter.hpp"
 #include "viewers/page.hpp"
 
@@ -57,17 +60,8 @@ public:
     PageInfo() {};
   };
 
-  struct PageCompare {
-    auto operator()(const PageId &lhs, const PageId &rhs) const -> bool {
-      if (lhs.itemrefIndex < rhs.itemrefIndex) return true;
-      if (lhs.itemrefIndex > rhs.itemrefIndex) return false;
-      return lhs.offset < rhs.offset;
-    }
-  };
-
-  using PagePair = std::pair<const PageId, PageInfo>;
-  using PagesMap = HimemMap<PageId, PageInfo, PageCompare>;
-  using ItemsSet = HimemSet<int16_t>;
+  using PageEntry   = PagesTable::Entry;
+  using PendingItem = PagesTable::PendingItem;
 
   enum class Req : int8_t { NONE, ASAP_READY, STOPPED, PERCENT, COMPLETED };
 
@@ -99,6 +93,7 @@ public:
     std::atomic<uint64_t> percentRequestsSubmitted{0};
     std::atomic<uint64_t> mapInsertions{0};
     std::atomic<uint64_t> mapLockContentions{0};
+    std::atomic<uint64_t> deferredMerges{0};
     std::atomic<uint64_t> queueSendFailures{0};
 
     // Hardening #3: Bounded waits/timeouts
@@ -114,7 +109,25 @@ public:
   static constexpr int STOP_TOTAL_TIMEOUT_MS = 4000; // 4 second hard limit
 private:
   static constexpr const char *TAG                = "PageLocs";
-  static constexpr const int8_t LOCS_FILE_VERSION = 4;
+  static constexpr const int8_t LOCS_FILE_VERSION = 5;
+  static constexpr const int8_t LOCS_V4_VERSION   = 4; ///< Still readable, migrated on load
+
+  // .locs v5 layout: one LocsHeader followed by recordCount LocsRecord entries
+  // sorted by PageId. The CRC covers the header (crc field excluded) and all
+  // records, so the whole file is read or written with a single block I/O.
+  #pragma pack(push, 1)
+  struct LocsHeader {
+    int8_t version;
+    EPub::BookFormatParams formatParams;
+    uint32_t recordCount;
+    uint32_t crc;
+  };
+  struct LocsRecord {
+    int16_t itemrefIndex;
+    int32_t offset;
+    int32_t size;
+  };
+  #pragma pack(pop)
 
   bool completed{false};
   bool aborted{false};
@@ -128,9 +141,26 @@ private:
 
   PageLocsControlPtr controlTask{nullptr};
 
-  PagesMap pagesMap;
-  ItemsSet itemsSet;
+  PagesTable pagesTable;
   int16_t itemCount{0};
+
+  // Resume points in the layout of items, found while computing the pages
+  // location or while showing pages. They are not saved in the .locs file.
+  LayoutCheckpoints checkpoints;
+
+  // Entries read by loadV4(). Each retriever worker stages the item it computes
+  // in its own PendingItem: they are merged into pagesTable as a whole by
+  // commitPendingItem(), keeping the page by page inserts out of the shared
+  // table and its mutex.
+  PendingItem pendingItem;
+  std::mutex commitMutex; // Serializes the merges of the retriever workers
+
+  // While a caller of retrieveAsap() waits for an item, holding the mutex,
+  // only the worker of that item merges into pagesTable: the merges of the
+  // other workers are kept in deferredItems (guarded by commitMutex) until
+  // the caller is done waiting.
+  std::atomic<int16_t> asapWaitItemref{-1};
+  HimemVector<PendingItem> deferredItems;
   std::atomic<uint32_t> generatedPageEntryCount{0};
 
   std::string currentFilename;
@@ -146,7 +176,9 @@ private:
 
   auto show() -> void;
   auto retrieveAsap(int16_t itemrefIndex) -> bool;
-  auto checkAndFind(const PageId &pageId) -> PagesMap::iterator;
+  auto checkAndFind(const PageId &pageId) -> int32_t;
+  auto mergePendingItem(PendingItem &pending) -> void;
+  auto endAsapWait() -> void;
 
   // ----- Page Locations computation -----
 
@@ -155,6 +187,8 @@ private:
 
   auto load(const std::string &epubFilename) -> bool; ///< load pages location from .locs file
   auto save(const std::string &epubFilename) -> bool; ///< save pages location to .locs file
+  auto loadV4(std::ifstream &file) -> bool;           ///< read the pre-v5 per-entry layout
+  static auto locsCrc(const LocsHeader &header, const LocsRecord *records) -> uint32_t;
 
 #if EPUB_LINUX_BUILD
   static mqd_t mgrQueue;
@@ -193,7 +227,8 @@ public:
   auto getPageId(const PageId &pageId) -> const PageId *;
 
   auto getItemInfo() -> const EPub::ItemInfo & { return itemInfo; }
-  auto getPagesMap() -> const PagesMap & { return pagesMap; }
+  auto getPagesTable() -> const PagesTable & { return pagesTable; }
+  auto getCheckpoints() -> LayoutCheckpoints & { return checkpoints; }
 
   auto checkForFormatChanges(EPubPtr &epub, int16_t itemrefIndex, bool force = false) -> void;
   auto computationCompleted() -> void;
@@ -202,12 +237,20 @@ public:
 
   [[nodiscard]] inline auto isRunning() const -> bool { return controlTask != nullptr; }
 
+  /**
+   * The returned PageInfo is a per-thread copy, valid until the next call
+   * from the same thread: table entries move when items are merged.
+   */
   [[nodiscard]] inline auto getPageInfo(const PageId &pageId) -> const PageInfo * {
+    static thread_local PageInfo result;
+
     if (isControlTaskReadyToBeStopped()) stopControlTask();
 
     std::scoped_lock guard(mutex);
-    PagesMap::iterator it = checkAndFind(pageId);
-    return it == pagesMap.end() ? nullptr : &it->second;
+    int32_t idx = checkAndFind(pageId);
+    if (idx == PagesTable::NOT_FOUND) { return nullptr; }
+    result = PageInfo(pagesTable[idx].size, pagesTable[idx].pageNumber);
+    return &result;
   }
 
   [[nodiscard]] inline auto getCurrentItemrefIndex() const {
@@ -222,15 +265,18 @@ public:
     return computationDone.load();
   }
 
-  auto insert(PageId &id, PageInfo &info) -> void;
+  auto insert(PendingItem &pending, PageId &id, PageInfo &info) -> void;
+  auto commitPendingItem(PendingItem &pending) -> void;
 
   inline auto clear() -> void {
     if (isControlTaskReadyToBeStopped()) stopControlTask();
 
     {
       std::scoped_lock guard(mutex);
-      pagesMap.clear();
-      itemsSet.clear();
+      pagesTable.clear();
+      pendingItem.entries.clear();
+      pendingItem.itemrefIndex = -1;
+      checkpoints.clear();
       generatedPageEntryCount.store(0);
       completed                   = false;
       aborted                     = false;
@@ -251,8 +297,8 @@ public:
         // LOG_W("Page Locs not completed.");
         return -1;
       }
-      PagesMap::iterator it = checkAndFind(id);
-      return it == pagesMap.end() ? -1 : it->second.pageNumber;
+      int32_t idx = checkAndFind(id);
+      return (idx == PagesTable::NOT_FOUND) ? -1 : pagesTable[idx].pageNumber;
     }
   };
 };
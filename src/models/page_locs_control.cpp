@@ -2,6 +2,7 @@
 
 #include "models/page_locs.hpp"
 
+#include <algorithm>
 #include <chrono>
 
 namespace {
@@ -22,11 +23,11 @@ namespace {
     return false;
   }
 
-  auto sendToRetrieverChecked(const PageLocsRetriever::QueueData &msg, const char *ctx,
-                              bool critical = false) -> bool {
+  auto sendToRetrieverChecked(PageLocsRetriever &retriever, const PageLocsRetriever::QueueData &msg,
+                              const char *ctx, bool critical = false) -> bool {
     const int attempts = critical ? kCriticalSendRetries : 1;
     for (int i = 0; i < attempts; ++i) {
-      if (PageLocsRetriever::send(msg) >= 0) { return true; }
+      if (retriever.send(msg) >= 0) { return true; }
       pageLocs.telemetry.queueSendFailures.fetch_add(1);
       LOG_W("{}: PageLocsRetriever::send failed (attempt {}/{})", ctx, i + 1, attempts);
     }
@@ -46,16 +47,30 @@ namespace {
 #endif
 
 /**
- * Initialize control-side queueing and start the control worker thread.
+ * Start the retriever workers, initialize control-side queueing and start the
+ * control worker thread.
  *
- * Returns false if either retriever setup or control queue/thread setup fails.
+ * Returns false if no retriever worker could be started, or if control
+ * queue/thread setup fails.
  */
 auto PageLocsControl::setup(const HimemString &epubFilename) -> bool {
 
-  if (!retrieverTask.setup(epubFilename)) {
-    LOG_E("Unable to setup retriever task");
-    return false;
+  uint32_t count = (requestedWorkerCount != 0) ? requestedWorkerCount : PAGE_LOCS_WORKERS;
+  #if EPUB_LINUX_BUILD
+    if (count == 0) { count = std::thread::hardware_concurrency(); }
+  #endif
+  count = std::clamp<uint32_t>(count, 1, MAX_WORKERS);
+
+  // A worker that cannot be started (e.g. out of memory for its EPub
+  // instance) only slows the computation down.
+  for (workerCount = 0; workerCount < count; workerCount++) {
+    if (!workers[workerCount].retriever.setup(epubFilename, workerCount)) {
+      LOG_E("Unable to setup retriever worker {}", workerCount);
+      break;
+    }
   }
+  if (workerCount == 0) { return false; }
+  LOG_D("{} page locations retriever workers", workerCount);
 
   #if EPUB_LINUX_BUILD
     mq_unlink("/control_mgr");
@@ -77,7 +92,7 @@ auto PageLocsControl::setup(const HimemString &epubFilename) -> bool {
   #else
 
     if (managerQueue == nullptr) {
-      managerQueue = xQueueCreate(5, sizeof(PageLocsControl::QueueData));
+      managerQueue = xQueueCreate(QUEUE_SIZE, sizeof(PageLocsControl::QueueData));
     } else {
       xQueueReset(managerQueue);
     }
@@ -87,7 +102,7 @@ auto PageLocsControl::setup(const HimemString &epubFilename) -> bool {
     }
 
     if (retrieverQueue == nullptr) {
-      retrieverQueue = xQueueCreate(5, sizeof(PageLocsControl::QueueData));
+      retrieverQueue = xQueueCreate(QUEUE_SIZE, sizeof(PageLocsControl::QueueData));
     } else {
       xQueueReset(retrieverQueue);
     }
@@ -128,87 +143,186 @@ auto PageLocsControl::waitForExit() -> void {
   #endif
 }
 
-auto PageLocsControl::sendPendingAsapReplies(int16_t itemref, const char *ctx,
-                                             bool alreadySentToMgr) -> void {
+auto PageLocsControl::sendPendingAsapReplies(int16_t itemref, const char *ctx) -> void {
   if (asapCorrelationIds.empty()) { return; }
 
   for (uint32_t correlationId : asapCorrelationIds) {
-    if (!alreadySentToMgr || (correlationId != asapCorrelationIds.front())) {
-      sendToMgrChecked({ .req           = PageLocs::Req::ASAP_READY,
-                         .correlationId = correlationId,
-                         .itemrefIndex  = itemref },
-                       ctx, true);
-    }
+    sendToMgrChecked({ .req           = PageLocs::Req::ASAP_READY,
+                       .correlationId = correlationId,
+                       .itemrefIndex  = itemref },
+                     ctx, true);
   }
   asapCorrelationIds.clear();
 }
 
+auto PageLocsControl::workerOf(int16_t itemref) const -> int8_t {
+  for (uint8_t w = 0; w < workerCount; w++) {
+    if (workers[w].itemref == itemref) { return w; }
+  }
+  return -1;
+}
+
+/**
+ * Send an item to a worker, marking it busy. A send failure is logged by
+ * the caller context; the worker stays busy, as the item is expected back.
+ */
+auto PageLocsControl::dispatch(uint8_t worker, PageLocsRetriever::Req req, int16_t itemref,
+                               uint32_t correlationId, const char *ctx, bool critical) -> bool {
+  Worker &wk = workers[worker];
+
+  wk.itemref            = itemref;
+  wk.asap               = (req == PageLocsRetriever::Req::GET_ASAP);
+  wk.aborting           = false;
+  wk.dispatchSeq        = ++dispatchSeq;
+  lastDispatchedItemref = itemref;
+
+  wk.retriever.clearAbort();
+
+  SHOW_IT("{} ({}) to worker {} ----> ", wk.asap ? "GET_ASAP" : "RETRIEVE_ITEM", itemref, worker);
+  return sendToRetrieverChecked(wk.retriever,
+                                { .req           = req,
+                                  .itemrefIndex  = itemref,
+                                  .correlationId = correlationId },
+                                ctx, critical);
+}
+
 /**
- * Select and dispatch the next retrieval work item.
+ * Select and dispatch the next retrieval work item for an idle worker.
  *
  * Priority is ASAP item, then deferred interrupted item, then next sequential
  * not-yet-computed item.
  */
-auto PageLocsControl::requestNextItem(int16_t itemref, bool alreadySentToMgr) -> void {
-  if (asapItemref != -1) { // is there an urgent spine to do?
-    if (itemref == asapItemref) {
-      asapItemref = -1;
-      // if (!alreadySentToMgr) SHOW_IT("Sending ASAP_READY to Mgr");
-      sendPendingAsapReplies(itemref, "requestNextItem/ASAP_READY", alreadySentToMgr);
-    } else {
-      waitingForItemref = asapItemref;
-      asapItemref       = -1;
-      SHOW_IT("GET_ASAP ({}) ----> ", waitingForItemref);
-      sendToRetrieverChecked(
-        { .req           = PageLocsRetriever::Req::GET_ASAP,
-          .itemrefIndex  = waitingForItemref,
-          .correlationId = asapCorrelationIds.empty() ? 0 : asapCorrelationIds.front() },
-        "requestNextItem/GET_ASAP");
-      return;
-    }
+auto PageLocsControl::requestNextItem(uint8_t worker) -> void {
+  if ((asapItemref != -1) && (workerOf(asapItemref) == -1)) { // is there an urgent spine to do?
+    dispatch(worker, PageLocsRetriever::Req::GET_ASAP, asapItemref,
+             asapCorrelationIds.empty() ? 0 : asapCorrelationIds.front(),
+             "requestNextItem/GET_ASAP");
+    return;
   }
+
+  if (itemrefCount <= 0) { return; }
+
+  int16_t itemref = -1;
+
   if (nextItemrefToGet != -1) {
-    waitingForItemref = nextItemrefToGet;
-    nextItemrefToGet  = -1;
-    SHOW_IT("RETRIEVE_ITEM ({}) ----> ", waitingForItemref);
-    sendToRetrieverChecked({ .req           = PageLocsRetriever::Req::RETRIEVE_ITEM,
-                             .itemrefIndex  = waitingForItemref,
-                             .correlationId = 0 },
-                           "requestNextItem/RETRIEVE_ITEM");
-  } else {
-    int16_t newref;
-    if (itemref != -1) {
-      newref = (itemref + 1) % itemrefCount;
-    } else {
-      itemref = 0;
-      newref  = 0;
+    if (!isDone(nextItemrefToGet) && (workerOf(nextItemrefToGet) == -1)) {
+      itemref = nextItemrefToGet;
     }
-    while ((bitset[newref >> 3] & (1 << (newref & 7))) != 0) {
+    nextItemrefToGet = -1;
+  }
+
+  if (itemref == -1) {
+    int16_t newref = (lastDispatchedItemref + 1) % itemrefCount;
+    for (int16_t count = 0; count < itemrefCount; count++) {
+      if (!isDone(newref) && (workerOf(newref) == -1)) {
+        itemref = newref;
+        break;
+      }
       newref = (newref + 1) % itemrefCount;
-      if (newref == itemref) { break; }
     }
-    if (newref != itemref) {
-      waitingForItemref = newref;
-      SHOW_IT("RETRIEVE_ITEM itemref {} ---->", waitingForItemref);
-      sendToRetrieverChecked({ .req           = PageLocsRetriever::Req::RETRIEVE_ITEM,
-                               .itemrefIndex  = waitingForItemref,
-                               .correlationId = 0 },
-                             "requestNextItem/RETRIEVE_ITEM_NEXT");
-    } else {
-      SHOW_IT("COMPLETED ->");
-      sendToRetrieverChecked({ .req = PageLocsRetriever::Req::COMPLETED },
-                             "requestNextItem/COMPLETED");
-      pageLocs.computationCompleted();
-      runningDown = true;
+  }
+
+  if (itemref != -1) {
+    dispatch(worker, PageLocsRetriever::Req::RETRIEVE_ITEM, itemref, 0,
+             "requestNextItem/RETRIEVE_ITEM");
+  }
+}
+
+auto PageLocsControl::dispatchWork() -> void {
+  if (itemrefCount == -1) { return; }
+
+  bool busy = false;
+
+  for (uint8_t w = 0; w < workerCount; w++) {
+    if (workers[w].itemref == -1) { requestNextItem(w); }
+    busy = busy || (workers[w].itemref != -1);
+  }
+
+  if (!busy) {
+    // The table of content entries are located by the worker that computed
+    // their item. Worker 0 saves them all.
+    for (uint8_t w = 1; w < workerCount; w++) {
+      workers[0].retriever.getToc()->merge(*workers[w].retriever.getToc());
     }
+    SHOW_IT("COMPLETED ->");
+    sendToRetrieverChecked(workers[0].retriever, { .req = PageLocsRetriever::Req::COMPLETED },
+                           "dispatchWork/COMPLETED");
+    pageLocs.computationCompleted();
+    runningDown = true;
   }
 }
 
+auto PageLocsControl::preemptWorker() -> void {
+  int8_t target = -1;
+
+  for (uint8_t w = 0; w < workerCount; w++) {
+    // The worker already interrupted will take the new ASAP item.
+    if (workers[w].aborting) { return; }
+    // With a single worker, the previous ASAP item is interrupted as well.
+    if ((target == -1) || (workers[target].asap && !workers[w].asap) ||
+        ((workers[target].asap == workers[w].asap) &&
+         (workers[w].dispatchSeq > workers[target].dispatchSeq))) {
+      target = w;
+    }
+  }
+
+  SHOW_IT("Interrupting worker {} ({}) for ASAP ({})", target, workers[target].itemref,
+          asapItemref);
+  workers[target].aborting = true;
+  workers[target].retriever.signalAbort();
+}
+
+/**
+ * An item is done (ITEM_READY or ASAP_READY). Its ASAP waiters, if any, are
+ * answered and the worker gets its next item.
+ */
+auto PageLocsControl::itemDone(const QueueData &data) -> void {
+  if (data.worker >= workerCount) {
+    LOG_E("Ignoring notification from unknown worker {}", data.worker);
+    return;
+  }
+
+  Worker &wk = workers[data.worker];
+  wk.itemref  = -1;
+  wk.asap     = false;
+  wk.aborting = false;
+
+  if (itemrefCount == -1) { return; }
+
+  int16_t itemref = data.itemrefIndex;
+  if (itemref < 0) {
+    itemref = -(itemref + 1);
+    LOG_E("Unable to retrieve pages location for item {}", itemref);
+  }
+  if ((itemref < 0) || (itemref >= itemrefCount)) {
+    LOG_E("Ignoring {} with invalid item index {} (count={})",
+          (data.req == Req::ASAP_READY) ? "ASAP_READY" : "ITEM_READY", itemref, itemrefCount);
+    dispatchWork();
+    return;
+  }
+
+  if (itemref == asapItemref) {
+    // Done by the worker it was sent to, or computed sequentially when the
+    // request arrived: the manager gets the result (negative on failure).
+    asapItemref = -1;
+    sendPendingAsapReplies(data.itemrefIndex, "itemDone/ASAP_READY->mgr");
+  }
+
+  if (!isDone(itemref)) {
+    bitset[itemref >> 3] |= (1 << (itemref & 7));
+    itemsDoneCount += 1;
+    // ESP_LOGI(TAG,"itemsDoneCount = %" PRIi16 " of %" PRIi16, itemsDoneCount,
+    // itemrefCount);
+  }
+
+  dispatchWork();
+}
+
 /**
  * Main control loop.
  *
  * Consumes manager/retriever messages, orchestrates scheduling, forwards
- * notifications to PageLocs, and coordinates retriever lifecycle.
+ * notifications to PageLocs, and coordinates retriever workers lifecycle.
  */
 auto PageLocsControl::task() -> void {
   for (;;) {
@@ -246,11 +360,14 @@ auto PageLocsControl::task() -> void {
 
     case Req::STOP:
       runningDown = true;
-      retrieverTask.requestStop();
       SHOW_IT("STOP ->");
-      sendToRetrieverChecked({ .req = PageLocsRetriever::Req::STOP }, "task/STOP->retriever", true);
+      for (uint8_t w = 0; w < workerCount; w++) {
+        workers[w].retriever.requestStop();
+        sendToRetrieverChecked(workers[w].retriever, { .req = PageLocsRetriever::Req::STOP },
+                               "task/STOP->retriever", true);
+      }
 
-      retrieverTask.waitForExit();
+      for (uint8_t w = 0; w < workerCount; w++) { workers[w].retriever.waitForExit(); }
 
       // SHOW_IT("Sending STOPPED to Mgr");
       sendToMgrChecked({ .req = PageLocs::Req::STOPPED }, "task/STOPPED->mgr", true);
@@ -266,16 +383,9 @@ auto PageLocsControl::task() -> void {
 
       if (bitset) {
         memset(bitset.get(), 0, bitsetSize);
-        if (waitingForItemref == -1) {
-          waitingForItemref = controlQueueData.itemrefIndex;
-          SHOW_IT("RETRIEVE_ITEM itemref {} ---->", waitingForItemref);
-          sendToRetrieverChecked({ .req           = PageLocsRetriever::Req::RETRIEVE_ITEM,
-                                   .itemrefIndex  = waitingForItemref,
-                                   .correlationId = 0 },
-                                 "task/START_DOCUMENT/RETRIEVE_ITEM");
-        } else {
-          nextItemrefToGet = controlQueueData.itemrefIndex;
-        }
+        // Sequential retrieval starts at the requested item.
+        nextItemrefToGet = controlQueueData.itemrefIndex;
+        dispatchWork();
       } else {
         LOG_E("Unable to allocate bitset for {} items", itemrefCount);
         pageLocs.computationAborted("Unable to allocate bitset");
@@ -290,7 +400,8 @@ auto PageLocsControl::task() -> void {
         // Mgr request a specific item. If document retrieval not started,
         // return a negative value.
         // If already done, let it know it a.s.a.p. If currently being processed,
-        // keep a mark when it will be back. If not, queue the request.
+        // keep a mark when it will be back. If not, send it to an idle worker
+        // or interrupt one.
         if (itemrefCount == -1) {
           // SHOW_IT("Sending ASAP_READY to Mgr for itemref {}", -(controlQueueData.itemrefIndex +
           // 1));
@@ -310,149 +421,82 @@ auto PageLocsControl::task() -> void {
               "task/GET_ASAP/invalid", true);
             break;
           }
-          if ((bitset[itemref >> 3] & (1 << (itemref & 7))) != 0) {
+          if (isDone(itemref)) {
             // SHOW_IT("Sending ASAP_READY to Mgr for itemref {}", itemref);
             sendToMgrChecked({ .req           = PageLocs::Req::ASAP_READY,
                                .correlationId = controlQueueData.correlationId,
                                .itemrefIndex  = itemref },
                              "task/GET_ASAP/already_done", true);
-          } else if (waitingForItemref != -1) {
-            if (itemref != waitingForItemref) {
-              // Replacing a previously pending ASAP target can orphan its
-              // waiter correlations; complete them immediately with a miss so
-              // callers do not block until timeout.
-              if ((asapItemref != -1) && (asapItemref != itemref) && !asapCorrelationIds.empty()) {
-                int16_t replacedItem = asapItemref;
-                // SHOW_IT("Replacing pending ASAP item {} with {} ({} waiters)", replacedItem,
-                //         itemref, asapCorrelationIds.size());
-                sendPendingAsapReplies(static_cast<int16_t>(-(replacedItem + 1)),
-                                       "task/GET_ASAP/replaced", false);
-              }
+            break;
+          }
+          if (itemref == asapItemref) {
+            // Coalesce another waiter for the same item; broadcast the eventual reply.
+            asapCorrelationIds.push_back(controlQueueData.correlationId);
+            // SHOW_IT("GET_ASAP for current item {} adds pending waiter ({} total)", itemref,
+            //         asapCorrelationIds.size());
+            break;
+          }
 
-              asapItemref = itemref;
-              asapCorrelationIds.clear();
-              asapCorrelationIds.push_back(controlQueueData.correlationId);
-              // Queue the ASAP request immediately so the retriever can notice it at the next
-              // page boundary and switch items without completing the current one.
-              SHOW_IT("GET_ASAP ({}) while ({}) ---->", itemref, waitingForItemref);
-              if (!sendToRetrieverChecked({ .req           = PageLocsRetriever::Req::GET_ASAP,
-                                            .itemrefIndex  = itemref,
-                                            .correlationId = controlQueueData.correlationId },
-                                          "task/GET_ASAP/preempt", true)) {
-                LOG_E("Failed to queue GET_ASAP(preempt) for item {}", itemref);
+          // Replacing a previously pending ASAP target can orphan its
+          // waiter correlations; complete them immediately with a miss so
+          // callers do not block until timeout.
+          if (asapItemref != -1) {
+            int16_t replacedItem = asapItemref;
+            // SHOW_IT("Replacing pending ASAP item {} with {} ({} waiters)", replacedItem,
+            //         itemref, asapCorrelationIds.size());
+            sendPendingAsapReplies(static_cast<int16_t>(-(replacedItem + 1)),
+                                   "task/GET_ASAP/replaced");
+          }
+
+          asapItemref = itemref;
+          asapCorrelationIds.clear();
+          asapCorrelationIds.push_back(controlQueueData.correlationId);
+
+          int8_t worker = workerOf(itemref);
+          if (worker != -1) {
+            // A worker is already computing this very item sequentially.
+            // ASAP_READY is delivered to the manager as soon as it is done,
+            // no interrupt needed.
+            SHOW_IT("GET_ASAP ({}) computed by worker {}", itemref, worker);
+          } else {
+            for (uint8_t w = 0; w < workerCount; w++) {
+              if (workers[w].itemref == -1) {
+                worker = w;
+                break;
+              }
+            }
+            if (worker != -1) {
+              if (!dispatch(worker, PageLocsRetriever::Req::GET_ASAP, itemref,
+                            controlQueueData.correlationId, "task/GET_ASAP/idle", true)) {
+                LOG_E("Failed to queue GET_ASAP(idle) for item {}", itemref);
+                workers[worker].itemref = -1;
+                workers[worker].asap    = false;
+                asapItemref             = -1;
+                asapCorrelationIds.clear();
                 sendToMgrChecked({ .req           = PageLocs::Req::ASAP_READY,
                                    .correlationId = controlQueueData.correlationId,
                                    .itemrefIndex  = static_cast<int16_t>(-(itemref + 1)) },
-                                 "task/GET_ASAP/preempt_failed", true);
-                asapItemref = -1;
-                asapCorrelationIds.clear();
+                                 "task/GET_ASAP/idle_failed", true);
               }
-            } else if (asapItemref == -1) {
-              // The retriever is already computing this very item sequentially.
-              // Instead of ignoring the request (which would cause a 2 s timeout),
-              // mark asapItemref so that ASAP_READY is delivered to the manager
-              // as soon as ITEM_READY arrives — no retriever interrupt needed.
-              asapItemref = itemref;
-              // Keep any waiter already queued for this same item (e.g. an earlier
-              // GET_ASAP/idle request) and add this requester as an additional waiter.
-              asapCorrelationIds.push_back(controlQueueData.correlationId);
-              // SHOW_IT(
-              // "GET_ASAP for current item %d: will send ASAP_READY on completion (%zu waiters)",
-              // itemref, asapCorrelationIds.size());
             } else {
-              // Coalesce another waiter for the same item; broadcast the eventual reply.
-              asapCorrelationIds.push_back(controlQueueData.correlationId);
-              // SHOW_IT("GET_ASAP for current item {} adds pending waiter ({} total)", itemref,
-              //         asapCorrelationIds.size());
-            }
-          } else {
-            asapItemref = -1;
-            asapCorrelationIds.clear();
-            asapCorrelationIds.push_back(controlQueueData.correlationId);
-            waitingForItemref = itemref;
-            SHOW_IT("GET_ASAP itemref {} ->", itemref);
-            if (!sendToRetrieverChecked({ .req           = PageLocsRetriever::Req::GET_ASAP,
-                                          .itemrefIndex  = itemref,
-                                          .correlationId = controlQueueData.correlationId },
-                                        "task/GET_ASAP/idle", true)) {
-              LOG_E("Failed to queue GET_ASAP(idle) for item {}", itemref);
-              waitingForItemref = -1;
-              asapCorrelationIds.clear();
-              sendToMgrChecked({ .req           = PageLocs::Req::ASAP_READY,
-                                 .correlationId = controlQueueData.correlationId,
-                                 .itemrefIndex  = static_cast<int16_t>(-(itemref + 1)) },
-                               "task/GET_ASAP/idle_failed", true);
+              // The interrupted worker reports ITEM_INTERRUPTED (or ITEM_READY if it
+              // was at the end of its item) and then gets the ASAP item.
+              preemptWorker();
             }
           }
         }
       }
       break;
 
-    // This is sent by the retrieval task, indicating that an item has been
+    // These are sent by the retrieval workers, indicating that an item has been
     // processed.
     case Req::ITEM_READY:
-      if (!runningDown) {
-        SHOW_IT("ITEM_READY ({}) <----", controlQueueData.itemrefIndex);
-        waitingForItemref = -1;
-        if (itemrefCount != -1) {
-          int16_t itemref = -1;
-
-          itemref = controlQueueData.itemrefIndex;
-          if (itemref < 0) {
-            itemref = -(itemref + 1);
-            LOG_E("Unable to retrieve pages location for item {}", itemref);
-          }
-          if ((itemref < 0) || (itemref >= itemrefCount)) {
-            LOG_E("Ignoring ITEM_READY with invalid item index {} (count={})", itemref,
-                  itemrefCount);
-            requestNextItem(-1);
-            break;
-          }
-          if ((bitset[itemref >> 3] & (1 << (itemref & 7))) == 0) {
-            bitset[itemref >> 3] |= (1 << (itemref & 7));
-            itemsDoneCount += 1;
-            // ESP_LOGI(TAG,"itemsDoneCount = %" PRIi16 " of %" PRIi16, itemsDoneCount,
-            // itemrefCount);
-          }
-
-          requestNextItem(itemref);
-        }
-      }
-      break;
-
-    // This is sent by the retrieval task, indicating that an ASAP item has been
-    // processed.
     case Req::ASAP_READY:
       if (!runningDown) {
-        SHOW_IT("ASAP_READY ({}) <----", controlQueueData.itemrefIndex);
-        waitingForItemref = -1;
-        if (itemrefCount != -1) {
-          int16_t itemref = controlQueueData.itemrefIndex;
-          if (asapCorrelationIds.empty()) {
-            asapCorrelationIds.push_back(controlQueueData.correlationId);
-          }
-          // SHOW_IT("Sending ASAP_READY to Mgr for itemref {} ({} waiters)", itemref,
-          //         asapCorrelationIds.size());
-          sendPendingAsapReplies(itemref, "task/ASAP_READY->mgr", false);
-          if (itemref < 0) {
-            itemref = -(itemref + 1);
-            LOG_E("Unable to retrieve pages location for item {}", itemref);
-          }
-          if ((itemref < 0) || (itemref >= itemrefCount)) {
-            LOG_E("Ignoring ASAP_READY with invalid item index {} (count={})", itemref,
-                  itemrefCount);
-            requestNextItem(-1, true);
-            break;
-          }
-          if ((bitset[itemref >> 3] & (1 << (itemref & 7))) == 0) {
-            bitset[itemref >> 3] |= (1 << (itemref & 7));
-            itemsDoneCount += 1;
-            // ESP_LOGI(TAG,"itemsDoneCount = %" PRIi16" of %" PRIi16, itemsDoneCount,
-            // itemrefCount);
-          }
-
-          requestNextItem(itemref, true);
-        }
+        SHOW_IT("{} ({}) from worker {} <----",
+                (controlQueueData.req == Req::ASAP_READY) ? "ASAP_READY" : "ITEM_READY",
+                controlQueueData.itemrefIndex, controlQueueData.worker);
+        itemDone(controlQueueData);
       }
       break;
 
@@ -463,12 +507,17 @@ auto PageLocsControl::task() -> void {
         "task/PERCENT->mgr");
       break;
 
-    // Sent by the retrieval task when it was aborted mid-item by a signalAbort() call.
-    // The partially-computed pages are already in pagesMap (insert is idempotent), so the
+    // Sent by a retrieval worker when it was aborted mid-item by a signalAbort() call.
+    // The partially-computed pages are already in the pages table (merging is idempotent), so the
     // item can safely be re-queued and reprocessed from scratch after the ASAP item is done.
     case Req::ITEM_INTERRUPTED:
-      SHOW_IT("ITEM_INTERRUPTED ({}) <----", controlQueueData.itemrefIndex);
+      SHOW_IT("ITEM_INTERRUPTED ({}) from worker {} <----", controlQueueData.itemrefIndex,
+              controlQueueData.worker);
       if (!runningDown) {
+        if (controlQueueData.worker >= workerCount) {
+          LOG_E("Ignoring notification from unknown worker {}", controlQueueData.worker);
+          break;
+        }
         int16_t itemref = controlQueueData.itemrefIndex;
         // If this was an ASAP request (has non-zero correlationId), notify the manager
         // with a miss reply so it doesn't block indefinitely. The item will be re-queued
@@ -480,38 +529,24 @@ auto PageLocsControl::task() -> void {
                            "task/ITEM_INTERRUPTED->mgr", true);
         }
         // SHOW_IT("Item {} interrupted; re-queuing after ASAP", itemref);
-        waitingForItemref = -1;
+        Worker &wk = workers[controlQueueData.worker];
+        wk.itemref  = -1;
+        wk.asap     = false;
+        wk.aborting = false;
         // Forward-bias heuristic: if the pending ASAP target is ahead of the
         // interrupted item, do not re-queue the interrupted item. Continue
         // from the ASAP item onward to match likely forward reading behavior.
         bool skipInterruptedRequeue =
           (asapItemref != -1) && (itemrefCount > 0) && (asapItemref > itemref);
         if (skipInterruptedRequeue) {
-          nextItemrefToGet = -1;
           SHOW_IT("Skipping interrupted item {} after forward ASAP to {}", itemref, asapItemref);
         } else {
           // Re-queue interrupted work when no forward-ASAP preference applies.
           nextItemrefToGet = itemref;
         }
 
-        // If there's a pending ASAP request, resend it to retriever since the original
-        // GET_ASAP was consumed by the retriever's page boundary handler.
-        if (asapItemref != -1) {
-          waitingForItemref = asapItemref;
-          SHOW_IT("GET_ASAP ({}) resend after interrupt ----> ", asapItemref);
-          if (!sendToRetrieverChecked(
-                { .req           = PageLocsRetriever::Req::GET_ASAP,
-                  .itemrefIndex  = asapItemref,
-                  .correlationId = asapCorrelationIds.empty() ? 0 : asapCorrelationIds.front() },
-                "task/ITEM_INTERRUPTED/resend_GET_ASAP", true)) {
-            LOG_E("Failed to resend GET_ASAP({}) after interrupt", asapItemref);
-            waitingForItemref = -1;
-            asapItemref       = -1;
-            asapCorrelationIds.clear();
-          }
-        } else {
-          requestNextItem(-1);
-        }
+        // The pending ASAP item goes first to the worker just freed.
+        dispatchWork();
       }
       break;
     }
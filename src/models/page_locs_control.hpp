@@ -17,6 +17,14 @@
 #include <atomic>
 #include <vector>
 
+#ifndef PAGE_LOCS_WORKERS
+  #if EPUB_INKPLATE_BUILD
+    #define PAGE_LOCS_WORKERS 1 ///< Page locations retriever workers. 0: one per hardware thread
+  #else
+    #define PAGE_LOCS_WORKERS 0
+  #endif
+#endif
+
 class PageLocsControl;
 
 using PageLocsControlPtr = HimemUniquePtr<PageLocsControl>;
@@ -47,7 +55,7 @@ public:
 
   struct QueueData {
     Req req{Req::NONE};
-    uint8_t reserved{0};
+    uint8_t worker{0}; ///< The retriever worker sending an ITEM_READY, ASAP_READY or ITEM_INTERRUPTED
     int16_t itemrefIndex{0};
     int16_t itemrefCount{0};
     uint32_t correlationId{0}; // Hardening #1: correlation ID for tracking
@@ -58,7 +66,7 @@ public:
     (void)timeout;
     QueueData wireData{};
     wireData.req           = data.req;
-    wireData.reserved      = 0;
+    wireData.worker        = 0;
     wireData.itemrefIndex  = data.itemrefIndex;
     wireData.itemrefCount  = data.itemrefCount;
     wireData.correlationId = data.correlationId;
@@ -75,7 +83,7 @@ public:
     (void)timeout;
     QueueData wireData{};
     wireData.req           = data.req;
-    wireData.reserved      = 0;
+    wireData.worker        = data.worker;
     wireData.itemrefIndex  = data.itemrefIndex;
     wireData.itemrefCount  = data.itemrefCount;
     wireData.correlationId = data.correlationId;
@@ -85,6 +93,19 @@ public:
 #endif
   }
 
+  static constexpr uint8_t MAX_WORKERS = 4;
+
+  /**
+   * Set the number of retriever workers used by the next setup().
+   *
+   * Every worker has its own EPub instance (with its fonts) and task stack.
+   * By default, PAGE_LOCS_WORKERS is used, 0 meaning one worker per hardware
+   * thread. The count is limited to MAX_WORKERS.
+   *
+   * @param count The number of workers, 0 for the default.
+   */
+  static inline auto setWorkerCount(uint8_t count) -> void { requestedWorkerCount = count; }
+
   auto setup(const HimemString &epubFilename) -> bool;
   auto waitForExit() -> void;
 
@@ -96,27 +117,42 @@ public:
   }
 
   [[nodiscard]] inline auto getCurrentItemrefIndex() const {
-    return retrieverTask.getCurrentItemrefIndex();
+    return workers[0].retriever.getCurrentItemrefIndex();
   }
 
 private:
+  // Every worker may have a notification waiting in retrieverQueue.
+  static constexpr long QUEUE_SIZE = MAX_WORKERS + 1;
+
+  static inline uint8_t requestedWorkerCount{0};
+
+  struct Worker {
+    PageLocsRetriever retriever;
+    int16_t itemref{-1};   // Item being computed, -1 when idle
+    bool asap{false};      // itemref was sent with GET_ASAP
+    bool aborting{false};  // Asked to give up itemref for the ASAP item
+    uint32_t dispatchSeq{0};
+  };
+
   std::atomic<bool> runningDown{false};
 
   int16_t itemrefCount{-1};                  // Number of items in the document
   int16_t itemsDoneCount{-1};                // Number of items done
-  int16_t waitingForItemref{-1};             // Current item being processed by retrieval task
   int16_t nextItemrefToGet{-1};              // Non prioritize item to get next
-  int16_t asapItemref{-1};                   // Prioritize item to get next
+  int16_t lastDispatchedItemref{-1};         // Sequential retrieval continues after this one
+  int16_t asapItemref{-1};                   // Prioritize item, until it is done
   std::vector<uint32_t> asapCorrelationIds;  // Correlations for pending ASAP manager replies
   HimemUniquePtr<uint8_t[]> bitset{nullptr}; // Set of all items processed so far
   uint8_t bitsetSize{0};                     // bitset byte length
 
-  PageLocsRetriever retrieverTask;
+  Worker workers[MAX_WORKERS];
+  uint8_t workerCount{0};
+  uint32_t dispatchSeq{0};
 
 #if EPUB_LINUX_BUILD
   static mqd_t managerQueue;
   static mqd_t retrieverQueue;
-  static constexpr mq_attr queueAttr = {0, 5, sizeof(QueueData), 0};
+  static constexpr mq_attr queueAttr = {0, QUEUE_SIZE, sizeof(QueueData), 0};
 #else
   static QueueHandle_t managerQueue;
   static QueueHandle_t retrieverQueue;
@@ -158,26 +194,43 @@ private:
 #endif
   }
 
+  [[nodiscard]] inline auto isDone(int16_t itemref) const -> bool {
+    return (bitset[itemref >> 3] & (1 << (itemref & 7))) != 0;
+  }
+
+  /// The worker computing itemref, or -1.
+  [[nodiscard]] auto workerOf(int16_t itemref) const -> int8_t;
+
   /**
-   * Pick and dispatch the next retrieval request for the page-location pipeline.
+   * Pick and dispatch the next retrieval request to an idle worker.
    *
    * Selection priority:
-   * 1) Pending ASAP request (asapItemref)
+   * 1) Pending ASAP request (asapItemref), if no worker is computing it
    * 2) Deferred normal request (nextItemrefToGet)
-   * 3) Next not-yet-processed spine item found in bitset order
+   * 3) Next not-yet-processed spine item found in bitset order, after
+   *    the last dispatched one, that no worker is computing
    *
-   * Side effects:
-   * - Sends requests to PageLocsRetriever (GET_ASAP, RETRIEVE_ITEM, or COMPLETED)
-   * - Optionally notifies PageLocs manager with ASAP_READY
-   * - Updates waitingForItemref, asapItemref, and nextItemrefToGet
-   *
-   * @param itemref Last itemref that just completed. Use -1 when no previous item is known.
-   * @param alreadySentToMgr True when ASAP_READY for itemref was already sent by caller,
-   *                         avoiding duplicate manager notification.
+   * The worker stays idle when there is nothing left to dispatch.
+   */
+  auto requestNextItem(uint8_t worker) -> void;
+
+  /**
+   * Give work to all idle workers. When they all stay idle, every item is
+   * done: the tables of content of the workers are merged and saved.
+   */
+  auto dispatchWork() -> void;
+
+  auto dispatch(uint8_t worker, PageLocsRetriever::Req req, int16_t itemref,
+                uint32_t correlationId, const char *ctx, bool critical = false) -> bool;
+
+  /**
+   * No worker is idle for the ASAP item: interrupt the one that started its
+   * item last, at its next page boundary.
    */
-  auto requestNextItem(int16_t itemref, bool alreadySentToMgr = false) -> void;
-  auto sendPendingAsapReplies(int16_t itemref, const char *ctx, bool alreadySentToMgr = false)
-      -> void;
+  auto preemptWorker() -> void;
+
+  auto itemDone(const QueueData &data) -> void;
+  auto sendPendingAsapReplies(int16_t itemref, const char *ctx) -> void;
 
 #if EPUB_INKPLATE_BUILD
   TaskHandle_t controlTaskHandle{nullptr};
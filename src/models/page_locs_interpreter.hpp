@@ -21,10 +21,10 @@ class PageLocsInterpreter : public HTMLInterpreter {
 
     PageLocsInterpreter(EPubPtr &theEpub, PagePtr &thePage, DOMPtr &theDom,
                         Page::ComputeMode theCompMode, const EPub::ItemInfo &theItem,
-                        const std::atomic<bool> &abortFlag, PendingRequestCheck pendingRequestCheck,
-                        void *pendingRequestContext)
+                        PageLocs::PendingItem &thePending, const std::atomic<bool> &abortFlag,
+                        PendingRequestCheck pendingRequestCheck, void *pendingRequestContext)
       : HTMLInterpreter(theEpub, thePage, theDom, theCompMode, theItem), epub(theEpub), itemInfo(theItem),
-      abortFlag(abortFlag), pendingRequestCheck(pendingRequestCheck),
+      pending(thePending), abortFlag(abortFlag), pendingRequestCheck(pendingRequestCheck),
       pendingRequestContext(pendingRequestContext) {}
 
   public:
@@ -36,10 +36,10 @@ class PageLocsInterpreter : public HTMLInterpreter {
 
     static inline auto Make(EPubPtr &theEpub, PagePtr &thePage, DOMPtr &theDom,
                             Page::ComputeMode theCompMode, const EPub::ItemInfo &theItem,
-                            const std::atomic<bool> &abortFlag,
+                            PageLocs::PendingItem &thePending, const std::atomic<bool> &abortFlag,
                             PendingRequestCheck pendingRequestCheck, void *pendingRequestContext) {
       return makeUniqueHimem<PageLocsInterpreter>(theEpub, thePage, theDom, theCompMode, theItem,
-                                                  abortFlag, pendingRequestCheck,
+                                                  thePending, abortFlag, pendingRequestCheck,
                                                   pendingRequestContext);
     }
 
@@ -48,6 +48,7 @@ class PageLocsInterpreter : public HTMLInterpreter {
   private:
     EPubPtr &epub;
     const EPub::ItemInfo &itemInfo;
+    PageLocs::PendingItem &pending; ///< Where the pages of the item are staged
     const std::atomic<bool> &abortFlag;
     PendingRequestCheck pendingRequestCheck;
     void *pendingRequestContext;
@@ -78,7 +79,7 @@ class PageLocsInterpreter : public HTMLInterpreter {
           // std::this_thread::sleep_for(std::chrono::milliseconds(100));
         #endif
 
-        pageLocs.insert(pageId, pageInfo);
+        pageLocs.insert(pending, pageId, pageInfo);
 
         #if DEBUGGING
           LOG_D("Begin {}, End {}, PageNbr {}, Size {}",
@@ -95,6 +96,7 @@ class PageLocsInterpreter : public HTMLInterpreter {
       #endif
 
       startOffset = currentOffset;
+      recordCheckpoint();
 
       #if LINE_POS_TRACING
         if (pageId.itemrefIndex == 5) {
@@ -107,7 +109,7 @@ class PageLocsInterpreter : public HTMLInterpreter {
 
       // Abort at page boundaries when control has signalled an interrupt or when a queued
       // retriever request (typically GET_ASAP or STOP) is waiting to be handled next.
-      // Partial pages already inserted into pagesMap are safe — insert() is idempotent.
+      // Partial pages already staged are safe — merging them into the pages table is idempotent.
       if (abortFlag.load(std::memory_order_relaxed) ||
           ((pendingRequestCheck != nullptr) && pendingRequestCheck(pendingRequestContext))) {
         return false;
@@ -29,18 +29,27 @@ namespace {
 #if EPUB_INKPLATE_BUILD
   #include "esp.hpp"
   #include "freertos/task.h"
-
-  QueueHandle_t PageLocsRetriever::retrieverQueue{ nullptr };
 #else
   #include <mqueue.h>
-
-  mqd_t PageLocsRetriever::retrieverQueue{ -1 };
 #endif
 
+PageLocsRetriever::~PageLocsRetriever() {
+  #if EPUB_LINUX_BUILD
+    if (retrieverQueue != -1) {
+      mq_close(retrieverQueue);
+      mq_unlink(queueName);
+    }
+  #else
+    if (retrieverQueue != nullptr) { vQueueDelete(retrieverQueue); }
+  #endif
+}
+
 /**
  * Initialize retriever dependencies, queue, and worker thread.
  */
-auto PageLocsRetriever::setup(const HimemString &epubFilename) -> bool {
+auto PageLocsRetriever::setup(const HimemString &epubFilename, uint8_t workerIndex) -> bool {
+
+  worker = workerIndex;
 
   epub = EPub::Make();
   if (epub == nullptr) {
@@ -60,9 +69,10 @@ auto PageLocsRetriever::setup(const HimemString &epubFilename) -> bool {
   }
 
   #if EPUB_LINUX_BUILD
-    mq_unlink("/retriever");
+    snprintf(queueName, sizeof(queueName), "/retriever%u", (unsigned)worker);
+    mq_unlink(queueName);
 
-    retrieverQueue = mq_open("/retriever", O_RDWR | O_CREAT, S_IRWXU, &retrieverAttr);
+    retrieverQueue = mq_open(queueName, O_RDWR | O_CREAT, S_IRWXU, &retrieverAttr);
     if (retrieverQueue == -1) {
       LOG_E("Unable to open retrieverQueue: {}", errno);
       return false;
@@ -70,14 +80,10 @@ auto PageLocsRetriever::setup(const HimemString &epubFilename) -> bool {
 
     retrieverThread = std::thread(&PageLocsRetriever::task, this);
   #else
+    retrieverQueue = xQueueCreate(5, sizeof(PageLocsRetriever::QueueData));
     if (retrieverQueue == nullptr) {
-      retrieverQueue = xQueueCreate(5, sizeof(PageLocsRetriever::QueueData));
-      if (retrieverQueue == nullptr) {
-        LOG_E("Unable to create retrieverQueue");
-        return false;
-      }
-    } else {
-      xQueueReset(retrieverQueue);
+      LOG_E("Unable to create retrieverQueue");
+      return false;
     }
 
     if (pdPASS != xTaskCreatePinnedToCore(
@@ -85,14 +91,12 @@ auto PageLocsRetriever::setup(const HimemString &epubFilename) -> bool {
     auto *self = static_cast<PageLocsRetriever *>(param);
     self->task();
     vTaskDelete(nullptr);
-  }, "retrieverTask", 25 * 1024, this, (configMAX_PRIORITIES - 2) | portPRIVILEGE_BIT, nullptr,
-          1)) {
+  }, "retrieverTask", 25 * 1024, this, (configMAX_PRIORITIES - 2) | portPRIVILEGE_BIT,
+          &retrieverTaskHandle, 1)) {
       LOG_E("Unable to create retriever task");
       return false;
     }
 
-    retrieverTaskHandle = xTaskGetHandle("retrieverTask");
-
   #endif
 
   return true;
@@ -252,11 +256,14 @@ auto PageLocsRetriever::retrieve_item(Req req, int16_t itemrefIndex, uint32_t co
 
   stopRequested.store(false, std::memory_order_relaxed);
 
-  // Clear any stale abort signal before starting this item.
-  abortCurrentItem.store(false, std::memory_order_relaxed);
+  // A stale abort signal was cleared by PageLocsControl when it dispatched this
+  // item (see clearAbort()): one raised since then must not be lost.
 
   bool                       done = buildPageLocs(itemrefIndex);
 
+  // Publish the pages staged for this item (complete or partial) before control is told.
+  pageLocs.commitPendingItem(pendingItem);
+
   bool                       aborted  = abortCurrentItem.load(std::memory_order_relaxed);
   bool                       stopping = stopRequested.load(std::memory_order_relaxed);
 
@@ -270,9 +277,10 @@ auto PageLocsRetriever::retrieve_item(Req req, int16_t itemrefIndex, uint32_t co
 
   if (aborted && !done) {
     // Interrupted mid-item by a higher-priority request.  Partial pages already
-    // inserted into pagesMap are harmless — pageLocs.insert() is idempotent.
+    // committed to the pages table are harmless — merging an item again is idempotent.
     // SHOW_IT("Item {} interrupted; sending ITEM_INTERRUPTED to ControlTask", itemrefIndex);
     controlQueueData = { .req           = PageLocsControl::Req::ITEM_INTERRUPTED,
+                         .worker        = worker,
                          .itemrefIndex  = itemrefIndex,
                          .itemrefCount  = 0,
                          .correlationId = correlationId };
@@ -283,6 +291,7 @@ auto PageLocsRetriever::retrieve_item(Req req, int16_t itemrefIndex, uint32_t co
     }
     controlQueueData = { .req           = (req == Req::GET_ASAP) ? PageLocsControl::Req::ASAP_READY
                                                                 : PageLocsControl::Req::ITEM_READY,
+                         .worker        = worker,
                          .itemrefIndex  = itemrefIndex,
                          .itemrefCount  = 0,
                          .correlationId = (req == Req::GET_ASAP) ? correlationId : 0 };
@@ -338,10 +347,19 @@ auto PageLocsRetriever::buildPageLocs(int16_t itemrefIndex) -> bool {
     };
 
     auto         dom     = DOM::Make(epub->getDomPools());
-    auto         pageOut = Page::Make(fonts, epub->getLanguage());
+
+    if (page != nullptr) {
+      page->rebind(epub->getLanguage());
+    } else if ((page = Page::Make(fonts, epub->getLanguage())) == nullptr) {
+      LOG_E("Unable to allocate a Page instance");
+      return false;
+    }
+
+    // The page of the previous item was the only user of the glyphs.
+    fonts.releaseGlyphs();
 
     auto         interp = PageLocsInterpreter::Make(
-      epub, pageOut, dom, Page::ComputeMode::LOCATION, itemInfo, abortCurrentItem,
+      epub, page, dom, Page::ComputeMode::LOCATION, itemInfo, pendingItem, abortCurrentItem,
       &PageLocsRetriever::pollPendingQueueAtPageBoundary, this);
 
     #if DEBUGGING_AID
@@ -351,6 +369,7 @@ auto PageLocsRetriever::buildPageLocs(int16_t itemrefIndex) -> bool {
 
     // In PageLocs mode we only need stable text flow boundaries.ure.
     interp->setLimits(0, 9999999, epub->getBookFormatParams()->showPictures != 0);
+    interp->setCheckpoints(&pageLocs.getCheckpoints());
 
     xml_node node;
 
@@ -358,13 +377,13 @@ auto PageLocsRetriever::buildPageLocs(int16_t itemrefIndex) -> bool {
 
       #if LINE_POS_TRACING
         if (itemrefIndex == LINE_POS_TRACING) {
-          pageOut->setTracing(true);
+          page->setTracing(true);
           LOG_I("buildPageAt(): {} {}", itemrefIndex, 0);
-          pageOut->showFmt(fmt, "");
+          page->showFmt(fmt, "");
         }
       #endif
 
-      pageOut->start(fmt, epub->getBookFormatParams()->columnCount);
+      page->start(fmt, epub->getBookFormatParams()->columnCount);
 
       // newFmt is required to be able to modify the format in the recursive calls without
       // interfering with the original one used for page start
@@ -376,7 +395,7 @@ auto PageLocsRetriever::buildPageLocs(int16_t itemrefIndex) -> bool {
       } else {
         interp->releaseFmt(newFmt);
 
-        if (pageOut->someDataWaiting()) { pageOut->endParagraph(fmt); }
+        if (page->someDataWaiting()) { page->endParagraph(fmt); }
 
         // Remaining processing at the end of the document to be sure to
         // include the last page if not already done
@@ -389,7 +408,7 @@ auto PageLocsRetriever::buildPageLocs(int16_t itemrefIndex) -> bool {
     }
 
     #if LINE_POS_TRACING
-      pageOut->setTracing(false);
+      page->setTracing(false);
     #endif
   }
 
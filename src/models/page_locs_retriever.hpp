@@ -4,6 +4,7 @@
 
 #include "models/dom.hpp"
 #include "models/epub.hpp"
+#include "models/pages_table.hpp"
 #include "viewers/html_interpreter.hpp"
 #include "viewers/page.hpp"
 
@@ -22,8 +23,8 @@ private:
   static constexpr const char *TAG = "PageLocsRetriever";
 
 public:
-  PageLocsRetriever()  = default;
-  ~PageLocsRetriever() = default; // { LOG_I("PageLocsRetriever destructor called"); }
+  PageLocsRetriever() = default;
+  ~PageLocsRetriever();
 
   enum class Req : int8_t { NONE, STOP, RETRIEVE_ITEM, GET_ASAP, SHOW_HEAP, COMPLETED };
 
@@ -34,7 +35,7 @@ public:
     uint32_t correlationId{0};
   };
 
-  static inline auto send(const QueueData data, int timeout = 0) {
+  inline auto send(const QueueData data, int timeout = 0) {
 #if EPUB_LINUX_BUILD
     (void)timeout;
     QueueData wireData{};
@@ -48,19 +49,36 @@ public:
 #endif
   }
 
-  auto setup(const HimemString &epubFilename) -> bool;
+  /**
+   * Open the book in a private EPub instance and start the worker task.
+   *
+   * @param epubFilename The book to compute the pages location of.
+   * @param workerIndex The worker number, sent back to PageLocsControl with
+   *                    every notification.
+   */
+  auto setup(const HimemString &epubFilename, uint8_t workerIndex) -> bool;
   auto waitForExit() -> void;
 
   [[nodiscard]] static auto pollPendingQueueAtPageBoundary(void *context) -> bool;
 
   [[nodiscard]] inline auto getCurrentItemrefIndex() const { return currentItemrefIndex; }
 
+  /// The table of content entries located by this worker. Not to be used while it is computing.
+  [[nodiscard]] inline auto getToc() -> TOCPtr & { return epub->toc; }
+
   /**
    * Signal the retriever to abort the current item computation at the next page boundary.
-   * Called by PageLocsControl when a higher-priority GET_ASAP request arrives.
+   * Called by PageLocsControl when a higher-priority GET_ASAP request arrives and no
+   * worker is idle.
    */
   inline auto signalAbort() { abortCurrentItem.store(true, std::memory_order_relaxed); }
 
+  /**
+   * Forget an abort signal raised too late to interrupt the previous item.
+   * Called by PageLocsControl before dispatching a new item to this retriever.
+   */
+  inline auto clearAbort() { abortCurrentItem.store(false, std::memory_order_relaxed); }
+
   /**
    * Request retriever shutdown at the next page boundary.
    * Called before queueing STOP so long items do not have to run to completion.
@@ -75,14 +93,18 @@ private:
   std::atomic<bool> abortCurrentItem{false};
   DOMPtr dom{nullptr};
   EPubPtr epub{nullptr};
+  PagePtr page{nullptr}; // Kept from item to item, released before the epub
   uint16_t pageBottom{0};
   int16_t currentItemrefIndex{-1};
+  uint8_t worker{0};
+  PagesTable::PendingItem pendingItem; // Pages of the item being computed
 
 #if EPUB_LINUX_BUILD
-  static mqd_t retrieverQueue;
+  mqd_t retrieverQueue{-1};
+  char queueName[16]{};
   static constexpr mq_attr retrieverAttr = {0, 5, sizeof(QueueData), 0};
 #else
-  static QueueHandle_t retrieverQueue;
+  QueueHandle_t retrieverQueue{nullptr};
 #endif
 
   auto receive(QueueData &data, int timeout = -1) {
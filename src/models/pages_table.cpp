@@ -0,0 +1,109 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "models/pages_table.hpp"
+
+#include <algorithm>
+
+auto PagesTable::clear() -> void {
+  entries.clear();
+  spans.clear();
+  presentItems = 0;
+}
+
+auto PagesTable::ensureSpan(int16_t itemrefIndex) -> void {
+  if (itemrefIndex >= (int16_t)spans.size()) {
+    // New spans start where the last entry ends, keeping start indexes of
+    // empty items meaningful as insertion points.
+    spans.resize(itemrefIndex + 1, Span{ (uint32_t)entries.size(), 0 });
+  }
+}
+
+auto PagesTable::find(const PageId &pageId) const -> int32_t {
+  if (!itemIsPresent(pageId.itemrefIndex)) { return NOT_FOUND; }
+
+  const Span &span  = spans[pageId.itemrefIndex];
+  auto        first = entries.begin() + span.start;
+  auto        last  = first + span.count;
+  auto        it    = std::lower_bound(first, last, pageId.offset,
+                                       [](const Entry &e, int32_t off) { return e.offset < off; });
+
+  return ((it != last) && (it->offset == pageId.offset)) ? (int32_t)(it - entries.begin())
+                                                          : NOT_FOUND;
+}
+
+auto PagesTable::findFloor(const PageId &pageId) const -> int32_t {
+  if (!itemIsPresent(pageId.itemrefIndex)) { return NOT_FOUND; }
+
+  const Span &span  = spans[pageId.itemrefIndex];
+  auto        first = entries.begin() + span.start;
+  auto        last  = first + span.count;
+  auto        it    = std::upper_bound(first, last, pageId.offset,
+                                       [](int32_t off, const Entry &e) { return off < e.offset; });
+
+  return (it == first) ? NOT_FOUND : (int32_t)(it - entries.begin() - 1);
+}
+
+auto PagesTable::appendItem(int16_t itemrefIndex, const Entry *items, uint32_t count) -> uint32_t {
+  if ((itemrefIndex < 0) || (count == 0)) { return 0; }
+
+  ensureSpan(itemrefIndex);
+  Span &span = spans[itemrefIndex];
+
+  // Merge with what is already known for this item (a previous partial
+  // computation), keeping offsets unique.
+  HimemVector<Entry> merged;
+  merged.reserve(span.count + count);
+
+  auto     oldIt  = entries.begin() + span.start;
+  auto     oldEnd = oldIt + span.count;
+  uint32_t i      = 0;
+
+  while ((oldIt != oldEnd) || (i < count)) {
+    if ((i >= count) || ((oldIt != oldEnd) && (oldIt->offset <= items[i].offset))) {
+      if ((i < count) && (oldIt->offset == items[i].offset)) { ++i; }
+      merged.push_back(*oldIt++);
+    } else {
+      if (merged.empty() || (merged.back().offset < items[i].offset)) {
+        merged.push_back(items[i]);
+        merged.back().itemrefIndex = itemrefIndex;
+      }
+      ++i;
+    }
+  }
+
+  uint32_t added = merged.size() - span.count;
+  if (added == 0) { return 0; }
+
+  auto pos = entries.erase(entries.begin() + span.start, entries.begin() + span.start + span.count);
+  entries.insert(pos, merged.begin(), merged.end());
+
+  if (span.count == 0) { presentItems++; }
+  span.count = merged.size();
+  for (auto it = spans.begin() + itemrefIndex + 1; it != spans.end(); ++it) { it->start += added; }
+
+  return added;
+}
+
+auto PagesTable::pushBackSorted(const Entry &entry) -> bool {
+  if (entry.itemrefIndex < 0) { return false; }
+  if (!entries.empty()) {
+    const Entry &last = entries.back();
+    if ((entry.itemrefIndex < last.itemrefIndex) ||
+        ((entry.itemrefIndex == last.itemrefIndex) && (entry.offset <= last.offset))) {
+      return false;
+    }
+  }
+
+  ensureSpan(entry.itemrefIndex);
+  Span &span = spans[entry.itemrefIndex];
+  if (span.count == 0) {
+    span.start = entries.size();
+    presentItems++;
+  }
+  span.count++;
+  entries.push_back(entry);
+
+  return true;
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+/**
+ * class PagesTable - Flat storage of page locations
+ *
+ * All page entries of a book are kept in one contiguous vector sorted by
+ * PageId (itemref index, then offset). A per-itemref span table gives the
+ * first entry index and the entry count of every item, so that locating an
+ * item, stepping to the next or previous page and getting a page number are
+ * done with index arithmetic instead of tree walks.
+ *
+ * Items are computed out of order by the page locations retriever. They are
+ * added as whole items with appendItem(), which slides the following items
+ * up in the vector. Within an item, entries are strictly increasing in offset.
+ *
+ * This class is not thread-safe: PageLocs protects it with its own mutex.
+ */
+class PagesTable {
+  public:
+    #pragma pack(push, 1)
+    struct Entry {
+      int16_t itemrefIndex;
+      int32_t offset;
+      int32_t size;
+      int16_t pageNumber;
+    };
+    #pragma pack(pop)
+
+    /// Entries of an item being computed, staged until given to appendItem().
+    struct PendingItem {
+      HimemVector<Entry> entries;
+      int16_t itemrefIndex{ -1 };
+    };
+
+    static constexpr int32_t NOT_FOUND = -1;
+
+    PagesTable() = default;
+
+    auto clear() -> void;
+    auto reserve(uint32_t count) -> void { entries.reserve(count); }
+
+    [[nodiscard]] inline auto size() const -> int32_t { return entries.size(); }
+    [[nodiscard]] inline auto empty() const -> bool { return entries.empty(); }
+
+    /// Number of items having at least one entry.
+    [[nodiscard]] inline auto presentItemCount() const -> int16_t { return presentItems; }
+
+    [[nodiscard]] inline auto operator[](int32_t idx) -> Entry & { return entries[idx]; }
+    [[nodiscard]] inline auto operator[](int32_t idx) const -> const Entry & { return entries[idx]; }
+
+    [[nodiscard]] inline auto pageIdAt(int32_t idx) const -> PageId {
+      return PageId(entries[idx].itemrefIndex, entries[idx].offset);
+    }
+
+    [[nodiscard]] inline auto begin() { return entries.begin(); }
+    [[nodiscard]] inline auto end() { return entries.end(); }
+    [[nodiscard]] inline auto begin() const { return entries.begin(); }
+    [[nodiscard]] inline auto end() const { return entries.end(); }
+
+    [[nodiscard]] inline auto itemIsPresent(int16_t itemrefIndex) const -> bool {
+      return (itemrefIndex >= 0) && (itemrefIndex < (int16_t)spans.size()) &&
+             (spans[itemrefIndex].count > 0);
+    }
+
+    /// Index of the first entry of an item, or NOT_FOUND.
+    [[nodiscard]] inline auto firstOfItem(int16_t itemrefIndex) const -> int32_t {
+      return itemIsPresent(itemrefIndex) ? (int32_t)spans[itemrefIndex].start : NOT_FOUND;
+    }
+
+    /// Index of the last entry of an item, or NOT_FOUND.
+    [[nodiscard]] inline auto lastOfItem(int16_t itemrefIndex) const -> int32_t {
+      return itemIsPresent(itemrefIndex)
+               ? (int32_t)(spans[itemrefIndex].start + spans[itemrefIndex].count - 1)
+               : NOT_FOUND;
+    }
+
+    /// Index of the entry with exactly this PageId, or NOT_FOUND.
+    [[nodiscard]] auto find(const PageId &pageId) const -> int32_t;
+
+    /// Index of the last entry of the item whose offset is <= pageId.offset, or NOT_FOUND.
+    [[nodiscard]] auto findFloor(const PageId &pageId) const -> int32_t;
+
+    /**
+     * Merge a whole item into the table. Entries must be sorted by offset.
+     * Offsets already present for that item are left untouched, so adding
+     * the same (or a partial) item again is harmless.
+     *
+     * @return The number of entries actually added.
+     */
+    auto appendItem(int16_t itemrefIndex, const Entry *items, uint32_t count) -> uint32_t;
+
+    /**
+     * Append one entry at the end of the table. Used for bulk loading of
+     * entries already sorted by PageId.
+     *
+     * @return false if the entry does not sort after the current last entry.
+     */
+    auto pushBackSorted(const Entry &entry) -> bool;
+
+  private:
+    struct Span {
+      uint32_t start{0};
+      uint32_t count{0};
+    };
+
+    HimemVector<Entry> entries;
+    HimemVector<Span> spans;
+    int16_t presentItems{0};
+
+    auto ensureSpan(int16_t itemrefIndex) -> void;
+};
@@ -0,0 +1,332 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#define __PICTURE_CACHE__ 1
+#include "models/picture_cache.hpp"
+
+#include "miniz.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <sys/stat.h>
+
+auto PictureCache::hashOf(const HimemString &path) -> uint64_t {
+  // FNV-1a
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (char ch : path) {
+    hash ^= static_cast<uint8_t>(ch);
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+auto PictureCache::epubSizeOf(const HimemString &epubFilename) -> uint32_t {
+  struct stat fileStat;
+  return (stat(epubFilename.c_str(), &fileStat) != -1) ? (uint32_t)fileStat.st_size : 0;
+}
+
+auto PictureCache::bitmapSize(Dim dim, uint8_t bitsPerPixel) -> uint32_t {
+  return (bitsPerPixel == 4) ? ((dim.width + 1) >> 1) * dim.height : dim.width * dim.height;
+}
+
+auto PictureCache::indexCrc() -> uint32_t {
+  mz_ulong crc = mz_crc32(MZ_CRC32_INIT, index.get(), offsetof(Header, crc));
+  crc = mz_crc32(crc, reinterpret_cast<const uint8_t *>(entries()),
+                 header().entryCount * sizeof(Entry));
+  return static_cast<uint32_t>(crc);
+}
+
+auto PictureCache::indexIsValid(uint32_t fileSize, const BinUUID &uuid) -> bool {
+  Header &hdr = header();
+
+  if ((hdr.version != FILE_VERSION) || (memcmp(hdr.uuid, uuid, sizeof(BinUUID)) != 0) ||
+      (hdr.epubSize != epubSizeOf(epubFilename))) {
+    LOG_I("Pictures file of '{}' is outdated.", epubFilename);
+    return false;
+  }
+
+  if ((hdr.entryCount > MAX_ENTRIES) || (hdr.dataEnd < DATA_OFFSET) || (hdr.dataEnd > fileSize) ||
+      (indexCrc() != hdr.crc)) {
+    LOG_E("Pictures file of '{}' is corrupted.", epubFilename);
+    return false;
+  }
+
+  liveBytes = 0;
+  for (uint16_t i = 0; i < hdr.entryCount; ++i) {
+    const Entry &entry = entries()[i];
+    if ((entry.offset < DATA_OFFSET) || (entry.offset + entry.size > hdr.dataEnd) ||
+        (entry.size != bitmapSize(entry.dim, entry.bitsPerPixel))) {
+      LOG_E("Pictures file of '{}' is corrupted.", epubFilename);
+      return false;
+    }
+    liveBytes += entry.size;
+  }
+
+  return true;
+}
+
+auto PictureCache::writeIndex() -> bool {
+  header().crc = indexCrc();
+
+  // The whole block up to the first bitmap is written: the file never has
+  // a hole before the bitmaps.
+  bool res = (fseek(file, 0, SEEK_SET) == 0) && (fwrite(index.get(), DATA_OFFSET, 1, file) == 1) &&
+             (fflush(file) == 0);
+
+  if (res) {
+    indexDirty = false;
+  } else {
+    LOG_E("Unable to write pictures file index of '{}'.", epubFilename);
+  }
+  return res;
+}
+
+auto PictureCache::reset(const BinUUID &uuid) -> bool {
+  if (file != nullptr) { fclose(file); }
+
+  HimemString filename = filenameOf(epubFilename);
+  if ((file = fopen(filename.c_str(), "w+b")) == nullptr) {
+    LOG_E("Not able to create pictures file '{}': errno={} ({})", filename, errno,
+          std::strerror(errno));
+    return false;
+  }
+
+  memset(index.get(), 0, DATA_OFFSET);
+
+  Header &hdr = header();
+  hdr.version = FILE_VERSION;
+  memcpy(hdr.uuid, uuid, sizeof(BinUUID));
+  hdr.epubSize = epubSizeOf(epubFilename);
+  hdr.dataEnd  = DATA_OFFSET;
+
+  liveBytes = 0;
+
+  return writeIndex();
+}
+
+auto PictureCache::open(const HimemString &theEpubFilename, const BinUUID &uuid) -> bool {
+  std::scoped_lock guard(mutex);
+
+  if ((file != nullptr) && (epubFilename == theEpubFilename)) { return true; }
+
+  doClose();
+
+  index = makeUniqueHimem<uint8_t[]>(DATA_OFFSET);
+  if (index == nullptr) {
+    LOG_E("Not enough memory for the pictures file index: {} bytes required.", DATA_OFFSET);
+    return false;
+  }
+
+  epubFilename         = theEpubFilename;
+  HimemString filename = filenameOf(epubFilename);
+
+  bool ok = false;
+  if ((file = fopen(filename.c_str(), "r+b")) != nullptr) {
+    struct stat fileStat;
+    ok = (stat(filename.c_str(), &fileStat) != -1) &&
+         (fread(index.get(), DATA_OFFSET, 1, file) == 1) &&
+         indexIsValid((uint32_t)fileStat.st_size, uuid);
+  } else {
+    LOG_D("No pictures file '{}'.", filename);
+  }
+
+  if (!ok && !reset(uuid)) {
+    doClose();
+    return false;
+  }
+
+  LOG_D("Pictures file '{}' opened with {} pictures.", filename, header().entryCount);
+  return true;
+}
+
+auto PictureCache::doClose() -> void {
+  if (file != nullptr) {
+    if (indexDirty) { writeIndex(); }
+    fclose(file);
+    file = nullptr;
+  }
+  index.reset();
+  epubFilename.clear();
+  liveBytes  = 0;
+  indexDirty = false;
+}
+
+auto PictureCache::close() -> void {
+  std::scoped_lock guard(mutex);
+  doClose();
+}
+
+auto PictureCache::isOpenFor(const HimemString &theEpubFilename) -> bool {
+  std::scoped_lock guard(mutex);
+  return (file != nullptr) && (epubFilename == theEpubFilename);
+}
+
+auto PictureCache::get(const HimemString &path, const TargetOf &targetOf, Dim &srcDim)
+-> PicturePtr {
+  std::scoped_lock guard(mutex);
+
+  if (file == nullptr) {
+    ++misses;
+    return nullptr;
+  }
+
+  uint64_t hash  = hashOf(path);
+  Entry   *first = entries();
+  Entry   *last  = first + header().entryCount;
+
+  Entry *entry = std::find_if(first, last, [hash](const Entry &e) { return e.pathHash == hash; });
+  if (entry == last) {
+    ++misses;
+    return nullptr;
+  }
+
+  srcDim     = entry->srcDim;
+  Dim target = targetOf(srcDim);
+
+  entry = std::find_if(entry, last, [hash, target](const Entry &e) {
+    return (e.pathHash == hash) && (e.dim.width == target.width) && (e.dim.height == target.height);
+  });
+  if (entry == last) {
+    ++misses;
+    return nullptr;
+  }
+
+  FileContentPtr bitmap = makeUniqueHimem<uint8_t[]>(entry->size);
+  if (bitmap == nullptr) {
+    LOG_E("Not enough memory for a cached picture: {} bytes required.", entry->size);
+    ++misses;
+    return nullptr;
+  }
+
+  if ((fseek(file, entry->offset, SEEK_SET) != 0) ||
+      (fread(bitmap.get(), entry->size, 1, file) != 1)) {
+    LOG_E("Unable to read a picture from the pictures file of '{}'.", epubFilename);
+    remove(entry - first);
+    writeIndex();
+    ++misses;
+    return nullptr;
+  }
+
+  entry->lastUse = ++header().useClock;
+  indexDirty     = true;
+  ++hits;
+
+  return Picture::Make(entry->dim, std::move(bitmap), entry->size, entry->bitsPerPixel);
+}
+
+auto PictureCache::remove(uint16_t idx) -> void {
+  Header &hdr = header();
+
+  liveBytes -= entries()[idx].size;
+  hdr.entryCount -= 1;
+  if (idx != hdr.entryCount) { entries()[idx] = entries()[hdr.entryCount]; }
+  indexDirty = true;
+}
+
+auto PictureCache::compact() -> bool {
+  Header  &hdr   = header();
+  Entry   *first = entries();
+  uint16_t count = hdr.entryCount;
+
+  std::sort(first, first + count,
+            [](const Entry &a, const Entry &b) { return a.offset < b.offset; });
+
+  // The index is emptied on file first: if the move is interrupted, the
+  // file is left as an empty cache.
+  hdr.entryCount = 0;
+  hdr.dataEnd    = DATA_OFFSET;
+  if (!writeIndex()) { return false; }
+
+  HimemVector<uint8_t> buffer;
+  uint32_t             offset = DATA_OFFSET;
+  uint16_t             kept   = 0;
+
+  for (uint16_t i = 0; i < count; ++i) {
+    Entry entry = first[i];
+    if (entry.offset != offset) {
+      buffer.resize(entry.size);
+      if ((fseek(file, entry.offset, SEEK_SET) != 0) ||
+          (fread(buffer.data(), entry.size, 1, file) != 1) ||
+          (fseek(file, offset, SEEK_SET) != 0) ||
+          (fwrite(buffer.data(), entry.size, 1, file) != 1)) {
+        break;
+      }
+      entry.offset = offset;
+    }
+    first[kept++] = entry;
+    offset += entry.size;
+  }
+
+  hdr.entryCount = kept;
+  hdr.dataEnd    = offset;
+
+  liveBytes = offset - DATA_OFFSET;
+
+  LOG_D("Pictures file of '{}' compacted: {} pictures, {} bytes.", epubFilename, kept, liveBytes);
+
+  return (kept == count) && writeIndex();
+}
+
+auto PictureCache::put(const HimemString &path, Dim srcDim, const Picture &picture) -> bool {
+  std::scoped_lock guard(mutex);
+
+  if ((file == nullptr) || (picture.getBitmap() == nullptr)) { return false; }
+
+  Dim      dim  = picture.getDim();
+  uint8_t  bpp  = picture.getBitsPerPixel();
+  uint32_t size = bitmapSize(dim, bpp);
+
+  // A picture taking a large part of the cache would evict most of the others.
+  if ((size == 0) || (size > capacity / 4)) { return false; }
+
+  uint64_t hash  = hashOf(path);
+  Header  &hdr   = header();
+  Entry   *first = entries();
+
+  for (uint16_t i = 0; i < hdr.entryCount; ++i) {
+    if ((first[i].pathHash == hash) && (first[i].dim.width == dim.width) &&
+        (first[i].dim.height == dim.height)) {
+      return true;
+    }
+  }
+
+  while ((hdr.entryCount > 0) &&
+         ((liveBytes + size > capacity) || (hdr.entryCount >= MAX_ENTRIES))) {
+    Entry *lru = std::min_element(first, first + hdr.entryCount, [](const Entry &a, const Entry &b) {
+      return a.lastUse < b.lastUse;
+    });
+    remove(lru - first);
+  }
+
+  if ((hdr.dataEnd - DATA_OFFSET - liveBytes > capacity / 2) && !compact()) { return false; }
+
+  // The bitmap is written before the index referring to it.
+  if ((fseek(file, hdr.dataEnd, SEEK_SET) != 0) ||
+      (fwrite(picture.getBitmap(), size, 1, file) != 1)) {
+    LOG_E("Unable to write a picture to the pictures file of '{}'.", epubFilename);
+    return false;
+  }
+
+  Entry &entry       = first[hdr.entryCount];
+  entry.pathHash     = hash;
+  entry.srcDim       = srcDim;
+  entry.dim          = dim;
+  entry.bitsPerPixel = bpp;
+  entry.offset       = hdr.dataEnd;
+  entry.size         = size;
+  entry.lastUse      = ++hdr.useClock;
+
+  hdr.entryCount += 1;
+  hdr.dataEnd += size;
+  liveBytes += size;
+
+  return writeIndex();
+}
+
+auto PictureCache::getStats() -> Stats {
+  std::scoped_lock guard(mutex);
+  return Stats{ hits, misses, liveBytes, (uint16_t)((file != nullptr) ? header().entryCount : 0) };
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include "picture.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <mutex>
+
+/**
+ * class PictureCache - Pictures of a book, decoded and sized for the pages
+ *
+ * Showing a page with an illustration inflates the picture file, decodes it
+ * and resizes it to the room it gets on the page. This class keeps the
+ * resulting bitmaps in a file next to the .locs and .toc files of the book
+ * (.pics extension): a page shown again gets its pictures with a single read
+ * each.
+ *
+ * A picture is known by its path in the book and its size on the page. The
+ * size it had once decoded is kept with it: the page layout is computed
+ * from it.
+ *
+ * File layout: a Header and a table of MAX_ENTRIES entries, read and written
+ * as a single block and checked with a CRC, then the bitmaps. The file is
+ * tied to the book by its binary UUID and size, as the CSSStore file.
+ *
+ * The bitmaps are appended. When the cache holds more than its capacity, the
+ * least recently used pictures are dropped; their room is reclaimed by
+ * moving the others down once it exceeds half the capacity.
+ *
+ * A single instance is shared by the EPub instances of the book shown (the
+ * viewer and the page prefetcher).
+ */
+class PictureCache {
+  public:
+    using BinUUID = uint8_t[16]; ///< Same as EPub::BinUUID
+    using TargetOf = std::function<Dim(Dim)>;
+
+    struct Stats {
+      uint32_t hits;
+      uint32_t misses;
+      uint32_t bytes; ///< Size of the bitmaps in the cache
+      uint16_t count; ///< Number of pictures in the cache
+    };
+
+    static constexpr uint16_t MAX_ENTRIES = 256;
+
+    #if EPUB_LINUX_BUILD
+      static constexpr uint32_t CAPACITY = 32 * 1024 * 1024;
+    #else
+      static constexpr uint32_t CAPACITY = 16 * 1024 * 1024;
+    #endif
+
+    PictureCache() = default;
+    PictureCache(const PictureCache &)            = delete;
+    PictureCache &operator=(const PictureCache &) = delete;
+    ~PictureCache() { close(); }
+
+    /**
+     * @brief Open the cache of a book
+     *
+     * Nothing is done if it is already open. The cache of another book is
+     * closed first. A file that is absent, of another version, of another
+     * book or corrupted is replaced with an empty one.
+     */
+    auto open(const HimemString &epubFilename, const BinUUID &uuid) -> bool;
+
+    /// Save the pictures usage and close the file.
+    auto close() -> void;
+
+    [[nodiscard]] auto isOpenFor(const HimemString &epubFilename) -> bool;
+
+    /**
+     * @brief Retrieve a picture sized for a page
+     *
+     * @param path The picture path in the book.
+     * @param targetOf Gives the size on the page from the decoded size.
+     * @param srcDim Set to the decoded size when the picture was cached at
+     *               any size.
+     * @return The picture, or nullptr if not cached at the size given by
+     *         targetOf.
+     */
+    auto get(const HimemString &path, const TargetOf &targetOf, Dim &srcDim) -> PicturePtr;
+
+    /**
+     * @brief Add a picture sized for a page
+     *
+     * @param path The picture path in the book.
+     * @param srcDim Its decoded size.
+     * @param picture The picture at its size on the page.
+     */
+    auto put(const HimemString &path, Dim srcDim, const Picture &picture) -> bool;
+
+    /// The cache content is kept under this number of bytes. For tests.
+    inline auto setCapacity(uint32_t bytes) -> void { capacity = bytes; }
+
+    [[nodiscard]] auto getStats() -> Stats;
+
+    static auto filenameOf(const HimemString &epubFilename) -> HimemString {
+      return epubFilename.substr(0, epubFilename.find_last_of('.')) + ".pics";
+    }
+
+  private:
+    static constexpr char const *TAG     = "PictureCache";
+    static constexpr int8_t FILE_VERSION = 1;
+
+    #pragma pack(push, 1)
+    struct Header {
+      int8_t version;
+      uint8_t uuid[16];
+      uint32_t epubSize;
+      uint32_t useClock; ///< Incremented each time a picture is used
+      uint16_t entryCount;
+      uint32_t dataEnd;
+      uint32_t crc; ///< Of the header up to here and of the entries
+    };
+
+    struct Entry {
+      uint64_t pathHash;
+      Dim srcDim;
+      Dim dim;
+      uint8_t bitsPerPixel;
+      uint32_t offset;
+      uint32_t size;
+      uint32_t lastUse;
+    };
+    #pragma pack(pop)
+
+    static constexpr uint32_t INDEX_SIZE  = sizeof(Header) + MAX_ENTRIES * sizeof(Entry);
+    static constexpr uint32_t DATA_OFFSET = (INDEX_SIZE + 511) & ~511U; ///< On a sector boundary
+
+    std::mutex mutex;
+    FILE *file{ nullptr };
+    HimemString epubFilename{};
+    HimemUniquePtr<uint8_t[]> index{ nullptr }; ///< Header and entries, as in the file
+    uint32_t capacity{ CAPACITY };
+    uint32_t liveBytes{ 0 };
+    uint32_t hits{ 0 };
+    uint32_t misses{ 0 };
+    bool indexDirty{ false };
+
+    [[nodiscard]] inline auto header() -> Header & { return *reinterpret_cast<Header *>(index.get()); }
+    [[nodiscard]] inline auto entries() -> Entry * {
+      return reinterpret_cast<Entry *>(index.get() + sizeof(Header));
+    }
+
+    static auto hashOf(const HimemString &path) -> uint64_t;
+    static auto epubSizeOf(const HimemString &epubFilename) -> uint32_t;
+    static auto bitmapSize(Dim dim, uint8_t bitsPerPixel) -> uint32_t;
+
+    auto indexCrc() -> uint32_t;
+    auto indexIsValid(uint32_t fileSize, const BinUUID &uuid) -> bool;
+    auto writeIndex() -> bool;
+    auto reset(const BinUUID &uuid) -> bool;
+    auto remove(uint16_t idx) -> void;
+    auto compact() -> bool;
+    auto doClose() -> void;
+};
+
+#if __PICTURE_CACHE__
+  PictureCache pictureCache;
+#else
+  extern PictureCache pictureCache;
+#endif
@@ -420,8 +420,7 @@ auto TOC::clean() -> void {
   someIds   = false;
 }
 
-auto TOC::set(std::string &id, int32_t currentOffset) -> void {
-  auto itemrefIndex = pageLocs.getCurrentItemrefIndex();
+auto TOC::set(int16_t itemrefIndex, std::string &id, int32_t currentOffset) -> void {
   if (itemrefIndex < 0) { return; }
 
   Infos::iterator infosIt = infos.find(std::make_pair(itemrefIndex, id));
@@ -431,8 +430,7 @@ auto TOC::set(std::string &id, int32_t currentOffset) -> void {
   }
 }
 
-auto TOC::set(int32_t currentOffset) -> void {
-  auto itemrefIndex = pageLocs.getCurrentItemrefIndex();
+auto TOC::set(int16_t itemrefIndex, int32_t currentOffset) -> void {
   if (itemrefIndex < 0) { return; }
   int16_t idx = -1;
 
@@ -447,6 +445,19 @@ auto TOC::set(int32_t currentOffset) -> void {
   }
 }
 
+auto TOC::merge(const TOC &other) -> void {
+  if (other.entries.size() != entries.size()) {
+    LOG_E("Unable to merge tables of content of different sizes.");
+    return;
+  }
+
+  for (size_t idx = 0; idx < entries.size(); ++idx) {
+    if ((entries[idx].pageId.offset < 0) && (other.entries[idx].pageId.offset >= 0)) {
+      entries[idx].pageId.offset = other.entries[idx].pageId.offset;
+    }
+  }
+}
+
 auto TOC::exists(const HimemString &epubFilename) -> bool {
   HimemString filename = epubFilename.substr(0, epubFilename.find_last_of('.')) + ".toc";
   auto        db              = SimpleDB::Make();
@@ -133,11 +133,24 @@ public:
    * of content, its location will be set with the
    * pageId received.
    *
+   * @param itemrefIndex The item being computed.
    * @param id HTML id attribute that is part of an item.
    * @param currentOffset The location offset of the id in the item
    */
-  auto set(std::string &id, int32_t currentOffset) -> void;
-  auto set(int32_t currentOffset) -> void;
+  auto set(int16_t itemrefIndex, std::string &id, int32_t currentOffset) -> void;
+  auto set(int16_t itemrefIndex, int32_t currentOffset) -> void;
+
+  /**
+   * @brief Get the entries locations found by another instance
+   *
+   * Each page locations retriever worker sets the entries of the items
+   * it computes in the table of content of its own EPub instance. They
+   * are gathered in one of them before it is saved. Both instances must
+   * have been loaded from the same book.
+   *
+   * @param other The table of content of another worker.
+   */
+  auto merge(const TOC &other) -> void;
 
   static auto exists(const HimemString &epubFilename) -> bool;
 
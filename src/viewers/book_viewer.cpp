@@ -21,6 +21,7 @@
 #include "alloc.hpp"
 #include "screen.hpp"
 
+#include <chrono>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
@@ -45,29 +46,71 @@ class BookViewerInterp : public HTMLInterpreter {
     }
 };
 
-auto BookViewer::recreatePage(EPubPtr &epub) -> bool {
-  page.reset();
-  page = Page::Make(epub->getFonts(), epub->getLanguage());
-  if (page == nullptr) {
+/**
+ * Get the page ready to be built. The page instance is kept for the book:
+ * only its content is cleared. A prefetched page, that gets its glyphs from
+ * the prefetcher's fonts, is given back to the prefetcher.
+ */
+auto BookViewer::resetPage(EPubPtr &epub) -> bool {
+  pageIsPrefetched = false;
+
+  if ((page == nullptr) || !page->usesFonts(epub->getFonts())) {
+    releasePage(std::move(page), epub);
+    page = std::move(sparePage);
+  }
+
+  if (page != nullptr) {
+    page->rebind(epub->getLanguage());
+  } else if ((page = Page::Make(epub->getFonts(), epub->getLanguage())) == nullptr) {
     LOG_E("Unable to allocate a new Page instance");
     return false;
   }
+
+  // No other page refers to the glyphs of the book fonts: the glyph caches
+  // can be trimmed.
+  if (sparePage == nullptr) { epub->getFonts().releaseGlyphs(); }
+
   return true;
 }
 
+/**
+ * Put aside a page no longer shown, to be reused by resetPage() or by the
+ * prefetcher, depending on the fonts it uses.
+ */
+auto BookViewer::releasePage(PagePtr oldPage, EPubPtr &epub) -> void {
+  if (oldPage == nullptr) { return; }
+
+  if (oldPage->usesFonts(epub->getFonts())) {
+    if (sparePage == nullptr) { sparePage = std::move(oldPage); }
+  } else if (prefetcher != nullptr) {
+    prefetcher->recycle(std::move(oldPage));
+  }
+}
+
 auto BookViewer::buildPageAt(const PageId &pageId, EPubPtr &epub) -> void {
+  const PageLocs::PageInfo *page_info = pageLocs.getPageInfo(pageId);
+
+  if (page_info == nullptr) { return; }
+
+  buildPage(page, pageId, page_info->size, epub);
+}
+
+auto BookViewer::buildPage(PagePtr &page, const PageId &pageId, int32_t pageSize, EPubPtr &epub)
+-> bool {
 
   #if LINE_POS_TRACING
     if ((pageId.itemrefIndex == LINE_POS_TRACING)) {
       page->setTracing(true);
-      LOG_I("buildPageAt(): {} {}", pageId.itemrefIndex, pageId.offset);
+      LOG_I("buildPage(): {} {}", pageId.itemrefIndex, pageId.offset);
     }
   #endif
 
-  FontPtr &font = epub->getFonts().getFont(ScreenBottom::FONT);
-  pageBottom    = font->getCharsHeight(ScreenBottom::FONT_SIZE) + 15;
+  FontPtr &font       = epub->getFonts().getFont(ScreenBottom::FONT);
+  uint16_t pageBottom = font->getCharsHeight(ScreenBottom::FONT_SIZE) + 15;
+
+  bool built = epub->getItemAtIndex(pageId.itemrefIndex);
 
-  if (epub->getItemAtIndex(pageId.itemrefIndex)) {
+  if (built) {
 
     int16_t idx;
 
@@ -101,15 +144,19 @@ auto BookViewer::buildPageAt(const PageId &pageId, EPubPtr &epub) -> void {
       vTaskDelay(pdMS_TO_TICKS(1));
     #endif
 
-    const PageLocs::PageInfo *page_info = pageLocs.getPageInfo(pageId);
-
-    if (page_info == nullptr) { return; }
-
     auto dom    = DOM::Make(epub->getDomPools());
     auto interp = std::make_unique<BookViewerInterp>(epub, page, dom, Page::ComputeMode::DISPLAY,
                                                      epub->getCurrentItemInfo());
-    interp->setLimits(pageId.offset, pageId.offset + page_info->size,
+    interp->setLimits(pageId.offset, pageId.offset + pageSize,
                       epub->getBookFormatParams()->showPictures != 0);
+    interp->setCheckpoints(&pageLocs.getCheckpoints());
+
+    // Start from the nearest layout checkpoint, avoiding to walk through
+    // everything that precedes the page in the item.
+    LayoutCheckpoints::Path checkpointPath;
+    if (pageLocs.getCheckpoints().nearest(pageId.itemrefIndex, pageId.offset, checkpointPath) >= 0) {
+      interp->resumeFrom(checkpointPath);
+    }
 
     #if DEBUGGING_AID
       interp->setPagesToShowState(PAGE_FROM, PAGE_TO);
@@ -130,7 +177,22 @@ auto BookViewer::buildPageAt(const PageId &pageId, EPubPtr &epub) -> void {
 
       Page::Format *new_fmt = interp->duplicateFmt(fmt);
 
-      if (interp->buildPagesRecurse(node, *new_fmt, dom->body, 1)) {
+      bool done = interp->buildPagesRecurse(node, *new_fmt, dom->body, 1);
+
+      if (interp->resumeFailed()) {
+        // The checkpoint does not fit the item: walk it from the beginning.
+        LOG_W("Layout checkpoint rejected, rebuilding page from item start.");
+        interp->releaseFmt(new_fmt);
+        dom.reset();
+        dom = DOM::Make(epub->getDomPools());
+        interp->setLimits(pageId.offset, pageId.offset + pageSize,
+                          epub->getBookFormatParams()->showPictures != 0);
+        page->start(fmt, epub->getBookFormatParams()->columnCount);
+        new_fmt = interp->duplicateFmt(fmt);
+        done    = interp->buildPagesRecurse(node, *new_fmt, dom->body, 1);
+      }
+
+      if (done) {
 
         if (page->someDataWaiting()) { page->endParagraph(fmt); }
 
@@ -168,7 +230,9 @@ auto BookViewer::buildPageAt(const PageId &pageId, EPubPtr &epub) -> void {
     page->setTracing(false);
   #endif
 
-  LOG_D("end of buildPageAt()");
+  LOG_D("end of buildPage()");
+
+  return built;
 }
 
 auto BookViewer::showFakeCover(EPubPtr &epub) -> void {
@@ -205,10 +269,56 @@ auto BookViewer::showFakeCover(EPubPtr &epub) -> void {
 
 auto BookViewer::displayPage(const PageId &pageId) -> void {
   // page->putRounded(Dim(Screen::getWidth() - 2, Screen::getHeight() - 2), Pos(1, 1));
-  ScreenBottom::show(page, pageLocs.getPageNbr(pageId), pageLocs.getPageCountOrPercent());
+  {
+    // A prefetched page gets its glyphs from the prefetcher's fonts, that its
+    // task may be using to build another page.
+    std::unique_lock<std::mutex> fontsGuard;
+    if (pageIsPrefetched) { fontsGuard = prefetcher->lockFonts(); }
+
+    ScreenBottom::show(page, pageLocs.getPageNbr(pageId), pageLocs.getPageCountOrPercent());
+  }
   page->paint();
 }
 
+auto BookViewer::prefetchAround(const PageId &pageId, EPubPtr &epub) -> void {
+  if (prefetchDisabled) { return; }
+
+  if (prefetcher == nullptr) {
+    prefetcher = PagePrefetcher::Make();
+    if ((prefetcher == nullptr) || !prefetcher->start(epub->getCurrentFilename())) {
+      LOG_W("Page prefetching not available.");
+      prefetcher.reset();
+      prefetchDisabled = true;
+      return;
+    }
+  }
+
+  PagePrefetcher::Target targets[PagePrefetcher::TARGET_COUNT];
+
+  // The cover page is never prefetched, as it is painted while being prepared.
+  // Going back from the first page would wrap to the end of the book: not a
+  // likely move, and it could force the computation of the last item's locations.
+  const PageId *id = pageLocs.getNextPageId(pageId);
+  if ((id != nullptr) && !id->firstPage() && !(*id == pageId)) { targets[0].id = *id; }
+  id = pageLocs.getPrevPageId(pageId);
+  if ((id != nullptr) && !id->firstPage() && (id->itemrefIndex <= pageId.itemrefIndex) &&
+      !(*id == pageId)) {
+    targets[1].id = *id;
+  }
+
+  for (auto &target : targets) {
+    if (target.id.itemrefIndex < 0) { continue; }
+    const PageLocs::PageInfo *info = pageLocs.getPageInfo(target.id);
+    if (info != nullptr) {
+      target.size = info->size;
+    } else {
+      target.id.reset();
+    }
+  }
+
+  prefetcher->request(targets);
+}
+
 auto BookViewer::preparePage(const PageId &pageId, EPubPtr &epub) -> bool {
   if ((pageId.itemrefIndex < 0) || (pageId.offset < 0)) {
     LOG_W("Ignoring invalid preparePage request: itemref={} offset={}", pageId.itemrefIndex,
@@ -216,11 +326,34 @@ auto BookViewer::preparePage(const PageId &pageId, EPubPtr &epub) -> bool {
     return false;
   }
 
-  if (!recreatePage(epub)) { return false; }
+  #if EPUB_LINUX_BUILD
+    auto     start       = std::chrono::steady_clock::now();
+    uint32_t allocations = himemAllocationCount.load(std::memory_order_relaxed);
+  #endif
 
   current_page_id = pageId;
 
-  const bool isCoverPage = (pageId.itemrefIndex == 0) && (pageId.offset == 0);
+  const bool isCoverPage = pageId.firstPage();
+
+  if (!isCoverPage && (prefetcher != nullptr)) {
+    PagePtr prefetched = prefetcher->take(pageId);
+    if (prefetched != nullptr) {
+      std::swap(page, prefetched);
+      releasePage(std::move(prefetched), epub);
+      pageIsPrefetched = true;
+
+      #if EPUB_LINUX_BUILD
+        prefetcher->recordTurn(true,
+                               std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - start).count(),
+                               himemAllocationCount.load(std::memory_order_relaxed) - allocations);
+      #endif
+
+      return true;
+    }
+  }
+
+  if (!resetPage(epub)) { return false; }
 
   if (isCoverPage) {
     if (epub->getBookFormatParams()->showPictures != 0) {
@@ -256,6 +389,15 @@ auto BookViewer::preparePage(const PageId &pageId, EPubPtr &epub) -> bool {
     }
   } else {
     buildPageAt(pageId, epub);
+
+    #if EPUB_LINUX_BUILD
+      if (prefetcher != nullptr) {
+        prefetcher->recordTurn(false,
+                               std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - start).count(),
+                               himemAllocationCount.load(std::memory_order_relaxed) - allocations);
+      }
+    #endif
   }
 
   return true;
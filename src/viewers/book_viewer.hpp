@@ -23,6 +23,7 @@
 #include "models/page_locs.hpp"
 #include "pugixml.hpp"
 #include "viewers/page.hpp"
+#include "viewers/page_prefetcher.hpp"
 
 using namespace pugi;
 
@@ -35,12 +36,18 @@ class BookViewer {
   private:
     BookViewer(Fonts &fonts, const char *language) : page(Page::Make(fonts, language)) {};
 
-    uint16_t pageBottom;
     PageId current_page_id{ -1, -1 };
 
+    // Declared before the page: a prefetched page uses the prefetcher's fonts.
+    PagePrefetcherPtr prefetcher{ nullptr };
+    bool prefetchDisabled{ false };
+    bool pageIsPrefetched{ false };
+
     PagePtr page{ nullptr };
+    PagePtr sparePage{ nullptr }; ///< Page of the book's fonts put aside while a prefetched page is shown
 
-    auto recreatePage(EPubPtr &epub) -> bool;
+    auto resetPage(EPubPtr &epub) -> bool;
+    auto releasePage(PagePtr oldPage, EPubPtr &epub) -> void;
     auto buildPageAt(const PageId &pageId, EPubPtr &epub) -> void;
 
     struct PageEnd {
@@ -78,6 +85,31 @@ class BookViewer {
 
     auto showFakeCover(EPubPtr &epub) -> void;
 
+    /**
+     * @brief Start building the pages following and preceding a page in the background.
+     *
+     * Called once the page is on screen. The next call to preparePage() for
+     * one of these pages will then only have to take it from the prefetcher.
+     */
+    auto prefetchAround(const PageId &pageId, EPubPtr &epub) -> void;
+
+    /**
+     * @brief Build the display list of a page.
+     *
+     * Shared by the book viewer and the page prefetcher. The page size comes
+     * from the page locations.
+     *
+     * @return true if the item of the page could be retrieved.
+     */
+    static auto buildPage(PagePtr &page, const PageId &pageId, int32_t pageSize, EPubPtr &epub)
+    -> bool;
+
+    #if EPUB_LINUX_BUILD
+      [[nodiscard]] auto getPrefetchStats() -> PagePrefetcher::Stats {
+        return (prefetcher != nullptr) ? prefetcher->getStats() : PagePrefetcher::Stats{};
+      }
+    #endif
+
     static constexpr int16_t TITLE_FONT      = 2;
     static constexpr int16_t TITLE_FONT_SIZE = 8;
 };
@@ -156,6 +156,8 @@ class FormChoiceField : public FormField {
 
     static constexpr FormChoice coverSizeChoices[3] = { { "SMALL", 0 }, { "MEDIUM", 1 }, { "LARGE", 2 } };
 
+    static constexpr FormChoice booksSortChoices[3] = { { "RECENT", 0 }, { "TITLE", 1 }, { "AUTHOR", 2 } };
+
     static constexpr FormChoice lineHeightChoices[3] = { { "TIGHT", 0 }, { "MEDIUM", 1 }, { "LARGE", 2 } };
 
     static constexpr FormChoice okCancelChoices[2] = { { "OK", 1 }, { "CANCEL", 0 } };
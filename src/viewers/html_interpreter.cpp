@@ -48,11 +48,11 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
 
   (void)checkIfStarted();
 
-  std::string         pictureFilename;
-  const char *        name;
-  const char *        str           = nullptr;
-  DOM::Node *         domCurrentNode = domNode;
-  DOM::Tags::iterator tagIt = DOM::tags.end();
+  std::string               pictureFilename;
+  const char *              name;
+  const char *              str            = nullptr;
+  DOM::Node *               domCurrentNode = domNode;
+  DOM::Tags::const_iterator tagIt          = DOM::tags.end();
 
   // xml node without a tag name are internal data to be processed as string of chars
   bool namedElement = *(name = node.name()) != 0;
@@ -64,7 +64,7 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
     if ((page->getComputeMode() == Page::ComputeMode::LOCATION) && epub->toc->thereIsSomeIds() &&
         (attr = node.attribute("id"))) {
       std::string id = attr.value();
-      epub->toc->set(id, currentOffset);
+      epub->toc->set(itemInfo.itemrefIndex, id, currentOffset);
     }
 
     if (node.attribute("hidden")) { return true; }
@@ -77,7 +77,7 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
     fmt.marginRight  = 0;
     fmt.marginTop    = 0;
 
-    if ((tagIt = DOM::tags.find(name)) != DOM::tags.end()) {
+    if ((tagIt = DOM::tags.find(std::string_view(name))) != DOM::tags.end()) {
 
       if (tagIt->second != DOM::Tag::BODY) {
         domCurrentNode = dom->addChild(domNode, tagIt->second);
@@ -331,11 +331,18 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
         if (started && (currentOffset < endOffset)) {
           const bool displayMode = page->getComputeMode() == Page::ComputeMode::DISPLAY;
 
-          auto       pict = epub->getPicture(fname, displayMode);
+          // In display mode, the picture comes sized for the page, from the
+          // book's pictures cache when it was already shown.
+          Dim        srcDim(0, 0);
+          PicturePtr pict =
+            displayMode
+              ? epub->getSizedPicture(
+                  fname, [this, &fmt](Dim dim) { return page->pictureDim(dim, fmt); }, srcDim)
+              : epub->getPicture(fname, false);
 
           // If the image is large, show a loading icon while it loads to avoid a
           // long wait with a blank page.
-          if (displayMode) {
+          if (displayMode && !epub->isSecondaryInstance()) {
             if ((pict != nullptr) && eventMgr.someEventWaiting()) {
               showLoadIcon(pict->getDim());
             }
@@ -343,12 +350,13 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
 
           if (pict != nullptr) {
             bool added            = false;
-            std::tie(added, pict) = page->addPicture(std::move(pict), fmt /*, beginning_of_page */);
+            std::tie(added, pict) =
+              page->addPicture(std::move(pict), fmt, srcDim /*, beginning_of_page */);
             if (!added) {
               if (page->isFull() && !pageEndProcessing(fmt)) { return false; }
               if (atEndOfPageOffset()) { return true; }
 
-              page->addPicture(std::move(pict), fmt /*, beginning_of_page */);
+              page->addPicture(std::move(pict), fmt, srcDim /*, beginning_of_page */);
               if (page->isFull() && !pageEndProcessing(fmt)) { return false; }
               if (atEndOfPageOffset()) { return true; }
             }
@@ -366,12 +374,26 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
   if (namedElement) { // The element possesses a tag
     // Here we recurse on each child of the currernt tag.
     ++currentOffset;
-    xml_node sub = node.first_child();
+    xml_node sub        = node.first_child();
+    uint16_t childIndex = 0;
+
+    bool resuming = !resumePath.empty() && (resumeLevel == (level - 1));
+    if (resuming && !skipToResumeStep(sub, childIndex, domCurrentNode)) { return false; }
+
     while (sub != nullptr) {
       if (page->isFull() && !pageEndProcessing(fmt)) { return false; }
       if (atEndOfPageOffset()) { break; }
       Page::Format *newFmt = duplicateFmt(fmt);
-      if (!buildPagesRecurse(sub, *newFmt, domCurrentNode, level + 1)) {
+      path.push_back(LayoutCheckpoints::Step{ childIndex, currentOffset });
+      bool res = buildPagesRecurse(sub, *newFmt, domCurrentNode, level + 1);
+      path.pop_back();
+      if (resuming) {
+        // Whatever remains of the checkpoint path was inside that child.
+        resumePath.clear();
+        resuming = false;
+        if (resumeError) { releaseFmt(newFmt); return false; }
+      }
+      if (!res) {
         releaseFmt(newFmt);
         if (page->isFull() && !pageEndProcessing(fmt)) { return false; }
         if (atEndOfPageOffset()) { break; }
@@ -379,6 +401,7 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
       }
       releaseFmt(newFmt);
       sub = sub.next_sibling();
+      ++childIndex;
     }
 
     // The sub-nodes have been processed. Complete the block if not Inline and check
@@ -534,3 +557,43 @@ auto HTMLInterpreter::buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::N
 
   return true;
 }
+
+// Skip the children of the current node that precede the checkpoint step of
+// this level. Preceding element siblings are still added to the DOM, without
+// their content, so that sibling related selectors (+, ~, :first-child) give
+// the same result as with a complete walk.
+auto HTMLInterpreter::skipToResumeStep(xml_node &sub, uint16_t &childIndex, DOM::Node *domNode)
+-> bool {
+  const LayoutCheckpoints::Step &step = resumePath[resumeLevel];
+
+  while ((sub != nullptr) && (childIndex < step.childIndex)) {
+    const char *name = sub.name();
+    if ((*name != 0) && !sub.attribute("hidden")) {
+      DOM::Tags::const_iterator tagIt = DOM::tags.find(std::string_view(name));
+      if ((tagIt != DOM::tags.end()) && (tagIt->second != DOM::Tag::BODY)) {
+        DOM::Node *domSibling = dom->addChild(domNode, tagIt->second);
+        if (domSibling != nullptr) {
+          xml_attribute attr;
+          if ((attr = sub.attribute("id"))) { domSibling->addId(attr.value()); }
+          if ((attr = sub.attribute("class"))) { domSibling->addClasses(attr.value()); }
+        }
+      }
+    }
+    sub = sub.next_sibling();
+    ++childIndex;
+  }
+
+  if ((sub == nullptr) || (step.entryOffset < currentOffset) || (step.entryOffset > startOffset)) {
+    LOG_E("Layout checkpoint does not match item content at level {}.", resumeLevel + 1);
+    resumePath.clear();
+    resumeError = true;
+    return false;
+  }
+
+  currentOffset = step.entryOffset;
+  if (++resumeLevel >= resumePath.size()) {
+    // Last step: the walk goes on from there as usual.
+    resumeLevel = UINT8_MAX;
+  }
+  return true;
+}
@@ -9,6 +9,7 @@
 
 #include "models/dom.hpp"
 #include "models/epub.hpp"
+#include "models/layout_checkpoints.hpp"
 #include "pugixml.hpp"
 #include "viewers/page.hpp"
 
@@ -50,6 +51,24 @@ class HTMLInterpreter {
 
     HimemPool<Page::Format> fmtPool;
 
+    // Layout checkpoints: path is the child index / entry offset of every
+    // node being walked below the body tag. When resumePath is not empty, the
+    // walk skips the siblings preceding each of its steps (see resumeFrom()).
+    LayoutCheckpoints *checkpoints{ nullptr };
+    LayoutCheckpoints::Path path;
+    LayoutCheckpoints::Path resumePath;
+    uint8_t resumeLevel{ 0 };
+    bool resumeError{ false };
+
+    auto skipToResumeStep(xml_node &sub, uint16_t &childIndex, DOM::Node *domNode) -> bool;
+
+    /// Record the path to the current page start, if it is a valid resume point.
+    inline auto recordCheckpoint() -> void {
+      if ((checkpoints != nullptr) && !path.empty() && (path.back().entryOffset <= startOffset)) {
+        checkpoints->record(itemInfo.itemrefIndex, startOffset, path);
+      }
+    }
+
     // The pageEnd method is responsible of doing post-processing once
     // the end of a page has been detected (the page.isFull() method returns true or
     // the process reached the pageEnd offset). This is specific for each of the book_viewer
@@ -70,9 +89,33 @@ class HTMLInterpreter {
       startOffset   = start;
       endOffset     = end;
       showPictures  = showImgs;
+      path.clear();
+      resumePath.clear();
+      resumeLevel = 0;
+      resumeError = false;
       page->setComputeMode(Page::ComputeMode::MOVE);
     }
 
+    /// Checkpoints store to feed with page starts found while walking.
+    auto setCheckpoints(LayoutCheckpoints *store) -> void { checkpoints = store; }
+
+    /**
+     * Start the next walk from a checkpoint instead of the beginning of the
+     * item. Must be called after setLimits(), with the path of a checkpoint
+     * located at or before the start offset. Siblings preceding the path are
+     * not walked; the ancestors are entered as usual to rebuild the format
+     * and the DOM context. If the path does not match the item, the walk
+     * stops and resumeFailed() returns true: the caller must then start over
+     * without a checkpoint.
+     */
+    auto resumeFrom(const LayoutCheckpoints::Path &checkpointPath) -> void {
+      resumePath  = checkpointPath;
+      resumeLevel = 0;
+      resumeError = false;
+    }
+
+    [[nodiscard]] inline auto resumeFailed() const -> bool { return resumeError; }
+
     auto buildPagesRecurse(xml_node node, Page::Format &fmt, DOM::Node *domNode, int16_t level)
     -> bool;
 
@@ -107,6 +150,7 @@ class HTMLInterpreter {
         if ((started = (currentOffset >= startOffset))) {
           page->setComputeMode(computeMode);
           page->clean();
+          recordCheckpoint();
           LOG_D("---- PAGE START ----");
         }
       }
@@ -71,10 +71,11 @@ auto LinearBooksDirViewer::showPage(int16_t pageNbr, int16_t hightlightItemIdx)
     auto    book = booksDir.getBookData(bookIdx);
 
     if (!book) { break; }
-    PicturePtr picture =
-      Picture::Make(book->coverDim, (uint8_t *)book->coverBitmap, book->coverSize(), 4);
-    page->putPicture(std::move(picture),
-                     Pos(10 + BooksDir::coverDim.width - book->coverDim.width, ypos));
+    PicturePtr picture = booksDir.getCover(*book);
+    if (picture) {
+      page->putPicture(std::move(picture),
+                       Pos(10 + BooksDir::coverDim.width - book->coverDim.width, ypos));
+    }
 
     #if !(INKPLATE_6PLUS || INKPLATE_6PLUS_V2 || INKPLATE_6FLICK || TOUCH_TRIAL)
       if (itemIdx == currentItemIdx) {
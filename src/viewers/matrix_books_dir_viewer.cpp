@@ -96,12 +96,13 @@ auto MatrixBooksDirViewer::showPage(int16_t page_nbr, int16_t hightlight_item_id
 
     if (!book) { break; }
 
-    PicturePtr picture =
-      Picture::Make(book->coverDim, (uint8_t *)book->coverBitmap, book->coverSize(), 4);
+    PicturePtr picture = booksDir.getCover(*book);
 
-    page->putPicture(std::move(picture),
-                     Pos(xpos + ((BooksDir::coverDim.width - book->coverDim.width) >> 1),
-                         ypos + ((BooksDir::coverDim.height - book->coverDim.height) >> 1)));
+    if (picture) {
+      page->putPicture(std::move(picture),
+                       Pos(xpos + ((BooksDir::coverDim.width - book->coverDim.width) >> 1),
+                           ypos + ((BooksDir::coverDim.height - book->coverDim.height) >> 1)));
+    }
 
     #if !(INKPLATE_6PLUS || INKPLATE_6PLUS_V2 || INKPLATE_6FLICK || TOUCH_TRIAL || TOUCH_MENU)
       if (item_idx == currentItemIdx) {
@@ -28,6 +28,28 @@ auto Page::clean() -> void {
   pageEmpty    = true;
 }
 
+auto Page::rebind(const char *language) -> void {
+  clean();
+
+  computeMode     = ComputeMode::DISPLAY;
+  multiColumnMode = false;
+  currentColumn   = 1;
+  columnCount     = 1;
+
+  #if LINE_POS_TRACING
+    tracing = false;
+  #endif
+
+  // Looking up the language trie is only done when it changed.
+  const char *lang = (language != nullptr) ? language : "";
+  bool        same = (strlen(lang) >= 2) ? (strncmp(lang, languageCode, 2) == 0)
+                                         : (languageCode[0] == 0);
+  if (!same) {
+    hyphenator = Hyphenator::Make(lang);
+    setLanguageCode(lang);
+  }
+}
+
 auto Page::putStrAt(const std::string &str, Pos pos, const Format &fmt) -> void {
   FontPtr &   font = fonts.getFont(fmt.fontIndex);
 
@@ -1041,39 +1063,12 @@ auto Page::addChar(const char *ch, const Format &fmt) -> bool {
  * @note The picture object may be modified (resized) by this method.
  *       The method respects glyph baseline information from the current font.
  */
-auto Page::addPicture(PicturePtr picture, const Format &fmt /*, bool at_start_of_page*/)
--> std::pair<bool, PicturePtr> {
-
-  if (screenIsFull) {
-    return { false, std::move(picture) };
-  }
-
-  // Compute the baseline advance for the bitmap, using info from the current font
-  Glyph *     glyph;
-  FontPtr &   font = fonts.getFont(fmt.fontIndex);
-
-  const char *str = "m";
-
-  auto [code, s1] = UTF8::toUnicode(str, fmt.textTransform, true);
-
-  glyph = font->getGlyph(code, fmt.fontSize);
-
-  // Compute available space to put the picture.
-
+auto Page::pictureDim(Dim dim, const Format &fmt) const -> Dim {
   int32_t w = 0;
   int32_t h = 0;
-  int32_t advance;
-  int16_t gap = 0;
-
-  if (glyph != nullptr) {
-    gap = glyph->advance - glyph->dim.width;
-  }
-
-  // compute target w, h and advance for the picture
 
   int16_t targetWidth  = paraMaxX - paraMinX;
   int16_t targetHeight = maxY - minY;
-  auto    dim             = picture->getDim();
 
   if (fmt.width || fmt.height) {
     if (fmt.width && (fmt.width < targetWidth)) { targetWidth = fmt.width; }
@@ -1105,6 +1100,46 @@ auto Page::addPicture(PicturePtr picture, const Format &fmt /*, bool at_start_of
       }
     }
   }
+
+  return Dim(w, h);
+}
+
+auto Page::addPicture(PicturePtr picture, const Format &fmt, Dim srcDim
+                      /*, bool at_start_of_page*/) -> std::pair<bool, PicturePtr> {
+
+  if (screenIsFull) {
+    return { false, std::move(picture) };
+  }
+
+  // Compute the baseline advance for the bitmap, using info from the current font
+  Glyph *     glyph;
+  FontPtr &   font = fonts.getFont(fmt.fontIndex);
+
+  const char *str = "m";
+
+  auto [code, s1] = UTF8::toUnicode(str, fmt.textTransform, true);
+
+  glyph = font->getGlyph(code, fmt.fontSize);
+
+  // Compute available space to put the picture.
+
+  int32_t w = 0;
+  int32_t h = 0;
+  int32_t advance;
+  int16_t gap = 0;
+
+  if (glyph != nullptr) {
+    gap = glyph->advance - glyph->dim.width;
+  }
+
+  // compute target w, h and advance for the picture
+
+  auto dim    = picture->getDim();
+  Dim  target = pictureDim((srcDim.width != 0) ? srcDim : dim, fmt);
+
+  w = target.width;
+  h = target.height;
+
   advance = w + gap;
 
   // Verify that there is enough room for the bitmap on the line
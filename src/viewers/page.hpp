@@ -15,6 +15,7 @@
 #include "models/css.hpp"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <utility>
 
@@ -37,10 +38,19 @@ using PagePtr = HimemUniquePtr<class Page>;
 
 class Page {
   private:
-    Page(Fonts &fonts, const char * language) : fonts(fonts), hyphenator(Hyphenator::Make(language)) {}
+    Page(Fonts &fonts, const char * language) : fonts(fonts), hyphenator(Hyphenator::Make(language)) {
+      setLanguageCode(language);
+    }
 
     Fonts &fonts;
     HyphenatorPtr hyphenator;
+    char languageCode[3]{}; ///< The hyphenator is selected with the first two letters
+
+    auto setLanguageCode(const char *language) -> void {
+      bool ok = (language != nullptr) && (strlen(language) >= 2);
+      languageCode[0] = ok ? language[0] : 0;
+      languageCode[1] = ok ? language[1] : 0;
+    }
 
   public:
     ~Page() = default; // { LOG_D("Page destructor called"); };
@@ -136,6 +146,22 @@ class Page {
   public:
     auto clean() -> void;
 
+    /**
+     * @brief Make the page ready to be built again
+     *
+     * The page is cleared as by clean(), back to the DISPLAY compute mode.
+     * Its display list pool is kept, and so is its hyphenator unless the
+     * language changed. Used by the book viewer, the page prefetcher and the
+     * page locations retrievers to keep a page for a book instead of
+     * allocating one for each page built. The format is given to start().
+     *
+     * @param language The book language.
+     */
+    auto rebind(const char *language) -> void;
+
+    /// True if the page gets its glyphs from these fonts.
+    [[nodiscard]] inline auto usesFonts(const Fonts &f) const -> bool { return &fonts == &f; }
+
     #if LINE_POS_TRACING
       auto setTracing(bool value) -> void { tracing = value; }
     #endif
@@ -232,13 +258,24 @@ class Page {
      *
      * @param picture Picture data. Each pixel is a grayscaled byte.
      * @param fmt Formatting parameters.
+     * @param srcDim The decoded picture size, when the picture was already sized with
+     *               pictureDim(). The picture size otherwise.
      * @param at_start_of_page True if it's the first item in a page
      * @return {true, nullptr} The picture has been added to the paragraph
      * @return {false, picture} There is not enough room to add the picture. The picture is returned
      * to the caller.
      */
-    auto addPicture(PicturePtr picture, const Format &fmt /*, bool at_start_of_page*/)
-    -> std::pair<bool, PicturePtr>;
+    auto addPicture(PicturePtr picture, const Format &fmt, Dim srcDim = Dim(0, 0)
+                    /*, bool at_start_of_page*/) -> std::pair<bool, PicturePtr>;
+
+    /**
+     * @brief Size of a picture on the page
+     *
+     * @param dim The decoded picture size.
+     * @param fmt Formatting parameters.
+     * @return The size given to the picture by addPicture().
+     */
+    [[nodiscard]] auto pictureDim(Dim dim, const Format &fmt) const -> Dim;
 
     /**
      * @brief Add text on page
@@ -320,6 +357,7 @@ class Page {
     inline auto setComputeMode(ComputeMode mode) -> void { computeMode = mode; }
 
     [[nodiscard]] inline auto getComputeMode() const -> ComputeMode { return computeMode; }
+    [[nodiscard]] inline auto getHyphenator() -> HyphenatorPtr & { return hyphenator; }
     [[nodiscard]] inline auto paintWidth() const -> int16_t { return maxX - minX; }
     [[nodiscard]] inline auto isFull() const -> bool { return screenIsFull; }
     [[nodiscard]] inline auto isEmpty() const -> bool { return pageEmpty; }
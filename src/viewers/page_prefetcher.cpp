@@ -0,0 +1,262 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#include "viewers/page_prefetcher.hpp"
+
+#include "viewers/book_viewer.hpp"
+
+#include "logging.hpp"
+
+#include <algorithm>
+
+#if EPUB_LINUX_BUILD
+  #include <chrono>
+#endif
+
+auto PagePrefetcher::start(const HimemString &epubFilename) -> bool {
+  filename = epubFilename;
+
+  epub = EPub::Make();
+  if (epub == nullptr) {
+    LOG_E("Unable to allocate the prefetch EPub instance.");
+    return false;
+  }
+
+  // Like the page locations instance, this one must not close the shared
+  // unzip or interact with the user.
+  epub->setPrefetchInstance(true);
+  if (glyphCacheBudget > 0) { epub->getFonts().setGlyphCacheBudget(glyphCacheBudget); }
+
+  #if EPUB_LINUX_BUILD
+    prefetchThread = std::thread(&PagePrefetcher::task, this);
+  #else
+    taskRunning.store(true);
+    if (pdPASS != xTaskCreatePinnedToCore(
+          [](void *param) {
+            auto *self = static_cast<PagePrefetcher *>(param);
+            self->task();
+            self->taskRunning.store(false);
+            vTaskDelete(nullptr);
+          }, "prefetchTask", 25 * 1024, this, (configMAX_PRIORITIES - 3) | portPRIVILEGE_BIT,
+          &prefetchTaskHandle, 1)) {
+      taskRunning.store(false);
+      LOG_E("Unable to create prefetch task");
+      return false;
+    }
+  #endif
+
+  return true;
+}
+
+auto PagePrefetcher::stop() -> void {
+  {
+    std::scoped_lock guard(mutex);
+    stopRequested = true;
+  }
+  cv.notify_all();
+
+  #if EPUB_LINUX_BUILD
+    if (prefetchThread.joinable()) { prefetchThread.join(); }
+  #else
+    while (taskRunning.load()) { vTaskDelay(pdMS_TO_TICKS(10)); }
+  #endif
+}
+
+auto PagePrefetcher::request(const Target (&targets)[TARGET_COUNT]) -> void {
+  Slot newSlots[TARGET_COUNT];
+
+  {
+    std::scoped_lock guard(mutex);
+
+    for (uint8_t i = 0; i < TARGET_COUNT; i++) {
+      if ((targets[i].id.itemrefIndex < 0) || (targets[i].id.offset < 0)) { continue; }
+      newSlots[i].target = targets[i];
+      for (auto &slot : slots) {
+        if ((slot.page != nullptr) && (slot.target.id == targets[i].id) &&
+            (slot.target.size == targets[i].size)) {
+          newSlots[i].page = std::move(slot.page);
+          newSlots[i].mark = slot.mark;
+          break;
+        }
+      }
+    }
+
+    // The dropped pages are released out of the lock, with newSlots. One of
+    // them is kept for the next build.
+    for (uint8_t i = 0; i < TARGET_COUNT; i++) {
+      std::swap(slots[i], newSlots[i]);
+      if ((sparePage == nullptr) && (newSlots[i].page != nullptr)) {
+        sparePage = std::move(newSlots[i].page);
+      }
+    }
+  }
+
+  cv.notify_all();
+}
+
+auto PagePrefetcher::take(const PageId &pageId) -> PagePtr {
+  std::unique_lock guard(mutex);
+
+  cv.wait(guard, [&] { return !(building == pageId) || stopRequested; });
+
+  for (auto &slot : slots) {
+    if ((slot.page != nullptr) && (slot.target.id == pageId)) {
+      lent.push_back(Lent{ slot.page.get(), slot.mark });
+      return std::move(slot.page);
+    }
+  }
+
+  return nullptr;
+}
+
+auto PagePrefetcher::recycle(PagePtr page) -> void {
+  if (page == nullptr) { return; }
+
+  std::scoped_lock guard(mutex);
+  std::erase_if(lent, [&](const Lent &entry) { return entry.page == page.get(); });
+
+  if ((sparePage == nullptr) && (epub != nullptr) && page->usesFonts(epub->getFonts())) {
+    sparePage = std::move(page);
+  }
+}
+
+/**
+ * Select the next page to build, in the targets order. Called with the mutex held.
+ */
+auto PagePrefetcher::nextTarget(Target &target) -> bool {
+  if (failed) { return false; }
+
+  for (auto &slot : slots) {
+    if ((slot.target.id.itemrefIndex >= 0) && (slot.page == nullptr)) {
+      target = slot.target;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Use mark of the oldest page built by the task and still in use, in a slot
+ * or handed over to the viewer. Called with the mutex held.
+ */
+auto PagePrefetcher::inUseMark() const -> uint32_t {
+  uint32_t mark = UINT32_MAX;
+
+  for (auto &slot : slots) {
+    if (slot.page != nullptr) { mark = std::min(mark, slot.mark); }
+  }
+  for (auto &entry : lent) { mark = std::min(mark, entry.mark); }
+
+  return mark;
+}
+
+auto PagePrefetcher::task() -> void {
+  if (!epub->open(filename)) {
+    LOG_E("Unable to open the book for prefetching: {}", filename);
+    std::scoped_lock guard(mutex);
+    failed = true;
+    return;
+  }
+
+  for (;;) {
+    Target   target;
+    PagePtr  page{ nullptr };
+    bool     built = false;
+    uint32_t inUse;
+    uint32_t mark;
+
+    {
+      std::unique_lock guard(mutex);
+      cv.wait(guard, [&] { return stopRequested || nextTarget(target); });
+      if (stopRequested) { break; }
+      building = target.id;
+      page     = std::move(sparePage);
+      inUse    = inUseMark();
+    }
+
+    #if EPUB_LINUX_BUILD
+      auto        start = std::chrono::steady_clock::now();
+      std::size_t glyphBytes;
+    #endif
+
+    {
+      std::scoped_lock buildGuard(buildMutex);
+
+      // The glyphs of the pages in use were all retrieved after their mark:
+      // the others can go.
+      epub->getFonts().releaseGlyphs(inUse);
+      mark = Font::getUseMark();
+
+      #if EPUB_LINUX_BUILD
+        glyphBytes = epub->getFonts().getLargestGlyphCacheBytes();
+      #endif
+
+      if (page != nullptr) {
+        page->rebind(epub->getLanguage());
+      } else {
+        page = Page::Make(epub->getFonts(), epub->getLanguage());
+      }
+      if (page != nullptr) {
+        built = BookViewer::buildPage(page, target.id, target.size, epub);
+      } else {
+        LOG_E("Unable to allocate a prefetch Page instance");
+      }
+    }
+
+    {
+      std::scoped_lock guard(mutex);
+
+      #if EPUB_LINUX_BUILD
+        stats.builds++;
+        stats.buildMicros += std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - start).count();
+        stats.glyphBytes = std::max(stats.glyphBytes, glyphBytes);
+      #endif
+
+      building.reset();
+
+      bool kept = false;
+      for (auto &slot : slots) {
+        if ((slot.target.id == target.id) && (slot.target.size == target.size) &&
+            (slot.page == nullptr)) {
+          if (built) {
+            slot.page = std::move(page);
+            slot.mark = mark;
+          } else {
+            // Not retried: take() will report a miss and the page will be
+            // built on the spot.
+            slot.target.id.reset();
+          }
+          kept = true;
+          break;
+        }
+      }
+      if (!kept) { LOG_D("Prefetched page dropped: it is no longer requested."); }
+      if ((page != nullptr) && (sparePage == nullptr)) { sparePage = std::move(page); }
+    }
+
+    cv.notify_all();
+  }
+}
+
+#if EPUB_LINUX_BUILD
+  auto PagePrefetcher::recordTurn(bool hit, uint64_t micros, uint32_t allocations) -> void {
+    std::scoped_lock guard(mutex);
+    if (hit) {
+      stats.hits++;
+      stats.hitMicros += micros;
+      stats.hitAllocations += allocations;
+    } else {
+      stats.misses++;
+      stats.missMicros += micros;
+      stats.missAllocations += allocations;
+    }
+  }
+
+  auto PagePrefetcher::getStats() -> Stats {
+    std::scoped_lock guard(mutex);
+    return stats;
+  }
+#endif
@@ -0,0 +1,160 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+#pragma once
+
+#include "global.hpp"
+#include "himem.hpp"
+
+#include "models/epub.hpp"
+#include "viewers/page.hpp"
+
+#if EPUB_INKPLATE_BUILD
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+#else
+  #include <thread>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+using PagePrefetcherPtr = HimemUniquePtr<class PagePrefetcher>;
+
+/**
+ * class PagePrefetcher - Build the pages around the current one in the background
+ *
+ * While a page is on screen, the pages the reader is likely to show next (the
+ * following and the preceding ones) are built by a separate task, in the
+ * same way the page locations are computed by the PageLocsRetriever: the task
+ * owns its own EPub instance, opened on the same book, as the DOM and CSS
+ * pools of an EPub cannot be shared between threads. A page turn then takes
+ * the ready page and only has to paint it.
+ *
+ * Pages handed over by take() refer to the glyphs of the prefetcher's fonts:
+ * they must be released before the prefetcher, and given back with
+ * recycle(). Before each build, the task trims its glyph caches to their
+ * budget, keeping the glyphs used by the pages it built that were not given
+ * back. Adding text to such a page (the screen bottom line) requires
+ * lockFonts(), as the task may be loading glyphs in the same fonts.
+ */
+class PagePrefetcher {
+  public:
+    static constexpr char const *TAG = "PagePrefetcher";
+
+    static constexpr uint8_t TARGET_COUNT = 2; ///< Next and previous pages
+
+    /// A page to build, with its size in the item as found in the page locations.
+    struct Target {
+      PageId id{ -1, -1 };
+      int32_t size{ 0 };
+    };
+
+    #if EPUB_LINUX_BUILD
+      struct Stats {
+        uint32_t hits{ 0 };        ///< Page turns served with a prefetched page
+        uint32_t misses{ 0 };      ///< Page turns that had to build the page
+        uint64_t hitMicros{ 0 };   ///< Total time taken to get the page on hits
+        uint64_t missMicros{ 0 };  ///< Total time taken to get the page on misses
+        uint32_t builds{ 0 };      ///< Pages built by the prefetch task
+        uint64_t buildMicros{ 0 }; ///< Total time spent by the task building pages
+        uint64_t hitAllocations{ 0 };  ///< Total himem allocations made by the turns on hits
+        uint64_t missAllocations{ 0 }; ///< Total himem allocations made by the turns on misses
+        std::size_t glyphBytes{ 0 };   ///< Most bytes left in a glyph cache of the task by a trim
+      };
+    #endif
+
+    PagePrefetcher() = default;
+    ~PagePrefetcher() { stop(); }
+
+    static inline auto Make() { return makeUniqueHimem<PagePrefetcher>(); }
+
+    /// Glyph cache budget of each font of the task, if not the default. Called before start().
+    inline auto setGlyphCacheBudget(std::size_t bytes) -> void { glyphCacheBudget = bytes; }
+
+    /**
+     * Start the prefetch task. The book is opened by the task itself, so the
+     * caller is not delayed.
+     */
+    auto start(const HimemString &epubFilename) -> bool;
+
+    /// Stop the prefetch task and wait for it to exit.
+    auto stop() -> void;
+
+    /**
+     * Replace the pages to prefetch, in priority order. Pages already built
+     * for one of the new targets are kept, the others are dropped. Targets
+     * with an invalid id are ignored.
+     */
+    auto request(const Target (&targets)[TARGET_COUNT]) -> void;
+
+    /**
+     * Retrieve the page prefetched for pageId. If the task is currently
+     * building it, wait for it to be ready.
+     *
+     * @return The page, or nullptr if it was not prefetched.
+     */
+    auto take(const PageId &pageId) -> PagePtr;
+
+    /**
+     * Give back a page handed over by take() and no longer shown. It is
+     * reused by the task for the next page it builds. Pages of other fonts
+     * are released.
+     */
+    auto recycle(PagePtr page) -> void;
+
+    /// Keep the prefetch task from using the fonts while the returned lock is held.
+    [[nodiscard]] inline auto lockFonts() -> std::unique_lock<std::mutex> {
+      return std::unique_lock<std::mutex>(buildMutex);
+    }
+
+    #if EPUB_LINUX_BUILD
+      auto recordTurn(bool hit, uint64_t micros, uint32_t allocations) -> void;
+      [[nodiscard]] auto getStats() -> Stats;
+    #endif
+
+  private:
+    struct Slot {
+      Target target;
+      PagePtr page{ nullptr };
+      uint32_t mark{ 0 }; ///< Font use mark taken before building the page
+    };
+
+    /// A page handed over by take(), until given back by recycle().
+    struct Lent {
+      const Page *page;
+      uint32_t mark;
+    };
+
+    HimemString filename;
+    EPubPtr epub{ nullptr };
+
+    std::mutex mutex; ///< Guards the slots and the state below
+    std::condition_variable cv;
+    Slot slots[TARGET_COUNT];
+    PagePtr sparePage{ nullptr }; ///< Reused by the task instead of allocating a page
+    HimemVector<Lent> lent;
+    PageId building{ -1, -1 }; ///< Page being built by the task
+    bool stopRequested{ false };
+    bool failed{ false }; ///< The task could not open the book
+
+    std::mutex buildMutex; ///< Held by the task while building a page
+    std::size_t glyphCacheBudget{ 0 };
+
+    #if EPUB_LINUX_BUILD
+      Stats stats;
+    #endif
+
+    #if EPUB_INKPLATE_BUILD
+      TaskHandle_t prefetchTaskHandle{ nullptr };
+      std::atomic<bool> taskRunning{ false };
+    #else
+      std::thread prefetchThread;
+    #endif
+
+    auto task() -> void;
+    auto nextTarget(Target &target) -> bool;
+    auto inUseMark() const -> uint32_t;
+};
@@ -484,6 +484,9 @@
                  book->coverDim.height, pixels);
         if (pixels == 0) {
           ESP_LOGW(TAG, "S3: book[%d] has zero-size cover", i);
+        } else if (!booksDir.getCover(*book)) {
+          ESP_LOGE(TAG, "S3: getCover(%d) returned nullptr", i);
+          ++errors;
         }
       }
       updateHeap();
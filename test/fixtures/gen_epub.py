@@ -237,6 +237,138 @@ COVER_JPG = bytes([
     0x00,0xfb,0x00,0x1e,0xff,0xd9,
 ])
 
+# ---------------------------------------------------------------------------
+# A single long chapter (for the layout checkpoints tests): nested parts and
+# sections with sibling-dependent CSS rules, so that resuming the layout in
+# the middle of the chapter exercises the DOM context rebuild.
+# ---------------------------------------------------------------------------
+LONG_CONTENT_OPF = """\
+<?xml version="1.0" encoding="UTF-8"?>
+<package xmlns="http://www.idpf.org/2007/opf" version="2.0"
+         unique-identifier="uid">
+  <metadata xmlns:dc="http://purl.org/dc/elements/1.1/"
+            xmlns:opf="http://www.idpf.org/2007/opf">
+    <dc:title>Long Chapter Book</dc:title>
+    <dc:creator opf:role="aut">EPub-InkPlate Test Fixture</dc:creator>
+    <dc:identifier id="uid">urn:uuid:5b1f3c2e-7a44-4d0c-9e61-2f8a9c3d4e10</dc:identifier>
+  </metadata>
+  <manifest>
+    <item id="long"  href="long.xhtml" media-type="application/xhtml+xml"/>
+    <item id="style" href="style.css"  media-type="text/css"/>
+  </manifest>
+  <spine>
+    <itemref idref="long"/>
+  </spine>
+</package>
+"""
+
+LONG_STYLE_CSS = """\
+body { font-family: serif; font-size: 1em; }
+h2   { font-size: 1.2em; font-weight: bold; }
+p    { margin: 0.3em 0; }
+p + p { text-indent: 1.5em; }
+h2 + p { font-style: italic; }
+div.section > p:first-child { font-weight: bold; }
+.note { font-size: 0.8em; margin-left: 2em; }
+#epilogue p { font-style: italic; }
+"""
+
+LONG_WORDS = (
+    "the quick brown fox jumps over lazy dogs while seven wizards quietly "
+    "judge boxing matches under a pale autumn moon near the old harbour"
+).split()
+
+def long_chapter_xhtml(parts=40, sections=4, paragraphs=6, words=70):
+    out = ['<?xml version="1.0" encoding="UTF-8"?>',
+           '<html xmlns="http://www.w3.org/1999/xhtml">',
+           '  <head>',
+           '    <title>Long Chapter</title>',
+           '    <link rel="stylesheet" type="text/css" href="style.css"/>',
+           '  </head>',
+           '  <body>']
+    n = 0
+    for part in range(parts):
+        out.append(f'    <div class="part" id="part{part}">')
+        out.append(f'      <h2>Part {part + 1}</h2>')
+        for section in range(sections):
+            out.append('      <div class="section">')
+            for para in range(paragraphs):
+                text = []
+                for w in range(words):
+                    text.append(LONG_WORDS[(n * 7 + w) % len(LONG_WORDS)])
+                n += 1
+                body = " ".join(text)
+                if para == 2:
+                    body = body.replace("fox", "<em>fox</em>", 1)
+                    body = body.replace("moon", "<b>moon</b>", 1)
+                cls = ' class="note"' if (para == paragraphs - 1) else ""
+                out.append(f'        <p{cls}>{body}.</p>')
+            out.append('      </div>')
+        out.append('    </div>')
+    out.append('    <div id="epilogue"><p>The end of the long chapter.</p></div>')
+    out.append('  </body>')
+    out.append('</html>')
+    return "\n".join(out) + "\n"
+
+# ---------------------------------------------------------------------------
+# A chapter whose sections each use their own letters (for the page prefetcher
+# glyph budget test): the glyphs of a few pages are a small part of those of
+# the book.
+# ---------------------------------------------------------------------------
+LETTERS_CONTENT_OPF = """\
+<?xml version="1.0" encoding="UTF-8"?>
+<package xmlns="http://www.idpf.org/2007/opf" version="2.0"
+         unique-identifier="uid">
+  <metadata xmlns:dc="http://purl.org/dc/elements/1.1/"
+            xmlns:opf="http://www.idpf.org/2007/opf">
+    <dc:title>Letters Chapter Book</dc:title>
+    <dc:creator opf:role="aut">EPub-InkPlate Test Fixture</dc:creator>
+    <dc:identifier id="uid">urn:uuid:8d2e4f6a-1b3c-4e5d-a7f9-0c2b4d6e8f13</dc:identifier>
+  </metadata>
+  <manifest>
+    <item id="letters" href="letters.xhtml" media-type="application/xhtml+xml"/>
+    <item id="style"   href="style.css"     media-type="text/css"/>
+  </manifest>
+  <spine>
+    <itemref idref="letters"/>
+  </spine>
+</package>
+"""
+
+LETTERS_STYLE_CSS = """\
+body { font-family: serif; font-size: 1em; }
+p    { margin: 0.3em 0; }
+"""
+
+# Latin, Latin-1, Latin Extended-A, Greek and Cyrillic small letters.
+LETTERS = [chr(c) for c in [*range(0x61, 0x7B), *range(0xDF, 0xF7), *range(0xF8, 0x100),
+                            *range(0x101, 0x180, 2), *range(0x3B1, 0x3CA),
+                            *range(0x430, 0x460)]]
+
+def letters_chapter_xhtml(letters=16, paragraphs=10, words=60):
+    out = ['<?xml version="1.0" encoding="UTF-8"?>',
+           '<html xmlns="http://www.w3.org/1999/xhtml">',
+           '  <head>',
+           '    <title>Letters Chapter</title>',
+           '    <link rel="stylesheet" type="text/css" href="style.css"/>',
+           '  </head>',
+           '  <body>']
+    n = 0
+    for start in range(0, len(LETTERS), letters):
+        alphabet = LETTERS[start:start + letters]
+        out.append(f'    <div class="section" id="letters{start}">')
+        for para in range(paragraphs):
+            text = []
+            for w in range(words):
+                text.append("".join(alphabet[(n * 5 + w * 3 + k * 7) % len(alphabet)]
+                                    for k in range(2 + (n + w) % 5)))
+            n += 1
+            out.append(f'      <p>{" ".join(text)}.</p>')
+        out.append('    </div>')
+    out.append('  </body>')
+    out.append('</html>')
+    return "\n".join(out) + "\n"
+
 # ---------------------------------------------------------------------------
 # OPF without any Dublin Core metadata (for testNoMetadata)
 # ---------------------------------------------------------------------------
@@ -304,6 +436,22 @@ write_epub("table.epub", {
     "OEBPS/cover.jpg":         COVER_JPG,
 })
 
+write_epub("long_chapter.epub", {
+    "mimetype":                MIMETYPE,
+    "META-INF/container.xml":  CONTAINER_XML,
+    "OEBPS/content.opf":       LONG_CONTENT_OPF,
+    "OEBPS/long.xhtml":        long_chapter_xhtml(),
+    "OEBPS/style.css":         LONG_STYLE_CSS,
+})
+
+write_epub("letters_chapter.epub", {
+    "mimetype":                MIMETYPE,
+    "META-INF/container.xml":  CONTAINER_XML,
+    "OEBPS/content.opf":       LETTERS_CONTENT_OPF,
+    "OEBPS/letters.xhtml":     letters_chapter_xhtml(),
+    "OEBPS/style.css":         LETTERS_STYLE_CSS,
+})
+
 write_epub("bad_mimetype.epub", {
     "mimetype":                "text/plain",   # deliberately wrong
     "META-INF/container.xml":  CONTAINER_XML,
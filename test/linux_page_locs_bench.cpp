@@ -0,0 +1,187 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// test/linux_page_locs_bench.cpp — Headless Linux timing of the pages location
+//                                  computation with 1, 2 and N retriever workers.
+//
+// Build:  make page_locs_bench
+// Run:    build_bench/epub_page_locs_bench [/path/to/book.epub ...]
+//
+// For every book and worker count, the computation is started as when a book
+// is opened and timed up to the .locs file being saved. The .locs and .toc
+// files produced must be identical to the single worker ones. One more run
+// asks for the last item of the book as soon as the computation is started,
+// as when the user jumps to the end of the book, and reports the time to get
+// its pages.
+// ---------------------------------------------------------------------------
+
+// Must be compiled with EPUB_LINUX_BUILD=1 (Makefile sets this).
+
+#define __GLOBAL__ 1 // emit global singleton definitions from headers
+#include "global.hpp"
+
+#include "config.hpp"
+#include "fonts.hpp"
+#include "models/epub.hpp"
+#include "models/page_locs.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int RUNS                      = 3;
+static constexpr int64_t COMPLETION_TIMEOUT_MS = 600'000;
+
+using Clock = std::chrono::steady_clock;
+
+static auto elapsedMs(Clock::time_point start) -> double {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static auto readFile(const std::string &filename) -> std::string {
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static auto sibling(const std::string &epubPath, const char *ext) -> std::string {
+  return epubPath.substr(0, epubPath.find_last_of('.')) + ext;
+}
+
+struct RunResult {
+  bool ok{false};
+  double totalMs{0};
+  double asapMs{-1};
+  std::string locs;
+  std::string toc;
+};
+
+/**
+ * Compute the pages location of the book from scratch with the given number
+ * of workers. When asap is true, the last item is asked for right away.
+ */
+static auto run(EPubPtr &epub, const std::string &epubPath, uint8_t workers, bool asap)
+-> RunResult {
+  RunResult result;
+
+  PageLocsControl::setWorkerCount(workers);
+  std::remove(sibling(epubPath, ".locs").c_str());
+
+  auto start = Clock::now();
+  pageLocs.checkForFormatChanges(epub, 0, true);
+
+  if (asap) {
+    PageId lastItem(epub->getItemCount() - 1, 0);
+    if (pageLocs.getPageInfo(lastItem) != nullptr) { result.asapMs = elapsedMs(start); }
+  }
+
+  while (!pageLocs.isComputationCompleted()) {
+    if (elapsedMs(start) > COMPLETION_TIMEOUT_MS) {
+      std::fprintf(stderr, "[bench] TIMEOUT\n");
+      pageLocs.stopControlTask();
+      return result;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // The .locs file is saved once the control task and its workers are stopped.
+  pageLocs.stopControlTask();
+  result.totalMs = elapsedMs(start);
+
+  result.locs = readFile(sibling(epubPath, ".locs"));
+  result.toc  = readFile(sibling(epubPath, ".toc"));
+  result.ok   = !result.locs.empty() && !result.toc.empty();
+  return result;
+}
+
+static auto benchBook(const std::string &epubPath, const std::vector<uint8_t> &counts) -> bool {
+  auto epub = EPub::Make();
+  if (!epub || !epub->open(HimemString(epubPath.c_str()))) {
+    std::fprintf(stderr, "[bench] Unable to open %s\n", epubPath.c_str());
+    return false;
+  }
+
+  std::printf("%s (%" PRIi16 " items)\n", epubPath.c_str(), epub->getItemCount());
+
+  bool        ok = true;
+  std::string refLocs, refToc;
+  double      refMs = 0;
+
+  for (uint8_t count : counts) {
+    std::vector<double> times;
+    for (int i = 0; i < RUNS; i++) {
+      RunResult r = run(epub, epubPath, count, false);
+      if (!r.ok) {
+        std::printf("  %u worker(s): FAILED\n", (unsigned)count);
+        ok = false;
+        break;
+      }
+      if (refLocs.empty()) {
+        refLocs = r.locs;
+        refToc  = r.toc;
+      } else if ((r.locs != refLocs) || (r.toc != refToc)) {
+        std::printf("  %u worker(s): .locs or .toc differs from the single worker one\n",
+                    (unsigned)count);
+        ok = false;
+      }
+      times.push_back(r.totalMs);
+    }
+    if (times.empty()) { continue; }
+
+    std::sort(times.begin(), times.end());
+    double best = times.front();
+    if (count == counts.front()) { refMs = best; }
+
+    RunResult r = run(epub, epubPath, count, true);
+    if (!r.ok || (r.locs != refLocs) || (r.toc != refToc)) {
+      std::printf("  %u worker(s): ASAP run result differs from the single worker one\n",
+                  (unsigned)count);
+      ok = false;
+    }
+
+    std::printf("  %u worker(s): %8.1f ms to .locs (best of %d, median %.1f), x%.2f, "
+                "last item ASAP in %.1f ms\n",
+                (unsigned)count, best, RUNS, times[times.size() / 2], refMs / best, r.asapMs);
+  }
+
+  pageLocs.clear();
+  epub->closeFile();
+  return ok;
+}
+
+auto main(int argc, char **argv) -> int {
+  std::vector<std::string> books;
+  for (int i = 1; i < argc; i++) { books.emplace_back(argv[i]); }
+  if (books.empty()) {
+    books.emplace_back(BOOKS_FOLDER "/Austen, Jane - Orgueil et prejuges.epub");
+    books.emplace_back(BOOKS_FOLDER "/Austen, Jane - Pride and Prejudice.epub");
+  }
+
+  if (!config.read()) {
+    std::fprintf(stderr, "[bench] WARNING: config.read() failed — fonts may not load\n");
+  }
+  if (!appFonts.setup()) {
+    std::fprintf(stderr, "[bench] FATAL: appFonts.setup() failed\n");
+    return 1;
+  }
+
+  uint8_t n = std::clamp<uint32_t>(std::thread::hardware_concurrency(), 1,
+                                   PageLocsControl::MAX_WORKERS);
+  std::vector<uint8_t> counts{ 1, 2 };
+  if (n > 2) { counts.push_back(n); }
+
+  std::printf("Hardware threads: %u\n", std::thread::hardware_concurrency());
+
+  bool ok = true;
+  for (auto &book : books) { ok = benchBook(book, counts) && ok; }
+
+  appFonts.clearEverything();
+  return ok ? 0 : 1;
+}
@@ -28,6 +28,7 @@
 #include "fonts.hpp"
 #include "models/epub.hpp"
 #include "models/page_locs.hpp"
+#include "models/page_locs_control.hpp"
 
 #include <atomic>
 #include <chrono>
@@ -45,6 +46,7 @@ static constexpr int64_t COMPLETION_TIMEOUT_MS      = 600'000; ///< 10 min hard
 static constexpr int64_t NAV_SLEEP_MS               = 50;      ///< nav thread yield interval
 static constexpr int64_t PREFLIGHT_START_TIMEOUT_MS = 30'000;
 static constexpr int64_t PREFLIGHT_STOP_TIMEOUT_MS  = 15'000;
+static constexpr int ASAP_THREAD_COUNT              = 2;
 
 // ---------------------------------------------------------------------------
 // Nav thread
@@ -169,6 +171,85 @@ static auto runStopUnderPageNbrPollingPreflight(EPubPtr &epub) -> bool {
   return true;
 }
 
+// ---------------------------------------------------------------------------
+// Preflight: ASAP requests while several retriever workers run
+//
+// Threads request items from the end of the book backward, through
+// retrieveAsap(), while all the workers compute and commit other items. Only
+// the worker of the requested item may merge while a request waits: every
+// request must get its item, none may time out, and once the computation is
+// done, walking the whole book must go through every page (no merge deferred
+// during a request may be lost). Build with -fsanitize=thread to check the
+// merges against the reads of the waiters.
+// ---------------------------------------------------------------------------
+static auto runAsapWithWorkersPreflight(EPubPtr &epub) -> bool {
+  std::fprintf(stderr, "[S5 Valgrind] preflight: retrieveAsap with %d workers\n",
+               (int)PageLocsControl::MAX_WORKERS);
+
+  PageLocsControl::setWorkerCount(PageLocsControl::MAX_WORKERS);
+  uint64_t timeoutsBefore = pageLocs.telemetry.asapReplyTimeouts.load();
+  uint64_t deferredBefore = pageLocs.telemetry.deferredMerges.load();
+
+  pageLocs.checkForFormatChanges(epub, 0, true);
+
+  int16_t itemCount = epub->getItemCount();
+  std::atomic<int16_t> nextItem{static_cast<int16_t>(itemCount - 1)};
+  std::atomic<int> missed{0};
+  std::atomic<int> requested{0};
+
+  std::thread askers[ASAP_THREAD_COUNT];
+  for (auto &asker : askers) {
+    asker = std::thread([&]() {
+      int16_t item;
+      while ((item = nextItem.fetch_sub(3)) > 0) {
+        if (pageLocs.getPageId(PageId{item, 0}) == nullptr) {
+          std::fprintf(stderr, "[S5 Valgrind] preflight: item %" PRIi16 " not retrieved\n", item);
+          missed.fetch_add(1);
+        }
+        requested.fetch_add(1);
+      }
+    });
+  }
+  for (auto &asker : askers) asker.join();
+
+  int64_t waitedMs = 0;
+  while (!pageLocs.isComputationCompleted() && (waitedMs < COMPLETION_TIMEOUT_MS)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    waitedMs += 100;
+  }
+
+  bool completed    = pageLocs.isComputationCompleted();
+  int16_t pageCount = pageLocs.getPageCountOrPercent();
+  int walked        = 0;
+  const PageId *first;
+  if (completed && ((first = pageLocs.getPageId(PageId{0, 0})) != nullptr)) {
+    PageId cur          = *first;
+    PageId start        = cur;
+    do {
+      walked++;
+      const PageId *next = pageLocs.getNextPageId(cur, 1);
+      if (next == nullptr) break;
+      cur = *next;
+    } while (!((cur.itemrefIndex == start.itemrefIndex) && (cur.offset == start.offset)) &&
+             (walked <= pageCount));
+  }
+
+  uint64_t timeouts = pageLocs.telemetry.asapReplyTimeouts.load() - timeoutsBefore;
+  std::fprintf(stderr,
+               "[S5 Valgrind] preflight: %d requests, %d missed, %" PRIu64 " timeouts, %" PRIu64
+               " deferred merges, %d/%" PRIi16 " pages walked\n",
+               requested.load(), missed.load(), timeouts,
+               pageLocs.telemetry.deferredMerges.load() - deferredBefore, walked, pageCount);
+
+  pageLocs.stopControlTask();
+  pageLocs.clear();
+  PageLocsControl::setWorkerCount(0);
+
+  bool ok = completed && (missed.load() == 0) && (timeouts == 0) && (walked == pageCount);
+  std::fprintf(stderr, "[S5 Valgrind] preflight: %s\n", ok ? "OK" : "FAILED");
+  return ok;
+}
+
 // ---------------------------------------------------------------------------
 // main
 // ---------------------------------------------------------------------------
@@ -210,6 +291,11 @@ auto main(int argc, char **argv) -> int {
     return 1;
   }
 
+  if (!runAsapWithWorkersPreflight(epub)) {
+    std::fprintf(stderr, "[S5 Valgrind] FATAL: ASAP preflight regression failed\n");
+    return 1;
+  }
+
   // ------------------------------------------------------------------
   // Save initial format params; prepare a modified copy for restart
   // ------------------------------------------------------------------
@@ -14,8 +14,12 @@
 
 #include <cerrno>
 #include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <cstdio>
 #include <cstring>
+#include <format>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -39,7 +43,8 @@ void log(const char level, const char *tag, const char *fmt, ...) {
   va_end(args);
 }
 
-static constexpr const int8_t LOCS_FILE_VERSION = 3;
+static constexpr const int8_t LOCS_FILE_VERSION = 5;
+static constexpr const int8_t LOCS_V4_VERSION   = 4;
 
 static constexpr const char * TAG = "PageLocsChecker";
 
@@ -86,6 +91,22 @@ struct BookFormatParams {
   int8_t lineHeight;
   int8_t useFontsInBook;
   int8_t font;
+  int8_t columnCount;
+  uint16_t screenWidth;
+  uint16_t screenHeight;
+};
+
+struct LocsHeader {
+  int8_t version;
+  BookFormatParams formatParams;
+  uint32_t recordCount;
+  uint32_t crc;
+};
+
+struct LocsRecord {
+  int16_t itemrefIndex;
+  int32_t offset;
+  int32_t size;
 };
 #pragma pack(pop)
 
@@ -93,58 +114,111 @@ BookFormatParams currentFormatParams;
 
 int16_t          pageCount{ 0 };
 
-bool readLocsFile(std::string filename) {
-  std::ifstream file(filename, std::ios::in | std::ios::binary);
-
-  LOG_D("Loading pages location from file {}.", filename);
+// Standard CRC-32 (same values as miniz mz_crc32() used by PageLocs).
+uint32_t crc32(uint32_t crc, const uint8_t *buf, size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
 
-  int8_t  version;
+bool readLocsV4(std::ifstream &file) {
   int16_t pgCount;
 
-  if (!file.is_open()) {
-    LOG_I("Unable to open pages location file '{}': errno={} ({}). Calculating locations...",
-          filename.c_str(), errno, std::strerror(errno));
+  if (file.read(reinterpret_cast<char *>(&currentFormatParams), sizeof(currentFormatParams))
+      .fail()) {
     return false;
   }
+  if (file.read(reinterpret_cast<char *>(&pgCount), sizeof(pgCount)).fail()) { return false; }
 
-  bool ok = false;
+  pagesMap.clear();
+
+  int16_t pageNbr = 0;
 
-  while (true) {
-    if (file.read(reinterpret_cast<char *>(&version), 1).fail()) { break; }
-    if (version != LOCS_FILE_VERSION) { break; }
+  for (int16_t i = 0; i < pgCount; ++i) {
+    PageId   pageId;
+    PageInfo pageInfo;
 
-    if (file.read(reinterpret_cast<char *>(&currentFormatParams), sizeof(currentFormatParams))
+    if (file.read(reinterpret_cast<char *>(&pageId.itemrefIndex), sizeof(pageId.itemrefIndex))
         .fail()) {
       break;
     }
-    if (file.read(reinterpret_cast<char *>(&pgCount), sizeof(pgCount)).fail()) { break; }
+    if (file.read(reinterpret_cast<char *>(&pageId.offset), sizeof(pageId.offset)).fail()) { break; }
+    if (file.read(reinterpret_cast<char *>(&pageInfo.size), sizeof(pageInfo.size)).fail()) { break; }
+    pageInfo.pageNumber = (pageInfo.size >= 0) ? pageNbr++ : -1;
 
-    pagesMap.clear();
+    pagesMap.insert(std::pair(pageId, pageInfo));
+  }
 
-    int16_t pageNbr = 0;
+  pageCount = pageNbr;
+  return !file.fail();
+}
 
-    for (int16_t i = 0; i < pgCount; ++i) {
-      PageId   pageId;
-      PageInfo pageInfo;
+bool readLocsV5(std::ifstream &file) {
+  LocsHeader header;
+  header.version = LOCS_FILE_VERSION;
 
-      if (file.read(reinterpret_cast<char *>(&pageId.itemrefIndex), sizeof(pageId.itemrefIndex))
-          .fail()) {
-        break;
-      }
-      if (file.read(reinterpret_cast<char *>(&pageId.offset), sizeof(pageId.offset)).fail()) { break; }
-      if (file.read(reinterpret_cast<char *>(&pageInfo.size), sizeof(pageInfo.size)).fail()) { break; }
-      pageInfo.pageNumber = (pageInfo.size >= 0) ? pageNbr++ : -1;
+  if (file.read(reinterpret_cast<char *>(&header) + 1, sizeof(header) - 1).fail()) { return false; }
+
+  std::vector<LocsRecord> records(header.recordCount);
+  if (file.read(reinterpret_cast<char *>(records.data()),
+                header.recordCount * sizeof(LocsRecord)).fail()) {
+    return false;
+  }
 
-      //   if (pageNbr == 50) {
-      //     pageInfo.size -= 1;
-      //   }
+  uint32_t crc = crc32(0, reinterpret_cast<const uint8_t *>(&header), offsetof(LocsHeader, crc));
+  crc = crc32(crc, reinterpret_cast<const uint8_t *>(records.data()),
+              header.recordCount * sizeof(LocsRecord));
+  if (crc != header.crc) {
+    LOG_E("CRC mismatch: computed {:08x}, stored {:08x}", crc, header.crc);
+    return false;
+  }
 
-      pagesMap.insert(std::pair(pageId, pageInfo));
+  currentFormatParams = header.formatParams;
+  pagesMap.clear();
+
+  int16_t pageNbr = 0;
+  for (size_t i = 0; i < records.size(); ++i) {
+    const LocsRecord &rec = records[i];
+    if ((i > 0) && !PageCompare()(PageId(records[i - 1].itemrefIndex, records[i - 1].offset),
+                                  PageId(rec.itemrefIndex, rec.offset))) {
+      LOG_E("Records not sorted at index {} (ItemrefIndex: {}, Offset: {})", i, rec.itemrefIndex,
+            rec.offset);
+      return false;
     }
+    pagesMap.insert(std::pair(PageId(rec.itemrefIndex, rec.offset),
+                              PageInfo(rec.size, (rec.size >= 0) ? pageNbr++ : -1)));
+  }
+
+  pageCount = pageNbr;
+  return true;
+}
+
+bool readLocsFile(std::string filename) {
+  std::ifstream file(filename, std::ios::in | std::ios::binary);
+
+  LOG_D("Loading pages location from file {}.", filename);
+
+  int8_t version;
 
-    pageCount = pageNbr;
-    ok        = !file.fail();
-    break;
+  if (!file.is_open()) {
+    LOG_I("Unable to open pages location file '{}': errno={} ({}). Calculating locations...",
+          filename.c_str(), errno, std::strerror(errno));
+    return false;
+  }
+
+  bool ok = false;
+
+  if (!file.read(reinterpret_cast<char *>(&version), 1).fail()) {
+    if (version == LOCS_FILE_VERSION) {
+      ok = readLocsV5(file);
+    } else if (version == LOCS_V4_VERSION) {
+      ok = readLocsV4(file);
+    } else {
+      LOG_E("Unsupported pages location file version: {}", version);
+    }
   }
 
   file.close();
@@ -152,6 +226,8 @@ bool readLocsFile(std::string filename) {
   if (!ok) {
     LOG_E("Page locations load failed for '{}' (fail={} bad={} eof={})", filename,
           file.fail() ? 1 : 0, file.bad() ? 1 : 0, file.eof() ? 1 : 0);
+  } else {
+    LOG_I("Version {} file: {} entries, {} pages.", version, pagesMap.size(), pageCount);
   }
 
   return ok;
@@ -181,7 +257,7 @@ bool checkOffsetsContinuity() {
     const PageInfo &info = entry.second;
 
     if (currentItemrefIndex != id.itemrefIndex) {
-      nextOffset          = id.offset + info.size;
+      nextOffset          = id.offset + std::abs(info.size);
       currentItemrefIndex = id.itemrefIndex;
     } else {
       if (id.offset != nextOffset) {
@@ -189,7 +265,7 @@ bool checkOffsetsContinuity() {
               id.itemrefIndex, id.offset, nextOffset);
         result = false;
       }
-      nextOffset = id.offset + info.size;
+      nextOffset = id.offset + std::abs(info.size);
     }
   }
 
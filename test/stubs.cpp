@@ -13,7 +13,12 @@
 //   • DisplayList::getNewEntry()— avoids pulling in the real msg_viewer.hpp
 //   • TOC::loadFromEpub()       — no-op (pageLocsInstance is false in tests)
 //   • JPegPicture constructor   — no-op (getPicture() never called in tests)
-//   • PngPicture constructor    — no-op (getPicture() never called in tests)
+//   • eventMgr / showLoadIcon() — no events, no icon (html_interpreter.cpp)
+//   • TOC::set()                — no-op (TOC ids are not used by the tests)
+//   • Picture::resize()         — no-op (pictures are not shown in tests)
+//   • Picture::convert_to_4bpp()— no-op (BooksScanner covers are not shown)
+//   • ~PageLocsRetriever()      — no-op (the retriever workers are never set up)
+//   • BookViewer::buildPage()   — page laid out without title (page prefetcher)
 // ---------------------------------------------------------------------------
 
 #include <cstdarg>
@@ -75,17 +80,32 @@ auto MsgViewer::show(MsgType, bool, bool, const char *title, const char *fmtStr,
 #include "models/toc.hpp"
 
 auto TOC::loadFromEpub(EPub &) -> bool { return true; }
+auto TOC::set(int16_t, std::string &, int32_t) -> void {}
 
 // ============================================================================
-// JPegPicture / PngPicture — only instantiated via getPicture() which is
-// never called in the epub structural tests.  Stubs satisfy the linker.
+// JPegPicture — only instantiated via getPicture() which is never called in
+// the epub structural tests.  Stubs satisfy the linker. PngPicture is the real
+// one (test_png_decoder.cpp extracts PNG covers).
 // ============================================================================
 
 #include "jpeg_picture.hpp"
-#include "png_picture.hpp"
 
 JPegPicture::JPegPicture(const HimemString &, Dim, bool, bool) {}
-PngPicture::PngPicture(const HimemString &, Dim, bool) {}
+auto Picture::resize(Dim) -> void {}
+void Picture::convert_to_4bpp() {}
+
+// ============================================================================
+// eventMgr / showLoadIcon — referenced by html_interpreter.cpp when a picture
+// is added to a page in DISPLAY mode.  test/stubs/screen.hpp shadows the GTK
+// screen header pulled in by event_mgr.hpp.
+// ============================================================================
+
+#define __EVENT_MGR__ 1
+#include "controllers/event_mgr.hpp"
+#include "helpers/show_load_icon.hpp"
+
+auto EventMgr::someEventWaiting() -> bool { return false; }
+auto showLoadIcon(const Dim &) -> void {}
 
 // ============================================================================
 // PageLocs — epub.cpp::closeFile() references the global `pageLocs` object
@@ -98,3 +118,59 @@ PngPicture::PngPicture(const HimemString &, Dim, bool) {}
 PageLocs pageLocs; // the global instance referenced by epub.cpp
 
 auto PageLocs::stopControlTask() -> void {}
+
+PageLocsRetriever::~PageLocsRetriever() {}
+
+// ============================================================================
+// BookViewer::buildPage — used by the page prefetch task (page_prefetcher.cpp).
+// book_viewer.cpp needs the screen and the controllers: the page is laid out
+// here from the beginning of its item, without title or checkpoints.
+// ============================================================================
+
+#include "viewers/book_viewer.hpp"
+#include "viewers/html_interpreter.hpp"
+
+namespace {
+
+class StubViewerInterp : public HTMLInterpreter {
+  public:
+    StubViewerInterp(EPubPtr &theEpub, PagePtr &thePage, DOMPtr &theDom)
+      : HTMLInterpreter(theEpub, thePage, theDom, Page::ComputeMode::DISPLAY,
+                        theEpub->getCurrentItemInfo()) {}
+
+  protected:
+    auto pageEndProcessing(const Page::Format &) -> bool override { return true; }
+};
+
+} // namespace
+
+auto BookViewer::buildPage(PagePtr &page, const PageId &pageId, int32_t pageSize, EPubPtr &epub)
+-> bool {
+  if (!epub->getItemAtIndex(pageId.itemrefIndex)) { return false; }
+
+  int16_t idx;
+  if ((idx = epub->getFonts().getFontIndex("Fontbase", FaceStyle::NORMAL)) == -1) { idx = 3; }
+
+  Page::Format fmt = {
+    .lineHeightFactor = epub->getLineHeightFactor(),
+    .fontIndex        = idx,
+    .fontSize         = epub->getBookFormatParams()->fontSize,
+    .screenTop        = 0,
+    .screenBottom     = 30,
+  };
+
+  auto     dom  = DOM::Make(epub->getDomPools());
+  xml_node node = epub->getCurrentItem().child("html").child("body");
+
+  StubViewerInterp interp(epub, page, dom);
+  interp.setLimits(pageId.offset, pageId.offset + pageSize, false);
+
+  page->start(fmt, epub->getBookFormatParams()->columnCount);
+  Page::Format *newFmt = interp.duplicateFmt(fmt);
+  if (interp.buildPagesRecurse(node, *newFmt, dom->body, 1) && page->someDataWaiting()) {
+    page->endParagraph(fmt);
+  }
+  interp.releaseFmt(newFmt);
+
+  return true;
+}
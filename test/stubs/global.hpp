@@ -6,9 +6,10 @@
 // NOTE: intentionally using a traditional header guard instead of #pragma once
 // to avoid a GCC bug where #pragma once can prevent #include_next from finding
 // the next file when both files have #pragma once.
+//
+// MAIN_FOLDER is defined on the command line by the Makefile (TEST_DEFINES) as
+// test/fixtures/config_data under the repository root, so that the fonts used
+// by the layout tests are found wherever the repository is checked out.
 #include_next "global.hpp"
 
-#undef MAIN_FOLDER
-#define MAIN_FOLDER "/home/turgu1/Dev/EPub-InkPlate/test/fixtures/config_data"
-
 #endif // TEST_STUBS_GLOBAL_HPP
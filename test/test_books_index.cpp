@@ -0,0 +1,238 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for BooksIndex
+//
+// Covers:
+//  • The RECENTLY_READ, TITLE and AUTHOR sort orders and their tie breaks
+//  • Books with the same title are all kept
+//  • Sorted index of an id / of a database index in every order
+//  • setPos() moving a book in the RECENTLY_READ order
+//  • Paging time against the former title map walk (BENCH)
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "models/books_index.hpp"
+#include "test_stats.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+using SortOrder = BooksIndex::SortOrder;
+
+// Database indexes of the books in the current sort order, as a string of digits.
+static auto dbOrder(const BooksIndex &index) -> std::string {
+  std::string res;
+  for (uint16_t i = 0; i < index.size(); ++i) { res += char('0' + index.dbIndexAt(i)); }
+  return res;
+}
+
+// Books 1 to 6, in database order. Books 3 and 5 were read recently, 5 last.
+static auto fill(BooksIndex &index) -> void {
+  index.clear();
+  index.add(101, 1, "Persuasion", "Austen, Jane", -1);
+  index.add(102, 2, "Emma", "Austen, Jane", -1);
+  index.add(103, 3, "Dracula", "Stoker, Bram", 1);
+  index.add(104, 4, "Ulysses", "Joyce, James", -1);
+  index.add(105, 5, "Walden", "Thoreau, Henry David", 0);
+  index.add(106, 6, "Emma", "Adams, Anne", -1);
+  index.build();
+}
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testEmpty() {
+  std::printf("  [empty]\n");
+
+  BooksIndex index;
+  uint32_t   id = 0;
+  CHECK(index.size() == 0);
+  CHECK(index.dbIndexAt(0) == BooksIndex::NOT_FOUND);
+  CHECK(!index.idAt(0, id));
+  CHECK(index.sortedIdxOfId(101) == BooksIndex::NOT_FOUND);
+  CHECK(index.sortedIdxOfDbIndex(1) == BooksIndex::NOT_FOUND);
+
+  // Books are part of the orders once built only.
+  index.add(101, 1, "Persuasion", "Austen, Jane", -1);
+  CHECK(index.size() == 0);
+  index.build();
+  CHECK(index.size() == 1);
+  CHECK(index.dbIndexAt(0) == 1);
+}
+
+static void testSortOrders() {
+  std::printf("  [sortOrders]\n");
+
+  BooksIndex index;
+  fill(index);
+  CHECK(index.size() == 6);
+
+  // Recently read ones first, then by title, equal titles in database order.
+  CHECK(index.getSortOrder() == SortOrder::RECENTLY_READ);
+  CHECK(dbOrder(index) == "532614");
+
+  // Equal titles: the author breaks the tie.
+  index.setSortOrder(SortOrder::TITLE);
+  CHECK(dbOrder(index) == "362145");
+
+  // Equal authors: the title breaks the tie.
+  index.setSortOrder(SortOrder::AUTHOR);
+  CHECK(dbOrder(index) == "621435");
+
+  // An unknown order falls back on RECENTLY_READ.
+  index.setSortOrder(static_cast<SortOrder>(7));
+  CHECK(index.getSortOrder() == SortOrder::RECENTLY_READ);
+  CHECK(dbOrder(index) == "532614");
+}
+
+static void testLookups() {
+  std::printf("  [lookups]\n");
+
+  BooksIndex index;
+  fill(index);
+
+  for (uint8_t o = 0; o < BooksIndex::SORT_ORDER_COUNT; ++o) {
+    index.setSortOrder(static_cast<SortOrder>(o));
+    bool consistent = true;
+    for (uint16_t i = 0; i < index.size(); ++i) {
+      uint32_t id = 0;
+      consistent  = consistent && index.idAt(i, id) && (index.sortedIdxOfId(id) == i) &&
+                   (index.sortedIdxOfDbIndex(index.dbIndexAt(i)) == i) &&
+                   (id == 100u + (uint32_t)index.dbIndexAt(i));
+    }
+    CHECK(consistent);
+  }
+
+  CHECK(index.sortedIdxOfId(999) == BooksIndex::NOT_FOUND);
+  CHECK(index.sortedIdxOfDbIndex(9) == BooksIndex::NOT_FOUND);
+  CHECK(index.dbIndexAt(6) == BooksIndex::NOT_FOUND);
+}
+
+static void testSetPos() {
+  std::printf("  [setPos]\n");
+
+  BooksIndex index;
+  fill(index);
+
+  // Ulysses is opened: it becomes the most recent one, the others move down.
+  CHECK(index.setPos(104, 0));
+  CHECK(index.setPos(105, 1));
+  CHECK(index.setPos(103, 2));
+  CHECK(dbOrder(index) == "453261");
+  CHECK(index.sortedIdxOfId(104) == 0);
+  CHECK(index.sortedIdxOfId(106) == 4);
+
+  // Dracula leaves the recently read list: back among the other titles.
+  CHECK(index.setPos(103, -1));
+  CHECK(dbOrder(index) == "453261");
+  CHECK(index.setPos(105, -1));
+  CHECK(dbOrder(index) == "432615");
+
+  // The other orders don't move.
+  index.setSortOrder(SortOrder::TITLE);
+  CHECK(dbOrder(index) == "362145");
+
+  CHECK(!index.setPos(999, 0));
+
+  // A book not sorted yet takes its position at the next build.
+  index.setSortOrder(SortOrder::RECENTLY_READ);
+  index.add(107, 7, "Zadig", "Voltaire", -1);
+  CHECK(index.setPos(107, 1));
+  index.build();
+  CHECK(dbOrder(index) == "4732615");
+}
+
+// ── benchmark ────────────────────────────────────────────────────────────────
+// Every cover of a 1,200 books library, page after page, against the walk of
+// the former title map to reach each sorted index.
+static void testPagingBench() {
+  std::printf("  [pagingBench]\n");
+
+  const int BOOKS = 1200;
+
+  BooksIndex index;
+  index.reserve(BOOKS);
+  std::map<std::string, uint16_t> titles;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < BOOKS; ++i) {
+    std::string title  = "Title " + std::to_string((i * 7919) % BOOKS);
+    std::string author = "Author " + std::to_string(i % 97);
+    index.add(1000 + i, i + 1, title.c_str(), author.c_str(), -1);
+    titles["z" + title] = i + 1;
+  }
+  index.build();
+  double buildMs =
+    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  CHECK(index.size() == BOOKS);
+
+  const int rounds = 20;
+  long      sum = 0, mapSum = 0;
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (uint16_t idx = 0; idx < BOOKS; ++idx) { sum += index.dbIndexAt(idx); }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (uint16_t idx = 0; idx < BOOKS; ++idx) {
+      int i = 0;
+      for (auto &entry : titles) {
+        if (i++ == idx) {
+          mapSum += entry.second;
+          break;
+        }
+      }
+    }
+  }
+  double mapSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(sum == mapSum);
+
+  double cells = double(rounds) * BOOKS;
+  std::printf("    BENCH books=%d build=%.2f ms (3 orders) cells=%.0f index=%.0f cells/s "
+              "map walk=%.0f cells/s (x%.0f)\n",
+              BOOKS, buildMs, cells, secs > 0 ? cells / secs : 0.0,
+              mapSecs > 0 ? cells / mapSecs : 0.0, secs > 0 ? mapSecs / secs : 0.0);
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testBooksIndex() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testEmpty();
+  testSortOrders();
+  testLookups();
+  testSetPos();
+  testPagingBench();
+
+  std::printf("  BooksIndex: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
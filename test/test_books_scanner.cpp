@@ -0,0 +1,207 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for BooksScanner
+//
+// Covers:
+//  • Meta-data and cover of a book, books that cannot be opened
+//  • Books delivered in the order of the file names by the worker
+//  • stop() while the worker is ahead of the caller
+//  • Books/minute of the scan inline and with the worker (BENCH)
+//
+// The fixtures are copied in a temporary folder: opening a book creates its
+// .pars file next to it.
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "models/books_scanner.hpp"
+#include "test_stats.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+static const char *const SCAN_FOLDER = "/tmp/epub_test_scan";
+static const char *const FIXTURES[]  = { "minimal.epub", "bad_mimetype.epub", "table.epub",
+                                         "no_metadata.epub" };
+
+static const Dim COVER_DIM{ 70, 90 };
+
+static auto setupFolder() -> bool {
+  std::error_code ec;
+  std::filesystem::remove_all(SCAN_FOLDER, ec);
+  if (!std::filesystem::create_directory(SCAN_FOLDER, ec)) { return false; }
+  for (auto name : FIXTURES) {
+    std::filesystem::copy_file(std::string("test/fixtures/") + name,
+                               std::string(SCAN_FOLDER) + "/" + name, ec);
+    if (ec) { return false; }
+  }
+  return true;
+}
+
+static auto fixtureNames(int rounds) -> HimemVector<HimemString> {
+  HimemVector<HimemString> names;
+  for (int r = 0; r < rounds; ++r) {
+    for (auto name : FIXTURES) { names.push_back(name); }
+  }
+  return names;
+}
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testScan() {
+  std::printf("  [scan]\n");
+
+  auto book = BooksScanner::scan(SCAN_FOLDER, "minimal.epub", COVER_DIM);
+  CHECK(book != nullptr);
+  if (!book) { return; }
+
+  const BooksDir::EBookRecord &record = book->entry.book;
+  CHECK(book->ok);
+  CHECK(std::strcmp(record.filename, "minimal.epub") == 0);
+  CHECK(std::strcmp(record.title, "Test Book Title") == 0);
+  CHECK(std::strcmp(record.author, "Test Author") == 0);
+  CHECK(std::strcmp(book->entry.description, "A minimal test epub for unit tests.") == 0);
+  CHECK(record.fileSize == (int32_t)std::filesystem::file_size("test/fixtures/minimal.epub"));
+
+  // No cover in the book: the default one, within the cover size.
+  CHECK(book->cover != nullptr);
+  CHECK((record.coverDim.width > 0) && (record.coverDim.width <= COVER_DIM.width));
+  CHECK((record.coverDim.height > 0) && (record.coverDim.height <= COVER_DIM.height));
+
+  book = BooksScanner::scan(SCAN_FOLDER, "bad_mimetype.epub", COVER_DIM);
+  CHECK((book != nullptr) && !book->ok);
+
+  book = BooksScanner::scan(SCAN_FOLDER, "missing.epub", COVER_DIM);
+  CHECK((book != nullptr) && !book->ok);
+}
+
+static void testOrder() {
+  std::printf("  [order]\n");
+
+  BooksScanner scanner;
+  CHECK(scanner.next() == nullptr); // Not started
+
+  CHECK(scanner.start(SCAN_FOLDER, fixtureNames(2), COVER_DIM));
+
+  int  count   = 0;
+  bool inOrder = true;
+  while (auto book = scanner.next()) {
+    const char *expected = FIXTURES[count % 4];
+    bool        ok       = (count % 4) != 1; // bad_mimetype.epub
+    inOrder = inOrder && (book->ok == ok) &&
+              (!ok || (std::strcmp(book->entry.book.filename, expected) == 0));
+    ++count;
+  }
+  CHECK(count == 8);
+  CHECK(inOrder);
+  CHECK(!scanner.failed());
+  CHECK(scanner.next() == nullptr);
+}
+
+static void testStop() {
+  std::printf("  [stop]\n");
+
+  BooksScanner scanner;
+  CHECK(scanner.start(SCAN_FOLDER, fixtureNames(10), COVER_DIM));
+  CHECK(scanner.next() != nullptr);
+
+  // The worker fills its queue and waits: stop() must end it.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  scanner.stop();
+  CHECK(scanner.next() == nullptr);
+
+  // A scanner can be started again.
+  CHECK(scanner.start(SCAN_FOLDER, fixtureNames(1), COVER_DIM));
+  int count = 0;
+  while (scanner.next()) { ++count; }
+  CHECK(count == 4);
+}
+
+// ── benchmark ────────────────────────────────────────────────────────────────
+// Books scanned inline, one after the other, against the worker, with the
+// same time spent by the caller on each book to write it and update the
+// progress page.
+static void testScanBench() {
+  std::printf("  [scanBench]\n");
+
+  const int  rounds   = 10;
+  const auto commitMs = std::chrono::milliseconds(2);
+  const int  books    = rounds * 4;
+
+  auto names = fixtureNames(rounds);
+
+  auto start = std::chrono::steady_clock::now();
+  int  okInline = 0;
+  for (auto &name : names) {
+    auto book = BooksScanner::scan(SCAN_FOLDER, name, COVER_DIM);
+    if (book && book->ok) { ++okInline; }
+    std::this_thread::sleep_for(commitMs);
+  }
+  double inlineSecs =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  BooksScanner scanner;
+  int          okWorker = 0;
+  scanner.start(SCAN_FOLDER, std::move(names), COVER_DIM);
+  while (auto book = scanner.next()) {
+    if (book->ok) { ++okWorker; }
+    std::this_thread::sleep_for(commitMs);
+  }
+  double workerSecs =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(okInline == rounds * 3);
+  CHECK(okWorker == okInline);
+
+  std::printf("    BENCH books=%d commit=%d ms/book inline=%.0f books/minute "
+              "worker=%.0f books/minute (x%.2f)\n",
+              books, (int)commitMs.count(), inlineSecs > 0 ? books * 60.0 / inlineSecs : 0.0,
+              workerSecs > 0 ? books * 60.0 / workerSecs : 0.0,
+              workerSecs > 0 ? inlineSecs / workerSecs : 0.0);
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testBooksScanner() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  CHECK(setupFolder());
+  if (failures == 0) {
+    testScan();
+    testOrder();
+    testStop();
+    testScanBench();
+  }
+
+  std::error_code ec;
+  std::filesystem::remove_all(SCAN_FOLDER, ec);
+
+  std::printf("  BooksScanner: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
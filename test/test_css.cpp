@@ -14,8 +14,13 @@
 //     crash the parser
 //   * !important is consumed without error
 //   * all supported CSS length units decode to the correct ValueType
+//   * CSS::match() on a generated 1,000-rule stylesheet: matched rules and
+//     their order, plus a matches/s benchmark
+//   * CSSStore: stylesheets rebuilt from their binary form are identical to
+//     the parsed ones, plus a parse vs rebuild benchmark
 // ---------------------------------------------------------------------------
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
@@ -27,6 +32,7 @@
 // CSS and its dependencies
 #include "models/css.hpp"
 #include "models/css_parser.hpp"
+#include "models/css_store.hpp"
 #include "models/dom.hpp"
 
 // ---------------------------------------------------------------------------
@@ -61,6 +67,11 @@ static auto loadFixture(const char *path) -> CSSPtr {
   return css;
 }
 
+// True when a class or id atom of the default CSS pools stands for `name`.
+static auto isName(Atoms::Atom atom, const char *name) -> bool {
+  return std::strcmp(CSS::defaultPools().atoms.name(atom), name) == 0;
+}
+
 // Return the first value of the given property from rulesMap, or nullptr.
 static auto firstValue(const CSS::RulesMap &rules, CSS::PropertyId pid) -> const CSS::Value * {
   const CSS::Values *vals = CSS::getValuesFromRules(rules, pid);
@@ -89,8 +100,8 @@ static auto countRulesForClass(const CSS::RulesMap &rules, const std::string &cl
   int count = 0;
   for (const auto &[sel, props] : rules) {
     for (const auto &node : sel->selectorNodeList) {
-      for (const auto &c : node.classList) {
-        if (c == cls.c_str()) {
+      for (auto c : node.classList) {
+        if (isName(c, cls.c_str())) {
           ++count;
           goto next_rule;
         }
@@ -106,7 +117,7 @@ static auto countRulesForId(const CSS::RulesMap &rules, const std::string &id) -
   int count = 0;
   for (const auto &[sel, props] : rules) {
     for (const auto &node : sel->selectorNodeList) {
-      if (node.idCount > 0 && node.id == id.c_str()) {
+      if (node.idCount > 0 && isName(node.id, id.c_str())) {
         ++count;
         break;
       }
@@ -299,8 +310,8 @@ static auto testClassProperties(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it = sel->selectorNodeList.begin();
     if (it->classCount == 1) {
-      for (const auto &c : it->classList) {
-        if (c == "highlight") {
+      for (auto c : it->classList) {
+        if (isName(c, "highlight")) {
           singleHighlight = true;
           break;
         }
@@ -339,7 +350,7 @@ static auto testClassProperties(const CSS::RulesMap &rules) -> void {
   for (const auto &[sel, props] : rules) {
     if (sel->selectorNodeList.empty()) continue;
     auto it = sel->selectorNodeList.begin();
-    if (it->idCount != 1 || it->id != "main" || it->tag != DOM::Tag::NONE) continue;
+    if (it->idCount != 1 || !isName(it->id, "main") || it->tag != DOM::Tag::NONE) continue;
 
     CSS::RulesMap single;
     single.insert({const_cast<CSS::Selector *>(sel), props});
@@ -379,8 +390,8 @@ static auto testEnumValues(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "hidden") {
+    for (auto c : it->classList) {
+      if (isName(c, "hidden")) {
         match = true;
         break;
       }
@@ -402,8 +413,8 @@ static auto testEnumValues(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "no-transform") {
+    for (auto c : it->classList) {
+      if (isName(c, "no-transform")) {
         match = true;
         break;
       }
@@ -426,8 +437,8 @@ static auto testEnumValues(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "lower") {
+    for (auto c : it->classList) {
+      if (isName(c, "lower")) {
         match = true;
         break;
       }
@@ -450,8 +461,8 @@ static auto testEnumValues(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "left-align") {
+    for (auto c : it->classList) {
+      if (isName(c, "left-align")) {
         match = true;
         break;
       }
@@ -511,8 +522,8 @@ static auto testUnits(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "units-test") {
+    for (auto c : it->classList) {
+      if (isName(c, "units-test")) {
         match = true;
         break;
       }
@@ -606,13 +617,13 @@ static auto testSpecificity(const CSS::RulesMap &rules) -> void {
         std::next(it) == sel->selectorNodeList.end())
       specP = sel->specificity.value;
     // #main (no tag)
-    if (it->idCount == 1 && it->id == "main" && it->tag == DOM::Tag::NONE &&
+    if (it->idCount == 1 && isName(it->id, "main") && it->tag == DOM::Tag::NONE &&
         std::next(it) == sel->selectorNodeList.end())
       specId = sel->specificity.value;
     // .highlight (no tag)
     if (it->classCount == 1 && it->idCount == 0 && it->tag == DOM::Tag::NONE) {
-      for (const auto &c : it->classList) {
-        if (c == "highlight" && std::next(it) == sel->selectorNodeList.end())
+      for (auto c : it->classList) {
+        if (isName(c, "highlight") && std::next(it) == sel->selectorNodeList.end())
           specCls = sel->specificity.value;
       }
     }
@@ -709,8 +720,8 @@ static auto testImportant(const CSS::RulesMap &rules) -> void {
     if (sel->selectorNodeList.empty()) continue;
     auto it    = sel->selectorNodeList.begin();
     bool match = false;
-    for (const auto &c : it->classList) {
-      if (c == "important-test") {
+    for (auto c : it->classList) {
+      if (isName(c, "important-test")) {
         match = true;
         break;
       }
@@ -763,6 +774,301 @@ static auto testInlineStyle() -> void {
   }
 }
 
+// ── test 16: match() on a large generated stylesheet ─────────────────────────
+//
+// 1,000 rules: 400 `.cN`, 200 `p.cN`, 200 `#idN`, 100 `div .cN` and 100 tag
+// rules alternating `p` / `span`. Every rule sets margin-left to its source
+// index, so the order of matched rules of equal specificity can be checked.
+static auto buildLargeStylesheet() -> std::string {
+  std::string css;
+  int         n = 0;
+  auto        add = [&](const std::string &sel) {
+    css += sel + " { margin-left: " + std::to_string(n++) + "px; }\n";
+  };
+  for (int i = 0; i < 100; ++i) add((i % 2 == 0) ? "p" : "span");
+  for (int i = 0; i < 400; ++i) add(".c" + std::to_string(i));
+  for (int i = 0; i < 200; ++i) add("p.c" + std::to_string(i));
+  for (int i = 0; i < 200; ++i) add("#id" + std::to_string(i));
+  for (int i = 0; i < 100; ++i) add("div .c" + std::to_string(i));
+  return css;
+}
+
+// True when rules of equal specificity are in stylesheet order.
+static auto inSourceOrder(const CSS::RulesMap &rules) -> bool {
+  uint32_t lastSpec = 0;
+  float    lastIdx  = -1.0f;
+  for (const auto &[sel, props] : rules) {
+    const CSS::Values *vals = nullptr;
+    for (auto &prop : *props) {
+      if (prop.id == CSS::PropertyId::MARGIN_LEFT) { vals = &prop.values; }
+    }
+    if ((vals == nullptr) || vals->empty()) { return false; }
+    float idx = vals->front().num;
+    if ((sel->specificity.value == lastSpec) && (idx <= lastIdx)) { return false; }
+    lastSpec = sel->specificity.value;
+    lastIdx  = idx;
+  }
+  return true;
+}
+
+static auto testLargeStylesheetMatch() -> void {
+  std::printf("  [testLargeStylesheetMatch]\n");
+
+  std::string buf = buildLargeStylesheet();
+  auto css = CSS::Make("large", "", buf.c_str(), static_cast<int32_t>(buf.size()), 0);
+  SUITE_CHECK(css != nullptr, "large CSS::Make returned nullptr");
+  if (!css) return;
+  SUITE_CHECK(css->rulesMap.size() == 1000, "large stylesheet does not hold 1000 rules");
+
+  auto dom = DOM::Make();
+  SUITE_CHECK(dom != nullptr, "DOM::Make returned nullptr");
+  if (!dom) return;
+
+  DOM::Node *div  = dom->addChild(dom->body, DOM::Tag::DIV);
+  DOM::Node *p    = dom->addChild(div, DOM::Tag::P);
+  DOM::Node *span = dom->addChild(p, DOM::Tag::SPAN);
+  DOM::Node *img  = dom->addChild(p, DOM::Tag::IMG);
+  p->addClasses("c5 c17")->addId("id3");
+  span->addClass("c250");
+  img->addClass("unknown");
+
+  {
+    // 2 x .cN, 2 x p.cN, #id3, 2 x div .cN and the 50 `p` rules.
+    CSS::RulesMap rules;
+    css->match(p, rules);
+    SUITE_CHECK(rules.size() == 57, "p node: wrong matched rule count");
+    SUITE_CHECK(inSourceOrder(rules), "p node: equal specificity rules out of order");
+    SUITE_CHECK(!rules.empty() && (rules.rbegin()->first->specificity.spec.idCount == 1),
+                "p node: #id3 is not the most specific rule");
+  }
+  {
+    // .c250 and the 50 `span` rules.
+    CSS::RulesMap rules;
+    css->match(span, rules);
+    SUITE_CHECK(rules.size() == 51, "span node: wrong matched rule count");
+    SUITE_CHECK(inSourceOrder(rules), "span node: equal specificity rules out of order");
+  }
+  {
+    CSS::RulesMap rules;
+    css->match(img, rules);
+    SUITE_CHECK(rules.empty(), "img node: unexpected matched rules");
+  }
+
+  // Matching into a non-empty map (as done with several stylesheets) keeps
+  // earlier entries first among equal specificities.
+  {
+    CSS::RulesMap rules;
+    css->match(span, rules);
+    css->match(span, rules);
+    SUITE_CHECK(rules.size() == 102, "span node twice: wrong matched rule count");
+  }
+
+  // ── benchmark ────────────────────────────────────────────────────────────
+  DOM::Node *nodes[] = { p, span, img, div };
+  const int  rounds  = 20000;
+  size_t     total   = 0;
+  auto       start   = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    CSS::RulesMap rules;
+    css->match(nodes[i & 3], rules);
+    total += rules.size();
+  }
+  auto   elapsed = std::chrono::steady_clock::now() - start;
+  double secs    = std::chrono::duration<double>(elapsed).count();
+
+  SUITE_CHECK(total == (size_t)(rounds / 4) * (57 + 51), "benchmark: wrong matched rule total");
+  std::printf("    BENCH rules=1000 matches=%d time=%.3f s -> %.0f matches/s\n", rounds, secs,
+              secs > 0 ? rounds / secs : 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// CSSStore binary form
+// ---------------------------------------------------------------------------
+static auto roundTrip(CSS &css, CSS::CSSPools &pools, HimemVector<uint8_t> &bytes) -> CSSPtr {
+  bytes.clear();
+  if (!CSSStore::serialize(css, bytes)) return nullptr;
+  const uint8_t *p   = bytes.data();
+  CSSPtr         res = CSSStore::deserialize(p, bytes.data() + bytes.size(), pools);
+  return (p == bytes.data() + bytes.size()) ? std::move(res) : nullptr;
+}
+
+static auto testCssStore() -> void {
+  std::printf("  [testCssStore]\n");
+
+  // The fixture, rebuilt in other pools: same rules, so the same binary form.
+  {
+    auto css = loadFixture("test/fixtures/test.css");
+    SUITE_CHECK(css != nullptr, "fixture CSS::Make returned nullptr");
+    if (!css) return;
+
+    CSS::CSSPools        pools;
+    HimemVector<uint8_t> bytes, again;
+    CSSPtr               copy = roundTrip(*css, pools, bytes);
+    SUITE_CHECK(copy != nullptr, "fixture: rebuild from binary form failed");
+    if (!copy) return;
+    SUITE_CHECK(copy->getId() == css->getId(), "fixture: id not kept");
+    SUITE_CHECK(copy->rulesMap.size() == css->rulesMap.size(), "fixture: wrong rule count");
+    SUITE_CHECK(CSSStore::serialize(*copy, again) && (again == bytes),
+                "fixture: rebuilt stylesheet has another binary form");
+
+    const CSS::Value *v = firstValue(copy->rulesMap, CSS::PropertyId::FONT_FAMILY);
+    SUITE_CHECK((v != nullptr) && !v->str.empty(), "fixture: string value not kept");
+
+    // Truncated data is refused.
+    const uint8_t *p = bytes.data();
+    SUITE_CHECK(CSSStore::deserialize(p, bytes.data() + bytes.size() - 1, pools) == nullptr,
+                "fixture: truncated binary form accepted");
+    SUITE_CHECK(p == bytes.data(), "fixture: data pointer moved on failure");
+  }
+
+  // The large stylesheet, rebuilt in the default pools: same matches.
+  std::string buf = buildLargeStylesheet();
+  auto css = CSS::Make("large", "", buf.c_str(), static_cast<int32_t>(buf.size()), 0);
+  SUITE_CHECK(css != nullptr, "large CSS::Make returned nullptr");
+  if (!css) return;
+
+  HimemVector<uint8_t> bytes;
+  CSSPtr               copy = roundTrip(*css, CSS::defaultPools(), bytes);
+  SUITE_CHECK(copy != nullptr, "large: rebuild from binary form failed");
+  if (!copy) return;
+
+  auto dom = DOM::Make();
+  SUITE_CHECK(dom != nullptr, "DOM::Make returned nullptr");
+  if (!dom) return;
+
+  DOM::Node *div  = dom->addChild(dom->body, DOM::Tag::DIV);
+  DOM::Node *p    = dom->addChild(div, DOM::Tag::P);
+  DOM::Node *span = dom->addChild(p, DOM::Tag::SPAN);
+  p->addClasses("c5 c17")->addId("id3");
+  span->addClass("c250");
+
+  auto marginOf = [](const CSS::Properties *props) -> float {
+    for (auto &prop : *props) {
+      if ((prop.id == CSS::PropertyId::MARGIN_LEFT) && !prop.values.empty()) {
+        return prop.values.front().num;
+      }
+    }
+    return -1.0f;
+  };
+
+  for (DOM::Node *node : { p, span }) {
+    CSS::RulesMap parsed, rebuilt;
+    css->match(node, parsed);
+    copy->match(node, rebuilt);
+    bool same = parsed.size() == rebuilt.size();
+    for (auto a = parsed.begin(), b = rebuilt.begin(); same && (a != parsed.end()); ++a, ++b) {
+      same = (a->first->specificity.value == b->first->specificity.value) &&
+             (marginOf(a->second) == marginOf(b->second));
+    }
+    SUITE_CHECK(same, "large: rebuilt stylesheet matches other rules");
+  }
+
+  // ── benchmark ────────────────────────────────────────────────────────────
+  const int rounds = 50;
+  auto      start  = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    auto tmp = CSS::Make("large", "", buf.c_str(), static_cast<int32_t>(buf.size()), 0);
+  }
+  double parseSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    const uint8_t *data = bytes.data();
+    auto tmp = CSSStore::deserialize(data, bytes.data() + bytes.size(), CSS::defaultPools());
+  }
+  double loadSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::printf("    BENCH rules=1000 css=%zu bytes binary=%zu bytes parse=%.2f ms rebuild=%.2f ms "
+              "(x%.1f)\n",
+              buf.size(), bytes.size(), parseSecs * 1000.0 / rounds, loadSecs * 1000.0 / rounds,
+              loadSecs > 0 ? parseSecs / loadSecs : 0.0);
+}
+
+// ---------------------------------------------------------------------------
+// Property names and font-size keywords lookups
+// ---------------------------------------------------------------------------
+static auto testNameLookups() -> void {
+  std::printf("  [testNameLookups]\n");
+
+  bool allFound = true;
+  for (const auto &[key, value] : CSS::propertyMap) {
+    auto it  = CSS::propertyMap.find(std::string_view(key));
+    allFound = allFound && (it != CSS::propertyMap.end()) && (it->second == value);
+  }
+  SUITE_CHECK(allFound, "a property name is not found back");
+  SUITE_CHECK(CSS::propertyMap.find(std::string_view("colour")) == CSS::propertyMap.end(),
+              "unknown property name found");
+
+  const char *sizes = "p { font-size: x-large; } span { font-size: bogus; color: red; }";
+  auto        css   = CSS::Make("sizes", "", sizes, static_cast<int32_t>(strlen(sizes)), 0);
+  SUITE_CHECK(css != nullptr, "sizes CSS::Make returned nullptr");
+  if (!css) return;
+  SUITE_CHECK(countRulesForTag(css->rulesMap, DOM::Tag::P) == 1, "sizes: no p rule");
+  float pSize = -1, spanSize = -1;
+  for (const auto &[sel, props] : css->rulesMap) {
+    for (auto &prop : *props) {
+      if ((prop.id == CSS::PropertyId::FONT_SIZE) && !prop.values.empty()) {
+        bool isP = false;
+        for (const auto &node : sel->selectorNodeList) { isP = isP || (node.tag == DOM::Tag::P); }
+        (isP ? pSize : spanSize) = prop.values.front().num;
+      }
+    }
+  }
+  SUITE_CHECK(pSize == 18.0f, "sizes: x-large is not 18pt");
+  SUITE_CHECK(spanSize == 12.0f, "sizes: unknown keyword is not 12pt");
+
+  // ── benchmark ────────────────────────────────────────────────────────────
+  // Parsing: a stylesheet of 500 rules with 8 declarations each, one of them unknown.
+  static const char *decls[] = { "font-size: medium", "font-weight: bold", "color: red",
+                                 "text-align: center", "margin-top: 2px", "line-height: 1.2",
+                                 "display: block", "vertical-align: super" };
+  std::string buf;
+  for (int i = 0; i < 500; ++i) {
+    buf += ".c" + std::to_string(i) + " {";
+    for (const char *d : decls) { buf += std::string(" ") + d + ";"; }
+    buf += " }\n";
+  }
+  const int rounds = 50;
+  auto      start  = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    auto tmp = CSS::Make("decls", "", buf.c_str(), static_cast<int32_t>(buf.size()), 0);
+  }
+  double parseSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  double tokens    = double(rounds) * 500 * 8;
+
+  // Property name lookups, against the former linear strcmp() walk of the table.
+  static const char *names[] = { "font-size", "margin-left", "color", "text-indent", "display",
+                                 "src", "font-family", "vertical-align", "border", "width" };
+  const int lookups = 200000;
+  int       found = 0, linearFound = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i) {
+    if (CSS::propertyMap.find(std::string_view(names[i % 10])) != CSS::propertyMap.end()) {
+      ++found;
+    }
+  }
+  double hashSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; ++i) {
+    for (const auto &[key, value] : CSS::propertyMap) {
+      if (std::strcmp(key.data(), names[i % 10]) == 0) {
+        ++linearFound;
+        break;
+      }
+    }
+  }
+  double linearSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  SUITE_CHECK((found == linearFound) && (found == lookups / 10 * 9),
+              "benchmark: wrong property name lookup count");
+  std::printf("    BENCH declarations=%.0f parse=%.0f tokens/s; names=%d frozen=%.0f lookups/s "
+              "linear=%.0f lookups/s (x%.1f)\n",
+              tokens, parseSecs > 0 ? tokens / parseSecs : 0.0, lookups,
+              hashSecs > 0 ? lookups / hashSecs : 0.0, linearSecs > 0 ? lookups / linearSecs : 0.0,
+              hashSecs > 0 ? linearSecs / hashSecs : 0.0);
+}
+
 // ---------------------------------------------------------------------------
 // Suite entry point
 // ---------------------------------------------------------------------------
@@ -799,6 +1105,11 @@ auto testCss() -> TestStats {
   // Inline-style test (creates its own CSS object).
   testInlineStyle();
 
+  testLargeStylesheetMatch();
+
+  testCssStore();
+  testNameLookups();
+
   std::printf("\n  CSS tests: %d passed, %d failed\n", css_pass, css_fail);
   return TestStats{css_pass, css_fail};
 }
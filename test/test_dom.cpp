@@ -12,7 +12,12 @@
 #include "dom.hpp"
 #include "test_stats.hpp"
 
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
 
 #define DT_LOG(fmt, ...) std::printf("[dom_test] " fmt "\n", ##__VA_ARGS__)
 
@@ -140,14 +145,23 @@ static void testDomClasses() {
   p->addClass("intro");
   p->addClass("highlight");
 
-  bool hasIntro     = false;
-  bool hasHighlight = false;
-  for (const auto &cls : p->classList) {
-    if (cls == "intro") hasIntro = true;
-    if (cls == "highlight") hasHighlight = true;
+  Atoms &atoms        = dom->getAtoms();
+  bool   hasIntro     = false;
+  bool   hasHighlight = false;
+  for (auto cls : p->classList) {
+    if (std::strcmp(atoms.name(cls), "intro") == 0) hasIntro = true;
+    if (std::strcmp(atoms.name(cls), "highlight") == 0) hasHighlight = true;
   }
   DT_CHECK(hasIntro, "classList contains \"intro\"");
   DT_CHECK(hasHighlight, "classList contains \"highlight\"");
+
+  // Class names are interned: the same name gives the same atom on every node.
+  auto *q = dom->addChild(dom->body, DOM::Tag::P);
+  q->addClasses("  highlight  a b\tc intro d highlight ");
+  DT_CHECK(q->classList.size() == 6, "addClasses() keeps one atom per distinct class");
+  DT_CHECK(q->classList.contains(atoms.find("intro")), "shared atom for \"intro\"");
+  DT_CHECK(q->classList.contains(atoms.find("d")), "classList spills past its inline capacity");
+  DT_CHECK(atoms.find("not-a-class") == Atoms::NO_ATOM, "unknown name has no atom");
 }
 
 // ===========================================================================
@@ -160,7 +174,68 @@ static void testDomId() {
   auto *p  = dom->addChild(dom->body, DOM::Tag::P);
 
   p->addId("main-paragraph");
-  DT_CHECK(p->id == "main-paragraph", "id set correctly via addId()");
+  DT_CHECK(p->id != Atoms::NO_ATOM, "addId() gives the node an atom");
+  DT_CHECK(std::strcmp(dom->getAtoms().name(p->id), "main-paragraph") == 0,
+           "id set correctly via addId()");
+}
+
+// ===========================================================================
+// DOM::tags lookups — string views, and elements/s against a std::map
+// ===========================================================================
+static void testDomTagLookup() {
+  DT_LOG("--- DOM::tags lookup ---");
+
+  bool allFound = true;
+  for (const auto &[key, value] : DOM::tags) {
+    auto it  = DOM::tags.find(std::string_view(key));
+    allFound = allFound && (it != DOM::tags.end()) && (it->second == value);
+  }
+  DT_CHECK(allFound, "every tag name is found back");
+  DT_CHECK(DOM::tags.size() == 37, "37 tag names");
+
+  const char *name = "blockquotes";
+  auto it          = DOM::tags.find(std::string_view(name, 10));
+  DT_CHECK((it != DOM::tags.end()) && (it->second == DOM::Tag::BLOCKQUOTE),
+           "lookup of a slice of a longer name");
+  DT_CHECK(DOM::tags.find(std::string_view(name)) == DOM::tags.end(),
+           "longer name not found");
+  DT_CHECK(DOM::tags.find(std::string_view("")) == DOM::tags.end(), "empty name not found");
+
+  // Element names as given by pugixml for a typical chapter, unknown ones included.
+  static const char *elements[] = { "p", "span", "em", "p", "a", "div", "i", "p", "h2",
+                                    "section", "span", "br", "strong", "p", "img", "sup",
+                                    "li", "table", "tr", "td", "nav", "b", "p", "blockquote" };
+  const int count  = sizeof(elements) / sizeof(elements[0]);
+  const int rounds = 40000;
+
+  // The former lookup: a std::map keyed by std::string, with a temporary for every element.
+  std::map<std::string, DOM::Tag> oldTags;
+  for (const auto &[key, value] : DOM::tags) { oldTags.emplace(std::string_view(key), value); }
+
+  int  known = 0, oldKnown = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < count; ++i) {
+      if (DOM::tags.find(std::string_view(elements[i])) != DOM::tags.end()) { ++known; }
+    }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (int i = 0; i < count; ++i) {
+      if (oldTags.find(elements[i]) != oldTags.end()) { ++oldKnown; }
+    }
+  }
+  double oldSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  DT_CHECK((known == oldKnown) && (known == rounds * (count - 2)),
+           "same elements known as with a std::map");
+
+  double total = double(rounds) * count;
+  std::printf("    BENCH tag lookups=%.0f frozen=%.0f elements/s std::map=%.0f elements/s (x%.1f)\n",
+              total, secs > 0 ? total / secs : 0.0,
+              oldSecs > 0 ? total / oldSecs : 0.0, secs > 0 ? oldSecs / secs : 0.0);
 }
 
 } // namespace
@@ -178,6 +253,7 @@ auto testDom() -> TestStats {
   testDomTree();
   testDomClasses();
   testDomId();
+  testDomTagLookup();
 
   DT_LOG("--- DOM tests complete: %d passed, %d failed ---", s_pass, s_fail);
   return TestStats{s_pass, s_fail};
@@ -19,6 +19,9 @@
 //  10. testNoMetadata       — open() succeeds but getTitle()/getAuthor() return empty string.
 //  11. testReopenSameFile   — calling open() twice with the same path is a no-op (returns true).
 //  12. testReopenOtherFile  — calling open() with a different path re-opens correctly.
+//  13. testItemCache        — going back to a parsed item is served by the item cache.
+//  14. testCssStore         — parsed stylesheets are saved in the .cssc file at closeFile()
+//                             and used instead of parsing on the next opening.
 //
 // The test binary must be run from the repository root so that the relative
 // path "test/fixtures/*.epub" resolves correctly.
@@ -28,6 +31,7 @@
 // __FONTS__=1).  Both are linked into the same test binary.
 // ---------------------------------------------------------------------------
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 
@@ -35,6 +39,7 @@
 // models/display_list.hpp.  None of these drag in GTK.  The problematic
 // msg_viewer.hpp include is in epub.cpp (not epub.hpp) and is shadowed by
 // test/stubs/viewers/msg_viewer.hpp via -I test/stubs.
+#include "models/css_store.hpp"
 #include "models/epub.hpp"
 #include "test_stats.hpp"
 
@@ -210,6 +215,157 @@ static auto testGetItemAtIndex() -> bool {
   return sFail == 0;
 }
 
+// ---------------------------------------------------------------------------
+// Sub-test 13 — parsed items cache
+// ---------------------------------------------------------------------------
+static auto titleOf(EPubPtr &epub) -> const char * {
+  return epub->getCurrentItem().child("html").child("head").child("title").child_value();
+}
+
+static auto testItemCache() -> bool {
+  EPUB_LOG("--- parsed items cache ---");
+
+  auto epub = EPub::Make();
+  epub->open(MINIMAL);
+
+  epub->getItemAtIndex(0);
+  const CSS *css0 = epub->getCurrentItemCss().get();
+  epub->getItemAtIndex(1);
+  EPUB_CHECK(std::strcmp(titleOf(epub), "Chapter Two") == 0, "item 1 parsed");
+
+  EPub::ItemCacheStats stats = epub->getItemCacheStats();
+  EPUB_CHECK((stats.misses == 2) && (stats.hits == 0), "first visits are misses");
+  EPUB_CHECK((stats.count == 1) && (stats.bytes > 0), "item 0 kept in the cache");
+
+  // Back and forth across the item boundary: no more parsing.
+  EPUB_CHECK(epub->getItemAtIndex(0), "getItemAtIndex(0) from the cache succeeds");
+  EPUB_CHECK(epub->getItemrefIndex() == 0, "getItemrefIndex() == 0 from the cache");
+  EPUB_CHECK(std::strcmp(titleOf(epub), "Chapter One") == 0, "cached item 0 XML is intact");
+  EPUB_CHECK(epub->getCurrentItemCss().get() == css0, "cached item 0 keeps its merged CSS");
+  EPUB_CHECK(epub->getItemAtIndex(1), "getItemAtIndex(1) from the cache succeeds");
+  EPUB_CHECK(std::strcmp(titleOf(epub), "Chapter Two") == 0, "cached item 1 XML is intact");
+
+  stats = epub->getItemCacheStats();
+  EPUB_CHECK((stats.misses == 2) && (stats.hits == 2), "returns are hits");
+  EPUB_CHECK(stats.count == 1, "only the item left is cached");
+
+  // Without budget, every item change parses the item again.
+  epub->setItemCacheBudget(0);
+  EPUB_CHECK(epub->getItemCacheStats().count == 0, "budget 0 empties the cache");
+  epub->getItemAtIndex(0);
+  epub->getItemAtIndex(1);
+  stats = epub->getItemCacheStats();
+  EPUB_CHECK((stats.misses == 4) && (stats.hits == 2) && (stats.count == 0),
+             "budget 0 disables the cache");
+  EPUB_CHECK(std::strcmp(titleOf(epub), "Chapter Two") == 0, "item 1 parsed again");
+
+  epub->setItemCacheBudget(1024 * 1024);
+  epub->getItemAtIndex(0);
+  epub->closeFile();
+  stats = epub->getItemCacheStats();
+  EPUB_CHECK((stats.count == 0) && (stats.bytes == 0), "closeFile() empties the cache");
+
+  return sFail == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Sub-test 14 — stylesheets kept in the book's .cssc file
+// ---------------------------------------------------------------------------
+static auto cssRuleCount(EPubPtr &epub) -> size_t {
+  const CSSPtr &css = epub->getCurrentItemCss();
+  return (css != nullptr) ? css->rulesMap.size() : 0;
+}
+
+// Time to open a book and get its first item, in ms (best of some runs).
+static auto openTime(const char *path, bool withStore) -> double {
+  double best = 1e9;
+  for (int i = 0; i < 20; ++i) {
+    if (!withStore) std::remove(CSSStore::filenameOf(path).c_str());
+    auto epub  = EPub::Make();
+    auto start = std::chrono::steady_clock::now();
+    epub->open(path);
+    epub->getItemAtIndex(0);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                  .count();
+    if (ms < best) best = ms;
+    epub->closeFile(); // Saves the store when the stylesheets were parsed
+  }
+  return best;
+}
+
+static auto testCssStore() -> bool {
+  EPUB_LOG("--- stylesheets store ---");
+
+  const CSSStore::BinUUID noUuid{}; // minimal.epub is not encrypted
+  const HimemString       storeName = CSSStore::filenameOf(MINIMAL);
+  std::remove(storeName.c_str());
+
+  // First opening: the stylesheet is parsed, then saved by closeFile().
+  auto epub = EPub::Make();
+  epub->open(MINIMAL);
+  epub->getItemAtIndex(0);
+  size_t parsedRules = cssRuleCount(epub);
+  EPUB_CHECK(parsedRules == 3, "item 0 gets the 3 rules of style.css");
+  epub->closeFile();
+
+  {
+    CSS::CSSPools     pools;
+    CSSStore::CSSList sheets;
+    EPUB_CHECK(CSSStore::load(MINIMAL, noUuid, pools, sheets) && (sheets.size() == 1),
+               "closeFile() saved the parsed stylesheet");
+    EPUB_CHECK(!sheets.empty() && (sheets.front()->getId() == "style.css") &&
+                 (sheets.front()->rulesMap.size() == parsedRules),
+               "stylesheet saved under its href with its rules");
+  }
+
+  // A stored stylesheet is used instead of the one in the book.
+  {
+    CSS::CSSPools     pools;
+    CSSStore::CSSList sheets;
+    const char       *text = "p { margin: 0; }";
+    sheets.push_back(CSS::Make("style.css", "OEBPS/", text, strlen(text), 0, pools));
+    EPUB_CHECK(CSSStore::save(MINIMAL, noUuid, sheets), "CSSStore::save() succeeds");
+  }
+  epub->open(MINIMAL);
+  epub->getItemAtIndex(0);
+  EPUB_CHECK(cssRuleCount(epub) == 1, "item 0 gets its stylesheet from the store");
+  epub->getItemAtIndex(1);
+  EPUB_CHECK(cssRuleCount(epub) == 1, "item 1 shares the stored stylesheet");
+  epub->closeFile();
+
+  // A store of another book is ignored, and replaced.
+  {
+    CSS::CSSPools     pools;
+    CSSStore::CSSList sheets;
+    CSSStore::BinUUID otherUuid{ 1 };
+    const char       *text = "p { margin: 0; }";
+    sheets.push_back(CSS::Make("style.css", "OEBPS/", text, strlen(text), 0, pools));
+    CSSStore::save(MINIMAL, otherUuid, sheets);
+    sheets.clear();
+    EPUB_CHECK(!CSSStore::load(MINIMAL, noUuid, pools, sheets) && sheets.empty(),
+               "store of another book is not loaded");
+  }
+  epub->open(MINIMAL);
+  epub->getItemAtIndex(0);
+  EPUB_CHECK(cssRuleCount(epub) == parsedRules, "stylesheet parsed again from the book");
+  epub->closeFile();
+  {
+    CSS::CSSPools     pools;
+    CSSStore::CSSList sheets;
+    EPUB_CHECK(CSSStore::load(MINIMAL, noUuid, pools, sheets) && (sheets.size() == 1) &&
+                 (sheets.front()->rulesMap.size() == parsedRules),
+               "outdated store replaced at closeFile()");
+  }
+
+  double parseMs = openTime(MINIMAL, false);
+  double storeMs = openTime(MINIMAL, true);
+  EPUB_LOG("BENCH open + item 0 of minimal.epub: %.3f ms parsing, %.3f ms from the store", parseMs,
+           storeMs);
+
+  std::remove(storeName.c_str());
+  return sFail == 0;
+}
+
 // ---------------------------------------------------------------------------
 // Sub-test 7 — cover filename
 // ---------------------------------------------------------------------------
@@ -350,6 +506,8 @@ auto testEPub() -> TestStats {
   run("no-metadata", testNoMetadata);
   run("reopen-same", testReopenSameFile);
   run("reopen-other", testReopenOtherFile);
+  run("item-cache", testItemCache);
+  run("css-store", testCssStore);
 
   EPUB_LOG("========== EPub test suite end: %d passed, %d failed ==========", sPass, sFail);
 
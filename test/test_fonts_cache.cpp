@@ -5,9 +5,18 @@
 #include "test_stats.hpp"
 #include "ttf2.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -202,6 +211,713 @@ static auto runTtfChurnStress(int cycles) -> void {
   FT_Done_FreeType(library);
 }
 
+static const char *const GLYPHS_TMP = "/tmp/epub_test_glyphs";
+static const char *const TEXT       = "The quick brown fox jumps over the lazy dog, 0123456789!";
+
+static auto glyphFileCount() -> int {
+  std::error_code ec;
+  int             count = 0;
+  for (auto &entry : std::filesystem::directory_iterator(GLYPHS_TMP, ec)) {
+    (void)entry;
+    ++count;
+  }
+  return count;
+}
+
+static auto sameGlyph(const Glyph &a, const Glyph &b) -> bool {
+  if ((a.dim.width != b.dim.width) || (a.dim.height != b.dim.height) || (a.xoff != b.xoff) ||
+      (a.yoff != b.yoff) || (a.advance != b.advance) || (a.pitch != b.pitch) ||
+      (a.lineHeight != b.lineHeight) || (a.index != b.index) ||
+      ((a.buffer == nullptr) != (b.buffer == nullptr))) {
+    return false;
+  }
+  return (a.buffer == nullptr) || (memcmp(a.buffer, b.buffer, a.pitch * a.dim.height) == 0);
+}
+
+static auto testGlyphFiles() -> void {
+  std::printf("  [4. glyph files]\n");
+
+  std::error_code ec;
+  std::filesystem::remove_all(GLYPHS_TMP, ec);
+  GlyphFile::setFolder(GLYPHS_TMP);
+
+  FT_Library library = nullptr;
+  FC_CHECK(FT_Init_FreeType(&library) == 0, "FreeType init succeeds for glyph files");
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  FC_CHECK(descr != nullptr, "glyph files descriptor created");
+  if (!library || !descr) {
+    GlyphFile::setFolder("");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  // Reference glyphs, from FreeType.
+  FontPtr reference = TTF::Make(descr, library);
+  std::vector<Glyph *>  refGlyphs;
+  std::vector<int16_t>  refKerns;
+  for (const char *c = TEXT; *c; ++c) {
+    auto [glyph, kern, ignore] = reference->getGlyph(*c, c[1], 12);
+    refGlyphs.push_back(glyph);
+    refKerns.push_back(kern);
+  }
+  uint32_t distinct = reference->getRenderedGlyphCount();
+  FC_CHECK(distinct > 20, "text glyphs rendered by FreeType");
+  FC_CHECK(reference->getLoadedGlyphCount() == 0, "no glyph file at first");
+  reference->flushGlyphFiles();
+  FC_CHECK(glyphFileCount() == 1, "one glyph file for the font size");
+
+  {
+    FontPtr font     = TTF::Make(descr, library);
+    bool    same     = true;
+    bool    sameKern = true;
+    int     idx      = 0;
+    for (const char *c = TEXT; *c; ++c, ++idx) {
+      auto [glyph, kern, ignore] = font->getGlyph(*c, c[1], 12);
+      same     = same && (glyph != nullptr) && sameGlyph(*glyph, *refGlyphs[idx]);
+      sameKern = sameKern && (kern == refKerns[idx]);
+    }
+    FC_CHECK(font->getRenderedGlyphCount() == 0, "second font: no glyph from FreeType");
+    FC_CHECK(font->getLoadedGlyphCount() == distinct, "second font: all glyphs from the file");
+    FC_CHECK(same, "glyphs from the file are the FreeType ones");
+    FC_CHECK(sameKern, "kerning unchanged for glyphs from the file");
+
+    FC_CHECK(font->getGlyph('Z', 12) != nullptr && font->getRenderedGlyphCount() == 1,
+             "new glyph rendered by FreeType");
+  } // The new glyph is written when the font goes
+
+  {
+    FontPtr font = TTF::Make(descr, library);
+    font->getGlyph('a', 12);
+    FC_CHECK(font->getLoadedGlyphCount() == distinct + 1, "new glyph appended to the file");
+
+    font->getGlyph('a', 14);
+    font->setGlyphLoadMode(Font::GlyphLoadMode::METRICS_ONLY);
+    font->setCurrentSizeUnit(Font::SizeUnit::PIXELS);
+    Glyph *metrics = font->getGlyph('a', 16);
+    FC_CHECK(metrics != nullptr && metrics->buffer == nullptr, "metrics only glyph");
+    font->flushGlyphFiles();
+    FC_CHECK(glyphFileCount() == 3, "one file per size and render mode");
+  }
+
+  // Damaged end of file: dropped, the glyphs before it are kept.
+  std::filesystem::path file;
+  uintmax_t             biggest = 0;
+  for (auto &entry : std::filesystem::directory_iterator(GLYPHS_TMP, ec)) {
+    if (entry.file_size() > biggest) {
+      biggest = entry.file_size();
+      file    = entry.path();
+    }
+  }
+  {
+    std::ofstream out(file, std::ios::binary | std::ios::app);
+    out << "garbage at the end of the glyph file";
+  }
+  {
+    FontPtr font = TTF::Make(descr, library);
+    font->getGlyph('a', 12);
+    FC_CHECK(font->getLoadedGlyphCount() == distinct + 1, "glyphs kept before damaged bytes");
+    FC_CHECK(std::filesystem::file_size(file, ec) == biggest, "damaged bytes dropped");
+  }
+
+  // Two instances on the same file, as the viewer and the prefetcher: both
+  // found no file, and each appends its glyphs to the other's.
+  {
+    std::vector<uint8_t> bitmap(50000, 0x5A);
+    Glyph                big;
+    big.dim    = Dim(500, 100);
+    big.pitch  = 500;
+    big.buffer = bitmap.data();
+
+    auto countGlyphs = [](GlyphFile &f) -> uint16_t {
+      return f.load([](char32_t, const Glyph &, const uint8_t *) { return true; });
+    };
+
+    GlyphFile first(0x12345678, 99, GlyphFile::Mode::GRAY);
+    GlyphFile second(0x12345678, 99, GlyphFile::Mode::GRAY);
+    FC_CHECK(countGlyphs(first) == 0 && countGlyphs(second) == 0, "shared file absent at first");
+
+    first.add('a', big);
+    first.flush();
+    second.add('b', big);
+    second.flush();
+    {
+      GlyphFile reader(0x12345678, 99, GlyphFile::Mode::GRAY);
+      FC_CHECK(countGlyphs(reader) == 2, "second instance appends, not truncates");
+    }
+
+    for (char32_t c = 'c'; c < 'f'; ++c) { first.add(c, big); }
+    first.flush();
+    for (char32_t c = 'f'; c < 'i'; ++c) { second.add(c, big); }
+    second.flush();
+
+    uintmax_t size = 0;
+    for (auto &entry : std::filesystem::directory_iterator(GLYPHS_TMP, ec)) {
+      if (entry.path().filename().string().find("_99_") != std::string::npos) {
+        size = entry.file_size();
+      }
+    }
+    FC_CHECK(size > 0 && size <= GlyphFile::MAX_FILE_SIZE,
+             "file size limit kept across instances");
+
+    GlyphFile reader(0x12345678, 99, GlyphFile::Mode::GRAY);
+    FC_CHECK(countGlyphs(reader) == GlyphFile::MAX_FILE_SIZE / 50000,
+             "whole records written up to the limit");
+  }
+
+  // Without folder, no glyph file is used.
+  GlyphFile::setFolder("");
+  {
+    FontPtr font = TTF::Make(descr, library);
+    font->getGlyph('a', 12);
+    FC_CHECK(font->getLoadedGlyphCount() == 0 && font->getRenderedGlyphCount() == 1,
+             "glyph files not used without folder");
+  }
+
+  reference.reset();
+  FT_Done_FreeType(library);
+  std::filesystem::remove_all(GLYPHS_TMP, ec);
+}
+
+// ── benchmark ────────────────────────────────────────────────────────────────
+// First page of text after a restart: every glyph from FreeType, against
+// the glyphs of the font size read from its file.
+static auto benchGlyphFiles() -> void {
+  std::printf("  [5. glyph files bench]\n");
+
+  const int ROUNDS = 20;
+
+  std::error_code ec;
+  std::filesystem::remove_all(GLYPHS_TMP, ec);
+
+  FT_Library library = nullptr;
+  FT_Init_FreeType(&library);
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!library || !descr) {
+    FC_CHECK(false, "glyph files bench setup");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  auto firstPage = [&](uint32_t &rendered) -> double {
+    FontPtr font  = TTF::Make(descr, library);
+    auto    start = std::chrono::steady_clock::now();
+    for (char c = ' '; c <= '~'; ++c) { font->getGlyph(c, 12); }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    rendered += font->getRenderedGlyphCount();
+    return secs;
+  };
+
+  uint32_t coldRendered = 0, fileRendered = 0;
+  double   coldSecs = 0.0, fileSecs = 0.0;
+
+  for (int i = 0; i < ROUNDS; ++i) { coldSecs += firstPage(coldRendered); }
+
+  GlyphFile::setFolder(GLYPHS_TMP);
+  uint32_t ignored = 0;
+  firstPage(ignored); // Writes the file
+  for (int i = 0; i < ROUNDS; ++i) { fileSecs += firstPage(fileRendered); }
+  GlyphFile::setFolder("");
+
+  FC_CHECK(coldRendered == ROUNDS * 95, "bench: FreeType renders every glyph");
+  FC_CHECK(fileRendered == 0, "bench: no FreeType call with the glyph file");
+
+  std::printf("    BENCH glyphs=95 size=12 first page: FreeType=%.3f ms file=%.3f ms (x%.1f)\n",
+              coldSecs * 1000.0 / ROUNDS, fileSecs * 1000.0 / ROUNDS,
+              fileSecs > 0 ? coldSecs / fileSecs : 0.0);
+
+  FT_Done_FreeType(library);
+  std::filesystem::remove_all(GLYPHS_TMP, ec);
+}
+
+// Pages of text, as the book viewer builds them: the glyphs of a page are
+// retrieved, then released when the page is gone.
+static auto testGlyphCacheBudget() -> void {
+  std::printf("  [6. glyph cache budget]\n");
+
+  const std::size_t BUDGET = 64 * 1024;
+
+  FT_Library library = nullptr;
+  FC_CHECK(FT_Init_FreeType(&library) == 0, "FreeType init succeeds for budget test");
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  FC_CHECK(descr != nullptr, "budget descriptor created");
+  if (!library || !descr) {
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  FontPtr reference = TTF::Make(descr, library);
+  FontPtr font      = TTF::Make(descr, library);
+  font->setGlyphCacheBudget(BUDGET);
+  FC_CHECK(font->getGlyphCacheBudget() == BUDGET, "budget set");
+
+  // Over budget, but no page released yet: nothing dropped.
+  uint32_t lookups = 0;
+  for (int size = 20; size <= 40; size += 4) {
+    for (char32_t c = 0x21; c < 0x7F; ++c, ++lookups) { font->getGlyph(c, size); }
+  }
+  FC_CHECK(font->getGlyphCacheResidentBytes() > BUDGET, "cache over budget before release");
+  FC_CHECK(font->getGlyphCacheEvictions() == 0, "no eviction before release");
+
+  Glyph *kept = font->getGlyph('Q', 40);
+  ++lookups;
+  FC_CHECK(font->getGlyphCacheHits() == 1 && font->getGlyphCacheMisses() == lookups - 1,
+           "hits and misses counted");
+
+  font->releaseGlyphs();
+  FC_CHECK(font->getGlyphCacheEvictions() > 0, "glyphs evicted on release");
+  FC_CHECK(font->getGlyphCacheResidentBytes() <= BUDGET - BUDGET / 4,
+           "cache trimmed to 3/4 of the budget");
+  FC_CHECK(font->getGlyph('Q', 40) == kept, "most recently used glyph kept");
+
+  // Evicted glyphs come back as they were.
+  bool same = true;
+  for (char32_t c = 0x21; c < 0x7F; ++c) {
+    Glyph *a = font->getGlyph(c, 20);
+    Glyph *b = reference->getGlyph(c, 20);
+    same     = same && (a != nullptr) && (b != nullptr) && sameGlyph(*a, *b);
+  }
+  FC_CHECK(same, "evicted glyphs rendered again");
+
+  // Released with no budget: nothing dropped.
+  std::size_t resident = reference->getGlyphCacheResidentBytes();
+  reference->releaseGlyphs();
+  FC_CHECK(reference->getGlyphCacheEvictions() == 0 &&
+             reference->getGlyphCacheResidentBytes() == resident,
+           "no eviction without budget");
+
+  font->clearCache();
+  FC_CHECK(font->getGlyphCacheResidentBytes() == 0, "clearCache() empties the resident bytes");
+
+  font.reset();
+  reference.reset();
+  FT_Done_FreeType(library);
+}
+
+// Many pages in many sizes, as a symbol-heavy book or size changes do: with a
+// budget, the bitmap slots of dropped glyphs are reused and the memory stays
+// bounded. Without, it grows with every glyph seen.
+static auto runEvictionStress(int pages) -> void {
+  std::printf("  [stress] glyph cache eviction (%d pages)\n", pages);
+
+  const std::size_t BUDGET     = 96 * 1024;
+  const int         PAGE_CHARS = 150;
+
+  FT_Library library = nullptr;
+  FC_CHECK(FT_Init_FreeType(&library) == 0, "FreeType init succeeds for eviction stress");
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!library || !descr) {
+    FC_CHECK(false, "eviction stress setup");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  FontPtr bounded   = TTF::Make(descr, library);
+  FontPtr unbounded = TTF::Make(descr, library);
+  bounded->setGlyphCacheBudget(BUDGET);
+
+  bool        pageIntact  = true;
+  bool        underBudget = true;
+  std::size_t maxPools    = 0;
+  uint32_t    seed        = 12345;
+
+  for (int page = 0; page < pages; ++page) {
+    int16_t size = 10 + (page % 13) * 3;
+
+    Glyph  *glyphs[PAGE_CHARS];
+    Glyph   copies[PAGE_CHARS];
+    for (int i = 0; i < PAGE_CHARS; ++i) {
+      seed          = seed * 1103515245 + 12345;
+      char32_t c    = 0x21 + (seed >> 16) % 0x15E; // Latin and Latin extended
+      glyphs[i]     = bounded->getGlyph(c, size);
+      unbounded->getGlyph(c, size);
+      if (glyphs[i] != nullptr) { copies[i] = *glyphs[i]; }
+    }
+
+    // The glyphs of the page are still there when the page is complete.
+    for (int i = 0; i < PAGE_CHARS; ++i) {
+      if ((glyphs[i] != nullptr) && ((glyphs[i]->buffer != copies[i].buffer) ||
+                                     (glyphs[i]->advance != copies[i].advance))) {
+        pageIntact = false;
+      }
+    }
+
+    bounded->releaseGlyphs();
+    unbounded->releaseGlyphs();
+
+    underBudget = underBudget && (bounded->getGlyphCacheResidentBytes() <= BUDGET);
+    maxPools    = std::max(maxPools, bounded->getBytePoolsAllocatedBytes());
+  }
+
+  FC_CHECK(pageIntact, "eviction stress: glyphs of the page in use are never dropped");
+  FC_CHECK(underBudget, "eviction stress: under budget after each release");
+  FC_CHECK(bounded->getGlyphCacheEvictions() > 0, "eviction stress: glyphs evicted");
+  FC_CHECK(unbounded->getGlyphCacheEvictions() == 0, "eviction stress: none without budget");
+  FC_CHECK(maxPools < unbounded->getBytePoolsAllocatedBytes(),
+           "eviction stress: freed slots reused, bitmap memory bounded");
+
+  std::printf("    BENCH pages=%d budget=%zu KB: resident %zu KB, pools %zu KB, "
+              "hits %u misses %u evictions %u; no budget: resident %zu KB, pools %zu KB\n",
+              pages, BUDGET / 1024, bounded->getGlyphCacheResidentBytes() / 1024, maxPools / 1024,
+              bounded->getGlyphCacheHits(), bounded->getGlyphCacheMisses(),
+              bounded->getGlyphCacheEvictions(), unbounded->getGlyphCacheResidentBytes() / 1024,
+              unbounded->getBytePoolsAllocatedBytes() / 1024);
+
+  bounded.reset();
+  unbounded.reset();
+  FT_Done_FreeType(library);
+}
+
+// A face with kerning data, counting the values asked to it.
+class KernProbeFont : public Font {
+  public:
+    KernProbeFont() { ready = true; }
+
+    uint32_t faceCalls = 0;
+
+    static auto kernOf(uint16_t index, char32_t next) -> int16_t {
+      return -(int16_t)((index * 7 + next) % 5);
+    }
+
+    auto getLineHeight(int16_t glyphSize) -> int32_t override { return glyphSize; }
+    auto getDescenderHeight(int16_t glyphSize) -> int32_t override { return 0; }
+
+  protected:
+    auto getGlyphInternal(Glyph &glyph, char32_t charcode, int16_t glyphSize) -> bool override {
+      glyph.clear();
+      glyph.index   = (uint16_t)charcode;
+      glyph.advance = glyphSize / 2;
+      return true;
+    }
+    auto getKern(const Glyph &glyph, char32_t nextCharcode, int16_t glyphSize) -> int16_t override {
+      ++faceCalls;
+      return kernOf(glyph.index, nextCharcode);
+    }
+    [[nodiscard]] auto hasKerning() const -> bool override { return true; }
+};
+
+static auto testKerningCache() -> void {
+  std::printf("  [7. kerning pairs cache]\n");
+
+  KernProbeFont probe;
+  probe.setGlyphLoadMode(Font::GlyphLoadMode::METRICS_ONLY);
+
+  auto layout = [](Font &font, int16_t size) -> bool {
+    bool ok = true;
+    for (const char *c = TEXT; c[1]; ++c) {
+      auto [glyph, kern, ignoreNext] = font.getGlyph(c[0], c[1], size);
+      if (glyph == nullptr) { return false; }
+      if (!ignoreNext) { ok = ok && (kern == KernProbeFont::kernOf(glyph->index, c[1])); }
+    }
+    return ok;
+  };
+
+  FC_CHECK(layout(probe, 12), "kerning values from the face");
+  uint32_t firstCalls = probe.faceCalls;
+  FC_CHECK(firstCalls > 0 && firstCalls == probe.getKernCacheEntryCount(),
+           "the face is asked once per pair");
+  FC_CHECK(probe.getKernFaceCallCount() == firstCalls, "face calls counted");
+
+  FC_CHECK(layout(probe, 12), "kerning values from the cache");
+  FC_CHECK(probe.faceCalls == firstCalls, "no face call for the pairs already seen");
+
+  layout(probe, 14);
+  FC_CHECK(probe.faceCalls == 2 * firstCalls, "pairs kept by size");
+
+  Glyph glyph;
+  for (uint32_t i = 0; i < 5000; ++i) {
+    glyph.index = (uint16_t)(i / 100);
+    probe.getPairKern(glyph, 0x100 + (i % 100), 20);
+  }
+  FC_CHECK(probe.getKernCacheEntryCount() <= 4096, "kerning cache stays bounded");
+
+  // The fixture fonts have no 'kern' table (GPOS only): no pair goes to
+  // FreeType and the kerning is the one of the face.
+  FT_Library library = nullptr;
+  FC_CHECK(FT_Init_FreeType(&library) == 0, "FreeType init succeeds for kerning");
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!library || !descr) {
+    FC_CHECK(false, "kerning setup");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  FontPtr font = TTF::Make(descr, library);
+  TTF    *ttf  = static_cast<TTF *>(font.get());
+  bool    same = true;
+  for (const char *c = TEXT; c[1]; ++c) {
+    Glyph *g = font->getGlyph(c[0], 12);
+    same     = same && (g != nullptr) &&
+           (font->getPairKern(*g, c[1], 12) == ttf->getKern(*g, c[1], 12));
+  }
+  FC_CHECK(same, "TTF kerning same as the face");
+  FC_CHECK(font->getKernFaceCallCount() == 0, "no FreeType kerning call without kerning data");
+
+  font.reset();
+  FT_Done_FreeType(library);
+}
+
+// Pairs of a page of text, laid out by the page locations and the display:
+// each pair to FreeType, against the pairs cache.
+static auto benchKerning() -> void {
+  std::printf("  [8. kerning bench]\n");
+
+  const int ROUNDS = 2000;
+
+  FT_Library library = nullptr;
+  FT_Init_FreeType(&library);
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!library || !descr) {
+    FC_CHECK(false, "kerning bench setup");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  FontPtr font = TTF::Make(descr, library);
+  TTF    *ttf  = static_cast<TTF *>(font.get());
+
+  std::vector<Glyph *> glyphs;
+  for (const char *c = TEXT; c[1]; ++c) { glyphs.push_back(font->getGlyph(c[0], 12)); }
+  const std::size_t PAIRS = glyphs.size();
+
+  // Two sizes in turn, as the title and the text of a page.
+  int32_t sum   = 0;
+  auto    start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; ++r) {
+    for (std::size_t i = 0; i < PAIRS; ++i) {
+      sum += ttf->getKern(*glyphs[i], TEXT[i + 1], 12 + (i & 1));
+    }
+  }
+  double faceSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < ROUNDS; ++r) {
+    for (std::size_t i = 0; i < PAIRS; ++i) {
+      sum += font->getPairKern(*glyphs[i], TEXT[i + 1], 12 + (i & 1));
+    }
+  }
+  double cacheSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  KernProbeFont probe;
+  probe.setGlyphLoadMode(Font::GlyphLoadMode::METRICS_ONLY);
+  for (int r = 0; r < ROUNDS; ++r) {
+    for (const char *c = TEXT; c[1]; ++c) { probe.getGlyph(c[0], c[1], 12 + (r & 1)); }
+  }
+
+  FC_CHECK(sum == 0, "bench: no kerning in the fixture font");
+  FC_CHECK(font->getKernFaceCallCount() == 0, "bench: no FreeType kerning call");
+  FC_CHECK(probe.faceCalls <= 2 * PAIRS, "bench: face with kerning asked once per pair and size");
+
+  double total = (double)ROUNDS * PAIRS;
+  std::printf("    BENCH kerning pairs=%zu: FreeType=%.2f Mpairs/s cache=%.2f Mpairs/s (x%.1f); "
+              "face with kerning: %u face calls for %.0f pairs\n",
+              PAIRS, total / faceSecs / 1e6, total / cacheSecs / 1e6,
+              cacheSecs > 0 ? faceSecs / cacheSecs : 0.0, probe.faceCalls, total);
+
+  font.reset();
+  FT_Done_FreeType(library);
+}
+
+static auto testGlyphStore() -> void {
+  std::printf("  [9. shared glyph store]\n");
+
+  FT_Library library = nullptr;
+  FC_CHECK(FT_Init_FreeType(&library) == 0, "FreeType init succeeds for glyph store");
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!library || !descr) {
+    FC_CHECK(false, "glyph store setup");
+    if (library) FT_Done_FreeType(library);
+    return;
+  }
+
+  FontPtr reference = TTF::Make(descr, library);
+
+  glyphStore.setEnabled(true);
+  FontPtr viewer     = TTF::Make(descr, library);
+  FontPtr prefetcher = TTF::Make(descr, library);
+  FontPtr retriever  = TTF::Make(descr, library);
+  retriever->setGlyphLoadMode(Font::GlyphLoadMode::METRICS_ONLY);
+
+  for (const char *c = TEXT; *c; ++c) { viewer->getGlyph(*c, 12); }
+  uint32_t distinct = viewer->getRenderedGlyphCount();
+  FC_CHECK(distinct > 0 && viewer->getSharedGlyphCount() == 0, "first font renders the glyphs");
+
+  bool samePointers = true;
+  for (const char *c = TEXT; *c; ++c) {
+    samePointers = samePointers && (prefetcher->getGlyph(*c, 12) == viewer->getGlyph(*c, 12));
+  }
+  FC_CHECK(samePointers, "second font gets the glyphs of the first");
+  FC_CHECK(prefetcher->getRenderedGlyphCount() == 0, "second font renders nothing");
+  FC_CHECK(prefetcher->getSharedGlyphCount() == distinct, "second font counts shared glyphs");
+  FC_CHECK(prefetcher->getBytePoolsAllocatedBytes() == 0, "shared bitmaps not in the font pools");
+
+  for (const char *c = TEXT; *c; ++c) { retriever->getGlyph(*c, 12); }
+  FC_CHECK(retriever->getRenderedGlyphCount() == distinct,
+           "metrics only glyphs are not shared with bitmap ones");
+  FC_CHECK(glyphStore.getGlyphCount() == 2 * distinct, "store holds each glyph once per mode");
+
+  // Glyphs stay for as long as a font holds them.
+  std::size_t bytes = glyphStore.getBytes();
+  viewer->clearCache();
+  FC_CHECK(glyphStore.getBytes() == bytes, "glyphs held by another font are kept");
+
+  bool same = true;
+  for (const char *c = TEXT; *c; ++c) {
+    Glyph *a = prefetcher->getGlyph(*c, 12);
+    Glyph *b = reference->getGlyph(*c, 12);
+    same     = same && (a != nullptr) && (b != nullptr) && sameGlyph(*a, *b);
+  }
+  FC_CHECK(same, "shared glyphs same as the ones of a font of its own");
+
+  prefetcher->clearCache();
+  retriever->clearCache();
+  FC_CHECK(glyphStore.getGlyphCount() == 0 && glyphStore.getBytes() == 0,
+           "glyphs freed with the last font holding them");
+
+  // Eviction by a font leaves the glyphs of the others.
+  viewer->setGlyphCacheBudget(8 * 1024);
+  for (int size = 20; size <= 32; size += 4) {
+    for (char32_t c = 0x21; c < 0x7F; ++c) {
+      viewer->getGlyph(c, size);
+      prefetcher->getGlyph(c, size);
+    }
+  }
+  std::size_t glyphCount = glyphStore.getGlyphCount();
+  viewer->releaseGlyphs();
+  FC_CHECK(viewer->getGlyphCacheEvictions() > 0, "font over budget evicts");
+  FC_CHECK(glyphStore.getGlyphCount() == glyphCount, "evicted glyphs kept for the other font");
+
+  same = true;
+  for (int size = 20; size <= 32; size += 4) {
+    for (char32_t c = 0x21; c < 0x7F; ++c) {
+      Glyph *a = viewer->getGlyph(c, size);
+      Glyph *b = reference->getGlyph(c, size);
+      same     = same && (a != nullptr) && (b != nullptr) && sameGlyph(*a, *b) &&
+             (a == prefetcher->getGlyph(c, size));
+    }
+  }
+  FC_CHECK(same, "evicted glyphs found again in the store");
+  FC_CHECK(viewer->getRenderedGlyphCount() == distinct + 4 * 94,
+           "no glyph rendered twice");
+
+  viewer.reset();
+  prefetcher.reset();
+  retriever.reset();
+  FC_CHECK(glyphStore.getGlyphCount() == 0, "store empty once the fonts are gone");
+  glyphStore.setEnabled(false);
+
+  reference.reset();
+  FT_Done_FreeType(library);
+}
+
+// The viewer and the page prefetcher laying out the pages the user turns,
+// while page locations workers lay out the whole book, each in its own
+// thread with its own FreeType library, as the tasks of the application.
+// Run with and without the glyph store.
+static auto runSharedGlyphsSession(int pages, bool shared) -> void {
+  const int      WORKERS    = 2;
+  const int      PAGE_CHARS = 400;
+  const int16_t  SIZES[]    = { 10, 12, 18 }; // Text, notes, titles
+
+  auto descr = makeDescriptor("RobotoCondensed-Regular",
+                              "test/fixtures/config_data/fonts/RobotoCondensed-Regular.otf");
+  if (!descr) {
+    FC_CHECK(false, "shared glyphs session setup");
+    return;
+  }
+
+  glyphStore.setEnabled(shared);
+
+  struct Task {
+    bool metricsOnly;
+    int firstPage, step;
+    uint32_t rendered{ 0 };
+    std::size_t bytes{ 0 }; ///< Glyphs held by the font, and bitmap pools
+    bool ok{ true };
+  };
+  std::vector<Task> tasks = { { false, 0, 1 }, { false, 1, 1 } };
+  for (int w = 0; w < WORKERS; ++w) { tasks.push_back({ true, w, WORKERS }); }
+
+  // Every font stays until all tasks are done, as the EPub instances do.
+  std::atomic<int>        done{ 0 };
+  std::size_t             storeBytes = 0;
+  std::mutex              m;
+  std::condition_variable cv;
+
+  auto run = [&](Task &task) {
+    FT_Library library = nullptr;
+    FT_Init_FreeType(&library);
+    {
+      FontPtr font = TTF::Make(descr, library);
+      font->setGlyphCacheBudget(0);
+      if (task.metricsOnly) { font->setGlyphLoadMode(Font::GlyphLoadMode::METRICS_ONLY); }
+
+      for (int page = task.firstPage; page < pages; page += task.step) {
+        uint32_t seed = 977 * (page + 1);
+        for (int i = 0; i < PAGE_CHARS; ++i) {
+          seed          = seed * 1103515245 + 12345;
+          uint32_t r    = seed >> 16;
+          char32_t c    = (r % 8 == 0) ? 0xC0 + (r >> 3) % 0x40 : 0x20 + (r >> 3) % 0x5F;
+          int16_t  size = SIZES[(i % 40 == 0) ? 2 : (i % 10 == 0) ? 1 : 0];
+          Glyph   *g    = font->getGlyph(c, size);
+          if ((g == nullptr) && (c != 0xD7) && (c != 0xF7)) { task.ok = false; }
+          if ((g != nullptr) && (g->advance <= 0) && (c != ' ')) { task.ok = false; }
+        }
+      }
+
+      task.rendered = font->getRenderedGlyphCount();
+      task.bytes    = shared ? font->getBytePoolsAllocatedBytes()
+                             : font->getGlyphCacheResidentBytes();
+
+      std::unique_lock lock(m);
+      if (++done == (int)tasks.size()) { storeBytes = glyphStore.getBytes(); }
+      cv.notify_all();
+      cv.wait(lock, [&] { return done == (int)tasks.size(); });
+    }
+    FT_Done_FreeType(library);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::vector<std::thread> threads;
+    for (auto &task : tasks) { threads.emplace_back(run, std::ref(task)); }
+    for (auto &thread : threads) { thread.join(); }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  uint32_t    rendered = 0;
+  std::size_t bytes    = storeBytes;
+  bool        ok       = true;
+  for (auto &task : tasks) {
+    rendered += task.rendered;
+    bytes += task.bytes;
+    ok = ok && task.ok;
+  }
+
+  FC_CHECK(ok, shared ? "session with store: glyphs of all tasks valid"
+                      : "session without store: glyphs of all tasks valid");
+  FC_CHECK(glyphStore.getGlyphCount() == 0, "session: store empty after the tasks");
+
+  std::printf("    BENCH session pages=%d tasks=%zu store=%s: FreeType glyph loads=%u "
+              "glyph memory=%zu KB time=%.1f ms\n",
+              pages, tasks.size(), shared ? "on " : "off", rendered, bytes / 1024,
+              secs * 1000.0);
+
+  glyphStore.setEnabled(false);
+}
+
+static auto benchGlyphStore(int pages) -> void {
+  std::printf("  [10. glyph store session]\n");
+  runSharedGlyphsSession(pages, false);
+  runSharedGlyphsSession(pages, true);
+}
+
 } // namespace
 
 auto testFontsCache() -> TestStats {
@@ -212,6 +928,14 @@ auto testFontsCache() -> TestStats {
 
   testTtfCachePoolLifecycle();
   testTtfCacheChurnMonotonic();
+  testGlyphFiles();
+  benchGlyphFiles();
+  testGlyphCacheBudget();
+  runEvictionStress(60);
+  testKerningCache();
+  benchKerning();
+  testGlyphStore();
+  benchGlyphStore(20);
 
   std::printf("--- Fonts Cache: %d passed, %d failed ---\n", gPass, gFail);
   return TestStats{gPass, gFail};
@@ -224,6 +948,8 @@ auto testFontsCacheStress() -> TestStats {
   std::printf("\n=== Fonts Cache Stress Tests ===\n");
 
   runTtfChurnStress(100);
+  runEvictionStress(600);
+  benchGlyphStore(400);
 
   std::printf("--- Fonts Cache Stress: %d passed, %d failed ---\n", gPass, gFail);
   return TestStats{gPass, gFail};
@@ -0,0 +1,319 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for GlyphBlitter (components/inkplate_screen)
+//
+// Covers:
+//  • For the four orientations, 1 bit and 3 bits frame buffers, and two
+//    screen geometries, glyphs drawn by GlyphBlitter give the same frame
+//    buffer as the former pixel per pixel Screen::drawGlyph code, kept here
+//    as a reference
+//  • Glyphs clipped at the screen edges
+//  • Benchmark: painting the glyphs of a full page of text, pixel per pixel
+//    and with GlyphBlitter
+// ---------------------------------------------------------------------------
+
+#include "glyph_blitter.hpp"
+#include "test_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+using Orientation = GlyphBlitter::Orientation;
+
+static const Orientation ORIENTATIONS[] = { Orientation::LEFT, Orientation::RIGHT,
+                                            Orientation::BOTTOM, Orientation::TOP };
+
+static auto orientationName(Orientation o) -> const char * {
+  switch (o) {
+    case Orientation::LEFT:   return "LEFT";
+    case Orientation::RIGHT:  return "RIGHT";
+    case Orientation::BOTTOM: return "BOTTOM";
+    case Orientation::TOP:    return "TOP";
+  }
+  return "?";
+}
+
+// ---------------------------------------------------------------------------
+// A frame buffer with the Screen geometry of a device in a given orientation
+// ---------------------------------------------------------------------------
+struct TestScreen {
+  static constexpr int32_t SLACK = 16; // The TOP orientation may touch the byte past the end
+
+  uint16_t einkWidth, einkHeight;
+  Orientation orientation;
+  bool bits1;
+
+  uint16_t width, height, yOffset;
+  int32_t lineSize, dataSize;
+  std::vector<uint8_t> data;
+
+  TestScreen(uint16_t w, uint16_t h, Orientation o, bool b)
+    : einkWidth(w), einkHeight(h), orientation(o), bits1(b) {
+    bool portrait = (o == Orientation::LEFT) || (o == Orientation::RIGHT);
+    width         = portrait ? h : w;
+    height        = portrait ? w : h;
+    yOffset       = 0;
+    if (o == Orientation::TOP) {
+      yOffset = bits1 ? (((height + 7) & 0xFFF8) - height) : (((height + 1) & 0xFFFE) - height);
+    }
+    lineSize = bits1 ? (w >> 3) : (w >> 1);
+    dataSize = lineSize * h;
+    data.assign(dataSize + SLACK, bits1 ? 0 : 0x77);
+  }
+
+  auto frameBuffer() -> GlyphBlitter::FrameBuffer {
+    return { data.data(), lineSize, dataSize, yOffset };
+  }
+
+  // The former Screen::setPixelO* methods
+  auto setPixel1Bit(uint32_t col, uint32_t row) -> void {
+    static const uint8_t LUT1BIT[8]     = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    static const uint8_t LUT1BIT_INV[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+    switch (orientation) {
+      case Orientation::LEFT:
+        data[dataSize - (lineSize * (col + 1)) + (row >> 3)] |= LUT1BIT_INV[row & 7];
+        break;
+      case Orientation::RIGHT:
+        data[(lineSize * (col + 1)) - (row >> 3) - 1] |= LUT1BIT[row & 7];
+        break;
+      case Orientation::BOTTOM:
+        data[lineSize * row + (col >> 3)] |= LUT1BIT_INV[col & 7];
+        break;
+      case Orientation::TOP:
+        data[dataSize - (lineSize * row) - ((col + yOffset) >> 3)] |= LUT1BIT[(col + yOffset) & 7];
+        break;
+    }
+  }
+
+  auto setPixel3Bit(uint32_t col, uint32_t row, uint8_t color) -> void {
+    uint8_t *temp;
+    switch (orientation) {
+      case Orientation::LEFT:
+        temp  = &data[dataSize - (lineSize * (col + 1)) + (row >> 1)];
+        *temp = (row & 1) ? ((*temp & 0xF0) | color) : ((*temp & 0x0F) | (color << 4));
+        break;
+      case Orientation::RIGHT:
+        temp  = &data[(lineSize * (col + 1)) - (row >> 1) - 1];
+        *temp = (row & 1) ? ((*temp & 0x0F) | (color << 4)) : ((*temp & 0xF0) | color);
+        break;
+      case Orientation::BOTTOM:
+        temp  = &data[lineSize * row + (col >> 1)];
+        *temp = (col & 1) ? ((*temp & 0xF0) | color) : ((*temp & 0x0F) | (color << 4));
+        break;
+      case Orientation::TOP:
+        temp  = &data[dataSize - (lineSize * row) - ((col + yOffset) >> 1)];
+        *temp = ((col + yOffset) & 1) ? ((*temp & 0x0F) | (color << 4))
+                                      : ((*temp & 0xF0) | color);
+        break;
+    }
+  }
+
+  // The former Screen::drawGlyph
+  auto drawReference(const uint8_t *bitmap, int16_t w, int16_t h, int16_t x, int16_t y,
+                     uint16_t pitch) -> void {
+    static const uint8_t LUT1BIT[8] = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    int xMax = std::min<int>(x + w, width);
+    int yMax = std::min<int>(y + h, height);
+    if (bits1) {
+      for (uint32_t j = y, q = 0; j < (uint32_t)yMax; j++, q++) {
+        for (uint32_t i = x, p = (q * pitch) << 3; i < (uint32_t)xMax; i++, p++) {
+          if (bitmap[p >> 3] & LUT1BIT[p & 7]) { setPixel1Bit(i, j); }
+        }
+      }
+    } else {
+      for (uint32_t j = y, q = 0; j < (uint32_t)yMax; j++, q++) {
+        for (uint32_t i = x, p = q * pitch; i < (uint32_t)xMax; i++, p++) {
+          uint8_t v = 7 - (bitmap[p] >> 5);
+          if (v != 7) { setPixel3Bit(i, j, v); }
+        }
+      }
+    }
+  }
+
+  // The new Screen::drawGlyph
+  auto drawBlitter(const uint8_t *bitmap, int16_t w, int16_t h, int16_t x, int16_t y,
+                   uint16_t pitch) -> void {
+    int xMax = std::min<int>(x + w, width);
+    int yMax = std::min<int>(y + h, height);
+    if ((x < 0) || (y < 0) || (xMax <= x) || (yMax <= y)) { return; }
+    GlyphBlitter::drawGlyph(frameBuffer(), orientation, bits1, bitmap, pitch, x, y, xMax - x,
+                            yMax - y);
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Glyphs with random pixels
+// ---------------------------------------------------------------------------
+static uint32_t seed = 12345;
+
+static auto nextRandom() -> uint32_t {
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) & 0xFFFFFF;
+}
+
+struct TestGlyph {
+  int16_t width, height;
+  uint16_t pitch;
+  std::vector<uint8_t> bitmap;
+};
+
+static auto makeGlyph(int16_t w, int16_t h, bool bits1) -> TestGlyph {
+  TestGlyph g{ w, h, (uint16_t)(bits1 ? ((w + 7) >> 3) : w), {} };
+  g.bitmap.resize(g.pitch * h);
+  for (auto &b : g.bitmap) {
+    if (bits1) {
+      b = nextRandom() & 0xFF;
+    } else {
+      // Mostly white, as in a real glyph
+      uint32_t r = nextRandom();
+      b          = ((r & 3) == 0) ? 0 : ((r >> 4) & 0xFF);
+    }
+  }
+  if (bits1 && (w & 7)) {
+    // Garbage in the padding bits must not be drawn
+    for (int16_t q = 0; q < h; q++) { g.bitmap[q * g.pitch + g.pitch - 1] |= 0xFF >> (w & 7); }
+  }
+  return g;
+}
+
+// ============================================================
+// Same frame buffer as the reference code
+// ============================================================
+
+static void testSameAsReference(uint16_t einkWidth, uint16_t einkHeight) {
+  for (bool bits1 : { true, false }) {
+    for (Orientation o : ORIENTATIONS) {
+      TestScreen ref(einkWidth, einkHeight, o, bits1);
+      TestScreen blit(einkWidth, einkHeight, o, bits1);
+
+      int mismatches = 0;
+      for (int n = 0; n < 400; n++) {
+        TestGlyph g = makeGlyph(1 + (nextRandom() % 40), 1 + (nextRandom() % 40), bits1);
+
+        // Some glyphs cross the right and bottom edges, some are fully out.
+        int16_t x = nextRandom() % (ref.width + 8);
+        int16_t y = nextRandom() % (ref.height + 8);
+        if (n < 8) { x = ref.width - (n * 3); }
+        if ((n >= 8) && (n < 16)) { y = ref.height - ((n - 8) * 3); }
+        if (n == 16) { x = -3; }
+
+        ref.drawReference(g.bitmap.data(), g.width, g.height, x, y, g.pitch);
+        blit.drawBlitter(g.bitmap.data(), g.width, g.height, x, y, g.pitch);
+
+        if ((ref.data != blit.data) && (mismatches++ == 0)) {
+          std::printf("  %s %s %ux%u: first mismatch with glyph %d (%dx%d at %d,%d)\n",
+                      orientationName(o), bits1 ? "1 bit" : "3 bits", einkWidth, einkHeight, n,
+                      g.width, g.height, x, y);
+          blit.data = ref.data;
+        }
+      }
+      CHECK(mismatches == 0);
+    }
+  }
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+template <typename F>
+static auto bestOf(int runs, F f) -> double {
+  double best = 1e30;
+  for (int i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                  .count();
+    best = std::min(best, us);
+  }
+  return best;
+}
+
+static void benchFullPage() {
+  std::printf("  [benchmark: full page of glyphs, Inkplate 6 geometry]\n");
+
+  // 12 pt text: glyphs about 9 x 13 pixels, 11 pixels apart, lines 20 pixels apart.
+  for (bool bits1 : { true, false }) {
+    std::vector<TestGlyph> font;
+    for (int i = 0; i < 64; i++) { font.push_back(makeGlyph(7 + (i % 5), 10 + (i % 7), bits1)); }
+
+    for (Orientation o : ORIENTATIONS) {
+      TestScreen ref(800, 600, o, bits1);
+      TestScreen blit(800, 600, o, bits1);
+
+      struct Placed {
+        const TestGlyph *glyph;
+        int16_t x, y;
+      };
+      std::vector<Placed> page;
+      for (int16_t y = 10; (y + 20) < ref.height; y += 20) {
+        for (int16_t x = 10; (x + 11) < ref.width; x += 11) {
+          page.push_back({ &font[nextRandom() % font.size()], x, y });
+        }
+      }
+
+      auto paint = [&](TestScreen &screen, bool reference) {
+        std::fill(screen.data.begin(), screen.data.end(), bits1 ? 0 : 0x77);
+        for (const Placed &p : page) {
+          if (reference) {
+            screen.drawReference(p.glyph->bitmap.data(), p.glyph->width, p.glyph->height, p.x,
+                                 p.y, p.glyph->pitch);
+          } else {
+            screen.drawBlitter(p.glyph->bitmap.data(), p.glyph->width, p.glyph->height, p.x, p.y,
+                               p.glyph->pitch);
+          }
+        }
+      };
+
+      double refUs  = bestOf(10, [&] { paint(ref, true); });
+      double blitUs = bestOf(10, [&] { paint(blit, false); });
+
+      std::printf("  BENCH paint %zu glyphs, %-6s %-6s: %8.1f us (per pixel), %8.1f us (blitter)\n",
+                  page.size(), orientationName(o), bits1 ? "1 bit" : "3 bits", refUs, blitUs);
+
+      CHECK(ref.data == blit.data);
+      if (bits1 && (o == Orientation::BOTTOM)) { CHECK(blitUs < refUs); }
+    }
+  }
+}
+
+} // namespace
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testGlyphBlitter() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testSameAsReference(800, 600);  // Inkplate 6
+  testSameAsReference(1200, 825); // Inkplate 10: yOffset != 0 in the TOP orientation
+
+  benchFullPage();
+
+  std::printf("  GlyphBlitter: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
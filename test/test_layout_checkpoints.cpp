@@ -0,0 +1,549 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for LayoutCheckpoints and HTMLInterpreter resume
+//
+// Covers:
+//  • LayoutCheckpoints record / nearest / clear bookkeeping
+//  • A page location pass over a long chapter records one checkpoint per page
+//  • Every page laid out from its checkpoint is identical to the same page
+//    laid out by walking the chapter from the beginning
+//  • A checkpoint that does not match the item is rejected
+//  • A page instance reused with Page::rebind() lays out as a new one
+//  • Pages turned with the prefetcher running: its fonts keep to their glyph
+//    budget and the pages it handed over keep their glyphs
+//  • Benchmark: cost of laying out the first, middle and last page
+//  • Benchmark: himem allocations per page built, new page against reused
+//
+// The test binary must be run from the repository root so that the relative
+// path "test/fixtures/*.epub" resolves correctly.
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "config.hpp"
+#include "models/epub.hpp"
+#include "models/layout_checkpoints.hpp"
+#include "models/toc.hpp"
+#include "viewers/html_interpreter.hpp"
+#include "viewers/page_prefetcher.hpp"
+#include "test_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+static constexpr const char *LONG_CHAPTER    = "test/fixtures/long_chapter.epub";
+static constexpr const char *LETTERS_CHAPTER = "test/fixtures/letters_chapter.epub";
+
+using Step = LayoutCheckpoints::Step;
+using Path = LayoutCheckpoints::Path;
+
+struct PageSpan {
+  int32_t offset;
+  int32_t size;
+};
+
+// Page location pass, as done by PageLocsInterpreter, keeping the pages found.
+class LocationInterp : public HTMLInterpreter {
+  public:
+    LocationInterp(EPubPtr &theEpub, PagePtr &thePage, DOMPtr &theDom)
+      : HTMLInterpreter(theEpub, thePage, theDom, Page::ComputeMode::LOCATION,
+                        theEpub->getCurrentItemInfo()) {}
+
+    std::vector<PageSpan> pages;
+
+    auto docEnd(const Page::Format &fmt) -> void { (void)pageEndProcessing(fmt); }
+
+  protected:
+    auto pageEndProcessing(const Page::Format &fmt) -> bool override {
+      if (currentOffset > startOffset) {
+        pages.push_back(PageSpan{ startOffset, currentOffset - startOffset });
+      }
+      startOffset = currentOffset;
+      recordCheckpoint();
+      page->start(fmt, epub->getBookFormatParams()->columnCount);
+      return true;
+    }
+};
+
+// Single page layout, as done by BookViewer::buildPageAt().
+class ViewInterp : public HTMLInterpreter {
+  public:
+    ViewInterp(EPubPtr &theEpub, PagePtr &thePage, DOMPtr &theDom)
+      : HTMLInterpreter(theEpub, thePage, theDom, Page::ComputeMode::DISPLAY,
+                        theEpub->getCurrentItemInfo()) {}
+
+  protected:
+    auto pageEndProcessing(const Page::Format &) -> bool override { return true; }
+};
+
+static auto pageFormat(EPubPtr &epub) -> Page::Format {
+  int16_t idx;
+  if ((idx = epub->getFonts().getFontIndex("Fontbase", FaceStyle::NORMAL)) == -1) { idx = 3; }
+
+  return Page::Format{
+    .lineHeightFactor = epub->getLineHeightFactor(),
+    .fontIndex        = idx,
+    .fontSize         = epub->getBookFormatParams()->fontSize,
+    .screenTop        = 0,
+    .screenBottom     = 30,
+  };
+}
+
+static auto computeLocations(EPubPtr &epub, LayoutCheckpoints &store) -> std::vector<PageSpan> {
+  Page::Format fmt  = pageFormat(epub);
+  auto         page = Page::Make(epub->getFonts(), epub->getLanguage());
+  auto         dom  = DOM::Make(epub->getDomPools());
+
+  LocationInterp interp(epub, page, dom);
+  interp.setLimits(0, 9999999, false);
+  interp.setCheckpoints(&store);
+
+  xml_node node = epub->getCurrentItem().child("html").child("body");
+  page->start(fmt, epub->getBookFormatParams()->columnCount);
+  Page::Format *newFmt = interp.duplicateFmt(fmt);
+  if (interp.buildPagesRecurse(node, *newFmt, dom->body, 1)) {
+    if (page->someDataWaiting()) { page->endParagraph(fmt); }
+    interp.docEnd(fmt);
+  }
+  interp.releaseFmt(newFmt);
+
+  return interp.pages;
+}
+
+struct Layout {
+  bool resumeFailed{ false };
+  std::vector<DisplayListCommand> commands;
+  std::vector<Pos> positions;
+
+  auto operator==(const Layout &other) const -> bool {
+    if (commands != other.commands) { return false; }
+    if (positions.size() != other.positions.size()) { return false; }
+    for (size_t i = 0; i < positions.size(); ++i) {
+      if ((positions[i].x != other.positions[i].x) || (positions[i].y != other.positions[i].y)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// Lay out one page, from the beginning of the item or from a checkpoint path,
+// with a new page or with the one given, as kept by BookViewer::resetPage().
+static auto layoutPage(EPubPtr &epub, const PageSpan &span, const Path *resumePath,
+                       PagePtr *reused = nullptr) -> Layout {
+  Page::Format fmt = pageFormat(epub);
+  PagePtr      newPage;
+  if (reused != nullptr) {
+    (*reused)->rebind(epub->getLanguage());
+  } else {
+    newPage = Page::Make(epub->getFonts(), epub->getLanguage());
+  }
+  PagePtr &page = (reused != nullptr) ? *reused : newPage;
+  auto     dom  = DOM::Make(epub->getDomPools());
+
+  ViewInterp interp(epub, page, dom);
+  interp.setLimits(span.offset, span.offset + span.size, false);
+  if (resumePath != nullptr) { interp.resumeFrom(*resumePath); }
+
+  xml_node node = epub->getCurrentItem().child("html").child("body");
+  page->start(fmt, epub->getBookFormatParams()->columnCount);
+  Page::Format *newFmt = interp.duplicateFmt(fmt);
+  if (interp.buildPagesRecurse(node, *newFmt, dom->body, 1)) {
+    if (page->someDataWaiting()) { page->endParagraph(fmt); }
+  }
+  interp.releaseFmt(newFmt);
+
+  Layout layout;
+  layout.resumeFailed = interp.resumeFailed();
+  for (DisplayListEntry *entry : const_cast<DisplayList &>(page->getDisplayList())) {
+    layout.commands.push_back(entry->command);
+    layout.positions.push_back(entry->pos);
+  }
+  return layout;
+}
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testStore() {
+  std::printf("  [store bookkeeping]\n");
+
+  LayoutCheckpoints store;
+  Path              path;
+
+  CHECK(store.nearest(0, 100, path) == -1);
+  CHECK(path.empty());
+
+  Path a; a.push_back(Step{ 1, 10 }); a.push_back(Step{ 3, 90 });
+  Path b; b.push_back(Step{ 2, 300 });
+  Path c; c.push_back(Step{ 1, 10 }); c.push_back(Step{ 5, 150 }); c.push_back(Step{ 0, 160 });
+
+  // Recorded out of order, on two items.
+  store.record(2, 400, b);
+  store.record(2, 100, a);
+  store.record(2, 200, c);
+  store.record(0, 100, b);
+  CHECK(store.size() == 4);
+
+  // Already known offsets and empty paths are ignored.
+  store.record(2, 200, b);
+  store.record(3, 0, Path());
+  store.record(-1, 0, a);
+  CHECK(store.size() == 4);
+
+  CHECK(store.nearest(2, 99, path) == -1);
+  CHECK(store.nearest(2, 100, path) == 100);
+  CHECK((path.size() == 2) && (path[1].childIndex == 3) && (path[1].entryOffset == 90));
+  CHECK(store.nearest(2, 399, path) == 200);
+  CHECK((path.size() == 3) && (path[1].childIndex == 5) && (path[2].entryOffset == 160));
+  CHECK(store.nearest(2, 5000, path) == 400);
+  CHECK((path.size() == 1) && (path[0].entryOffset == 300));
+  CHECK(store.nearest(1, 5000, path) == -1);
+  CHECK(store.nearest(7, 5000, path) == -1);
+  CHECK(store.nearest(0, 100, path) == 100);
+
+  store.clear();
+  CHECK(store.size() == 0);
+  CHECK(store.nearest(2, 5000, path) == -1);
+}
+
+static void testResume(EPubPtr &epub) {
+  std::printf("  [resume from checkpoints]\n");
+
+  LayoutCheckpoints     store;
+  std::vector<PageSpan> pages = computeLocations(epub, store);
+
+  CHECK(pages.size() > 30);
+  CHECK(store.size() >= (pages.size() - 1));
+  if (pages.size() < 2) { return; }
+
+  int  mismatches = 0;
+  Path path;
+  for (size_t i = 1; i < pages.size(); ++i) {
+    if (store.nearest(0, pages[i].offset, path) != pages[i].offset) {
+      ++mismatches;
+      continue;
+    }
+    Layout resumed = layoutPage(epub, pages[i], &path);
+    Layout full    = layoutPage(epub, pages[i], nullptr);
+    if (resumed.resumeFailed || resumed.commands.empty() || !(resumed == full)) {
+      std::printf("  page %zu at offset %d differs from a complete walk\n", i, pages[i].offset);
+      ++mismatches;
+    }
+  }
+  CHECK(mismatches == 0);
+
+  // A checkpoint from another item layout must be rejected, not followed.
+  Path stale;
+  stale.push_back(Step{ 9999, 0 });
+  Layout rejected = layoutPage(epub, pages.back(), &stale);
+  CHECK(rejected.resumeFailed);
+
+  store.nearest(0, pages.back().offset, stale);
+  stale.back().entryOffset = pages.back().offset + 1;
+  rejected = layoutPage(epub, pages.back(), &stale);
+  CHECK(rejected.resumeFailed);
+}
+
+static void testPageReuse(EPubPtr &epub) {
+  std::printf("  [page reuse]\n");
+
+  LayoutCheckpoints     store;
+  std::vector<PageSpan> pages = computeLocations(epub, store);
+  if (pages.size() < 3) {
+    CHECK(false);
+    return;
+  }
+
+  // Pages laid out one after the other in the same instance, in both
+  // directions, as the reader turns them.
+  PagePtr page       = Page::Make(epub->getFonts(), epub->getLanguage());
+  int     mismatches = 0;
+  for (size_t i : { size_t(1), size_t(2), pages.size() / 2, size_t(2), size_t(1) }) {
+    Layout reused = layoutPage(epub, pages[i], nullptr, &page);
+    Layout fresh  = layoutPage(epub, pages[i], nullptr);
+    if (reused.commands.empty() || !(reused == fresh)) { ++mismatches; }
+  }
+  CHECK(mismatches == 0);
+
+  // Left in another compute mode and in multi-column mode, then rebound.
+  page->setComputeMode(Page::ComputeMode::LOCATION);
+  page->start(pageFormat(epub), 3);
+  page->rebind(epub->getLanguage());
+  CHECK(page->getComputeMode() == Page::ComputeMode::DISPLAY);
+  CHECK(page->getDisplayList().empty());
+  CHECK(layoutPage(epub, pages[1], nullptr, &page) == layoutPage(epub, pages[1], nullptr));
+
+  // The hyphenator follows the language.
+  const uint8_t *trie = page->getHyphenator()->getTrieData();
+  page->rebind("fr-CA");
+  CHECK(page->getHyphenator()->getTrieData() != trie);
+  const uint8_t *frTrie = page->getHyphenator()->getTrieData();
+  page->rebind("fr");
+  CHECK(page->getHyphenator()->getTrieData() == frTrie);
+  page->rebind(nullptr);
+  CHECK(page->getHyphenator()->getTrieData() == nullptr);
+  CHECK(page->usesFonts(epub->getFonts()));
+}
+
+// Digest of the glyphs shown by a page, to check they are left as they were.
+static auto glyphsDigest(const PagePtr &page) -> uint32_t {
+  uint32_t digest = 2166136261u;
+  auto     mix    = [&](uint32_t value) { digest = (digest ^ value) * 16777619u; };
+
+  for (DisplayListEntry *entry : const_cast<DisplayList &>(page->getDisplayList())) {
+    if (entry->command != DisplayListCommand::GLYPH) { continue; }
+    const Glyph *glyph = std::get<GlyphEntry>(entry->v).glyph;
+    mix(glyph->dim.width);
+    mix(glyph->dim.height);
+    mix(glyph->advance);
+    if (glyph->buffer != nullptr) {
+      for (int32_t i = 0; i < glyph->pitch * glyph->dim.height; ++i) { mix(glyph->buffer[i]); }
+    }
+  }
+  return digest;
+}
+
+// The pages of a chapter turned as done by BookViewer: the page shown is
+// taken from the prefetcher, the one it replaces is given back, and the
+// pages around it are requested. Each section of the chapter has its own
+// letters: the glyphs of the book do not fit in the budget of the
+// prefetcher's fonts, those of the pages in use do.
+static void testPrefetchGlyphBudget(EPubPtr &epub) {
+  std::printf("  [prefetcher glyph budget]\n");
+
+  static constexpr std::size_t BUDGET = 4 * 1024;
+
+  LayoutCheckpoints     store;
+  std::vector<PageSpan> pages = computeLocations(epub, store);
+  if (pages.size() < 30) {
+    CHECK(false);
+    return;
+  }
+
+  auto prefetcher = PagePrefetcher::Make();
+  prefetcher->setGlyphCacheBudget(BUDGET);
+  CHECK(prefetcher->start(LETTERS_CHAPTER));
+
+  auto target = [&](size_t i) {
+    return PagePrefetcher::Target{ PageId(0, pages[i].offset), pages[i].size };
+  };
+
+  PagePrefetcher::Target targets[PagePrefetcher::TARGET_COUNT] = { target(1), {} };
+  prefetcher->request(targets);
+
+  PagePtr  shown;
+  uint32_t shownDigest = 0;
+  int      missing     = 0;
+  int      altered     = 0;
+  for (size_t i = 1; i < pages.size() - 1; ++i) {
+    PagePtr page;
+    for (int wait = 0; (page = prefetcher->take(PageId(0, pages[i].offset))) == nullptr; ++wait) {
+      if (wait == 5000) { break; }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (page == nullptr) {
+      ++missing;
+      break;
+    }
+
+    // Other pages were built since this one was shown.
+    if (shown != nullptr) {
+      if (glyphsDigest(shown) != shownDigest) { ++altered; }
+      prefetcher->recycle(std::move(shown));
+    }
+    shown       = std::move(page);
+    shownDigest = glyphsDigest(shown);
+
+    targets[0] = target(i + 1);
+    targets[1] = target(i - 1);
+    prefetcher->request(targets);
+  }
+  CHECK(missing == 0);
+  CHECK(altered == 0);
+
+  PagePrefetcher::Stats stats = prefetcher->getStats();
+  std::printf("  BENCH prefetcher glyphs: %zu pages built, largest trimmed glyph cache %zu bytes "
+              "(budget %zu)\n",
+              (size_t)stats.builds, stats.glyphBytes, BUDGET);
+  CHECK(stats.builds >= pages.size() - 2);
+  CHECK((stats.glyphBytes > 0) && (stats.glyphBytes <= BUDGET));
+
+  prefetcher->recycle(std::move(shown));
+  prefetcher.reset();
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+template <typename F>
+static auto bestOf(int runs, F f) -> double {
+  double best = 1e30;
+  for (int i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                  .count();
+    best = std::min(best, us);
+  }
+  return best;
+}
+
+static void benchPagePosition(EPubPtr &epub) {
+  std::printf("  [benchmark: page position]\n");
+
+  LayoutCheckpoints     store;
+  std::vector<PageSpan> pages = computeLocations(epub, store);
+  if (pages.size() < 3) {
+    CHECK(false);
+    return;
+  }
+
+  // The very last page of the chapter is usually short: the one before it
+  // is used instead.
+  size_t          lastIdx = pages.size() - 2;
+  const PageSpan &first   = pages[1];
+  const PageSpan &middle  = pages[pages.size() / 2];
+  const PageSpan &last    = pages[lastIdx];
+
+  auto resumed = [&](const PageSpan &span) {
+    Path path;
+    store.nearest(0, span.offset, path);
+    return bestOf(5, [&] { (void)layoutPage(epub, span, &path); });
+  };
+
+  double firstUs     = resumed(first);
+  double middleUs    = resumed(middle);
+  double lastUs      = resumed(last);
+  double lastFullUs  = bestOf(5, [&] { (void)layoutPage(epub, last, nullptr); });
+  double firstFullUs = bestOf(5, [&] { (void)layoutPage(epub, first, nullptr); });
+
+  std::printf("  BENCH layout page 1 of %zu:   %8.1f us (checkpoint), %8.1f us (walk)\n",
+              pages.size(), firstUs, firstFullUs);
+  std::printf("  BENCH layout page %zu of %zu: %8.1f us (checkpoint)\n",
+              pages.size() / 2, pages.size(), middleUs);
+  std::printf("  BENCH layout page %zu of %zu: %8.1f us (checkpoint), %8.1f us (walk)\n",
+              lastIdx, pages.size(), lastUs, lastFullUs);
+
+  // Walking to the last page costs a pass over the whole chapter; resuming
+  // from its checkpoint must not.
+  CHECK(lastUs * 3 < lastFullUs);
+}
+
+// Allocations made to build a page, as a page turn without a prefetched
+// page: the item is already parsed.
+static void benchPageAllocations(EPubPtr &epub) {
+  std::printf("  [benchmark: page allocations]\n");
+
+  LayoutCheckpoints     store;
+  std::vector<PageSpan> pages = computeLocations(epub, store);
+  if (pages.size() < 12) {
+    CHECK(false);
+    return;
+  }
+
+  const size_t count = 10;
+  PagePtr      page  = Page::Make(epub->getFonts(), epub->getLanguage());
+  (void)layoutPage(epub, pages[1], nullptr, &page); // Pools at their working size
+
+  auto allocationsOf = [&](PagePtr *reused, double &us) {
+    uint32_t before = himemAllocationCount.load();
+    auto     start  = std::chrono::steady_clock::now();
+    for (size_t i = 1; i <= count; ++i) {
+      Path path;
+      store.nearest(0, pages[i].offset, path);
+      (void)layoutPage(epub, pages[i], &path, reused);
+    }
+    us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+           .count() / count;
+    return double(himemAllocationCount.load() - before) / count;
+  };
+
+  double freshUs, reusedUs;
+  double fresh  = allocationsOf(nullptr, freshUs);
+  double reused = allocationsOf(&page, reusedUs);
+
+  std::printf("  BENCH page allocations: %6.1f per page (new page, %.1f us), "
+              "%6.1f per page (reused, %.1f us)\n",
+              fresh, freshUs, reused, reusedUs);
+
+  CHECK(reused < fresh);
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+static auto openChapter(const char *filename) -> EPubPtr {
+  auto epub = EPub::Make();
+  CHECK(epub->open(filename));
+  CHECK(epub->getItemAtIndex(0));
+
+  // The location pass looks for ids in the TOC, as done by the page locations
+  // instance of the EPub. An empty one does it here.
+  epub->toc = TOC::Make();
+
+  // The config is not read by the test runner: use its default book format.
+  EPub::BookFormatParams *params = epub->getBookFormatParams();
+  params->fontSize       = 12;
+  params->lineHeight     = 1;
+  params->columnCount    = 1;
+  params->showPictures   = 0;
+  params->useFontsInBook = 0;
+
+  return epub;
+}
+
+auto testLayoutCheckpoints() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testStore();
+
+  // The book fonts come from the fonts DB of the config, loaded from
+  // test/fixtures/config_data when no other suite did it before.
+  FontsDB *fontsDB = nullptr;
+  config.get(Config::Ident::FONTS_DB, &fontsDB);
+  if ((fontsDB != nullptr) && (fontsDB->getFontFaceCount() == 0)) { fontsDB->load(0); }
+  CHECK((fontsDB != nullptr) && (fontsDB->getFontFaceCount() > 3));
+
+  auto epub = openChapter(LONG_CHAPTER);
+
+  if (failures == 0) {
+    testResume(epub);
+    testPageReuse(epub);
+    benchPagePosition(epub);
+    benchPageAllocations(epub);
+  }
+
+  epub->closeFile();
+
+  epub = openChapter(LETTERS_CHAPTER);
+  if (failures == 0) { testPrefetchGlyphBudget(epub); }
+  epub->closeFile();
+
+  std::printf("  LayoutCheckpoints: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
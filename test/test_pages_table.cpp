@@ -0,0 +1,221 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for PagesTable
+//
+// Covers:
+//  • Items appended out of order end up sorted by PageId
+//  • Span bookkeeping: firstOfItem / lastOfItem / presentItemCount
+//  • find() and findFloor() within an item
+//  • Re-appending a complete or partial item is idempotent
+//  • pushBackSorted() bulk loading and its ordering check
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "models/pages_table.hpp"
+#include "test_stats.hpp"
+
+#include <cstdio>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+using Entry = PagesTable::Entry;
+
+// Build the entries of one item: pageCount pages of 100 bytes each.
+static auto makeItem(int16_t itemref, int pageCount, Entry *out) -> uint32_t {
+  for (int i = 0; i < pageCount; ++i) {
+    out[i] = Entry{ .itemrefIndex = itemref, .offset = i * 100, .size = 100, .pageNumber = -1 };
+  }
+  return pageCount;
+}
+
+static auto isSorted(const PagesTable &table) -> bool {
+  for (int32_t i = 1; i < table.size(); ++i) {
+    const Entry &a = table[i - 1];
+    const Entry &b = table[i];
+    if ((a.itemrefIndex > b.itemrefIndex) ||
+        ((a.itemrefIndex == b.itemrefIndex) && (a.offset >= b.offset))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testOutOfOrderItems() {
+  std::printf("  [out of order items]\n");
+
+  PagesTable table;
+  Entry      buf[8];
+
+  CHECK(table.empty());
+  CHECK(table.presentItemCount() == 0);
+
+  CHECK(table.appendItem(3, buf, makeItem(3, 2, buf)) == 2);
+  CHECK(table.appendItem(0, buf, makeItem(0, 3, buf)) == 3);
+  CHECK(table.appendItem(5, buf, makeItem(5, 1, buf)) == 1);
+  CHECK(table.appendItem(1, buf, makeItem(1, 4, buf)) == 4);
+
+  CHECK(table.size() == 10);
+  CHECK(table.presentItemCount() == 4);
+  CHECK(isSorted(table));
+
+  CHECK(table.firstOfItem(0) == 0);
+  CHECK(table.lastOfItem(0) == 2);
+  CHECK(table.firstOfItem(1) == 3);
+  CHECK(table.lastOfItem(1) == 6);
+  CHECK(table.firstOfItem(3) == 7);
+  CHECK(table.lastOfItem(3) == 8);
+  CHECK(table.firstOfItem(5) == 9);
+  CHECK(table.lastOfItem(5) == 9);
+
+  CHECK(!table.itemIsPresent(2));
+  CHECK(!table.itemIsPresent(4));
+  CHECK(!table.itemIsPresent(6));
+  CHECK(!table.itemIsPresent(-1));
+  CHECK(table.firstOfItem(2) == PagesTable::NOT_FOUND);
+  CHECK(table.lastOfItem(4) == PagesTable::NOT_FOUND);
+
+  // Filling a gap must slide the following items only.
+  CHECK(table.appendItem(2, buf, makeItem(2, 2, buf)) == 2);
+  CHECK(isSorted(table));
+  CHECK(table.firstOfItem(1) == 3);
+  CHECK(table.firstOfItem(2) == 7);
+  CHECK(table.firstOfItem(3) == 9);
+  CHECK(table.firstOfItem(5) == 11);
+  CHECK(table.presentItemCount() == 5);
+}
+
+static void testFind() {
+  std::printf("  [find / findFloor]\n");
+
+  PagesTable table;
+  Entry      buf[8];
+
+  table.appendItem(2, buf, makeItem(2, 3, buf));
+  table.appendItem(0, buf, makeItem(0, 2, buf));
+
+  int32_t idx = table.find(PageId(2, 100));
+  CHECK(idx == 3);
+  CHECK(table.pageIdAt(idx) == PageId(2, 100));
+  CHECK(table.find(PageId(2, 150)) == PagesTable::NOT_FOUND);
+  CHECK(table.find(PageId(1, 0)) == PagesTable::NOT_FOUND);
+  CHECK(table.find(PageId(9, 0)) == PagesTable::NOT_FOUND);
+
+  CHECK(table.findFloor(PageId(2, 150)) == 3);
+  CHECK(table.findFloor(PageId(2, 200)) == 4);
+  CHECK(table.findFloor(PageId(2, 9999)) == 4);
+  CHECK(table.findFloor(PageId(0, 0)) == 0);
+  CHECK(table.findFloor(PageId(0, -1)) == PagesTable::NOT_FOUND);
+  CHECK(table.findFloor(PageId(1, 50)) == PagesTable::NOT_FOUND);
+}
+
+static void testIdempotentAppend() {
+  std::printf("  [idempotent append]\n");
+
+  PagesTable table;
+  Entry      buf[8];
+
+  table.appendItem(1, buf, makeItem(1, 2, buf));
+  table.appendItem(0, buf, makeItem(0, 2, buf));
+
+  // Partial computation of item 2, interrupted after two pages.
+  CHECK(table.appendItem(2, buf, makeItem(2, 2, buf)) == 2);
+  // The complete item is later merged: only the missing pages are added.
+  CHECK(table.appendItem(2, buf, makeItem(2, 5, buf)) == 3);
+  CHECK(table.lastOfItem(2) - table.firstOfItem(2) == 4);
+  // Merging it again changes nothing.
+  CHECK(table.appendItem(2, buf, makeItem(2, 5, buf)) == 0);
+  CHECK(table.size() == 9);
+  CHECK(table.presentItemCount() == 3);
+  CHECK(isSorted(table));
+
+  // Every entry of a merged item carries its itemref index.
+  makeItem(7, 2, buf);
+  table.appendItem(3, buf, 2);
+  CHECK(table[table.firstOfItem(3)].itemrefIndex == 3);
+
+  // Empty or invalid appends are ignored.
+  CHECK(table.appendItem(4, buf, 0) == 0);
+  CHECK(table.appendItem(-1, buf, 2) == 0);
+  CHECK(!table.itemIsPresent(4));
+
+  table.clear();
+  CHECK(table.empty());
+  CHECK(table.presentItemCount() == 0);
+  CHECK(!table.itemIsPresent(0));
+}
+
+static void testPushBackSorted() {
+  std::printf("  [pushBackSorted]\n");
+
+  PagesTable table;
+  table.reserve(6);
+
+  CHECK(table.pushBackSorted(Entry{ 1, 0, 100, 0 }));
+  CHECK(table.pushBackSorted(Entry{ 1, 100, 100, 1 }));
+  CHECK(table.pushBackSorted(Entry{ 4, 0, -20, -1 }));
+  CHECK(table.pushBackSorted(Entry{ 4, 20, 80, 2 }));
+
+  // Out of order entries are refused.
+  CHECK(!table.pushBackSorted(Entry{ 4, 20, 80, 3 }));
+  CHECK(!table.pushBackSorted(Entry{ 2, 0, 80, 3 }));
+  CHECK(!table.pushBackSorted(Entry{ -1, 0, 80, 3 }));
+
+  CHECK(table.size() == 4);
+  CHECK(table.presentItemCount() == 2);
+  CHECK(table.firstOfItem(1) == 0);
+  CHECK(table.lastOfItem(1) == 1);
+  CHECK(table.firstOfItem(4) == 2);
+  CHECK(table.lastOfItem(4) == 3);
+  CHECK(table.find(PageId(4, 20)) == 3);
+  CHECK(table[3].pageNumber == 2);
+
+  // An item computed after a bulk load must land before the loaded items
+  // that follow it.
+  Entry buf[4];
+  CHECK(table.appendItem(2, buf, makeItem(2, 2, buf)) == 2);
+  CHECK(isSorted(table));
+  CHECK(table.firstOfItem(2) == 2);
+  CHECK(table.firstOfItem(4) == 4);
+  CHECK(table.appendItem(0, buf, makeItem(0, 1, buf)) == 1);
+  CHECK(isSorted(table));
+  CHECK(table.firstOfItem(0) == 0);
+  CHECK(table.firstOfItem(1) == 1);
+  CHECK(table.find(PageId(4, 20)) == 6);
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testPagesTable() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testOutOfOrderItems();
+  testFind();
+  testIdempotentAppend();
+  testPushBackSorted();
+
+  std::printf("  PagesTable: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
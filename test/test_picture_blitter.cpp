@@ -0,0 +1,365 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for PictureBlitter (components/inkplate_screen)
+//
+// Covers:
+//  • For the four orientations, 1 bit and 3 bits frame buffers, 4 and 8 bits
+//    pictures, and two screen geometries, pictures drawn by PictureBlitter
+//    give the same frame buffer as the former pixel per pixel
+//    Screen::drawPicture code, kept here as a reference
+//  • Pictures clipped at the screen edges
+//  • Benchmark: drawing a 1200x825 picture, pixel per pixel and with
+//    PictureBlitter, in each orientation
+// ---------------------------------------------------------------------------
+
+#include "picture_blitter.hpp"
+#include "test_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+using Orientation = PictureBlitter::Orientation;
+
+static const Orientation ORIENTATIONS[] = { Orientation::LEFT, Orientation::RIGHT,
+                                            Orientation::BOTTOM, Orientation::TOP };
+
+static auto orientationName(Orientation o) -> const char * {
+  switch (o) {
+    case Orientation::LEFT:   return "LEFT";
+    case Orientation::RIGHT:  return "RIGHT";
+    case Orientation::BOTTOM: return "BOTTOM";
+    case Orientation::TOP:    return "TOP";
+  }
+  return "?";
+}
+
+// ---------------------------------------------------------------------------
+// Pictures
+// ---------------------------------------------------------------------------
+static uint32_t seed = 4242;
+
+static auto nextRandom() -> uint32_t {
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) & 0xFFFFFF;
+}
+
+struct TestPicture {
+  int16_t width, height;
+  uint8_t bpp;
+  uint16_t stride;
+  std::vector<uint8_t> bitmap;
+};
+
+/// A gradient with some noise, as a scanned or photographic picture.
+static auto makePicture(int16_t w, int16_t h, uint8_t bpp) -> TestPicture {
+  TestPicture pic{ w, h, bpp, (uint16_t)((bpp == 4) ? ((w + 1) >> 1) : w), {} };
+  pic.bitmap.resize(pic.stride * h);
+  for (int16_t j = 0; j < h; j++) {
+    for (int16_t i = 0; i < pic.stride; i++) {
+      int v = ((i * 255) / pic.stride + (j * 64) / h + (nextRandom() % 48)) & 0xFF;
+      if (bpp == 4) { v = (v & 0xF0) | ((nextRandom() % 16)); }
+      pic.bitmap[j * pic.stride + i] = v;
+    }
+  }
+  return pic;
+}
+
+// ---------------------------------------------------------------------------
+// A frame buffer with the Screen geometry of a device in a given orientation
+// ---------------------------------------------------------------------------
+struct TestScreen {
+  static constexpr int32_t SLACK = 16; // The TOP orientation may touch the byte past the end
+
+  Orientation orientation;
+  bool bits1;
+
+  uint16_t width, height, yOffset;
+  int32_t lineSize, dataSize;
+  std::vector<uint8_t> data;
+
+  TestScreen(uint16_t w, uint16_t h, Orientation o, bool b) : orientation(o), bits1(b) {
+    bool portrait = (o == Orientation::LEFT) || (o == Orientation::RIGHT);
+    width         = portrait ? h : w;
+    height        = portrait ? w : h;
+    yOffset       = 0;
+    if (o == Orientation::TOP) {
+      yOffset = bits1 ? (((height + 7) & 0xFFF8) - height) : (((height + 1) & 0xFFFE) - height);
+    }
+    lineSize = bits1 ? (w >> 3) : (w >> 1);
+    dataSize = lineSize * h;
+    fill();
+  }
+
+  auto fill() -> void {
+    // Not blank, as pictures must overwrite what is under them.
+    data.resize(dataSize + SLACK);
+    uint32_t s = 99;
+    for (auto &b : data) {
+      s = s * 1103515245u + 12345u;
+      b = s >> 16;
+    }
+  }
+
+  // The former Screen::setPixelO* methods
+  auto setPixel1Bit(uint32_t col, uint32_t row, uint8_t color) -> void {
+    static const uint8_t LUT1BIT[8]     = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+    static const uint8_t LUT1BIT_INV[8] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+    uint8_t *p;
+    uint8_t  mask;
+    switch (orientation) {
+      case Orientation::LEFT:
+        p    = &data[dataSize - (lineSize * (col + 1)) + (row >> 3)];
+        mask = LUT1BIT_INV[row & 7];
+        break;
+      case Orientation::RIGHT:
+        p    = &data[(lineSize * (col + 1)) - (row >> 3) - 1];
+        mask = LUT1BIT[row & 7];
+        break;
+      case Orientation::BOTTOM:
+        p    = &data[lineSize * row + (col >> 3)];
+        mask = LUT1BIT_INV[col & 7];
+        break;
+      default: // TOP
+        p    = &data[dataSize - (lineSize * row) - ((col + yOffset) >> 3)];
+        mask = LUT1BIT[(col + yOffset) & 7];
+        break;
+    }
+    if (color == 1) {
+      *p |= mask;
+    } else {
+      *p &= ~mask;
+    }
+  }
+
+  auto setPixel3Bit(uint32_t col, uint32_t row, uint8_t color) -> void {
+    uint8_t *temp;
+    switch (orientation) {
+      case Orientation::LEFT:
+        temp  = &data[dataSize - (lineSize * (col + 1)) + (row >> 1)];
+        *temp = (row & 1) ? ((*temp & 0xF0) | color) : ((*temp & 0x0F) | (color << 4));
+        break;
+      case Orientation::RIGHT:
+        temp  = &data[(lineSize * (col + 1)) - (row >> 1) - 1];
+        *temp = (row & 1) ? ((*temp & 0x0F) | (color << 4)) : ((*temp & 0xF0) | color);
+        break;
+      case Orientation::BOTTOM:
+        temp  = &data[lineSize * row + (col >> 1)];
+        *temp = (col & 1) ? ((*temp & 0xF0) | color) : ((*temp & 0x0F) | (color << 4));
+        break;
+      case Orientation::TOP:
+        temp  = &data[dataSize - (lineSize * row) - ((col + yOffset) >> 1)];
+        *temp = ((col + yOffset) & 1) ? ((*temp & 0x0F) | (color << 4))
+                                      : ((*temp & 0xF0) | color);
+        break;
+    }
+  }
+
+  // The former Screen::drawPicture
+  auto drawReference(const TestPicture &pic, int16_t x, int16_t y) -> void {
+    const uint8_t *bitmapData = pic.bitmap.data();
+
+    if (x > width) { x = 0; }
+    if (y > height) { y = 0; }
+
+    uint32_t xMax = std::min<uint32_t>(x + pic.width, width);
+    uint32_t yMax = std::min<uint32_t>(y + pic.height, height);
+
+    if (bits1) {
+      static int16_t err[1201];
+      int16_t        error;
+      memset(err, 0, sizeof(err));
+
+      for (uint32_t j = y, q = 0; j < yMax; j++, q++) {
+        for (uint32_t i = x, p = q * pic.stride, k = 0; i < (xMax - 1); i++, k++) {
+          int32_t v;
+          if (pic.bpp == 4) {
+            v = (((k & 1) ? (bitmapData[p] & 0x0F) : (bitmapData[p] >> 4)) << 4) + err[k + 1];
+            if (k & 1) { ++p; }
+          } else {
+            v = bitmapData[p++] + err[k + 1];
+          }
+          if (v > 128) {
+            error = (v - 255);
+            setPixel1Bit(i, j, 0);
+          } else {
+            error = v;
+            setPixel1Bit(i, j, 1);
+          }
+          if (k != 0) { err[k - 1] += error / 8; }
+          err[k] += 3 * error / 8;
+          err[k + 1] = error / 8;
+          err[k + 2] += 3 * error / 8;
+        }
+      }
+    } else {
+      for (uint32_t j = y, q = 0; j < yMax; j++, q++) {
+        for (uint32_t i = x, p = q * pic.stride, k = 0; i < xMax; i++, k++) {
+          uint8_t v;
+          if (pic.bpp == 4) {
+            v = (k & 1) ? ((bitmapData[p] & 0x0F) >> 1) : (bitmapData[p] >> 5);
+            if (k & 1) { ++p; }
+          } else {
+            v = bitmapData[p++] >> 5;
+          }
+          setPixel3Bit(i, j, v);
+        }
+      }
+    }
+  }
+
+  // The new Screen::drawPicture
+  auto drawBlitter(const TestPicture &pic, int16_t x, int16_t y) -> void {
+    if (x > width) { x = 0; }
+    if (y > height) { y = 0; }
+
+    int32_t xMax = std::min<int32_t>(x + pic.width, width);
+    int32_t yMax = std::min<int32_t>(y + pic.height, height);
+    int32_t cols = (bits1 ? xMax - 1 : xMax) - x;
+    int32_t rows = yMax - y;
+    if ((x < 0) || (y < 0) || (cols <= 0) || (rows <= 0)) { return; }
+
+    PictureBlitter::drawPicture({ data.data(), lineSize, dataSize, yOffset }, orientation, bits1,
+                                pic.bitmap.data(), pic.bpp, pic.stride, x, y, cols, rows);
+  }
+};
+
+// ============================================================
+// Same frame buffer as the reference code
+// ============================================================
+
+static void testSameAsReference(uint16_t einkWidth, uint16_t einkHeight) {
+  for (bool bits1 : { true, false }) {
+    for (uint8_t bpp : { 4, 8 }) {
+      for (Orientation o : ORIENTATIONS) {
+        TestScreen ref(einkWidth, einkHeight, o, bits1);
+        TestScreen blit(einkWidth, einkHeight, o, bits1);
+
+        int mismatches = 0;
+        for (int n = 0; n < 40; n++) {
+          TestPicture pic = makePicture(1 + (nextRandom() % 150), 1 + (nextRandom() % 150), bpp);
+
+          // Some pictures cross the right and bottom edges, some are out.
+          int16_t x = nextRandom() % (ref.width - 20);
+          int16_t y = nextRandom() % (ref.height - 20);
+          if (n < 4) { x = ref.width - (n * 7); }
+          if ((n >= 4) && (n < 8)) { y = ref.height - ((n - 4) * 7); }
+          if (n == 8) { x = ref.width + 3; }
+
+          ref.drawReference(pic, x, y);
+          blit.drawBlitter(pic, x, y);
+
+          if ((ref.data != blit.data) && (mismatches++ == 0)) {
+            std::printf("  %s %s %u bpp %ux%u: first mismatch with picture %d (%dx%d at %d,%d)\n",
+                        orientationName(o), bits1 ? "1 bit" : "3 bits", bpp, einkWidth,
+                        einkHeight, n, pic.width, pic.height, x, y);
+            blit.data = ref.data;
+          }
+        }
+        CHECK(mismatches == 0);
+      }
+    }
+  }
+}
+
+// A picture filling the whole screen, as a cover.
+static void testFullScreen() {
+  for (bool bits1 : { true, false }) {
+    for (uint8_t bpp : { 4, 8 }) {
+      for (Orientation o : ORIENTATIONS) {
+        TestScreen  ref(1200, 825, o, bits1);
+        TestScreen  blit(1200, 825, o, bits1);
+        TestPicture pic = makePicture(ref.width, ref.height, bpp);
+
+        ref.drawReference(pic, 0, 0);
+        blit.drawBlitter(pic, 0, 0);
+        CHECK(ref.data == blit.data);
+      }
+    }
+  }
+}
+
+// ============================================================
+// Benchmark
+// ============================================================
+
+template <typename F>
+static auto bestOf(int runs, F f) -> double {
+  double best = 1e30;
+  for (int i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+                  .count();
+    best = std::min(best, us);
+  }
+  return best;
+}
+
+static void benchFullPicture() {
+  std::printf("  [benchmark: 1200x825 picture, Inkplate 10 geometry]\n");
+
+  for (bool bits1 : { true, false }) {
+    for (uint8_t bpp : { 8, 4 }) {
+      TestPicture pic = makePicture(1200, 825, bpp);
+
+      for (Orientation o : ORIENTATIONS) {
+        TestScreen ref(1200, 825, o, bits1);
+        TestScreen blit(1200, 825, o, bits1);
+
+        // In the LEFT and RIGHT orientations, the screen is 825 pixels wide:
+        // the picture is clipped, as a cover scaled to the screen height.
+        double refUs  = bestOf(5, [&] { ref.drawReference(pic, 0, 0); });
+        double blitUs = bestOf(5, [&] { blit.drawBlitter(pic, 0, 0); });
+
+        std::printf("  BENCH picture %u bpp, %-6s %-6s: %9.1f us (per pixel), %9.1f us (blitter)\n",
+                    bpp, orientationName(o), bits1 ? "1 bit" : "3 bits", refUs, blitUs);
+
+        CHECK(ref.data == blit.data);
+        if (bits1 && (o == Orientation::BOTTOM)) { CHECK(blitUs < refUs); }
+      }
+    }
+  }
+}
+
+} // namespace
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testPictureBlitter() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testSameAsReference(800, 600);  // Inkplate 6
+  testSameAsReference(1200, 825); // Inkplate 10: yOffset != 0 in the TOP orientation
+  testFullScreen();
+
+  benchFullPicture();
+
+  std::printf("  PictureBlitter: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
@@ -0,0 +1,495 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for PictureCache
+//
+// Covers:
+//  • Hits and misses by path and size, 8 and 4 bits per pixel pictures
+//  • Pictures kept when the cache is closed and opened again
+//  • File of another book, of a modified book or corrupted is emptied
+//  • Least recently used pictures dropped beyond the capacity, room reclaimed
+//  • EPub::getSizedPicture() decoding once, then reading from the cache
+//  • Picture shown again: decode against cache read (BENCH)
+//
+// The book file content doesn't matter to the cache, only its size: the
+// cache tests use a dummy file. The EPub tests build a book with a gray PNG
+// picture, whose zlib stream is made of stored blocks (miniz is built
+// without its compressor).
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "models/epub.hpp"
+#include "models/picture_cache.hpp"
+#include "test_stats.hpp"
+
+#include "miniz.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+const char *const CACHE_FOLDER = "/tmp/epub_test_pics";
+
+const PictureCache::BinUUID UUID       = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+const PictureCache::BinUUID OTHER_UUID = { 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+
+auto bookPath() -> HimemString { return HimemString(CACHE_FOLDER) + "/book.epub"; }
+
+auto writeFile(const std::string &path, const Bytes &data) -> void {
+  std::ofstream(path, std::ios::binary)
+    .write(reinterpret_cast<const char *>(data.data()), data.size());
+}
+
+/// A picture whose pixels depend on seed.
+auto makePicture(Dim dim, uint8_t bpp, uint8_t seed) -> PicturePtr {
+  uint32_t size = (bpp == 4) ? ((dim.width + 1) >> 1) * dim.height : dim.width * dim.height;
+  Bytes    bitmap(size);
+  for (uint32_t i = 0; i < size; ++i) { bitmap[i] = (uint8_t)(i * 7 + seed); }
+  return Picture::Make(dim, bitmap.data(), size, bpp);
+}
+
+auto samePicture(const PicturePtr &a, const PicturePtr &b) -> bool {
+  if ((a == nullptr) || (b == nullptr)) { return false; }
+  Dim da = a->getDim(), db = b->getDim();
+  if ((da.width != db.width) || (da.height != db.height) ||
+      (a->getBitsPerPixel() != b->getBitsPerPixel())) {
+    return false;
+  }
+  uint32_t size = (a->getBitsPerPixel() == 4) ? ((da.width + 1) >> 1) * da.height
+                                              : da.width * da.height;
+  return memcmp(a->getBitmap(), b->getBitmap(), size) == 0;
+}
+
+auto fixed(Dim dim) -> PictureCache::TargetOf {
+  return [dim](Dim) { return dim; };
+}
+
+// ── EPUB with a gray PNG picture ─────────────────────────────────────────────
+
+auto putU32(Bytes &out, uint32_t v) -> void {
+  for (int s = 24; s >= 0; s -= 8) { out.push_back((v >> s) & 0xFF); }
+}
+
+auto putU16LE(Bytes &out, uint16_t v) -> void {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+auto putU32LE(Bytes &out, uint32_t v) -> void {
+  putU16LE(out, v & 0xFFFF);
+  putU16LE(out, v >> 16);
+}
+
+auto putChunk(Bytes &out, const char *type, const Bytes &data) -> void {
+  putU32(out, data.size());
+  Bytes body(type, type + 4);
+  body.insert(body.end(), data.begin(), data.end());
+  out.insert(out.end(), body.begin(), body.end());
+  putU32(out, mz_crc32(MZ_CRC32_INIT, body.data(), body.size()));
+}
+
+/// 8 bits gray, no filter, zlib stream of stored blocks.
+auto grayPng(uint32_t w, uint32_t h) -> Bytes {
+  Bytes raw;
+  for (uint32_t y = 0; y < h; ++y) {
+    raw.push_back(0);
+    for (uint32_t x = 0; x < w; ++x) { raw.push_back((x / 4 + y / 6) & 0xFF); }
+  }
+
+  Bytes zlib = { 0x78, 0x01 };
+  for (size_t pos = 0; pos < raw.size(); pos += 65535) {
+    uint16_t len = std::min<size_t>(65535, raw.size() - pos);
+    zlib.push_back((pos + len) == raw.size() ? 1 : 0);
+    putU16LE(zlib, len);
+    putU16LE(zlib, ~len);
+    zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + len);
+  }
+  putU32(zlib, mz_adler32(MZ_ADLER32_INIT, raw.data(), raw.size()));
+
+  Bytes png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  Bytes ihdr;
+  putU32(ihdr, w);
+  putU32(ihdr, h);
+  ihdr.insert(ihdr.end(), { 8, 0, 0, 0, 0 });
+  putChunk(png, "IHDR", ihdr);
+  putChunk(png, "IDAT", zlib);
+  putChunk(png, "IEND", {});
+  return png;
+}
+
+/// A zip file of stored (uncompressed) entries.
+auto storedZip(const std::vector<std::pair<std::string, Bytes>> &entries) -> Bytes {
+  Bytes zip, central;
+  for (const auto &[name, data] : entries) {
+    uint32_t crc    = mz_crc32(MZ_CRC32_INIT, data.data(), data.size());
+    uint32_t offset = zip.size();
+
+    putU32LE(zip, 0x04034b50);
+    for (uint16_t v : { 20, 0, 0, 0, 0 }) { putU16LE(zip, v); }
+    putU32LE(zip, crc);
+    putU32LE(zip, data.size());
+    putU32LE(zip, data.size());
+    putU16LE(zip, name.size());
+    putU16LE(zip, 0);
+    zip.insert(zip.end(), name.begin(), name.end());
+    zip.insert(zip.end(), data.begin(), data.end());
+
+    putU32LE(central, 0x02014b50);
+    for (uint16_t v : { 20, 20, 0, 0, 0, 0 }) { putU16LE(central, v); }
+    putU32LE(central, crc);
+    putU32LE(central, data.size());
+    putU32LE(central, data.size());
+    putU16LE(central, name.size());
+    for (uint16_t v : { 0, 0, 0, 0 }) { putU16LE(central, v); }
+    putU32LE(central, 0);
+    putU32LE(central, offset);
+    central.insert(central.end(), name.begin(), name.end());
+  }
+
+  uint32_t centralOffset = zip.size();
+  zip.insert(zip.end(), central.begin(), central.end());
+
+  putU32LE(zip, 0x06054b50);
+  putU16LE(zip, 0);
+  putU16LE(zip, 0);
+  putU16LE(zip, entries.size());
+  putU16LE(zip, entries.size());
+  putU32LE(zip, central.size());
+  putU32LE(zip, centralOffset);
+  putU16LE(zip, 0);
+  return zip;
+}
+
+auto asBytes(const char *str) -> Bytes { return Bytes(str, str + std::strlen(str)); }
+
+const char *const CONTAINER_XML =
+  "<?xml version=\"1.0\"?>\n"
+  "<container version=\"1.0\" xmlns=\"urn:oasis:names:tc:opendocument:xmlns:container\">\n"
+  "  <rootfiles><rootfile full-path=\"OEBPS/content.opf\" "
+  "media-type=\"application/oebps-package+xml\"/></rootfiles>\n"
+  "</container>\n";
+
+const char *const CONTENT_OPF =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<package xmlns=\"http://www.idpf.org/2007/opf\" version=\"2.0\" unique-identifier=\"uid\">\n"
+  "  <metadata xmlns:dc=\"http://purl.org/dc/elements/1.1/\">\n"
+  "    <dc:title>Pictures</dc:title>\n"
+  "    <dc:identifier id=\"uid\">urn:uuid:12345678-1234-1234-1234-123456789abe</dc:identifier>\n"
+  "  </metadata>\n"
+  "  <manifest>\n"
+  "    <item id=\"ch1\" href=\"ch1.xhtml\" media-type=\"application/xhtml+xml\"/>\n"
+  "    <item id=\"pic\" href=\"pic.png\" media-type=\"image/png\"/>\n"
+  "  </manifest>\n"
+  "  <spine><itemref idref=\"ch1\"/></spine>\n"
+  "</package>\n";
+
+const char *const CH1_XHTML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<html xmlns=\"http://www.w3.org/1999/xhtml\"><head><title>One</title></head>\n"
+  "<body><p><img src=\"pic.png\"/></p></body></html>\n";
+
+} // namespace
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testHitMiss() {
+  std::printf("  [hitMiss]\n");
+
+  CHECK(pictureCache.open(bookPath(), UUID));
+  CHECK(pictureCache.isOpenFor(bookPath()));
+  CHECK(std::filesystem::exists(PictureCache::filenameOf(bookPath()).c_str()));
+
+  PictureCache::Stats before = pictureCache.getStats();
+
+  Dim  srcDim(0, 0);
+  auto pict = pictureCache.get("OEBPS/a.png", fixed(Dim(100, 80)), srcDim);
+  CHECK(pict == nullptr);
+  CHECK(srcDim.width == 0);
+
+  auto a = makePicture(Dim(100, 80), 8, 1);
+  auto b = makePicture(Dim(51, 40), 4, 2);
+  CHECK(pictureCache.put("OEBPS/a.png", Dim(400, 320), *a));
+  CHECK(pictureCache.put("OEBPS/b.png", Dim(51, 40), *b));
+  CHECK(pictureCache.put("OEBPS/a.png", Dim(400, 320), *a)); // Already there
+
+  // The size on the page is computed from the decoded size.
+  Dim given(0, 0);
+  pict = pictureCache.get("OEBPS/a.png", [&given](Dim dim) {
+    given = dim;
+    return Dim(dim.width / 4, dim.height / 4);
+  }, srcDim);
+  CHECK(samePicture(pict, a));
+  CHECK((given.width == 400) && (given.height == 320));
+  CHECK((srcDim.width == 400) && (srcDim.height == 320));
+
+  pict = pictureCache.get("OEBPS/b.png", fixed(Dim(51, 40)), srcDim);
+  CHECK(samePicture(pict, b));
+
+  // Known picture, other size: a miss, but its decoded size is known.
+  srcDim = Dim(0, 0);
+  pict   = pictureCache.get("OEBPS/a.png", fixed(Dim(50, 40)), srcDim);
+  CHECK(pict == nullptr);
+  CHECK(srcDim.width == 400);
+
+  PictureCache::Stats stats = pictureCache.getStats();
+  CHECK(stats.hits - before.hits == 2);
+  CHECK(stats.misses - before.misses == 2);
+  CHECK(stats.count == 2);
+  CHECK(stats.bytes == 100 * 80 + 26 * 40);
+
+  pictureCache.close();
+  CHECK(!pictureCache.isOpenFor(bookPath()));
+  CHECK(pictureCache.get("OEBPS/a.png", fixed(Dim(100, 80)), srcDim) == nullptr);
+}
+
+static void testReopen() {
+  std::printf("  [reopen]\n");
+
+  CHECK(pictureCache.open(bookPath(), UUID));
+  CHECK(pictureCache.getStats().count == 2);
+
+  Dim srcDim(0, 0);
+  CHECK(samePicture(pictureCache.get("OEBPS/a.png", fixed(Dim(100, 80)), srcDim),
+                    makePicture(Dim(100, 80), 8, 1)));
+  CHECK(samePicture(pictureCache.get("OEBPS/b.png", fixed(Dim(51, 40)), srcDim),
+                    makePicture(Dim(51, 40), 4, 2)));
+  pictureCache.close();
+}
+
+static void testInvalidation() {
+  std::printf("  [invalidation]\n");
+
+  HimemString picsName = PictureCache::filenameOf(bookPath());
+
+  // Another book with the same file name
+  CHECK(pictureCache.open(bookPath(), OTHER_UUID));
+  CHECK(pictureCache.getStats().count == 0);
+  CHECK(pictureCache.put("OEBPS/a.png", Dim(100, 80), *makePicture(Dim(100, 80), 8, 1)));
+  pictureCache.close();
+
+  // The book was replaced by a version of another size
+  writeFile(bookPath().c_str(), Bytes(2048, 0));
+  CHECK(pictureCache.open(bookPath(), OTHER_UUID));
+  CHECK(pictureCache.getStats().count == 0);
+  CHECK(pictureCache.put("OEBPS/a.png", Dim(100, 80), *makePicture(Dim(100, 80), 8, 1)));
+  pictureCache.close();
+
+  // A corrupted index
+  {
+    std::fstream file(picsName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(40);
+    file.put(0x5A);
+  }
+  CHECK(pictureCache.open(bookPath(), OTHER_UUID));
+  CHECK(pictureCache.getStats().count == 0);
+  pictureCache.close();
+
+  // A truncated file
+  CHECK(pictureCache.open(bookPath(), OTHER_UUID));
+  CHECK(pictureCache.put("OEBPS/a.png", Dim(100, 80), *makePicture(Dim(100, 80), 8, 1)));
+  pictureCache.close();
+  std::filesystem::resize_file(picsName.c_str(), std::filesystem::file_size(picsName.c_str()) - 10);
+  CHECK(pictureCache.open(bookPath(), OTHER_UUID));
+  CHECK(pictureCache.getStats().count == 0);
+  pictureCache.close();
+}
+
+static void testEviction() {
+  std::printf("  [eviction]\n");
+
+  const uint32_t capacity = 40000;
+  const Dim      dim(100, 100); // 10000 bytes
+
+  std::filesystem::remove(PictureCache::filenameOf(bookPath()).c_str());
+  pictureCache.setCapacity(capacity);
+  CHECK(pictureCache.open(bookPath(), UUID));
+
+  // Too large for the cache
+  CHECK(!pictureCache.put("big.png", Dim(101, 100), *makePicture(Dim(101, 100), 8, 0)));
+
+  auto name = [](int i) { return HimemString("p") + std::to_string(i).c_str() + ".png"; };
+
+  Dim srcDim;
+  for (int i = 0; i < 4; ++i) { CHECK(pictureCache.put(name(i), dim, *makePicture(dim, 8, i))); }
+  CHECK(pictureCache.get(name(0), fixed(dim), srcDim) != nullptr); // p1 is now the oldest used
+
+  CHECK(pictureCache.put(name(4), dim, *makePicture(dim, 8, 4)));
+  CHECK(pictureCache.get(name(1), fixed(dim), srcDim) == nullptr);
+  CHECK(samePicture(pictureCache.get(name(0), fixed(dim), srcDim), makePicture(dim, 8, 0)));
+
+  // Many more pictures: the dropped ones leave room to be reclaimed.
+  bool allKept = true;
+  for (int i = 5; i < 60; ++i) {
+    CHECK(pictureCache.put(name(i), dim, *makePicture(dim, 8, i)));
+    PictureCache::Stats stats = pictureCache.getStats();
+    allKept = allKept && (stats.bytes <= capacity) && (stats.count == 4);
+  }
+  CHECK(allKept);
+
+  auto fileSize = std::filesystem::file_size(PictureCache::filenameOf(bookPath()).c_str());
+  CHECK(fileSize <= 8192 + capacity + capacity / 2 + 10000);
+
+  pictureCache.close();
+  CHECK(pictureCache.open(bookPath(), UUID));
+  bool allThere = true;
+  for (int i = 56; i < 60; ++i) {
+    allThere =
+      allThere && samePicture(pictureCache.get(name(i), fixed(dim), srcDim), makePicture(dim, 8, i));
+  }
+  CHECK(allThere);
+  pictureCache.close();
+
+  pictureCache.setCapacity(PictureCache::CAPACITY);
+}
+
+// The picture is kept at its decoded size: Picture::resize() is a stub in
+// the test build.
+static void testEPub() {
+  std::printf("  [epub]\n");
+
+  const uint32_t w = 400, h = 600;
+
+  std::string path = std::string(CACHE_FOLDER) + "/pictures.epub";
+  writeFile(path, storedZip({
+    {"mimetype", asBytes("application/epub+zip")},
+    {"META-INF/container.xml", asBytes(CONTAINER_XML)},
+    {"OEBPS/content.opf", asBytes(CONTENT_OPF)},
+    {"OEBPS/ch1.xhtml", asBytes(CH1_XHTML)},
+    {"OEBPS/pic.png", grayPng(w, h)},
+  }));
+
+  auto identity = [](Dim dim) { return dim; };
+
+  for (int round = 0; round < 2; ++round) {
+    auto epub = EPub::Make();
+    CHECK(epub->open(path.c_str()));
+
+    PictureCache::Stats before = pictureCache.getStats();
+
+    HimemString fname = "pic.png";
+    Dim         srcDim(0, 0);
+    auto        first = epub->getSizedPicture(fname, identity, srcDim);
+    CHECK(first != nullptr);
+    CHECK((srcDim.width == w) && (srcDim.height == h));
+
+    srcDim      = Dim(0, 0);
+    auto second = epub->getSizedPicture(fname, identity, srcDim);
+    CHECK(samePicture(first, second));
+    CHECK((srcDim.width == w) && (srcDim.height == h));
+
+    // Decoded once, from the first book opening only.
+    PictureCache::Stats stats = pictureCache.getStats();
+    CHECK(stats.misses - before.misses == (round == 0 ? 1 : 0));
+    CHECK(stats.hits - before.hits == (round == 0 ? 1 : 2));
+
+    epub->closeFile();
+    CHECK(!pictureCache.isOpenFor(path.c_str()));
+  }
+}
+
+// ── benchmark ────────────────────────────────────────────────────────────────
+// A 1200x1600 picture shown again: decoded and resized from the book against
+// read from the cache file.
+static void testBench() {
+  std::printf("  [bench]\n");
+
+  std::string path = std::string(CACHE_FOLDER) + "/bench.epub";
+  writeFile(path, storedZip({
+    {"mimetype", asBytes("application/epub+zip")},
+    {"META-INF/container.xml", asBytes(CONTAINER_XML)},
+    {"OEBPS/content.opf", asBytes(CONTENT_OPF)},
+    {"OEBPS/ch1.xhtml", asBytes(CH1_XHTML)},
+    {"OEBPS/pic.png", grayPng(1200, 1600)},
+  }));
+
+  auto epub = EPub::Make();
+  CHECK(epub->open(path.c_str()));
+
+  const int   rounds = 10;
+  HimemString fname  = "pic.png";
+  Dim         srcDim;
+  auto        identity = [](Dim dim) { return dim; };
+
+  auto start  = std::chrono::steady_clock::now();
+  int  decoded = 0;
+  for (int i = 0; i < rounds; ++i) {
+    if (epub->getPicture(fname, true) != nullptr) { ++decoded; }
+  }
+  double decodeSecs =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  epub->getSizedPicture(fname, identity, srcDim); // Fills the cache
+
+  PictureCache::Stats before = pictureCache.getStats();
+  start                      = std::chrono::steady_clock::now();
+  int cached                 = 0;
+  for (int i = 0; i < rounds; ++i) {
+    if (epub->getSizedPicture(fname, identity, srcDim) != nullptr) { ++cached; }
+  }
+  double cacheSecs =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK((decoded == rounds) && (cached == rounds));
+  CHECK(pictureCache.getStats().hits - before.hits == rounds);
+
+  std::printf("    BENCH png=1200x1600 out=%ux%u decode=%.2f ms cache=%.2f ms (x%.1f)\n",
+              srcDim.width, srcDim.height, decodeSecs * 1000.0 / rounds,
+              cacheSecs * 1000.0 / rounds, cacheSecs > 0 ? decodeSecs / cacheSecs : 0.0);
+
+  epub->closeFile();
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testPictureCache() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  std::error_code ec;
+  std::filesystem::remove_all(CACHE_FOLDER, ec);
+  CHECK(std::filesystem::create_directory(CACHE_FOLDER, ec));
+  writeFile(bookPath().c_str(), Bytes(1024, 0));
+
+  if (failures == 0) {
+    testHitMiss();
+    testReopen();
+    testInvalidation();
+    testEviction();
+    testEPub();
+    testBench();
+  }
+
+  std::filesystem::remove_all(CACHE_FOLDER, ec);
+
+  std::printf("  Picture cache: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
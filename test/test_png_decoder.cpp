@@ -0,0 +1,629 @@
+// Copyright (c) 2026 Guy Turcotte
+//
+// MIT License. Look at file licenses.txt for details.
+
+// ---------------------------------------------------------------------------
+// Test suite for the row output of the PNG decoder (mypngle)
+//
+// Covers:
+//  • Gray rows for all color types and bit depths, alpha and tRNS applied
+//  • The five scanline filters
+//  • Box filtered downscaling against a reference average
+//  • Data fed in small pieces, interlaced pictures rejected
+//  • Draw callback vs row output on a large picture (BENCH)
+//  • Cover extraction of a book with a large PNG cover (BENCH)
+//
+// The pictures are encoded by the test itself, with the filter of each
+// scanline chosen by the test. The miniz of the project has no compressor:
+// the zlib streams are made of stored blocks, inflate is then a copy and the
+// benchmarks measure what comes after it.
+// ---------------------------------------------------------------------------
+
+#include "global.hpp"
+#include "models/books_scanner.hpp"
+#include "mypngle.hpp"
+#include "test_stats.hpp"
+
+#include "miniz.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Minimal check helpers (same style as the other test suites)
+// ---------------------------------------------------------------------------
+static int checks   = 0;
+static int failures = 0;
+
+#define CHECK(cond)                                                                                \
+  do {                                                                                             \
+    ++checks;                                                                                      \
+    if (!(cond)) {                                                                                 \
+      ++failures;                                                                                  \
+      std::printf("  FAIL [%s:%d]: %s\n", __FILE__, __LINE__, #cond);                              \
+    }                                                                                              \
+  } while (0)
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+// ── PNG encoder ──────────────────────────────────────────────────────────────
+
+struct PngImage {
+  uint32_t width{0};
+  uint32_t height{0};
+  uint8_t colorType{0};
+  uint8_t depth{8};
+  std::vector<uint16_t> samples{}; ///< width * height * channels values
+  Bytes palette{};                 ///< RGB triples (color type 3)
+  Bytes trns{};                    ///< tRNS chunk content, if any
+};
+
+auto channelsOf(uint8_t colorType) -> uint8_t {
+  switch (colorType) {
+    case 2: return 3;
+    case 4: return 2;
+    case 6: return 4;
+    default: return 1;
+  }
+}
+
+auto putU32(Bytes &out, uint32_t v) -> void {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+auto putU16(Bytes &out, uint16_t v) -> void {
+  out.push_back(v);
+  out.push_back(v >> 8);
+}
+
+auto putU32LE(Bytes &out, uint32_t v) -> void {
+  putU16(out, v & 0xFFFF);
+  putU16(out, v >> 16);
+}
+
+auto putChunk(Bytes &out, const char *type, const Bytes &data) -> void {
+  putU32(out, data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  putU32(out, mz_crc32(MZ_CRC32_INIT, &out[start], out.size() - start));
+}
+
+auto paethPredictor(int a, int b, int c) -> int {
+  int p  = a + b - c;
+  int pa = std::abs(p - a);
+  int pb = std::abs(p - b);
+  int pc = std::abs(p - c);
+  if ((pa <= pb) && (pa <= pc)) return a;
+  if (pb <= pc) return b;
+  return c;
+}
+
+/// A zlib stream of stored deflate blocks.
+auto zlibStored(const Bytes &data) -> Bytes {
+  Bytes out = {0x78, 0x01};
+  size_t pos = 0;
+  do {
+    size_t n = std::min<size_t>(65535, data.size() - pos);
+    out.push_back((pos + n) == data.size() ? 1 : 0);
+    putU16(out, n);
+    putU16(out, ~n);
+    out.insert(out.end(), data.begin() + pos, data.begin() + pos + n);
+    pos += n;
+  } while (pos < data.size());
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  putU32(out, (b << 16) | a);
+  return out;
+}
+
+/// Scanlines of the image, each filtered with filterOf(y). interlaced only sets
+/// the IHDR flag: the data is not reordered.
+auto encodePng(const PngImage &img, int (*filterOf)(uint32_t y), bool interlaced = false)
+    -> Bytes {
+  const uint8_t channels = channelsOf(img.colorType);
+  const size_t stride    = (size_t(img.width) * channels * img.depth + 7) / 8;
+  const size_t bpp       = (channels * img.depth + 7) / 8;
+
+  Bytes raw;
+  raw.reserve((stride + 1) * img.height);
+  Bytes prev(stride, 0), cur(stride);
+
+  for (uint32_t y = 0; y < img.height; ++y) {
+    std::fill(cur.begin(), cur.end(), 0);
+    size_t idx = 0;
+    for (uint32_t x = 0; x < img.width; ++x) {
+      for (uint8_t c = 0; c < channels; ++c, ++idx) {
+        uint16_t v = img.samples[idx + size_t(y) * img.width * channels];
+        if (img.depth == 16) {
+          cur[idx * 2]     = v >> 8;
+          cur[idx * 2 + 1] = v & 0xFF;
+        } else if (img.depth == 8) {
+          cur[idx] = v;
+        } else {
+          size_t bit = idx * img.depth;
+          cur[bit >> 3] |= v << (8 - img.depth - (bit & 7));
+        }
+      }
+    }
+
+    int filter = filterOf(y);
+    raw.push_back(filter);
+    for (size_t i = 0; i < stride; ++i) {
+      int a = (i >= bpp) ? cur[i - bpp] : 0;
+      int b = prev[i];
+      int c = (i >= bpp) ? prev[i - bpp] : 0;
+      int p = 0;
+      switch (filter) {
+        case 1: p = a; break;
+        case 2: p = b; break;
+        case 3: p = (a + b) / 2; break;
+        case 4: p = paethPredictor(a, b, c); break;
+        default: break;
+      }
+      raw.push_back(uint8_t(cur[i] - p));
+    }
+    prev.swap(cur);
+  }
+
+  Bytes zdata = zlibStored(raw);
+
+  Bytes png = {137, 80, 78, 71, 13, 10, 26, 10};
+
+  Bytes ihdr;
+  putU32(ihdr, img.width);
+  putU32(ihdr, img.height);
+  ihdr.insert(ihdr.end(), {img.depth, img.colorType, 0, 0, uint8_t(interlaced ? 1 : 0)});
+  putChunk(png, "IHDR", ihdr);
+
+  if (!img.palette.empty()) putChunk(png, "PLTE", img.palette);
+  if (!img.trns.empty()) putChunk(png, "tRNS", img.trns);
+
+  // Many IDAT chunks, as written by most encoders
+  for (size_t pos = 0; pos < zdata.size(); pos += 8192) {
+    size_t n = std::min<size_t>(8192, zdata.size() - pos);
+    putChunk(png, "IDAT", Bytes(zdata.begin() + pos, zdata.begin() + pos + n));
+  }
+  putChunk(png, "IEND", {});
+
+  return png;
+}
+
+// ── Reference ────────────────────────────────────────────────────────────────
+
+auto overWhite(uint32_t pix, uint32_t alpha) -> uint8_t {
+  return (alpha * pix + (255 - alpha) * 255) / 255;
+}
+
+/// Gray of each pixel, as expected from the decoder.
+auto referenceGray(const PngImage &img) -> Bytes {
+  const uint8_t channels = channelsOf(img.colorType);
+  const uint32_t maxval  = (1U << img.depth) - 1;
+
+  Bytes gray(size_t(img.width) * img.height);
+  for (size_t i = 0; i < gray.size(); ++i) {
+    const uint16_t *v = &img.samples[i * channels];
+
+    if (img.colorType == 3) {
+      uint32_t pix   = (img.palette[v[0] * 3] + img.palette[v[0] * 3 + 1] +
+                      img.palette[v[0] * 3 + 2]) / 3;
+      uint32_t alpha = (v[0] < img.trns.size()) ? img.trns[v[0]] : 255;
+      gray[i]        = overWhite(pix, alpha);
+      continue;
+    }
+
+    bool color     = (img.colorType & 2) != 0;
+    uint32_t pix   = color ? (v[0] + v[1] + v[2]) / 3 : v[0];
+    uint32_t alpha = maxval;
+    if (img.colorType & 4) {
+      alpha = v[channels - 1];
+    } else if (!img.trns.empty()) {
+      bool match = true;
+      for (uint8_t c = 0; c < (color ? 3 : 1); ++c) {
+        match = match && (v[c] == ((img.trns[c * 2] << 8) | img.trns[c * 2 + 1]));
+      }
+      if (match) alpha = 0;
+    }
+    gray[i] = overWhite((pix * 255 + maxval / 2) / maxval, (alpha * 255 + maxval / 2) / maxval);
+  }
+  return gray;
+}
+
+/// Box average of gray into outW x outH pixels.
+auto referenceBox(const Bytes &gray, uint32_t w, uint32_t h, uint32_t outW, uint32_t outH)
+    -> Bytes {
+  auto first = [](uint64_t o, uint64_t n, uint64_t outN) { return uint32_t((o * n + outN - 1) / outN); };
+
+  Bytes out(size_t(outW) * outH);
+  for (uint32_t oy = 0; oy < outH; ++oy) {
+    for (uint32_t ox = 0; ox < outW; ++ox) {
+      uint32_t sum = 0, count = 0;
+      for (uint32_t y = first(oy, h, outH); y < first(oy + 1, h, outH); ++y) {
+        for (uint32_t x = first(ox, w, outW); x < first(ox + 1, w, outW); ++x) {
+          sum += gray[size_t(y) * w + x];
+          ++count;
+        }
+      }
+      out[size_t(oy) * outW + ox] = (sum + count / 2) / count;
+    }
+  }
+  return out;
+}
+
+// ── Decoding ─────────────────────────────────────────────────────────────────
+
+struct RowSink {
+  uint32_t width{0}; ///< Set by the first row
+  uint32_t nextRow{0};
+  bool inOrder{true};
+  Bytes pixels{};
+};
+
+auto onRow(pngle_t *pngle, uint32_t y, const uint8_t *row, uint32_t w) -> void {
+  auto *sink = static_cast<RowSink *>(mypngle_get_user_data(pngle));
+  if (y == 0) sink->width = w;
+  sink->inOrder = sink->inOrder && (y == sink->nextRow) && (w == sink->width);
+  sink->nextRow = y + 1;
+  sink->pixels.insert(sink->pixels.end(), row, row + w);
+}
+
+/// Feed the PNG piece by piece, keeping what the decoder did not consume.
+auto feed(pngle_t *pngle, const Bytes &png, size_t piece) -> bool {
+  Bytes pending;
+  for (size_t pos = 0; pos < png.size(); pos += piece) {
+    pending.insert(pending.end(), png.begin() + pos,
+                   png.begin() + std::min(png.size(), pos + piece));
+    int res = mypngle_feed(pngle, pending.data(), pending.size());
+    if (res < 0) return false;
+    pending.erase(pending.begin(), pending.begin() + res);
+  }
+  return true;
+}
+
+/// Rows of the PNG decoded at outW x outH. Empty on error.
+auto decodeRows(const Bytes &png, uint32_t outW, uint32_t outH, size_t piece = 4096) -> Bytes {
+  RowSink sink;
+
+  pngle_t *pngle = mypngle_new();
+  mypngle_set_user_data(pngle, &sink);
+  mypngle_set_row_callback(pngle, outW, outH, onRow);
+  bool ok = feed(pngle, png, piece);
+  mypngle_destroy(pngle);
+
+  if (!ok || !sink.inOrder) return {};
+  return sink.pixels;
+}
+
+// The draw callback of PngPicture for interlaced pictures: one call per pixel,
+// coordinates shifted down to the picture size.
+struct DrawSink {
+  uint32_t width{0};
+  uint32_t height{0};
+  uint8_t scale{0};
+  Bytes pixels{};
+};
+
+auto onDraw(pngle_t *pngle, uint32_t x, uint32_t y, uint8_t pix, uint8_t alpha) -> void {
+  auto *sink = static_cast<DrawSink *>(mypngle_get_user_data(pngle));
+  x >>= sink->scale;
+  y >>= sink->scale;
+  if ((x < sink->width) && (y < sink->height)) {
+    sink->pixels[size_t(y) * sink->width + x] = (uint16_t(alpha) * pix / 255) + (255 - alpha);
+  }
+}
+
+auto makeImage(uint32_t w, uint32_t h, uint8_t colorType, uint8_t depth) -> PngImage {
+  PngImage img{w, h, colorType, depth};
+  const uint8_t channels = channelsOf(colorType);
+  const uint32_t maxval  = (colorType == 3) ? 3 : (1U << depth) - 1;
+  img.samples.resize(size_t(w) * h * channels);
+  for (uint32_t y = 0; y < h; ++y) {
+    for (uint32_t x = 0; x < w; ++x) {
+      for (uint8_t c = 0; c < channels; ++c) {
+        uint32_t v = (x * 7 + y * 13 + c * 101 + ((x * y) % 17) * 29) * 2654435761U;
+        img.samples[(size_t(y) * w + x) * channels + c] = (v >> 7) % (maxval + 1);
+      }
+    }
+  }
+  return img;
+}
+
+auto filterByRow(uint32_t y) -> int { return y % 5; }
+auto filterPaeth(uint32_t) -> int { return 4; }
+
+// ── EPUB with a PNG cover ────────────────────────────────────────────────────
+
+/// A zip file of stored (uncompressed) entries.
+auto storedZip(const std::vector<std::pair<std::string, Bytes>> &entries) -> Bytes {
+  Bytes zip, central;
+  for (const auto &[name, data] : entries) {
+    uint32_t crc    = mz_crc32(MZ_CRC32_INIT, data.data(), data.size());
+    uint32_t offset = zip.size();
+
+    putU32LE(zip, 0x04034b50);
+    putU16(zip, 20);
+    putU16(zip, 0);
+    putU16(zip, 0); // stored
+    putU32LE(zip, 0);
+    putU32LE(zip, crc);
+    putU32LE(zip, data.size());
+    putU32LE(zip, data.size());
+    putU16(zip, name.size());
+    putU16(zip, 0);
+    zip.insert(zip.end(), name.begin(), name.end());
+    zip.insert(zip.end(), data.begin(), data.end());
+
+    putU32LE(central, 0x02014b50);
+    putU16(central, 20);
+    putU16(central, 20);
+    putU16(central, 0);
+    putU16(central, 0);
+    putU32LE(central, 0);
+    putU32LE(central, crc);
+    putU32LE(central, data.size());
+    putU32LE(central, data.size());
+    putU16(central, name.size());
+    putU16(central, 0);
+    putU16(central, 0);
+    putU16(central, 0);
+    putU16(central, 0);
+    putU32LE(central, 0);
+    putU32LE(central, offset);
+    central.insert(central.end(), name.begin(), name.end());
+  }
+
+  uint32_t centralOffset = zip.size();
+  zip.insert(zip.end(), central.begin(), central.end());
+
+  putU32LE(zip, 0x06054b50);
+  putU16(zip, 0);
+  putU16(zip, 0);
+  putU16(zip, entries.size());
+  putU16(zip, entries.size());
+  putU32LE(zip, central.size());
+  putU32LE(zip, centralOffset);
+  putU16(zip, 0);
+  return zip;
+}
+
+auto asBytes(const char *str) -> Bytes { return Bytes(str, str + std::strlen(str)); }
+
+const char *const CONTAINER_XML =
+  "<?xml version=\"1.0\"?>\n"
+  "<container version=\"1.0\" xmlns=\"urn:oasis:names:tc:opendocument:xmlns:container\">\n"
+  "  <rootfiles><rootfile full-path=\"OEBPS/content.opf\" "
+  "media-type=\"application/oebps-package+xml\"/></rootfiles>\n"
+  "</container>\n";
+
+const char *const CONTENT_OPF =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<package xmlns=\"http://www.idpf.org/2007/opf\" version=\"2.0\" unique-identifier=\"uid\">\n"
+  "  <metadata xmlns:dc=\"http://purl.org/dc/elements/1.1/\">\n"
+  "    <dc:title>Large Cover</dc:title>\n"
+  "    <dc:creator>Test Author</dc:creator>\n"
+  "    <dc:identifier id=\"uid\">urn:uuid:12345678-1234-1234-1234-123456789abd</dc:identifier>\n"
+  "    <meta name=\"cover\" content=\"cover-img\"/>\n"
+  "  </metadata>\n"
+  "  <manifest>\n"
+  "    <item id=\"ch1\" href=\"ch1.xhtml\" media-type=\"application/xhtml+xml\"/>\n"
+  "    <item id=\"cover-img\" href=\"cover.png\" media-type=\"image/png\"/>\n"
+  "  </manifest>\n"
+  "  <spine><itemref idref=\"ch1\"/></spine>\n"
+  "</package>\n";
+
+const char *const CH1_XHTML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<html xmlns=\"http://www.w3.org/1999/xhtml\"><head><title>One</title></head>\n"
+  "<body><p>Text.</p></body></html>\n";
+
+static const char *const BOOK_FOLDER = "/tmp/epub_test_png";
+
+} // namespace
+
+// ============================================================
+// Tests
+// ============================================================
+
+static void testRowFormats() {
+  std::printf("  [rowFormats]\n");
+
+  struct Format {
+    const char *name;
+    uint8_t colorType;
+    uint8_t depth;
+  };
+  const Format formats[] = {
+    {"gray1", 0, 1},  {"gray2", 0, 2}, {"gray4", 0, 4},    {"gray8", 0, 8},
+    {"gray16", 0, 16}, {"rgb8", 2, 8},  {"rgb16", 2, 16},   {"graya8", 4, 8},
+    {"graya16", 4, 16}, {"rgba8", 6, 8}, {"rgba16", 6, 16},
+  };
+
+  for (const auto &f : formats) {
+    PngImage img = makeImage(37, 23, f.colorType, f.depth);
+    Bytes rows   = decodeRows(encodePng(img, filterByRow), 0, 0);
+    bool same    = rows == referenceGray(img);
+    if (!same) std::printf("    format %s\n", f.name);
+    CHECK(same);
+  }
+
+  // Palette, with alpha for the first entries
+  PngImage pal = makeImage(29, 17, 3, 2);
+  pal.palette  = {0, 0, 0, 255, 0, 0, 30, 200, 90, 255, 255, 255};
+  pal.trns     = {0, 128};
+  CHECK(decodeRows(encodePng(pal, filterByRow), 0, 0) == referenceGray(pal));
+
+  // tRNS colors: the matching pixels are white
+  PngImage gray = makeImage(31, 19, 0, 4);
+  gray.trns     = {0, 5};
+  CHECK(decodeRows(encodePng(gray, filterByRow), 0, 0) == referenceGray(gray));
+
+  PngImage rgb = makeImage(31, 19, 2, 8);
+  rgb.samples[0] = 10;
+  rgb.samples[1] = 20;
+  rgb.samples[2] = 30;
+  rgb.trns       = {0, 10, 0, 20, 0, 30};
+  Bytes expected = referenceGray(rgb);
+  CHECK(expected[0] == 255);
+  CHECK(decodeRows(encodePng(rgb, filterByRow), 0, 0) == expected);
+}
+
+static void testRowFilters() {
+  std::printf("  [rowFilters]\n");
+
+  PngImage img   = makeImage(45, 12, 6, 8);
+  Bytes expected = referenceGray(img);
+
+  int (*const filters[])(uint32_t) = {
+    [](uint32_t) { return 0; }, [](uint32_t) { return 1; }, [](uint32_t) { return 2; },
+    [](uint32_t) { return 3; }, [](uint32_t) { return 4; }, filterByRow,
+  };
+  for (auto filter : filters) { CHECK(decodeRows(encodePng(img, filter), 0, 0) == expected); }
+}
+
+static void testRowScale() {
+  std::printf("  [rowScale]\n");
+
+  PngImage img = makeImage(97, 61, 2, 8);
+  Bytes png    = encodePng(img, filterByRow);
+  Bytes gray   = referenceGray(img);
+
+  const uint32_t sizes[][2] = {{97, 61}, {48, 30}, {13, 9}, {24, 15}, {1, 1}, {96, 7}};
+  for (const auto &s : sizes) {
+    CHECK(decodeRows(png, s[0], s[1]) == referenceBox(gray, 97, 61, s[0], s[1]));
+  }
+
+  // Never scaled up
+  CHECK(decodeRows(png, 200, 100) == gray);
+  CHECK(decodeRows(png, 0, 0) == gray);
+}
+
+static void testRowFeed() {
+  std::printf("  [rowFeed]\n");
+
+  PngImage img   = makeImage(53, 21, 4, 8);
+  Bytes png      = encodePng(img, filterByRow);
+  Bytes expected = referenceBox(referenceGray(img), 53, 21, 20, 8);
+
+  CHECK(decodeRows(png, 20, 8, 1) == expected);
+  CHECK(decodeRows(png, 20, 8, 7) == expected);
+  CHECK(decodeRows(png, 20, 8, png.size()) == expected);
+
+  // Interlaced pictures are only drawn pixel by pixel
+  CHECK(decodeRows(encodePng(img, filterByRow, true), 20, 8).empty());
+}
+
+// ── benchmarks ───────────────────────────────────────────────────────────────
+
+static auto largeCover() -> PngImage {
+  PngImage img{2000, 3000, 2, 8};
+  img.samples.resize(size_t(img.width) * img.height * 3);
+  for (uint32_t y = 0; y < img.height; ++y) {
+    for (uint32_t x = 0; x < img.width; ++x) {
+      uint16_t *p = &img.samples[(size_t(y) * img.width + x) * 3];
+      p[0]        = (x / 8 + y / 12) & 0xFF;
+      p[1]        = ((x ^ y) >> 3) & 0xFF;
+      p[2]        = (x * y / 1024) & 0xFF;
+    }
+  }
+  return img;
+}
+
+// A 2000x3000 picture shown at 500x750, the size PngPicture gives it on a
+// 600x800 screen.
+static void testDecodeBench(const Bytes &png) {
+  std::printf("  [decodeBench]\n");
+
+  const uint32_t outW = 500, outH = 750;
+
+  auto start = std::chrono::steady_clock::now();
+  DrawSink sink{outW, outH, 2, Bytes(size_t(outW) * outH)};
+  pngle_t *pngle = mypngle_new();
+  mypngle_set_user_data(pngle, &sink);
+  mypngle_set_draw_callback(pngle, onDraw);
+  CHECK(feed(pngle, png, 10 * 1024));
+  mypngle_destroy(pngle);
+  double drawSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  start      = std::chrono::steady_clock::now();
+  Bytes rows = decodeRows(png, outW, outH, 10 * 1024);
+  double rowSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(rows.size() == size_t(outW) * outH);
+
+  std::printf("    BENCH png=2000x3000 out=%ux%u draw=%.1f ms rows=%.1f ms (x%.2f)\n", outW, outH,
+              drawSecs * 1000.0, rowSecs * 1000.0, rowSecs > 0 ? drawSecs / rowSecs : 0.0);
+}
+
+static void testCoverBench(const Bytes &png) {
+  std::printf("  [coverBench]\n");
+
+  std::error_code ec;
+  std::filesystem::remove_all(BOOK_FOLDER, ec);
+  std::filesystem::create_directory(BOOK_FOLDER, ec);
+
+  Bytes epub = storedZip({
+    {"mimetype", asBytes("application/epub+zip")},
+    {"META-INF/container.xml", asBytes(CONTAINER_XML)},
+    {"OEBPS/content.opf", asBytes(CONTENT_OPF)},
+    {"OEBPS/ch1.xhtml", asBytes(CH1_XHTML)},
+    {"OEBPS/cover.png", png},
+  });
+  std::ofstream(std::string(BOOK_FOLDER) + "/large_cover.epub", std::ios::binary)
+    .write(reinterpret_cast<const char *>(epub.data()), epub.size());
+
+  const int rounds = 3;
+  int covers       = 0;
+  auto start       = std::chrono::steady_clock::now();
+  for (int i = 0; i < rounds; ++i) {
+    auto book = BooksScanner::scan(BOOK_FOLDER, "large_cover.epub", Dim(120, 160));
+    if (book && book->ok && book->cover && (book->cover->getDim().width == 500) &&
+        (book->cover->getDim().height == 750)) {
+      ++covers;
+    }
+  }
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK(covers == rounds);
+
+  std::printf("    BENCH cover=2000x3000 png=%zu bytes extraction=%.1f ms/book\n", png.size(),
+              secs * 1000.0 / rounds);
+
+  std::filesystem::remove_all(BOOK_FOLDER, ec);
+}
+
+// ============================================================
+// Entry point
+// ============================================================
+
+auto testPngDecoder() -> TestStats {
+  checks   = 0;
+  failures = 0;
+
+  testRowFormats();
+  testRowFilters();
+  testRowScale();
+  testRowFeed();
+
+  Bytes png = encodePng(largeCover(), filterPaeth);
+  testDecodeBench(png);
+  testCoverBench(png);
+
+  std::printf("  PNG decoder: %d checks, %d failures\n", checks, failures);
+  return TestStats{checks - failures, failures};
+}
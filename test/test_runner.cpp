@@ -38,8 +38,16 @@ auto testCharPool() -> TestStats;
 auto testFontsCache() -> TestStats;
 auto testFontsCacheStress() -> TestStats;
 auto testGifDecoder() -> TestStats;
+auto testPngDecoder() -> TestStats;
+auto testPictureCache() -> TestStats;
 auto testSvgDecoder() -> TestStats;
 auto testHyphenator() -> TestStats;
+auto testPagesTable() -> TestStats;
+auto testBooksIndex() -> TestStats;
+auto testBooksScanner() -> TestStats;
+auto testLayoutCheckpoints() -> TestStats;
+auto testGlyphBlitter() -> TestStats;
+auto testPictureBlitter() -> TestStats;
 
 // ---------------------------------------------------------------------------
 // Entry point
@@ -78,8 +86,16 @@ int main(int argc, char *argv[]) {
       {"fonts_cache", testFontsCache},
       {"fonts_cache_stress", testFontsCacheStress},
       {"gif_decoder", testGifDecoder},
+      {"png_decoder", testPngDecoder},
+      {"picture_cache", testPictureCache},
       {"svg_decoder", testSvgDecoder},
-      {"hyphenator", testHyphenator}
+      {"hyphenator", testHyphenator},
+      {"pages_table", testPagesTable},
+      {"books_index", testBooksIndex},
+      {"books_scanner", testBooksScanner},
+      {"layout_checkpoints", testLayoutCheckpoints},
+      {"glyph_blitter", testGlyphBlitter},
+      {"picture_blitter", testPictureBlitter}
   };
 
   // Determine which suites to run. When no arguments are given, run all.
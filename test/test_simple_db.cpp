@@ -5,16 +5,21 @@
 // ---------------------------------------------------------------------------
 // SimpleDB test suite
 //
-// Exercises SimpleDB end-to-end using a temporary file so that no
-// pre-existing SDCard content is required.  The file is removed when the
+// Exercises SimpleDB and SlotStore end-to-end using temporary files so that no
+// pre-existing SDCard content is required.  The files are removed when the
 // suite exits (pass or fail).
 // ---------------------------------------------------------------------------
 
 #include "simple_db.hpp"
+#include "slot_store.hpp"
 #include "test_stats.hpp"
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 // Logging / check helpers (same style as the himem and DOM suites).
@@ -47,7 +52,13 @@ struct TestRecord {
   int32_t value;
 };
 
-static const char *const TMP_DB = "/tmp/epub_test_simpledb.db";
+static const char *const TMP_DB    = "/tmp/epub_test_simpledb.db";
+static const char *const TMP_SLOTS = "/tmp/epub_test_slotstore.db";
+
+static auto fileSizeOf(const char *filename) -> long {
+  struct stat statBuf;
+  return (stat(filename, &statBuf) == 0) ? statBuf.st_size : -1;
+}
 
 // ---------------------------------------------------------------------------
 // 1. Create / open lifecycle
@@ -280,6 +291,323 @@ static void testPersistence() {
   remove(TMP_DB);
 }
 
+// ---------------------------------------------------------------------------
+// 8. SlotStore: page aligned slots, capacity check, persistence
+// ---------------------------------------------------------------------------
+static void testSlotStore() {
+  SDB_LOG("--- SlotStore ---");
+
+  remove(TMP_SLOTS);
+
+  const uint32_t CAPACITY = 70 * 90; // Small cover
+
+  auto store = SlotStore::Make();
+  SDB_CHECK(!store->open(TMP_SLOTS, CAPACITY), "open() on non-existing file fails");
+  SDB_CHECK(store->create(TMP_SLOTS, CAPACITY), "create() succeeds");
+  SDB_CHECK(store->getSlotSize() == 13 * SlotStore::PAGE_SIZE, "slot size rounded up to a page");
+  SDB_CHECK(store->getSlotCount() == 0, "new store has zero slots");
+
+  std::vector<uint8_t> a(CAPACITY), b(50 * 90), r(CAPACITY);
+  for (uint32_t i = 0; i < a.size(); i++) { a[i] = i % 251; }
+  for (uint32_t i = 0; i < b.size(); i++) { b[i] = i % 13; }
+
+  uint16_t slotA = SlotStore::NO_SLOT, slotB = SlotStore::NO_SLOT, slotC = SlotStore::NO_SLOT;
+  SDB_CHECK(store->addSlot(a.data(), a.size(), slotA) && (slotA == 0), "full blob in slot 0");
+  SDB_CHECK(store->addSlot(b.data(), b.size(), slotB) && (slotB == 1), "smaller blob in slot 1");
+  SDB_CHECK(!store->addSlot(r.data(), CAPACITY + 1, slotC), "blob larger than capacity refused");
+  SDB_CHECK(store->getSlotCount() == 2, "two slots");
+  SDB_CHECK(fileSizeOf(TMP_SLOTS) == SlotStore::PAGE_SIZE + 2 * (long)store->getSlotSize(),
+            "slots padded: file is header page + whole slots");
+
+  SDB_CHECK(store->getSlot(slotB, r.data(), b.size()) &&
+              (memcmp(r.data(), b.data(), b.size()) == 0),
+            "smaller blob read back");
+  SDB_CHECK(store->getSlot(slotA, r.data(), a.size()) && (r == a), "full blob read back");
+  SDB_CHECK(!store->getSlot(2, r.data(), a.size()), "getSlot() past the last slot fails");
+
+  store->close();
+  SDB_CHECK(!store->isOpen(), "isOpen() false after close");
+
+  SDB_CHECK(!store->open(TMP_SLOTS, 140 * 180), "open() with another capacity fails");
+  SDB_CHECK(store->open(TMP_SLOTS, CAPACITY), "re-open with the same capacity succeeds");
+  SDB_CHECK(store->getSlotCount() == 2, "slot count survives close/reopen");
+  std::fill(r.begin(), r.end(), 0);
+  SDB_CHECK(store->getSlot(slotA, r.data(), a.size()) && (r == a), "blob survives close/reopen");
+
+  SDB_CHECK(store->addSlot(a.data(), a.size(), slotC) && (slotC == 2), "slot added after reopen");
+  store->close();
+
+  // An interrupted write leaves a partial last slot: it is ignored.
+  FILE *f = fopen(TMP_SLOTS, "a");
+  fwrite(a.data(), 100, 1, f);
+  fclose(f);
+  SDB_CHECK(store->open(TMP_SLOTS, CAPACITY) && (store->getSlotCount() == 3),
+            "partial last slot ignored");
+
+  store->close();
+  remove(TMP_SLOTS);
+}
+
+// ---------------------------------------------------------------------------
+// 9. Books list benchmark: metadata records + slot store against records
+//    holding the description and cover (books_dir.db version 7 layout)
+// ---------------------------------------------------------------------------
+static void testCoversBench() {
+  SDB_LOG("--- books list bench ---");
+
+  const int      BOOKS    = 240;
+  const int      CELLS    = 12; // 3x4 grid page
+  const uint32_t CAPACITY = 140 * 180;
+  const int      META     = 336; // Metadata part of a books_dir.db record
+  const int      DESCR    = 512;
+
+  remove(TMP_DB);
+  remove(TMP_SLOTS);
+
+  auto full = SimpleDB::Make();
+  auto meta = SimpleDB::Make();
+  auto store = SlotStore::Make();
+
+  std::vector<uint8_t> record(META + DESCR + CAPACITY, 0x5A);
+  full->create(TMP_DB);
+  for (int i = 0; i < BOOKS; i++) { full->addRecord(record.data(), record.size()); }
+
+  static const char *const TMP_META = "/tmp/epub_test_simpledb_meta.db";
+  remove(TMP_META);
+  meta->create(TMP_META);
+  store->create(TMP_SLOTS, CAPACITY);
+  for (int i = 0; i < BOOKS; i++) {
+    uint16_t slot;
+    store->addSlot(record.data(), CAPACITY, slot);
+    meta->addRecord(record.data(), META + DESCR);
+  }
+
+  std::vector<uint8_t> buf(record.size());
+  long                 oldBytes = 0, newBytes = 0;
+
+  // Grid: each page reads the 12 cells. List: metadata only.
+  auto start = std::chrono::steady_clock::now();
+  for (int idx = 0; idx < BOOKS; idx++) {
+    full->setCurrentIdx(idx);
+    full->getRecord(buf.data(), full->getRecordSize());
+    oldBytes += full->getRecordSize();
+  }
+  double oldSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  bool ok = true;
+  start   = std::chrono::steady_clock::now();
+  for (int idx = 0; idx < BOOKS; idx++) {
+    meta->setCurrentIdx(idx);
+    ok = meta->getRecord(buf.data(), META) && ok;
+    ok = store->getSlot(idx, buf.data() + META, CAPACITY) && ok;
+    newBytes += META + CAPACITY;
+  }
+  double newSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  SDB_CHECK(ok, "every cover read from the slot store");
+
+  long oldList = 0, newList = 0;
+  for (int idx = 0; idx < BOOKS; idx++) {
+    full->setCurrentIdx(idx);
+    oldList += full->getRecordSize();
+    meta->setCurrentIdx(idx);
+    ok = meta->getRecord(buf.data(), META) && ok;
+    newList += META;
+  }
+  SDB_CHECK(ok, "every metadata record read");
+
+  std::printf("    BENCH books=%d pages=%d grid: records=%.0f cells/s (%ld KB) "
+              "metadata+slots=%.0f cells/s (%ld KB); list: %ld KB -> %ld KB (x%.0f less)\n",
+              BOOKS, BOOKS / CELLS, oldSecs > 0 ? BOOKS / oldSecs : 0.0, oldBytes / 1024,
+              newSecs > 0 ? BOOKS / newSecs : 0.0, newBytes / 1024, oldList / 1024,
+              newList / 1024, double(oldList) / double(newList));
+
+  full->close();
+  meta->close();
+  store->close();
+  remove(TMP_DB);
+  remove(TMP_META);
+  remove(TMP_SLOTS);
+}
+
+// ---------------------------------------------------------------------------
+// 10. Trailer: written on close, read on open, dropped before an append,
+//     ignored when corrupted or partial
+// ---------------------------------------------------------------------------
+static auto trailerSize(uint32_t count) -> long { return 4 + 4 * count + 16; }
+
+static auto readBack(SimpleDB &db, uint16_t idx, int32_t id) -> bool {
+  TestRecord r{};
+  db.setCurrentIdx(idx);
+  return (db.getRecordSize() == (int32_t)sizeof(TestRecord)) && db.getRecord(&r, sizeof(r)) &&
+         (r.id == id) && (r.value == id * 10);
+}
+
+static void testTrailer() {
+  SDB_LOG("--- trailer ---");
+
+  const long RECORD = sizeof(int32_t) + sizeof(TestRecord);
+
+  remove(TMP_DB);
+
+  auto db = SimpleDB::Make();
+  db->create(TMP_DB);
+  for (int i = 0; i < 3; ++i) {
+    TestRecord w = {i, "trailer", i * 10};
+    db->addRecord(&w, sizeof(w));
+  }
+  SDB_CHECK(!db->hasValidTrailer(), "no trailer while records are added");
+  SDB_CHECK(fileSizeOf(TMP_DB) == 3 * RECORD, "only the records in file before close");
+  db->close();
+  SDB_CHECK(fileSizeOf(TMP_DB) == 3 * RECORD + trailerSize(3), "trailer appended on close");
+
+  SDB_CHECK(db->open(TMP_DB) && db->hasValidTrailer(), "open() reads the trailer");
+  SDB_CHECK(db->getRecordCount() == 3, "record count from the trailer");
+  SDB_CHECK(readBack(*db, 0, 0) && readBack(*db, 2, 2), "records located from the trailer");
+
+  TestRecord w = {3, "trailer", 30};
+  SDB_CHECK(db->addRecord(&w, sizeof(w)), "addRecord() after a trailer open");
+  SDB_CHECK(!db->hasValidTrailer() && (fileSizeOf(TMP_DB) == 4 * RECORD),
+            "trailer cut off before the append");
+  SDB_CHECK(readBack(*db, 3, 3) && readBack(*db, 2, 2), "appended record in place of the trailer");
+  db->close();
+
+  db->open(TMP_DB);
+  db->close();
+  SDB_CHECK(fileSizeOf(TMP_DB) == 4 * RECORD + trailerSize(4), "unchanged file not rewritten");
+
+  // Corrupted record offset: the CRC does not match, the records are scanned.
+  FILE *f = fopen(TMP_DB, "r+");
+  fseek(f, 4 * RECORD + 8, SEEK_SET);
+  int32_t bad = 12345;
+  fwrite(&bad, sizeof(bad), 1, f);
+  fclose(f);
+  SDB_CHECK(db->open(TMP_DB) && !db->hasValidTrailer(), "corrupted trailer ignored");
+  SDB_CHECK((db->getRecordCount() == 4) && readBack(*db, 1, 1) && readBack(*db, 3, 3),
+            "scan stops at the corrupted trailer");
+  db->close();
+  SDB_CHECK(db->open(TMP_DB) && db->hasValidTrailer(), "trailer rewritten on close");
+  db->close();
+
+  // Interrupted close: part of the trailer only.
+  SDB_CHECK(truncate(TMP_DB, 4 * RECORD + 10) == 0, "trailer cut short");
+  SDB_CHECK(db->open(TMP_DB) && !db->hasValidTrailer(), "partial trailer ignored");
+  SDB_CHECK((db->getRecordCount() == 4) && readBack(*db, 3, 3), "scan stops at the partial trailer");
+  w = {4, "trailer", 40};
+  SDB_CHECK(db->addRecord(&w, sizeof(w)) && (fileSizeOf(TMP_DB) == 5 * RECORD),
+            "partial trailer cut off before the append");
+  db->close();
+  SDB_CHECK(db->open(TMP_DB) && db->hasValidTrailer() && (db->getRecordCount() == 5) &&
+              readBack(*db, 4, 4),
+            "records and trailer after the append");
+  db->close();
+
+  // File written without a trailer (before this format): the trailer is added.
+  f = fopen(TMP_DB, "w");
+  for (int i = 0; i < 2; ++i) {
+    int32_t    size = sizeof(TestRecord);
+    TestRecord r    = {i, "legacy", i * 10};
+    fwrite(&size, sizeof(size), 1, f);
+    fwrite(&r, sizeof(r), 1, f);
+  }
+  fclose(f);
+  SDB_CHECK(db->open(TMP_DB) && !db->hasValidTrailer() && (db->getRecordCount() == 2) &&
+              readBack(*db, 1, 1),
+            "file without trailer scanned");
+  db->close();
+  SDB_CHECK(fileSizeOf(TMP_DB) == 2 * RECORD + trailerSize(2), "trailer added to an old file");
+
+  // An empty database stays empty.
+  db->create(TMP_DB);
+  db->close();
+  SDB_CHECK(fileSizeOf(TMP_DB) == 0, "no trailer for an empty database");
+
+  remove(TMP_DB);
+}
+
+// ---------------------------------------------------------------------------
+// 11. More records than the former 2000 entries table, with a trailer larger
+//     than the tail read of open()
+// ---------------------------------------------------------------------------
+static void testManyRecords() {
+  SDB_LOG("--- many records ---");
+
+  const int COUNT = 2500;
+
+  remove(TMP_DB);
+
+  auto db = SimpleDB::Make();
+  db->create(TMP_DB);
+  bool ok = true;
+  for (int i = 0; i < COUNT; ++i) {
+    TestRecord w = {i, "many", i * 10};
+    ok = db->addRecord(&w, sizeof(w)) && ok;
+  }
+  SDB_CHECK(ok && (db->getRecordCount() == COUNT), "all records added");
+  db->close();
+
+  SDB_CHECK(db->open(TMP_DB) && db->hasValidTrailer(), "large trailer read");
+  SDB_CHECK(db->getRecordCount() == COUNT, "record count from the large trailer");
+  SDB_CHECK(readBack(*db, 0, 0) && readBack(*db, 2000, 2000) && readBack(*db, COUNT - 1, COUNT - 1),
+            "records past the former limit");
+
+  int count = db->gotoFirst() ? 1 : 0;
+  while (db->gotoNext()) ++count;
+  SDB_CHECK(count == COUNT, "gotoNext() iterates all records");
+  db->close();
+
+  remove(TMP_DB);
+}
+
+// ---------------------------------------------------------------------------
+// 12. open() benchmark: records scanned against the trailer
+// ---------------------------------------------------------------------------
+static void testOpenBench() {
+  SDB_LOG("--- open bench ---");
+
+  const int  RECORDS = 1500;
+  const int  OPENS   = 20;
+  const int  SIZE    = 900; // About a books_dir.db record
+  const long DATA    = RECORDS * (long)(sizeof(int32_t) + SIZE);
+
+  remove(TMP_DB);
+
+  std::vector<uint8_t> record(SIZE, 0x5A);
+  auto                 db = SimpleDB::Make();
+  db->create(TMP_DB);
+  for (int i = 0; i < RECORDS; ++i) { db->addRecord(record.data(), SIZE); }
+  db->close();
+
+  bool   ok       = true;
+  double scanSecs = 0.0;
+  for (int i = 0; i < OPENS; ++i) {
+    ok         = (truncate(TMP_DB, DATA) == 0) && ok;
+    auto start = std::chrono::steady_clock::now();
+    ok         = db->open(TMP_DB) && !db->hasValidTrailer() && ok;
+    scanSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ok = (db->getRecordCount() == RECORDS) && ok;
+    db->close();
+  }
+  SDB_CHECK(ok, "records scanned on each open");
+
+  ok               = true;
+  double trailSecs = 0.0;
+  for (int i = 0; i < OPENS; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    ok         = db->open(TMP_DB) && db->hasValidTrailer() && ok;
+    trailSecs += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ok = (db->getRecordCount() == RECORDS) && ok;
+    db->close();
+  }
+  SDB_CHECK(ok, "records from the trailer on each open");
+
+  std::printf("    BENCH records=%d open: scan=%.3f ms (%d reads+seeks) "
+              "trailer=%.3f ms (%d reads) (x%.1f)\n",
+              RECORDS, scanSecs * 1000.0 / OPENS, 2 * RECORDS, trailSecs * 1000.0 / OPENS,
+              (trailerSize(RECORDS) > 4096) ? 2 : 1, trailSecs > 0 ? scanSecs / trailSecs : 0.0);
+
+  remove(TMP_DB);
+}
+
 // ---------------------------------------------------------------------------
 // Public entry point
 // ---------------------------------------------------------------------------
@@ -296,6 +624,11 @@ auto testSimpleDb() -> TestStats {
   testNavigation();
   testDelete();
   testPersistence();
+  testSlotStore();
+  testCoversBench();
+  testTrailer();
+  testManyRecords();
+  testOpenBench();
 
   SDB_LOG("========== SimpleDB test suite end: %d passed, %d failed ==========", sPass, sFail);
   return TestStats{sPass, sFail};
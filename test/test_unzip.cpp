@@ -8,11 +8,17 @@
 // Uses the EPUB fixture generated under test/fixtures/minimal.epub.
 // ---------------------------------------------------------------------------
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 #include "test_stats.hpp"
 #include "unzip.hpp"
@@ -99,6 +105,138 @@ static auto testReadDeflatedFile() -> bool {
   return sFail == 0;
 }
 
+// ---------------------------------------------------------------------------
+// Lookup benchmark
+//
+// Writes a stored (uncompressed) zip with N small entries named like the
+// content of a large EPUB, then measures fileExists() / getFileSize()
+// lookups per second over the whole set.
+// ---------------------------------------------------------------------------
+
+static auto putLe16(std::vector<char> &buf, uint16_t v) -> void {
+  buf.push_back((char)(v & 0xFF));
+  buf.push_back((char)(v >> 8));
+}
+
+static auto putLe32(std::vector<char> &buf, uint32_t v) -> void {
+  putLe16(buf, (uint16_t)(v & 0xFFFF));
+  putLe16(buf, (uint16_t)(v >> 16));
+}
+
+static auto benchFilename(int i) -> std::string {
+  char name[64];
+  std::snprintf(name, sizeof(name), "OEBPS/%s/part%05d.%s",
+                (i & 1) ? "Images" : "Text", i, (i & 1) ? "jpg" : "xhtml");
+  return name;
+}
+
+static auto writeStoredZip(const char *path, int count) -> bool {
+  std::vector<char> data;
+  std::vector<char> central;
+  const char        payload[] = "x";
+
+  for (int i = 0; i < count; ++i) {
+    std::string name   = benchFilename(i);
+    uint32_t    offset = (uint32_t)data.size();
+
+    putLe32(data, 0x04034b50);
+    putLe16(data, 10);
+    putLe16(data, 0);
+    putLe16(data, 0);                           // stored
+    putLe32(data, 0);                           // time / date
+    putLe32(data, 0);                           // crc (unchecked)
+    putLe32(data, 1);
+    putLe32(data, 1);
+    putLe16(data, (uint16_t)name.size());
+    putLe16(data, 0);
+    data.insert(data.end(), name.begin(), name.end());
+    data.push_back(payload[0]);
+
+    putLe32(central, 0x02014b50);
+    putLe16(central, 20);
+    putLe16(central, 10);
+    putLe16(central, 0);
+    putLe16(central, 0);                        // stored
+    putLe32(central, 0);                        // time / date
+    putLe32(central, 0);                        // crc
+    putLe32(central, 1);
+    putLe32(central, 1);
+    putLe16(central, (uint16_t)name.size());
+    putLe16(central, 0);
+    putLe16(central, 0);
+    putLe16(central, 0);
+    putLe16(central, 0);
+    putLe32(central, 0);
+    putLe32(central, offset);
+    central.insert(central.end(), name.begin(), name.end());
+  }
+
+  uint32_t centralOffset = (uint32_t)data.size();
+  data.insert(data.end(), central.begin(), central.end());
+
+  putLe32(data, 0x06054b50);
+  putLe16(data, 0);
+  putLe16(data, 0);
+  putLe16(data, (uint16_t)count);
+  putLe16(data, (uint16_t)count);
+  putLe32(data, (uint32_t)central.size());
+  putLe32(data, centralOffset);
+  putLe16(data, 0);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), (std::streamsize)data.size());
+  return out.good();
+}
+
+static auto testLookupBenchmark() -> bool {
+  UNZIP_LOG("--- lookup benchmark ---");
+
+  static constexpr const char *BENCH_ZIP = "/tmp/epub_test_unzip_bench.zip";
+  static constexpr int         COUNTS[]  = { 100, 1000, 5000 };
+
+  for (int count : COUNTS) {
+    bool written = writeStoredZip(BENCH_ZIP, count);
+    UNZIP_CHECK(written, "benchmark zip written");
+    if (!written) { continue; }
+
+    bool opened = unzip.openZipFile(BENCH_ZIP);
+    UNZIP_CHECK(opened, "openZipFile(benchmark zip) succeeds");
+    if (!opened) { continue; }
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) names.push_back(benchFilename(i));
+
+    bool allFound = true;
+    for (auto &n : names) allFound &= unzip.getFileSize(n.c_str()) == 1;
+    UNZIP_CHECK(allFound, "every benchmark entry is found with its size");
+    UNZIP_CHECK(!unzip.fileExists("OEBPS/Text/missing.xhtml"), "missing entry is not found");
+
+    uint32_t outSize = 0;
+    auto     last    = unzip.getFile(names.back().c_str(), outSize);
+    UNZIP_CHECK((last != nullptr) && (outSize == 1) && (last[0] == 'x'),
+                "last benchmark entry content is retrieved");
+
+    const int lookups = 200000;
+    int       found   = 0;
+    auto      start   = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+      if (unzip.fileExists(names[(i * 7919) % count].c_str())) ++found;
+    }
+    auto   elapsed = std::chrono::steady_clock::now() - start;
+    double secs    = std::chrono::duration<double>(elapsed).count();
+
+    UNZIP_CHECK(found == lookups, "all benchmark lookups succeed");
+    UNZIP_LOG("  BENCH entries=%5d lookups=%d time=%.3f s -> %.0f lookups/s",
+              count, lookups, secs, secs > 0 ? lookups / secs : 0.0);
+
+    unzip.closeZipFile();
+  }
+
+  std::remove(BENCH_ZIP);
+  return sFail == 0;
+}
+
 #if !STB
 
   static auto testCloseZipWhileStreamOpenSameThread() -> bool {
@@ -177,6 +315,221 @@ static auto testReadDeflatedFile() -> bool {
   }
 
 
+  // -------------------------------------------------------------------------
+  // Concurrent readers stress test
+  //
+  // Writes a zip with two deflated entries (copies of the long chapter of a
+  // fixture, as miniz is built without compression), then streams them from
+  // two threads at the same time, a number of times each: once serialized by
+  // a lock held for a whole file (as getFile() used to), then with independent
+  // readers. The content must be intact and, with more than one core, the
+  // readers must be faster.
+  // -------------------------------------------------------------------------
+
+  struct DeflatedEntry {
+    std::vector<char> compressed;
+    uint32_t size{ 0 };
+    uint32_t crc{ 0 };
+  };
+
+  /// Retrieve the compressed data of an entry from the local headers of a zip.
+  static auto readDeflatedEntry(const char *zipPath, const std::string &name, DeflatedEntry &entry)
+  -> bool {
+    std::ifstream in(zipPath, std::ios::binary);
+    std::vector<char> zip((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    auto le16 = [&](size_t pos) -> uint32_t {
+      return (uint8_t)zip[pos] | ((uint32_t)(uint8_t)zip[pos + 1] << 8);
+    };
+    auto le32 = [&](size_t pos) -> uint32_t { return le16(pos) | (le16(pos + 2) << 16); };
+
+    size_t pos = 0;
+    while ((pos + 30) <= zip.size() && (le32(pos) == 0x04034b50)) {
+      uint32_t compressedSize = le32(pos + 18);
+      uint32_t nameSize       = le16(pos + 26);
+      uint32_t extraSize      = le16(pos + 28);
+      size_t   dataPos        = pos + 30 + nameSize + extraSize;
+      if ((le16(pos + 8) == 8) && (name.compare(0, std::string::npos, &zip[pos + 30], nameSize) == 0)) {
+        entry.compressed.assign(zip.begin() + dataPos, zip.begin() + dataPos + compressedSize);
+        entry.crc  = le32(pos + 14);
+        entry.size = le32(pos + 22);
+        return true;
+      }
+      pos = dataPos + compressedSize;
+    }
+    return false;
+  }
+
+  static auto writeDeflatedZip(const char *path, const std::vector<std::string> &names,
+                               const DeflatedEntry &entry) -> bool {
+    std::vector<char> data;
+    std::vector<char> central;
+
+    for (const std::string &name : names) {
+      uint32_t offset = (uint32_t)data.size();
+
+      putLe32(data, 0x04034b50);
+      putLe16(data, 20);
+      putLe16(data, 0);
+      putLe16(data, 8);                           // deflated
+      putLe32(data, 0);                           // time / date
+      putLe32(data, entry.crc);
+      putLe32(data, (uint32_t)entry.compressed.size());
+      putLe32(data, entry.size);
+      putLe16(data, (uint16_t)name.size());
+      putLe16(data, 0);
+      data.insert(data.end(), name.begin(), name.end());
+      data.insert(data.end(), entry.compressed.begin(), entry.compressed.end());
+
+      putLe32(central, 0x02014b50);
+      putLe16(central, 20);
+      putLe16(central, 20);
+      putLe16(central, 0);
+      putLe16(central, 8);                        // deflated
+      putLe32(central, 0);                        // time / date
+      putLe32(central, entry.crc);
+      putLe32(central, (uint32_t)entry.compressed.size());
+      putLe32(central, entry.size);
+      putLe16(central, (uint16_t)name.size());
+      putLe16(central, 0);
+      putLe16(central, 0);
+      putLe16(central, 0);
+      putLe16(central, 0);
+      putLe32(central, 0);
+      putLe32(central, offset);
+      central.insert(central.end(), name.begin(), name.end());
+    }
+
+    uint32_t centralOffset = (uint32_t)data.size();
+    data.insert(data.end(), central.begin(), central.end());
+
+    putLe32(data, 0x06054b50);
+    putLe16(data, 0);
+    putLe16(data, 0);
+    putLe16(data, (uint16_t)names.size());
+    putLe16(data, (uint16_t)names.size());
+    putLe32(data, (uint32_t)central.size());
+    putLe32(data, centralOffset);
+    putLe16(data, 0);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), (std::streamsize)data.size());
+    return out.good();
+  }
+
+  static auto testConcurrentReadersStress() -> bool {
+    UNZIP_LOG("--- concurrent readers stress ---");
+
+    static constexpr const char *LONG_CHAPTER = "test/fixtures/long_chapter.epub";
+    static constexpr const char *STRESS_ZIP   = "/tmp/epub_test_unzip_stress.zip";
+    static constexpr int         PASSES       = 40;
+
+    DeflatedEntry chapter;
+    bool          found = readDeflatedEntry(LONG_CHAPTER, "OEBPS/long.xhtml", chapter);
+    UNZIP_CHECK(found, "long chapter found in its fixture");
+    if (!found) { return false; }
+
+    std::string expected;
+    {
+      bool opened = unzip.openZipFile(LONG_CHAPTER);
+      UNZIP_CHECK(opened, "openZipFile(long_chapter.epub) succeeds");
+      if (!opened) { return false; }
+      uint32_t size = 0;
+      auto     data = unzip.getFile("OEBPS/long.xhtml", size);
+      UNZIP_CHECK((data != nullptr) && (size == chapter.size), "long chapter retrieved");
+      if (data == nullptr) { return false; }
+      expected.assign((const char *)data.get(), size);
+    }
+
+    std::vector<std::string> names = { "OEBPS/Text/chapter1.xhtml", "OEBPS/Text/chapter2.xhtml" };
+
+    bool written = writeDeflatedZip(STRESS_ZIP, names, chapter);
+    UNZIP_CHECK(written, "stress zip written");
+    if (!written) { return false; }
+
+    bool opened = unzip.openZipFile(STRESS_ZIP);
+    UNZIP_CHECK(opened, "openZipFile(stress zip) succeeds");
+    if (!opened) { return false; }
+
+    const uint32_t ENTRY_SIZE = chapter.size;
+
+    // Each thread alternates between getFile() and a reader streaming by 4 KB
+    // chunks, as the page locations retriever and the book viewer do.
+    auto readEntry = [&](int i, std::mutex *wholeFileLock) -> bool {
+      bool intact = true;
+      for (int pass = 0; pass < PASSES; ++pass) {
+        std::unique_lock<std::mutex> guard;
+        if (wholeFileLock != nullptr) { guard = std::unique_lock<std::mutex>(*wholeFileLock); }
+
+        if (pass & 1) {
+          uint32_t size   = 0;
+          auto     reader = unzip.openReader(names[i].c_str(), size);
+          if ((reader == nullptr) || (size != ENTRY_SIZE)) { return false; }
+          std::string text(size, '\0');
+          uint32_t    total = 0;
+          uint32_t    got;
+          while ((total < size) &&
+                 ((got = reader->read(text.data() + total, std::min<uint32_t>(4096, size - total))) != 0)) {
+            total += got;
+          }
+          intact &= (total == size) && (text == expected);
+        } else {
+          uint32_t size = 0;
+          auto     data = unzip.getFile(names[i].c_str(), size);
+          intact &= (data != nullptr) && (size == ENTRY_SIZE) &&
+                    (memcmp(data.get(), expected.data(), size) == 0);
+        }
+      }
+      return intact;
+    };
+
+    auto runBoth = [&](std::mutex *wholeFileLock, bool &intact) -> double {
+      bool ok[2] = { false, false };
+      auto start = std::chrono::steady_clock::now();
+      std::thread first([&] { ok[0] = readEntry(0, wholeFileLock); });
+      std::thread second([&] { ok[1] = readEntry(1, wholeFileLock); });
+      first.join();
+      second.join();
+      intact = ok[0] && ok[1];
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::mutex lock;
+    bool       serializedIntact = false;
+    bool       parallelIntact   = false;
+    double     serializedSecs   = runBoth(&lock, serializedIntact);
+    double     parallelSecs     = runBoth(nullptr, parallelIntact);
+
+    UNZIP_CHECK(serializedIntact, "entries are intact when read one at a time");
+    UNZIP_CHECK(parallelIntact,   "entries are intact when read concurrently");
+
+    double mb = 2.0 * PASSES * ENTRY_SIZE / (1024.0 * 1024.0);
+    UNZIP_LOG("  BENCH 2 threads x %d x %u bytes: whole file lock %.3f s (%.1f MB/s), "
+              "readers %.3f s (%.1f MB/s), speedup %.2fx",
+              PASSES, ENTRY_SIZE, serializedSecs, mb / serializedSecs, parallelSecs,
+              mb / parallelSecs, serializedSecs / parallelSecs);
+
+    if (std::thread::hardware_concurrency() >= 2) {
+      UNZIP_CHECK(parallelSecs < serializedSecs, "concurrent readers are faster than the lock");
+    } else {
+      UNZIP_LOG("  (single core: no speedup expected)");
+    }
+
+    // A reader outlives the central directory.
+    uint32_t size   = 0;
+    auto     reader = unzip.openReader(names[0].c_str(), size);
+    unzip.closeZipFile();
+    char     head[16];
+    UNZIP_CHECK((reader != nullptr) && (reader->read(head, sizeof(head)) == sizeof(head)) &&
+                (memcmp(head, expected.data(), sizeof(head)) == 0),
+                "a reader stays usable after closeZipFile()");
+    reader.reset();
+
+    std::remove(STRESS_ZIP);
+    return sFail == 0;
+  }
+
+
 #endif
 
 auto testUnzip() -> TestStats {
@@ -198,10 +551,12 @@ auto testUnzip() -> TestStats {
     run("open-close",    testOpenClose);
     run("lookup-stored", testLookupAndReadStoredFile);
     run("read-deflated", testReadDeflatedFile);
+    run("lookup-bench",  testLookupBenchmark);
 
   #if !STB
     run("close-zip-during-stream",      testCloseZipWhileStreamOpenSameThread);
     run("concurrent-stream-contention", testConcurrentStreamAccessContention);
+    run("concurrent-readers-stress",    testConcurrentReadersStress);
   #endif
 
   UNZIP_LOG("========== Unzip test suite end: %d passed, %d failed ==========", sPass, sFail);